@@ -77,7 +77,7 @@ Glacier2::ClientBlobject::ice_invoke_async(const Ice::AMD_Object_ice_invokePtr&
         }
     }
 
-    ObjectPrx proxy = _routingTable->get(current.id);
+    ObjectPrx proxy = _routingTable->get(current.id, current.requestId == 0);
     if(!proxy)
     {
         //
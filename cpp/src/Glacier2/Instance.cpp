@@ -12,6 +12,8 @@
 #include <Glacier2/InstrumentationI.h>
 #include <Ice/InstrumentationI.h>
 
+#include <algorithm>
+
 using namespace std;
 using namespace Glacier2;
 
@@ -22,6 +24,46 @@ const string serverSleepTime = "Glacier2.Server.SleepTime";
 const string clientSleepTime = "Glacier2.Client.SleepTime";
 const string serverBuffered = "Glacier2.Server.Buffered";
 const string clientBuffered = "Glacier2.Client.Buffered";
+const string serverFlushThreads = "Glacier2.Server.FlushThreads";
+const string clientFlushThreads = "Glacier2.Client.FlushThreads";
+
+void
+startRequestQueueThreads(vector<RequestQueueThreadPtr>& threads, int count, const IceUtil::Time& sleepTime)
+{
+    for(int i = 0; i < count; ++i)
+    {
+        threads.push_back(new RequestQueueThread(sleepTime));
+        try
+        {
+            threads.back()->start();
+        }
+        catch(const IceUtil::Exception&)
+        {
+            for(vector<RequestQueueThreadPtr>::const_iterator p = threads.begin(); p != threads.end(); ++p)
+            {
+                (*p)->destroy();
+            }
+            throw;
+        }
+    }
+}
+
+RequestQueueThreadPtr
+selectRequestQueueThread(const vector<RequestQueueThreadPtr>& threads, IceUtilInternal::Atomic& index)
+{
+    if(threads.empty())
+    {
+        return 0;
+    }
+
+    //
+    // The request queue of a session is always flushed by the same
+    // thread to preserve the ordering of its requests. Sessions are
+    // assigned to the threads in turn to spread the load evenly.
+    //
+    unsigned int i = static_cast<unsigned int>(index.fetch_add(1));
+    return threads[i % threads.size()];
+}
 
 }
 
@@ -31,39 +73,29 @@ Glacier2::Instance::Instance(const Ice::CommunicatorPtr& communicator, const Ice
     _properties(communicator->getProperties()),
     _logger(communicator->getLogger()),
     _clientAdapter(clientAdapter),
-    _serverAdapter(serverAdapter)
+    _serverAdapter(serverAdapter),
+    _clientRequestQueueThreadIndex(0),
+    _serverRequestQueueThreadIndex(0)
 {
     if(_properties->getPropertyAsIntWithDefault(serverBuffered, 1) > 0)
     {
         IceUtil::Time sleepTime = IceUtil::Time::milliSeconds(_properties->getPropertyAsInt(serverSleepTime));
-        const_cast<RequestQueueThreadPtr&>(_serverRequestQueueThread) = new RequestQueueThread(sleepTime);
-        try
-        {
-            _serverRequestQueueThread->start();
-        }
-        catch(const IceUtil::Exception&)
-        {
-            _serverRequestQueueThread->destroy();
-            throw;
-        }
+        int threads = max(1, _properties->getPropertyAsIntWithDefault(serverFlushThreads, 1));
+        startRequestQueueThreads(const_cast<vector<RequestQueueThreadPtr>&>(_serverRequestQueueThreads), threads,
+                                 sleepTime);
     }
 
     if(_properties->getPropertyAsIntWithDefault(clientBuffered, 1) > 0)
     {
         IceUtil::Time sleepTime = IceUtil::Time::milliSeconds(_properties->getPropertyAsInt(clientSleepTime));
-        const_cast<RequestQueueThreadPtr&>(_clientRequestQueueThread) = new RequestQueueThread(sleepTime);
-        try
-        {
-            _clientRequestQueueThread->start();
-        }
-        catch(const IceUtil::Exception&)
-        {
-            _clientRequestQueueThread->destroy();
-            throw;
-        }
+        int threads = max(1, _properties->getPropertyAsIntWithDefault(clientFlushThreads, 1));
+        startRequestQueueThreads(const_cast<vector<RequestQueueThreadPtr>&>(_clientRequestQueueThreads), threads,
+                                 sleepTime);
     }
 
     const_cast<ProxyVerifierPtr&>(_proxyVerifier) = new ProxyVerifier(communicator);
+    const_cast<RoutingTableMemoryPtr&>(_routingTableMemory) = new RoutingTableMemory(
+        static_cast<Ice::Long>(_properties->getPropertyAsInt("Glacier2.RoutingTable.TotalMaxMemory")) * 1024);
 
     //
     // If an Ice metrics observer is setup on the communicator, also
@@ -83,17 +115,31 @@ Glacier2::Instance::~Instance()
 {
 }
 
+RequestQueueThreadPtr
+Glacier2::Instance::clientRequestQueueThread()
+{
+    return selectRequestQueueThread(_clientRequestQueueThreads, _clientRequestQueueThreadIndex);
+}
+
+RequestQueueThreadPtr
+Glacier2::Instance::serverRequestQueueThread()
+{
+    return selectRequestQueueThread(_serverRequestQueueThreads, _serverRequestQueueThreadIndex);
+}
+
 void
 Glacier2::Instance::destroy()
 {
-    if(_clientRequestQueueThread)
+    for(vector<RequestQueueThreadPtr>::const_iterator p = _clientRequestQueueThreads.begin();
+        p != _clientRequestQueueThreads.end(); ++p)
     {
-        _clientRequestQueueThread->destroy();
+        (*p)->destroy();
     }
 
-    if(_serverRequestQueueThread)
+    for(vector<RequestQueueThreadPtr>::const_iterator p = _serverRequestQueueThreads.begin();
+        p != _serverRequestQueueThreads.end(); ++p)
     {
-        _serverRequestQueueThread->destroy();
+        (*p)->destroy();
     }
 
     const_cast<SessionRouterIPtr&>(_sessionRouter) = 0;
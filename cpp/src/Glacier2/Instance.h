@@ -14,9 +14,11 @@
 #include <Ice/ObjectAdapterF.h>
 #include <Ice/PropertiesF.h>
 #include <IceUtil/Time.h>
+#include <IceUtil/Atomic.h>
 
 #include <Glacier2/RequestQueue.h>
 #include <Glacier2/ProxyVerifier.h>
+#include <Glacier2/RoutingTable.h>
 #include <Glacier2/SessionRouterI.h>
 #include <Glacier2/Instrumentation.h>
 
@@ -36,9 +38,14 @@ public:
     Ice::PropertiesPtr properties() const { return _properties; }
     Ice::LoggerPtr logger() const { return _logger; }
 
-    RequestQueueThreadPtr clientRequestQueueThread() const { return _clientRequestQueueThread; }
-    RequestQueueThreadPtr serverRequestQueueThread() const { return _serverRequestQueueThread; }
+    bool clientBuffered() const { return !_clientRequestQueueThreads.empty(); }
+    bool serverBuffered() const { return !_serverRequestQueueThreads.empty(); }
+
+    // Returns the thread to flush the request queue of a new session, null if not buffered.
+    RequestQueueThreadPtr clientRequestQueueThread();
+    RequestQueueThreadPtr serverRequestQueueThread();
     ProxyVerifierPtr proxyVerifier() const { return _proxyVerifier; }
+    RoutingTableMemoryPtr routingTableMemory() const { return _routingTableMemory; }
     SessionRouterIPtr sessionRouter() const { return _sessionRouter; }
 
     const Glacier2::Instrumentation::RouterObserverPtr& getObserver() const { return _observer; }
@@ -55,9 +62,12 @@ private:
     const Ice::LoggerPtr _logger;
     const Ice::ObjectAdapterPtr _clientAdapter;
     const Ice::ObjectAdapterPtr _serverAdapter;
-    const RequestQueueThreadPtr _clientRequestQueueThread;
-    const RequestQueueThreadPtr _serverRequestQueueThread;
+    const std::vector<RequestQueueThreadPtr> _clientRequestQueueThreads;
+    const std::vector<RequestQueueThreadPtr> _serverRequestQueueThreads;
+    IceUtilInternal::Atomic _clientRequestQueueThreadIndex;
+    IceUtilInternal::Atomic _serverRequestQueueThreadIndex;
     const ProxyVerifierPtr _proxyVerifier;
+    const RoutingTableMemoryPtr _routingTableMemory;
     const SessionRouterIPtr _sessionRouter;
     const Glacier2::Instrumentation::RouterObserverPtr _observer;
 };
@@ -22,7 +22,7 @@ using namespace IceMX;
 namespace
 {
 
-class SessionHelper : public MetricsHelperT<SessionMetrics>
+class SessionHelper : public MetricsHelperT<SessionRoutingTableMetrics>
 {
 public:
 
@@ -40,8 +40,10 @@ public:
     };
     static Attributes attributes;
 
-    SessionHelper(const string& instanceName, const string& id, const ::Ice::ConnectionPtr& connection, int rtSize) :
-        _instanceName(instanceName), _id(id), _connection(connection), _routingTableSize(rtSize)
+    SessionHelper(const string& instanceName, const string& id, const ::Ice::ConnectionPtr& connection, int rtSize,
+                  Ice::Long rtMemory) :
+        _instanceName(instanceName), _id(id), _connection(connection), _routingTableSize(rtSize),
+        _routingTableMemory(rtMemory)
     {
     }
 
@@ -50,9 +52,10 @@ public:
         return attributes(this, attribute);
     }
 
-    virtual void initMetrics(const SessionMetricsPtr& v) const
+    virtual void initMetrics(const SessionRoutingTableMetricsPtr& v) const
     {
         v->routingTableSize += _routingTableSize;
+        v->routingTableMemory += _routingTableMemory;
     }
 
     const string& getInstanceName() const
@@ -99,6 +102,7 @@ private:
     const string& _id;
     const ::Ice::ConnectionPtr& _connection;
     const int _routingTableSize;
+    const Ice::Long _routingTableMemory;
     mutable ::Ice::EndpointInfoPtr _endpointInfo;
 };
 
@@ -178,6 +182,24 @@ SessionObserverI::routingTableSize(int delta)
     forEach(add(&SessionMetrics::routingTableSize, delta));
 }
 
+void
+SessionObserverI::routingTableMemory(Ice::Long delta)
+{
+    forEach(add(&SessionRoutingTableMetrics::routingTableMemory, delta));
+}
+
+void
+SessionObserverI::routingTableEvicted(int count)
+{
+    forEach(add(&SessionRoutingTableMetrics::routingTableEvictions, count));
+}
+
+void
+SessionObserverI::routingTableTotalMemoryEvicted(int count)
+{
+    forEach(add(&SessionRoutingTableMetrics::routingTableTotalMemoryEvictions, count));
+}
+
 RouterObserverI::RouterObserverI(const IceInternal::MetricsAdminIPtr& metrics, const string& instanceName) :
     _metrics(metrics), _instanceName(instanceName), _sessions(metrics, "Session")
 {
@@ -193,13 +215,15 @@ SessionObserverPtr
 RouterObserverI::getSessionObserver(const string& id,
                                     const ::Ice::ConnectionPtr& connection,
                                     int routingTableSize,
+                                    Ice::Long routingTableMemory,
                                     const SessionObserverPtr& old)
 {
     if(_sessions.isEnabled())
     {
         try
         {
-            return _sessions.getObserver(SessionHelper(_instanceName, id, connection, routingTableSize), old);
+            return _sessions.getObserver(SessionHelper(_instanceName, id, connection, routingTableSize,
+                                                          routingTableMemory), old);
         }
         catch(const exception& ex)
         {
@@ -19,7 +19,7 @@ namespace Glacier2
 {
 
 class SessionObserverI : public Glacier2::Instrumentation::SessionObserver,
-                         public IceMX::ObserverT<IceMX::SessionMetrics>
+                         public IceMX::ObserverT<IceMX::SessionRoutingTableMetrics>
 {
 public:
 
@@ -27,6 +27,9 @@ public:
     virtual void queued(bool);
     virtual void overridden(bool);
     virtual void routingTableSize(int);
+    virtual void routingTableMemory(Ice::Long);
+    virtual void routingTableEvicted(int);
+    virtual void routingTableTotalMemoryEvicted(int);
 };
 
 class RouterObserverI : public Glacier2::Instrumentation::RouterObserver
@@ -38,7 +41,8 @@ public:
     virtual void setObserverUpdater(const Glacier2::Instrumentation::ObserverUpdaterPtr&);
 
     virtual Glacier2::Instrumentation::SessionObserverPtr getSessionObserver(
-        const std::string&, const Ice::ConnectionPtr&, int, const Glacier2::Instrumentation::SessionObserverPtr&);
+        const std::string&, const Ice::ConnectionPtr&, int, Ice::Long,
+        const Glacier2::Instrumentation::SessionObserverPtr&);
 
 private:
 
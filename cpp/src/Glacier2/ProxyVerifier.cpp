@@ -12,6 +12,9 @@
 
 #include <vector>
 #include <string>
+#include <map>
+#include <algorithm>
+#include <climits>
 
 using namespace std;
 using namespace Ice;
@@ -100,202 +103,234 @@ parseGroup(const string& parameter, vector<int>& validPorts, vector<Range>& rang
 }
 
 //
-// Base class for address matching operations.
+// A sorted table of disjoint numeric ranges compiled from the values and
+// ranges of a group, e.g. foo[1-3,10].bar.com or the port of a filter.
+// Looking up a number is a binary search in the table.
 //
-class AddressMatcher
+class NumberTable
 {
 public:
-    virtual ~AddressMatcher() {}
-    virtual bool match(const string&, string::size_type& pos) = 0;
-
-    virtual const char* toString() const = 0;
-
-protected:
-};
 
-class MatchesAny : public AddressMatcher
-{
-public:
-    MatchesAny()
+    NumberTable()
     {
     }
 
-    bool
-    match(const string&, string::size_type&)
-    {
-        return true;
-    }
-
-    const char*
-    toString() const
+    NumberTable(const vector<int>& values, const vector<Range>& ranges)
     {
-        return "(ANY)";
-    }
-};
+        vector<Range> all;
+        for(vector<int>::const_iterator i = values.begin(); i != values.end(); ++i)
+        {
+            Range r;
+            r.start = *i;
+            r.end = *i;
+            all.push_back(r);
+        }
+        for(vector<Range>::const_iterator i = ranges.begin(); i != ranges.end(); ++i)
+        {
+            if(i->start <= i->end)
+            {
+                all.push_back(*i);
+            }
+        }
+        sort(all.begin(), all.end(), rangeLess);
 
-//
-// Match the start of a string (i.e. position == 0). Occurs when filter
-// string starts with a set of characters followed by a wildcard or
-// numeric range.
-//
-class StartsWithString : public AddressMatcher
-{
-public:
-    StartsWithString(const string& criteria):
-        _criteria(criteria),
-        _description("starts with " + criteria)
-    {
+        //
+        // Merge the overlapping and adjacent ranges.
+        //
+        for(vector<Range>::const_iterator i = all.begin(); i != all.end(); ++i)
+        {
+            if(!_ranges.empty() && i->start <= _ranges.back().end + 1)
+            {
+                if(i->end > _ranges.back().end)
+                {
+                    _ranges.back().end = i->end;
+                }
+            }
+            else
+            {
+                _ranges.push_back(*i);
+            }
+        }
     }
 
     bool
-    match(const string& space, string::size_type& pos)
+    contains(long value) const
     {
-        assert(pos == 0);
-        bool result = strncmp(space.c_str(), _criteria.c_str(), _criteria.size()) == 0;
-        if(result)
+        size_t low = 0;
+        size_t high = _ranges.size();
+        while(low < high)
         {
-            pos += _criteria.size();
+            size_t mid = low + (high - low) / 2;
+            if(_ranges[mid].end < value)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
         }
-        return result;
+        return low < _ranges.size() && _ranges[low].start <= value;
     }
 
-    const char*
-    toString() const
+private:
+
+    static bool
+    rangeLess(const Range& lhs, const Range& rhs)
     {
-        return _description.c_str();
+        return lhs.start < rhs.start;
     }
 
-private:
-    string _criteria;
-    string _description;
+    vector<Range> _ranges;
 };
 
 //
-// Match the end portion of a string. Occurs when a filter string starts
-// with a wildcard or numeric range, but ends with a string.
+// Parses the number at the given position like the extraction of an int
+// from a stream: leading white space is skipped and the number can have
+// a sign. Returns false if there's no number at this position or if the
+// number doesn't fit in an int, pos is set past the digits in all cases.
 //
-class EndsWithString : public AddressMatcher
+static bool
+parseNumber(const string& space, string::size_type& pos, long& value)
 {
-public:
-    EndsWithString(const string& criteria):
-        _criteria(criteria),
-        _description("ends with " + criteria)
+    while(pos < space.size() && isspace(static_cast<unsigned char>(space[pos])))
     {
+        ++pos;
     }
 
-    bool
-    match(const string& space, string::size_type& pos)
+    bool negative = false;
+    if(pos < space.size() && (space[pos] == '-' || space[pos] == '+'))
+    {
+        negative = space[pos] == '-';
+        ++pos;
+    }
+
+    const Ice::Long max = negative ? -static_cast<Ice::Long>(INT_MIN) : static_cast<Ice::Long>(INT_MAX);
+    string::size_type start = pos;
+    bool overflow = false;
+    Ice::Long v = 0;
+    while(pos < space.size() && space[pos] >= '0' && space[pos] <= '9')
     {
-        if(space.size() - pos < _criteria.size())
+        int digit = space[pos] - '0';
+        if(v > (max - digit) / 10)
         {
-            return false;
+            overflow = true;
         }
-
-        string::size_type spaceEnd = space.size();
-        for(string::size_type i = _criteria.size(); i > 0; --i)
+        else
         {
-            if(space[spaceEnd - 1] != _criteria[i-1])
-            {
-                return false;
-            }
-            --spaceEnd;
+            v = v * 10 + digit;
         }
-        return true;
+        ++pos;
     }
+    value = static_cast<long>(negative ? -v : v);
+    return pos != start && !overflow;
+}
 
-    virtual const char*
-    toString() const
-    {
-        return _description.c_str();
-    }
-
-private:
-    string _criteria;
-    string _description;
-};
-
-class MatchesString : public AddressMatcher
+//
+// A step of an address filter. The filter string is compiled into a
+// sequence of these steps which are matched one after the other against
+// the host of the endpoint, pos being the position where the previous
+// step stopped matching.
+//
+class AddressMatcher
 {
 public:
-    MatchesString(const string& criteria):
-        _criteria(criteria),
-        _description("matches " + criteria)
-    {
-    }
 
-    bool
-    match(const string& space, string::size_type& pos)
+    enum Type
     {
-        if(strncmp(space.c_str(), _criteria.c_str(), _criteria.size()) == 0)
-        {
-            pos += _criteria.size();
-            return true;
-        }
-        return false;
-    }
+        //
+        // Matches any address, the filter is "*".
+        //
+        MatchesAny,
 
-    virtual const char*
-    toString() const
-    {
-        return _description.c_str();
-    }
+        //
+        // Match the start of a string (i.e. position == 0). Occurs when filter
+        // string starts with a set of characters followed by a wildcard or
+        // numeric range.
+        //
+        StartsWithString,
 
-private:
-    string _criteria;
-    string _description;
-};
+        //
+        // Match the end portion of a string. Occurs when a filter string starts
+        // with a wildcard or numeric range, but ends with a string.
+        //
+        EndsWithString,
 
-//
-// Match against somewhere within a string. Occurs when a filter
-// contains a string bounded by wildcards, or numeric ranges. e.g. *bar*.com.
-//
-class ContainsString : public AddressMatcher
-{
-public:
-    ContainsString(const string& criteria):
-        _criteria(criteria),
-        _description("contains " + criteria)
+        //
+        // Match a string directly following a numeric range. Like the start
+        // of the filter string, the string is compared with the start of the
+        // host.
+        //
+        MatchesString,
+
+        //
+        // Match against somewhere within a string. Occurs when a filter
+        // contains a string bounded by wildcards, or numeric ranges. e.g. *bar*.com.
+        // The character following the string is skipped.
+        //
+        ContainsString,
+
+        //
+        // Match a number against a range of values. This occurs when the filter
+        // contains a numeric range or group of numeric values. e.g. foo[1-3,
+        // 10].bar.com. Also used to match port numbers and ranges.
+        //
+        MatchesNumber,
+
+        //
+        // Occurs when a numeric range is preceded by a wildcard.
+        //
+        ContainsNumber
+    };
+
+    AddressMatcher() :
+        _type(MatchesAny),
+        _description("(ANY)")
     {
     }
 
-    bool
-    match(const string& space, string::size_type& pos)
+    AddressMatcher(Type type, const string& criteria) :
+        _type(type),
+        _criteria(criteria)
     {
-        string::size_type offset = space.find(_criteria, pos);
-        if(offset == string::npos)
+        switch(type)
         {
-            return false;
+            case StartsWithString:
+            {
+                _description = "starts with " + criteria;
+                break;
+            }
+            case EndsWithString:
+            {
+                _description = "ends with " + criteria;
+                break;
+            }
+            case MatchesString:
+            {
+                _description = "matches " + criteria;
+                break;
+            }
+            case ContainsString:
+            {
+                _description = "contains " + criteria;
+                break;
+            }
+            default:
+            {
+                assert(false);
+                break;
+            }
         }
-        pos = offset + _criteria.size() +1;
-        return true;
     }
 
-    virtual const char*
-    toString() const
+    AddressMatcher(Type type, const vector<int>& values, const vector<Range>& ranges) :
+        _type(type),
+        _numbers(values, ranges)
     {
-        return _description.c_str();
-    }
+        assert(type == MatchesNumber || type == ContainsNumber);
 
-private:
-    string _criteria;
-    string _description;
-};
-
-//
-// Match a number against a range of values. This occurs when the filter
-// contains a numeric range or group of numeric values. e.g. foo[1-3,
-// 10].bar.com. Also used to match port numbers and ranges.
-//
-class MatchesNumber : public AddressMatcher
-{
-public:
-    MatchesNumber(const vector<int>& values, const vector<Range>& ranges,
-                  const char* descriptionPrefix = "matches "):
-        _values(values),
-        _ranges(ranges)
-    {
         ostringstream ostr;
-        ostr << descriptionPrefix;
+        ostr << (type == MatchesNumber ? "matches " : "contains ");
         {
             bool start = true;
             for(vector<int>::const_iterator i = values.begin(); i != values.end(); ++i)
@@ -335,103 +370,99 @@ public:
                 ostr << i->start << " up to " << i->end;
             }
         }
-        ostr << ends;
         _description = ostr.str();
     }
 
     bool
-    match(const string & space, string::size_type& pos)
+    match(const string& space, string::size_type& pos) const
     {
-        istringstream istr(space.substr(pos));
-        int val;
-        if(!(istr >> val))
-        {
-            return false;
-        }
-        pos += static_cast<string::size_type>(istr.tellg());
+        switch(_type)
         {
-            for(vector<int>::const_iterator i = _values.begin(); i != _values.end(); ++i)
+            case MatchesAny:
+            {
+                return true;
+            }
+            case StartsWithString:
+            case MatchesString:
             {
-                if(val == *i)
+                assert(_type != StartsWithString || pos == 0);
+                if(space.compare(0, _criteria.size(), _criteria) != 0)
                 {
-                    return true;
+                    return false;
                 }
+                pos += _criteria.size();
+                return true;
             }
-        }
-        {
-            for(vector<Range>::const_iterator i = _ranges.begin(); i != _ranges.end(); ++i)
+            case EndsWithString:
             {
-                if((val >= i->start) && (val <= i->end))
+                if(space.size() < _criteria.size() || space.size() - pos < _criteria.size())
                 {
-                    return true;
+                    return false;
                 }
+                return space.compare(space.size() - _criteria.size(), _criteria.size(), _criteria) == 0;
             }
-        }
-        return false;
-    }
-
-    virtual const char*
-    toString() const
-    {
-        return _description.c_str();
-    }
-
-private:
-    const vector<int> _values;
-    const vector<Range> _ranges;
-    string _description;
-};
-
-//
-// Occurs when a numeric range is preceded by a wildcard.
-//
-class ContainsNumberMatch : public MatchesNumber
-{
-public:
-    ContainsNumberMatch(const vector<int>& values, const vector<Range>& ranges):
-        MatchesNumber(values, ranges, "contains ")
-    {
-    }
-
-    bool
-    match(const string& space, string::size_type& pos)
-    {
-        while(true)
-        {
-            pos = space.find_first_of("0123456789", pos);
-            if(pos == string::npos)
+            case ContainsString:
             {
-                return false;
+                string::size_type offset = space.find(_criteria, pos);
+                if(offset == string::npos)
+                {
+                    return false;
+                }
+                pos = offset + _criteria.size() + 1;
+                return true;
             }
-
-            if(MatchesNumber::match(space, pos))
+            case MatchesNumber:
             {
-                return true;
+                long value;
+                return parseNumber(space, pos, value) && _numbers.contains(value);
+            }
+            case ContainsNumber:
+            {
+                while(true)
+                {
+                    pos = space.find_first_of("0123456789", pos);
+                    if(pos == string::npos)
+                    {
+                        pos = space.size();
+                        return false;
+                    }
+
+                    long value;
+                    if(parseNumber(space, pos, value) && _numbers.contains(value))
+                    {
+                        return true;
+                    }
+                }
             }
         }
+        assert(false);
         return false;
     }
-};
 
-class EndsWithNumber : public MatchesNumber
-{
-public:
-    EndsWithNumber(const vector<int>& values, const vector<Range>& ranges):
-        MatchesNumber(values, ranges, "ends with ")
+    Type
+    type() const
     {
+        return _type;
     }
 
-    bool
-    match(const string& space, string::size_type& pos)
+    const string&
+    criteria() const
     {
-        pos = space.find_last_not_of("0123456789", pos);
-        if(pos == space.size()-1)
-        {
-            return false;
-        }
+        return _criteria;
+    }
 
-        return MatchesNumber::match(space, pos);
+    const char*
+    toString() const
+    {
+        return _description.c_str();
     }
+
+private:
+
+    Type _type;
+    string _criteria;
+    NumberTable _numbers;
+    string _description;
 };
 
 //
@@ -447,151 +478,214 @@ class AddressMatcherFactory
 public:
     virtual ~AddressMatcherFactory() {}
 
-    virtual AddressMatcher*
+    virtual AddressMatcher
     create(const string& criteria) = 0;
 
-    virtual AddressMatcher*
+    virtual AddressMatcher
     create(const vector<int>& ports, const vector<Range>& ranges) = 0;
 };
 
 class StartFactory : public AddressMatcherFactory
 {
 public:
-    AddressMatcher*
+    AddressMatcher
     create(const string& criteria)
     {
-        return new StartsWithString(criteria);
+        return AddressMatcher(AddressMatcher::StartsWithString, criteria);
     }
 
-    AddressMatcher*
+    AddressMatcher
     create(const vector<int>& ports, const vector<Range>& ranges)
     {
-        return new MatchesNumber(ports, ranges);
+        return AddressMatcher(AddressMatcher::MatchesNumber, ports, ranges);
     }
 };
 
 class WildCardFactory : public AddressMatcherFactory
 {
 public:
-    AddressMatcher*
+    AddressMatcher
     create(const string& criteria)
     {
-        return new ContainsString(criteria);
+        return AddressMatcher(AddressMatcher::ContainsString, criteria);
     }
 
-    AddressMatcher*
+    AddressMatcher
     create(const vector<int>& ports, const vector<Range>& ranges)
     {
-        return new ContainsNumberMatch(ports, ranges);
+        return AddressMatcher(AddressMatcher::ContainsNumber, ports, ranges);
     }
 };
 
 class FollowingFactory : public AddressMatcherFactory
 {
 public:
-    AddressMatcher*
+    AddressMatcher
     create(const string& criteria)
     {
-        return new MatchesString(criteria);
+        return AddressMatcher(AddressMatcher::MatchesString, criteria);
     }
 
-    AddressMatcher*
+    AddressMatcher
     create(const vector<int>& ports, const vector<Range>& ranges)
     {
-        return new MatchesNumber(ports, ranges);
+        return AddressMatcher(AddressMatcher::MatchesNumber, ports, ranges);
     }
 };
 
 class EndsWithFactory : public AddressMatcherFactory
 {
 public:
-    AddressMatcher*
+    AddressMatcher
     create(const string& criteria)
     {
-        return new EndsWithString(criteria);
+        return AddressMatcher(AddressMatcher::EndsWithString, criteria);
     }
 
-    AddressMatcher*
+    AddressMatcher
     create(const vector<int>& ports, const vector<Range>& ranges)
     {
-        return new EndsWithNumber(ports, ranges);
+        //
+        // The filter parsing never creates a number matcher once the end
+        // of the filter string is reached.
+        //
+        assert(false);
+        return AddressMatcher(AddressMatcher::MatchesNumber, ports, ranges);
     }
 };
 
+//
+// The host and port of an endpoint, extracted once from the stringified
+// endpoint before evaluating the filters.
+//
+struct EndpointAddress
+{
+    string host;
+    string port;
+};
+
+static bool
+extractPart(const char* opt, const string& source, string& result)
+{
+    string::size_type start = source.find(opt);
+    if(start == string::npos)
+    {
+        return false;
+    }
+    start += strlen(opt);
+    string::size_type end = source.find(' ', start);
+    if(end != string::npos)
+    {
+        result = source.substr(start, end - start);
+    }
+    else
+    {
+        result = source.substr(start);
+    }
+    return true;
+}
+
+//
+// Returns false if the proxy has no endpoints or if one of its endpoints
+// doesn't have a host and port, no address rule can match such a proxy.
+//
+static bool
+extractAddresses(const ObjectPrx& prx, vector<EndpointAddress>& addresses)
+{
+    EndpointSeq endpoints = prx->ice_getEndpoints();
+    if(endpoints.empty())
+    {
+        return false;
+    }
+
+    addresses.resize(endpoints.size());
+    for(EndpointSeq::size_type i = 0; i < endpoints.size(); ++i)
+    {
+        string info = endpoints[i]->toString();
+        if(!extractPart("-h ", info, addresses[i].host) || !extractPart("-p ", info, addresses[i].port))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 //
 // A proxy validation rule encapsulating an address filter.
 //
-class AddressRule : public Glacier2::ProxyRule
+class AddressRule
 {
 public:
-    AddressRule(const CommunicatorPtr& communicator, const vector<AddressMatcher*>& address, MatchesNumber* port,
-                const int traceLevel) :
+    AddressRule(const CommunicatorPtr& communicator, const vector<AddressMatcher>& address, bool checkPort,
+                const AddressMatcher& port, const int traceLevel) :
         _communicator(communicator),
         _addressRules(address),
+        _checkPort(checkPort),
         _portMatcher(port),
         _traceLevel(traceLevel)
     {
     }
 
-    ~AddressRule()
+    //
+    // The string the host must start with to match this rule, empty if
+    // the rule doesn't start with a string.
+    //
+    string
+    prefix() const
     {
-        for(vector<AddressMatcher*>::const_iterator i = _addressRules.begin(); i != _addressRules.end(); ++i)
+        if(!_addressRules.empty() && _addressRules.front().type() == AddressMatcher::StartsWithString)
         {
-            delete *i;
+            return _addressRules.front().criteria();
         }
-        delete _portMatcher;
+        return string();
     }
 
-    virtual bool
-    check(const ObjectPrx& prx) const
+    //
+    // The string the host must end with to match this rule, empty if the
+    // rule doesn't end with a string.
+    //
+    string
+    suffix() const
     {
-        EndpointSeq endpoints = prx->ice_getEndpoints();
-        if(endpoints.size() == 0)
+        if(!_addressRules.empty() && _addressRules.back().type() == AddressMatcher::EndsWithString)
         {
-            return false;
+            return _addressRules.back().criteria();
         }
+        return string();
+    }
 
-        for(EndpointSeq::const_iterator i = endpoints.begin(); i != endpoints.end(); ++i)
+    bool
+    check(const vector<EndpointAddress>& addresses) const
+    {
+        for(vector<EndpointAddress>::const_iterator p = addresses.begin(); p != addresses.end(); ++p)
         {
-            string info = (*i)->toString();
-            string host;
-            if(!extractPart("-h ", info, host))
-            {
-                return false;
-            }
-            string port;
-            if(!extractPart("-p ", info, port))
-            {
-                return false;
-            }
-
             string::size_type pos = 0;
-            if(_portMatcher && !_portMatcher->match(port, pos))
+            if(_checkPort && !_portMatcher.match(p->port, pos))
             {
                 if(_traceLevel >= 3)
                 {
                     Trace out(_communicator->getLogger(), "Glacier2");
-                    out << _portMatcher->toString() << " failed to match " << port << " at pos=" << pos << "\n";
+                    out << _portMatcher.toString() << " failed to match " << p->port << " at pos=" << pos << "\n";
                 }
                 return false;
             }
 
             pos = 0;
-            for(vector<AddressMatcher*>::const_iterator i = _addressRules.begin(); i != _addressRules.end(); ++i)
+            for(vector<AddressMatcher>::const_iterator i = _addressRules.begin(); i != _addressRules.end(); ++i)
             {
-                if(!(*i)->match(host, pos))
+                if(!i->match(p->host, pos))
                 {
                     if(_traceLevel >= 3)
                     {
                         Trace out(_communicator->getLogger(), "Glacier2");
-                        out << (*i)->toString() << " failed to match " << host << " at pos=" << pos << "\n";
+                        out << i->toString() << " failed to match " << p->host << " at pos=" << pos << "\n";
                     }
                     return false;
                 }
                 if(_traceLevel >= 3)
                 {
                     Trace out(_communicator->getLogger(), "Glacier2");
-                    out << (*i)->toString() << " matched " << host << " at pos=" << pos << "\n";
+                    out << i->toString() << " matched " << p->host << " at pos=" << pos << "\n";
                 }
             }
         }
@@ -602,207 +696,297 @@ public:
     dump() const
     {
         consoleErr << "address(";
-        for(vector<AddressMatcher*>::const_iterator i = _addressRules.begin(); i != _addressRules.end(); ++i)
+        for(vector<AddressMatcher>::const_iterator i = _addressRules.begin(); i != _addressRules.end(); ++i)
         {
-            consoleErr << (*i)->toString() << " ";
+            consoleErr << i->toString() << " ";
         }
-        if(_portMatcher != 0)
+        if(_checkPort)
         {
-            consoleErr << "):port(" << _portMatcher->toString() << " ";
+            consoleErr << "):port(" << _portMatcher.toString() << " ";
         }
         consoleErr << ")" << endl;
     }
 
 private:
 
-    bool
-    extractPart(const char* opt, const string& source, string& result) const
-    {
-        string::size_type start = source.find(opt);
-        if(start == string::npos)
-        {
-            return false;
-        }
-        start += strlen(opt);
-        string::size_type end = source.find(' ', start);
-        if(end != string::npos)
-        {
-            result = source.substr(start, end - start);
-        }
-        else
-        {
-            result = source.substr(start);
-        }
-        return true;
-    }
-
     CommunicatorPtr _communicator;
-    vector<AddressMatcher*> _addressRules;
-    MatchesNumber* _portMatcher;
-    const int _traceLevel;
+    vector<AddressMatcher> _addressRules;
+    bool _checkPort;
+    AddressMatcher _portMatcher;
+    int _traceLevel;
 };
 
 static void
-parseProperty(const Ice::CommunicatorPtr& communicator, const string& property, vector<ProxyRule*>& rules,
+parseProperty(const Ice::CommunicatorPtr& communicator, const string& property, vector<AddressRule>& rules,
               const int traceLevel)
 {
     StartFactory startsWithFactory;
     WildCardFactory wildCardFactory;
     EndsWithFactory endsWithFactory;
     FollowingFactory followingFactory;
-    vector<ProxyRule*> allRules;
-    try
+
+    istringstream propertyInput(property);
+
+    while(!propertyInput.eof() && propertyInput.good())
     {
-        istringstream propertyInput(property);
+        bool checkPort = false;
+        AddressMatcher portMatch;
+        vector<AddressMatcher> currentRuleSet;
 
-        while(!propertyInput.eof() && propertyInput.good())
+        string parameter;
+        ws(propertyInput);
+        propertyInput >> parameter;
+
+        string portInfo;
+        string::size_type portPortion = parameter.find(':');
+
+        string addr;
+        if(portPortion != string::npos)
         {
-            MatchesNumber* portMatch = 0;
-            vector<AddressMatcher*> currentRuleSet;
+            addr = parameter.substr(0, portPortion);
+            string port = parameter.substr(portPortion + 1);
+            string::size_type openBracket = port.find('[');
+            if(openBracket != string::npos)
+            {
+                ++openBracket;
+                string::size_type closeBracket = port.find(']', openBracket);
+                if(closeBracket == string::npos)
+                {
+                    throw invalid_argument("unclosed group");
+                }
+                port = port.substr(openBracket, closeBracket-openBracket);
+            }
+            vector<int> ports;
+            vector<Range> ranges;
+            parseGroup(port, ports, ranges);
+            checkPort = true;
+            portMatch = AddressMatcher(AddressMatcher::MatchesNumber, ports, ranges);
+        }
+        else
+        {
+            addr = parameter;
+        }
 
-            string parameter;
-            ws(propertyInput);
-            propertyInput >> parameter;
+        //
+        // The addr portion can contain alphanumerics, * and
+        // ranges.
+        //
+        string::size_type current = 0;
 
-            string portInfo;
-            string::size_type portPortion = parameter.find(':');
+        if(current == addr.size())
+        {
+            throw invalid_argument("expected address information before ':'");
+        }
+
+        //
+        // TODO: assuming that there is no leading or trailing whitespace. This
+        // should probably be confirmed.
+        //
+        assert(!isspace(static_cast<unsigned char>(parameter[current])));
+        assert(!isspace(static_cast<unsigned char>(addr[addr.size() -1])));
 
-            string addr;
-            if(portPortion != string::npos)
+        if(current != 0)
+        {
+            addr = addr.substr(current);
+        }
+
+        string::size_type mark = 0;
+        bool inGroup = false;
+        AddressMatcherFactory* currentFactory = &startsWithFactory;
+
+        if(addr == "*")
+        {
+            //
+            // Special case. Match everything.
+            //
+            currentRuleSet.push_back(AddressMatcher());
+        }
+        else
+        {
+            for(current = 0; current < addr.size(); ++current)
             {
-                addr = parameter.substr(0, portPortion);
-                string port = parameter.substr(portPortion + 1);
-                string::size_type openBracket = port.find('[');
-                if(openBracket != string::npos)
+                if(addr[current] == '*')
                 {
-                    ++openBracket;
-                    string::size_type closeBracket = port.find(']', openBracket);
-                    if(closeBracket == string::npos)
+                    if(inGroup)
                     {
-                        throw invalid_argument("unclosed group");
+                        throw invalid_argument("wildcards not permitted in groups");
                     }
-                    port = port.substr(openBracket, closeBracket-openBracket);
+                    //
+                    // current == mark when the wildcard is at the head of a
+                    // string or directly after a group.
+                    //
+                    if(current != mark)
+                    {
+                        currentRuleSet.push_back(currentFactory->create(addr.substr(mark, current-mark)));
+                    }
+                    currentFactory = &wildCardFactory;
+                    mark = current + 1;
+                }
+                else if(addr[current] == '[')
+                {
+                    // ??? what does it mean if current == mark?
+                    if(current != mark)
+                    {
+                        currentRuleSet.push_back(currentFactory->create(addr.substr(mark, current-mark)));
+                        currentFactory = &followingFactory;
+                    }
+                    inGroup = true;
+                    mark = current + 1;
+                }
+                else if(addr[current] == ']')
+                {
+                    if(!inGroup)
+                    {
+                        throw invalid_argument("group close without group start");
+                    }
+                    inGroup = false;
+                    if(mark == current)
+                    {
+                        throw invalid_argument("empty group");
+                    }
+                    string group = addr.substr(mark, current - mark);
+                    vector<int> numbers;
+                    vector<Range> ranges;
+                    parseGroup(group, numbers, ranges);
+                    currentRuleSet.push_back(currentFactory->create(numbers, ranges));
+                    currentFactory = &followingFactory;
+                    mark = current + 1;
                 }
-                vector<int> ports;
-                vector<Range> ranges;
-                parseGroup(port, ports, ranges);
-                portMatch = new MatchesNumber(ports, ranges);
             }
-            else
+            currentFactory = &endsWithFactory;
+
+            if(inGroup)
+            {
+                throw invalid_argument("unclosed group");
+            }
+            if(mark != current)
             {
-                addr = parameter;
+                currentRuleSet.push_back(currentFactory->create(addr.substr(mark, current - mark)));
             }
+        }
+        rules.push_back(AddressRule(communicator, currentRuleSet, checkPort, portMatch, traceLevel));
+    }
+}
 
-            //
-            // The addr portion can contain alphanumerics, * and
-            // ranges.
-            //
-            string::size_type current = 0;
+//
+// The address rules of a Glacier2.Filter.Address.Accept or Reject
+// property, compiled for matching many proxies against many rules.
+//
+// A proxy matches if all its endpoints match one of the rules. Most
+// rules start or end with a string (e.g. foo*, *.zeroc.com or a plain
+// host name), these rules are indexed in a trie of their prefixes or of
+// their reversed suffixes. Matching a proxy only evaluates the rules
+// found by walking the tries with the host of the first endpoint, and
+// the few rules which aren't anchored to a string.
+//
+class AddressFilter
+{
+public:
+
+    AddressFilter(const CommunicatorPtr& communicator, const string& property, int traceLevel)
+    {
+        parseProperty(communicator, property, _rules, traceLevel);
 
-            if(current == addr.size())
+        _prefixes.push_back(TrieNode());
+        _suffixes.push_back(TrieNode());
+        for(vector<AddressRule>::size_type i = 0; i < _rules.size(); ++i)
+        {
+            string prefix = _rules[i].prefix();
+            if(!prefix.empty())
             {
-                throw invalid_argument("expected address information before ':'");
+                add(_prefixes, prefix.begin(), prefix.end(), i);
+                continue;
             }
 
-            //
-            // TODO: assuming that there is no leading or trailing whitespace. This
-            // should probably be confirmed.
-            //
-            assert(!isspace(static_cast<unsigned char>(parameter[current])));
-            assert(!isspace(static_cast<unsigned char>(addr[addr.size() -1])));
-
-            if(current != 0)
+            string suffix = _rules[i].suffix();
+            if(!suffix.empty())
             {
-                addr = addr.substr(current);
+                add(_suffixes, suffix.rbegin(), suffix.rend(), i);
+                continue;
             }
 
-            string::size_type mark = 0;
-            bool inGroup = false;
-            AddressMatcherFactory* currentFactory = &startsWithFactory;
+            _unanchored.push_back(i);
+        }
+    }
 
-            if(addr == "*")
+    bool
+    match(const vector<EndpointAddress>& addresses) const
+    {
+        assert(!addresses.empty());
+        const string& host = addresses.front().host;
+        return match(_prefixes, host.begin(), host.end(), addresses) ||
+            match(_suffixes, host.rbegin(), host.rend(), addresses) ||
+            match(_unanchored, addresses);
+    }
+
+private:
+
+    struct TrieNode
+    {
+        map<char, size_t> children;
+        vector<size_t> rules; // The rules whose prefix or suffix ends at this node.
+    };
+
+    template<typename Iterator> static void
+    add(vector<TrieNode>& trie, Iterator p, Iterator end, size_t rule)
+    {
+        size_t node = 0;
+        for(; p != end; ++p)
+        {
+            map<char, size_t>::const_iterator q = trie[node].children.find(*p);
+            if(q != trie[node].children.end())
             {
-                //
-                // Special case. Match everything.
-                //
-                currentRuleSet.push_back(new MatchesAny);
+                node = q->second;
             }
             else
             {
-                for(current = 0; current < addr.size(); ++current)
-                {
-                    if(addr[current] == '*')
-                    {
-                        if(inGroup)
-                        {
-                            throw invalid_argument("wildcards not permitted in groups");
-                        }
-                        //
-                        // current == mark when the wildcard is at the head of a
-                        // string or directly after a group.
-                        //
-                        if(current != mark)
-                        {
-                            currentRuleSet.push_back(currentFactory->create(addr.substr(mark, current-mark)));
-                        }
-                        currentFactory = &wildCardFactory;
-                        mark = current + 1;
-                    }
-                    else if(addr[current] == '[')
-                    {
-                        // ??? what does it mean if current == mark?
-                        if(current != mark)
-                        {
-                            currentRuleSet.push_back(currentFactory->create(addr.substr(mark, current-mark)));
-                            currentFactory = &followingFactory;
-                        }
-                        inGroup = true;
-                        mark = current + 1;
-                    }
-                    else if(addr[current] == ']')
-                    {
-                        if(!inGroup)
-                        {
-                            throw invalid_argument("group close without group start");
-                        }
-                        inGroup = false;
-                        if(mark == current)
-                        {
-                            throw invalid_argument("empty group");
-                        }
-                        string group = addr.substr(mark, current - mark);
-                        vector<int> numbers;
-                        vector<Range> ranges;
-                        parseGroup(group, numbers, ranges);
-                        currentRuleSet.push_back(currentFactory->create(numbers, ranges));
-                        currentFactory = &followingFactory;
-                        mark = current + 1;
-                    }
-                }
-                currentFactory = &endsWithFactory;
+                size_t child = trie.size();
+                trie[node].children.insert(make_pair(*p, child));
+                trie.push_back(TrieNode());
+                node = child;
+            }
+        }
+        trie[node].rules.push_back(rule);
+    }
 
-                if(inGroup)
-                {
-                    throw invalid_argument("unclosed group");
-                }
-                if(mark != current)
-                {
-                    currentRuleSet.push_back(currentFactory->create(addr.substr(mark, current - mark)));
-                }
+    template<typename Iterator> bool
+    match(const vector<TrieNode>& trie, Iterator p, Iterator end, const vector<EndpointAddress>& addresses) const
+    {
+        size_t node = 0;
+        for(; p != end; ++p)
+        {
+            map<char, size_t>::const_iterator q = trie[node].children.find(*p);
+            if(q == trie[node].children.end())
+            {
+                return false;
+            }
+            node = q->second;
+            if(match(trie[node].rules, addresses))
+            {
+                return true;
             }
-            allRules.push_back(new AddressRule(communicator, currentRuleSet, portMatch, traceLevel));
         }
+        return false;
     }
-    catch(...)
+
+    bool
+    match(const vector<size_t>& rules, const vector<EndpointAddress>& addresses) const
     {
-        for(vector<ProxyRule*>::const_iterator i = allRules.begin(); i != allRules.end(); ++i)
+        for(vector<size_t>::const_iterator p = rules.begin(); p != rules.end(); ++p)
         {
-            delete *i;
+            if(_rules[*p].check(addresses))
+            {
+                return true;
+            }
         }
-        throw;
+        return false;
     }
-    rules = allRules;
-}
+
+    vector<AddressRule> _rules;
+    vector<TrieNode> _prefixes;
+    vector<TrieNode> _suffixes;
+    vector<size_t> _unanchored;
+};
 
 //
 // Helper function for checking a rule set.
@@ -866,7 +1050,9 @@ private:
 
 Glacier2::ProxyVerifier::ProxyVerifier(const CommunicatorPtr& communicator):
     _communicator(communicator),
-    _traceLevel(communicator->getProperties()->getPropertyAsInt("Glacier2.Client.Trace.Reject"))
+    _traceLevel(communicator->getProperties()->getPropertyAsInt("Glacier2.Client.Trace.Reject")),
+    _acceptFilter(0),
+    _rejectFilter(0)
 {
     //
     // Evaluation order is dependant on how the rules are stored to the
@@ -877,7 +1063,7 @@ Glacier2::ProxyVerifier::ProxyVerifier(const CommunicatorPtr& communicator):
     {
         try
         {
-            Glacier2::parseProperty(communicator, s, _acceptRules, _traceLevel);
+            _acceptFilter = new AddressFilter(communicator, s, _traceLevel);
         }
         catch(const exception& ex)
         {
@@ -892,10 +1078,11 @@ Glacier2::ProxyVerifier::ProxyVerifier(const CommunicatorPtr& communicator):
     {
         try
         {
-            Glacier2::parseProperty(communicator, s, _rejectRules, _traceLevel);
+            _rejectFilter = new AddressFilter(communicator, s, _traceLevel);
         }
         catch(const exception& ex)
         {
+            delete _acceptFilter;
             ostringstream os;
             os << "invalid `Glacier2.Filter.Address.Reject' property:\n" << ex.what();
             throw InitializationException(__FILE__, __LINE__, os.str());
@@ -912,6 +1099,8 @@ Glacier2::ProxyVerifier::ProxyVerifier(const CommunicatorPtr& communicator):
         }
         catch(const exception& ex)
         {
+            delete _acceptFilter;
+            delete _rejectFilter;
             ostringstream os;
             os << "invalid `Glacier2.Filter.ProxySizeMax' property:\n" << ex.what();
             throw InitializationException(__FILE__, __LINE__, os.str());
@@ -921,10 +1110,8 @@ Glacier2::ProxyVerifier::ProxyVerifier(const CommunicatorPtr& communicator):
 
 Glacier2::ProxyVerifier::~ProxyVerifier()
 {
-    for(vector<ProxyRule*>::const_iterator i = _acceptRules.begin(); i != _acceptRules.end(); ++i)
-    {
-        delete (*i);
-    }
+    delete _acceptFilter;
+    delete _rejectFilter;
     for(vector<ProxyRule*>::const_iterator j = _rejectRules.begin(); j != _rejectRules.end(); ++j)
     {
         delete (*j);
@@ -937,33 +1124,29 @@ Glacier2::ProxyVerifier::verify(const ObjectPrx& proxy)
     //
     // No rules have been defined so we accept all.
     //
-    if(_acceptRules.size() == 0 && _rejectRules.size() == 0)
+    if(!_acceptFilter && !_rejectFilter && _rejectRules.empty())
     {
         return true;
     }
 
-    bool result = false;
+    //
+    // The endpoint addresses are extracted once for all the address rules.
+    //
+    vector<EndpointAddress> addresses;
+    bool hasAddresses = (_acceptFilter || _rejectFilter) && extractAddresses(proxy, addresses);
 
-    if(_rejectRules.size() == 0)
-    {
-        //
-        // If there are no reject rules, we assume "reject all".
-        //
-        result = match(_acceptRules, proxy);
-    }
-    else if(_acceptRules.size() == 0)
+    //
+    // If no accept rules are defined we assume accept all. If there are no
+    // reject rules, we assume "reject all" for the proxies not accepted.
+    //
+    bool result = !_acceptFilter || (hasAddresses && _acceptFilter->match(addresses));
+    if(result && _rejectFilter && hasAddresses && _rejectFilter->match(addresses))
     {
-        //
-        // If no accept rules are defined we assume accept all.
-        //
-        result = !match(_rejectRules, proxy);
+        result = false;
     }
-    else
+    if(result && match(_rejectRules, proxy))
     {
-        if(match(_acceptRules, proxy))
-        {
-            result = !match(_rejectRules, proxy);
-        }
+        result = false;
     }
 
     //
@@ -32,6 +32,8 @@ public:
     virtual bool check(const Ice::ObjectPrx&) const = 0;
 };
 
+class AddressFilter;
+
 class ProxyVerifier : public IceUtil::Shared
 {
 public:
@@ -50,7 +52,12 @@ private:
     const Ice::CommunicatorPtr _communicator;
     const int _traceLevel;
 
-    std::vector<ProxyRule*> _acceptRules;
+    //
+    // The compiled Glacier2.Filter.Address.Accept and Reject rules, null
+    // if the property isn't set.
+    //
+    AddressFilter* _acceptFilter;
+    AddressFilter* _rejectFilter;
     std::vector<ProxyRule*> _rejectRules;
 };
 typedef IceUtil::Handle<ProxyVerifier> ProxyVerifierPtr;
@@ -20,11 +20,25 @@ Glacier2::Request::Request(const ObjectPrx& proxy, const std::pair<const Byte*,
                            const AMD_Object_ice_invokePtr& amdCB) :
     _proxy(proxy),
     _inParams(inParams.first, inParams.second),
-    _current(current),
-    _forwardContext(forwardContext),
-    _sslContext(sslContext),
+    _operation(current.operation),
+    _mode(current.mode),
+    _hasContext(forwardContext || !sslContext.empty()),
     _amdCB(amdCB)
 {
+    //
+    // Compute the context to forward the request with once, rather
+    // than each time the request is sent.
+    //
+    if(forwardContext)
+    {
+        const_cast<Context&>(_context) = current.ctx;
+        const_cast<Context&>(_context).insert(sslContext.begin(), sslContext.end());
+    }
+    else if(!sslContext.empty())
+    {
+        const_cast<Context&>(_context) = sslContext;
+    }
+
     Context::const_iterator p = current.ctx.find("_ovrd");
     if(p != current.ctx.end())
     {
@@ -63,61 +77,26 @@ Glacier2::Request::invoke(const Callback_Object_ice_invokePtr& cb)
     if(_proxy->ice_isBatchOneway() || _proxy->ice_isBatchDatagram())
     {
         ByteSeq outParams;
-        if(_forwardContext)
+        if(_hasContext)
         {
-            if(_sslContext.size() > 0)
-            {
-                Ice::Context ctx = _current.ctx;
-                ctx.insert(_sslContext.begin(), _sslContext.end());
-                _proxy->ice_invoke(_current.operation, _current.mode, inPair, outParams, ctx);
-            }
-            else
-            {
-                _proxy->ice_invoke(_current.operation, _current.mode, inPair, outParams, _current.ctx);
-            }
+            _proxy->ice_invoke(_operation, _mode, inPair, outParams, _context);
         }
         else
         {
-            if(_sslContext.size() > 0)
-            {
-                _proxy->ice_invoke(_current.operation, _current.mode, inPair, outParams, _sslContext);
-            }
-            else
-            {
-                _proxy->ice_invoke(_current.operation, _current.mode, inPair, outParams);
-            }
+            _proxy->ice_invoke(_operation, _mode, inPair, outParams);
         }
         return 0;
     }
     else
     {
-        Ice::AsyncResultPtr result;
-        if(_forwardContext)
+        if(_hasContext)
         {
-            if(_sslContext.size() > 0)
-            {
-                Ice::Context ctx = _current.ctx;
-                ctx.insert(_sslContext.begin(), _sslContext.end());
-                result = _proxy->begin_ice_invoke(_current.operation, _current.mode, inPair, ctx, cb, this);
-            }
-            else
-            {
-                result = _proxy->begin_ice_invoke(_current.operation, _current.mode, inPair, _current.ctx, cb, this);
-            }
+            return _proxy->begin_ice_invoke(_operation, _mode, inPair, _context, cb, this);
         }
         else
         {
-            if(_sslContext.size() > 0)
-            {
-                result = _proxy->begin_ice_invoke(_current.operation, _current.mode, inPair, _sslContext, cb, this);
-            }
-            else
-            {
-                result = _proxy->begin_ice_invoke(_current.operation, _current.mode, inPair, cb, this);
-            }
+            return _proxy->begin_ice_invoke(_operation, _mode, inPair, cb, this);
         }
-
-        return result;
     }
 }
 
@@ -50,10 +50,11 @@ private:
     void queued();
 
     const Ice::ObjectPrx _proxy;
-    const Ice::ByteSeq _inParams;
-    const Ice::Current _current;
-    const bool _forwardContext;
-    const Ice::Context _sslContext;
+    const Ice::ByteSeq _inParams; // Copied as the dispatch buffer is released once the dispatch returns.
+    const std::string _operation;
+    const Ice::OperationMode _mode;
+    const bool _hasContext;
+    const Ice::Context _context; // The context to forward the request with, only set if _hasContext is true.
     const std::string _override;
     const Ice::AMD_Object_ice_invokePtr _amdCB;
 };
@@ -22,10 +22,11 @@ Glacier2::RouterI::RouterI(const InstancePtr& instance, const ConnectionPtr& con
                            const SessionPrx& session, const Identity& controlId, const FilterManagerPtr& filters,
                            const Ice::Context& context) :
     _instance(instance),
-    _routingTable(new RoutingTable(_instance->communicator(), _instance->proxyVerifier())),
+    _routingTable(new RoutingTable(_instance->communicator(), _instance->proxyVerifier(),
+                                   _instance->routingTableMemory(), userId)),
     _clientBlobject(new ClientBlobject(_instance, filters, context, _routingTable)),
-    _clientBlobjectBuffered(_instance->clientRequestQueueThread()),
-    _serverBlobjectBuffered(_instance->serverRequestQueueThread()),
+    _clientBlobjectBuffered(_instance->clientBuffered()),
+    _serverBlobjectBuffered(_instance->serverBuffered()),
     _connection(connection),
     _userId(userId),
     _session(session),
@@ -75,14 +76,16 @@ Glacier2::RouterI::~RouterI()
 void
 Glacier2::RouterI::updateObserver(const Glacier2::Instrumentation::RouterObserverPtr& observer)
 {
-    // Can only be called with the SessionRouterI mutex locked
-
-    _observer = _routingTable->updateObserver(observer, _userId, _connection);
-    _clientBlobject->updateObserver(_observer);
+    Glacier2::Instrumentation::SessionObserverPtr sessionObserver =
+        _routingTable->updateObserver(observer, _userId, _connection);
+    _clientBlobject->updateObserver(sessionObserver);
     if(_serverBlobject)
     {
-        _serverBlobject->updateObserver(_observer);
+        _serverBlobject->updateObserver(sessionObserver);
     }
+
+    IceUtil::Mutex::Lock sync(_mutex);
+    _observer = sessionObserver;
 }
 
 void
@@ -200,10 +203,13 @@ Glacier2::RouterI::getACMTimeout(const Current&) const
 ClientBlobjectPtr
 Glacier2::RouterI::getClientBlobject() const
 {
-    // Can only be called with the SessionRouterI mutex locked
-    if(!_clientBlobjectBuffered && _observer)
+    if(!_clientBlobjectBuffered)
     {
-        _observer->forwarded(true);
+        IceUtil::Mutex::Lock sync(_mutex);
+        if(_observer)
+        {
+            _observer->forwarded(true);
+        }
     }
     return _clientBlobject;
 }
@@ -211,10 +217,13 @@ Glacier2::RouterI::getClientBlobject() const
 ServerBlobjectPtr
 Glacier2::RouterI::getServerBlobject() const
 {
-    // Can only be called with the SessionRouterI mutex locked
-    if(!_serverBlobjectBuffered && _observer)
+    if(!_serverBlobjectBuffered)
     {
-        _observer->forwarded(false);
+        IceUtil::Mutex::Lock sync(_mutex);
+        if(_observer)
+        {
+            _observer->forwarded(false);
+        }
     }
     return _serverBlobject;
 }
@@ -228,15 +237,16 @@ Glacier2::RouterI::getSession() const
 IceUtil::Time
 Glacier2::RouterI::getTimestamp() const
 {
-    // Can only be called with the SessionRouterI mutex locked
+    IceUtil::Mutex::Lock sync(_mutex);
     return _timestamp;
 }
 
 void
 Glacier2::RouterI::updateTimestamp() const
 {
-    // Can only be called with the SessionRouterI mutex locked
-    _timestamp = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    IceUtil::Time now = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    IceUtil::Mutex::Lock sync(_mutex);
+    _timestamp = now;
 }
 
 string
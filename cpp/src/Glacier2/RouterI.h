@@ -78,7 +78,7 @@ private:
     const SessionPrx _session;
     const Ice::Identity _controlId;
     const Ice::Context _context;
-    const IceUtil::Mutex _timestampMutex;
+    IceUtil::Mutex _mutex; // Protects _timestamp and _observer.
     mutable IceUtil::Time _timestamp;
 
     Glacier2::Instrumentation::SessionObserverPtr _observer;
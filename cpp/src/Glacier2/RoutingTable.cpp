@@ -14,11 +14,28 @@ using namespace std;
 using namespace Ice;
 using namespace Glacier2;
 
-Glacier2::RoutingTable::RoutingTable(const CommunicatorPtr& communicator, const ProxyVerifierPtr& verifier) :
+namespace
+{
+
+//
+// The approximate memory used by an endpoint of a proxy.
+//
+const size_t endpointMemory = 128;
+
+}
+
+Glacier2::RoutingTable::RoutingTable(const CommunicatorPtr& communicator, const ProxyVerifierPtr& verifier,
+                                     const RoutingTableMemoryPtr& totalMemory, const string& userId) :
     _communicator(communicator),
+    _userId(userId),
     _traceLevel(_communicator->getProperties()->getPropertyAsInt("Glacier2.Trace.RoutingTable")),
     _maxSize(_communicator->getProperties()->getPropertyAsIntWithDefault("Glacier2.RoutingTable.MaxSize", 1000)),
-    _verifier(verifier)
+    _maxMemory(static_cast<Ice::Long>(
+                   _communicator->getProperties()->getPropertyAsInt("Glacier2.RoutingTable.MaxMemory")) * 1024),
+    _verifier(verifier),
+    _totalMemory(totalMemory),
+    _memory(0),
+    _destroyed(false)
 {
 }
 
@@ -26,11 +43,21 @@ void
 Glacier2::RoutingTable::destroy()
 {
     IceUtil::Mutex::Lock sync(*this);
+    _destroyed = true;
     if(_observer)
     {
         _observer->routingTableSize(-static_cast<Ice::Int>(_map.size()));
+        _observer->routingTableMemory(-_memory);
     }
     _observer.detach();
+
+    //
+    // Release the memory of the proxies for the other sessions.
+    //
+    _totalMemory->remove(this, 0, _memory);
+    _memory = 0;
+    _queue.clear();
+    _map.clear();
 }
 
 Glacier2::Instrumentation::SessionObserverPtr
@@ -39,16 +66,77 @@ Glacier2::RoutingTable::updateObserver(const Glacier2::Instrumentation::RouterOb
                                        const Ice::ConnectionPtr& connection)
 {
     IceUtil::Mutex::Lock sync(*this);
-    _observer.attach(obsv->getSessionObserver(userId, connection, static_cast<Ice::Int>(_map.size()), _observer.get()));
+    _observer.attach(obsv->getSessionObserver(userId, connection, static_cast<Ice::Int>(_map.size()), _memory,
+                                              _observer.get()));
     return _observer.get();
 }
 
 ObjectProxySeq
 Glacier2::RoutingTable::add(const ObjectProxySeq& unfiltered, const Current& current)
+{
+    ObjectProxySeq evictedProxies = addProxies(unfiltered, current);
+
+    //
+    // If the memory used by the routing tables of all the sessions exceeds
+    // Glacier2.RoutingTable.TotalMaxMemory, we make room by evicting the
+    // least recently used proxies of the largest routing table. This isn't
+    // necessarily this routing table so this must be done without holding
+    // our lock. Only the proxies evicted from this routing table are
+    // returned, the other sessions add their proxies again on demand.
+    //
+    ObjectProxySeq ignored;
+    RoutingTablePtr largest;
+    while((largest = _totalMemory->largest()) &&
+          largest->shed(largest.get() == this ? evictedProxies : ignored, _userId))
+    {
+    }
+    return evictedProxies;
+}
+
+bool
+Glacier2::RoutingTable::shed(ObjectProxySeq& evictedProxies, const string& userId)
 {
     IceUtil::Mutex::Lock sync(*this);
+    if(_queue.empty())
+    {
+        return false;
+    }
+
+    if(_traceLevel >= 1)
+    {
+        Trace out(_communicator->getLogger(), "Glacier2");
+        out << "Glacier2.RoutingTable.TotalMaxMemory exceeded, evicting the least recently used proxy of session `"
+            << _userId << "' for session `" << userId << "'";
+    }
+
+    Ice::Long memory = _memory;
+    evict(evictedProxies);
+    if(_observer)
+    {
+        _observer->routingTableSize(-1);
+        _observer->routingTableMemory(_memory - memory);
+        _observer->routingTableEvicted(1);
+        _observer->routingTableTotalMemoryEvicted(1);
+    }
+    return true;
+}
+
+ObjectProxySeq
+Glacier2::RoutingTable::addProxies(const ObjectProxySeq& unfiltered, const Current& current)
+{
+    IceUtil::Mutex::Lock sync(*this);
+
+    //
+    // The session is destroyed, adding the proxies would register this
+    // routing table again with the total memory of the routing tables.
+    //
+    if(_destroyed)
+    {
+        throw ObjectNotExistException(__FILE__, __LINE__);
+    }
 
     size_t sz = _map.size();
+    Ice::Long memory = _memory;
 
     //
     // We 'pre-scan' the list, applying our validation rules. The
@@ -86,11 +174,16 @@ Glacier2::RoutingTable::add(const ObjectProxySeq& unfiltered, const Current& cur
                 out << "adding proxy to routing table:\n" << _communicator->proxyToString(proxy);
             }
 
+            Ice::Long entrySize = entryMemory(proxy);
+            _totalMemory->add(this, 0, entrySize);
+
             EvictorEntryPtr entry = new EvictorEntry;
             p = _map.insert(_map.begin(), pair<const Identity, EvictorEntryPtr>(proxy->ice_getIdentity(), entry));
             EvictorQueue::iterator q = _queue.insert(_queue.end(), p);
             entry->proxy = proxy;
+            entry->memory = entrySize;
             entry->pos = q;
+            _memory += entrySize;
         }
         else
         {
@@ -100,39 +193,38 @@ Glacier2::RoutingTable::add(const ObjectProxySeq& unfiltered, const Current& cur
                 out << "proxy already in routing table:\n" << _communicator->proxyToString(proxy);
             }
 
-            EvictorEntryPtr entry = p->second;
-            _queue.erase(entry->pos);
-            EvictorQueue::iterator q = _queue.insert(_queue.end(), p);
-            entry->pos = q;
+            //
+            // Move the entry to the end of the queue, splice doesn't
+            // reallocate the queue node.
+            //
+            _queue.splice(_queue.end(), _queue, p->second->pos);
         }
 
-        while(static_cast<int>(_map.size()) > _maxSize)
+        //
+        // The most recently added proxy is kept even if it exceeds
+        // Glacier2.RoutingTable.MaxMemory on its own.
+        //
+        while(static_cast<int>(_map.size()) > _maxSize || (_maxMemory > 0 && _memory > _maxMemory && _map.size() > 1))
         {
-            p = _queue.front();
-
-            if(_traceLevel >= 2)
-            {
-                Trace out(_communicator->getLogger(), "Glacier2");
-                out << "evicting proxy from routing table:\n" << _communicator->proxyToString(p->second->proxy);
-            }
-
-            evictedProxies.push_back(p->second->proxy);
-
-            _map.erase(p);
-            _queue.pop_front();
+            evict(evictedProxies);
         }
     }
 
     if(_observer)
     {
         _observer->routingTableSize(static_cast<Ice::Int>(_map.size()) - static_cast<Ice::Int>(sz));
+        _observer->routingTableMemory(_memory - memory);
+        if(!evictedProxies.empty())
+        {
+            _observer->routingTableEvicted(static_cast<Ice::Int>(evictedProxies.size()));
+        }
     }
 
     return evictedProxies;
 }
 
 ObjectPrx
-Glacier2::RoutingTable::get(const Identity& ident)
+Glacier2::RoutingTable::get(const Identity& ident, bool oneway)
 {
     if(ident.name.empty())
     {
@@ -150,10 +242,57 @@ Glacier2::RoutingTable::get(const Identity& ident)
     else
     {
         EvictorEntryPtr entry = p->second;
-        _queue.erase(entry->pos);
-        EvictorQueue::iterator q = _queue.insert(_queue.end(), p);
-        entry->pos = q;
+        _queue.splice(_queue.end(), _queue, entry->pos);
 
+        if(oneway)
+        {
+            //
+            // The oneway proxy is kept with the entry to avoid creating
+            // a new proxy, and establishing its connection binding, for
+            // each oneway request.
+            //
+            if(!entry->oneway)
+            {
+                entry->oneway = entry->proxy->ice_oneway();
+            }
+            return entry->oneway;
+        }
         return entry->proxy;
     }
 }
+
+Ice::Long
+Glacier2::RoutingTable::entryMemory(const ObjectPrx& proxy) const
+{
+    //
+    // An approximation of the memory used by an entry: the entry itself,
+    // its map and queue nodes, the identity key and the proxy, estimated
+    // with its identity, adapter ID and number of endpoints.
+    //
+    const Identity& ident = proxy->ice_getIdentity();
+    size_t size = sizeof(EvictorEntry) + sizeof(EvictorMap::value_type) + sizeof(EvictorMap::iterator) +
+        4 * sizeof(void*) + 2 * (ident.name.size() + ident.category.size()) + proxy->ice_getAdapterId().size() +
+        proxy->ice_getEndpoints().size() * endpointMemory;
+    return static_cast<Ice::Long>(size);
+}
+
+void
+Glacier2::RoutingTable::evict(ObjectProxySeq& evictedProxies)
+{
+    assert(!_queue.empty());
+    EvictorMap::iterator p = _queue.front();
+
+    if(_traceLevel >= 2)
+    {
+        Trace out(_communicator->getLogger(), "Glacier2");
+        out << "evicting proxy from routing table:\n" << _communicator->proxyToString(p->second->proxy);
+    }
+
+    evictedProxies.push_back(p->second->proxy);
+
+    _memory -= p->second->memory;
+    _totalMemory->remove(this, 0, p->second->memory);
+
+    _map.erase(p);
+    _queue.pop_front();
+}
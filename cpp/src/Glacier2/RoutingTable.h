@@ -12,6 +12,7 @@
 
 #include <Ice/Ice.h>
 #include <Ice/ObserverHelper.h>
+#include <Ice/MemoryLimit.h>
 #include <IceUtil/Mutex.h>
 
 #include <Glacier2/ProxyVerifier.h>
@@ -25,11 +26,19 @@ namespace Glacier2
 class RoutingTable;
 typedef IceUtil::Handle<RoutingTable> RoutingTablePtr;
 
+//
+// The memory used by the proxies of all the routing tables of the router,
+// bounded by Glacier2.RoutingTable.TotalMaxMemory.
+//
+typedef IceInternal::MemoryLimit<RoutingTable> RoutingTableMemory;
+typedef IceUtil::Handle<RoutingTableMemory> RoutingTableMemoryPtr;
+
 class RoutingTable : public IceUtil::Shared, public IceUtil::Mutex
 {
 public:
 
-    RoutingTable(const Ice::CommunicatorPtr&, const ProxyVerifierPtr&);
+    RoutingTable(const Ice::CommunicatorPtr&, const ProxyVerifierPtr&, const RoutingTableMemoryPtr&,
+                 const std::string&);
 
     void destroy();
 
@@ -38,14 +47,24 @@ public:
 
     // Returns evicted proxies.
     Ice::ObjectProxySeq add(const Ice::ObjectProxySeq&, const Ice::Current&);
-    Ice::ObjectPrx get(const Ice::Identity&); // Returns null if no proxy can be found.
+    // Returns null if no proxy can be found. The returned proxy is oneway if the bool is true.
+    Ice::ObjectPrx get(const Ice::Identity&, bool);
+
+    // Evicts the least recently used proxy to reclaim memory for the session with the given user ID, returns false
+    // if the table is empty.
+    bool shed(Ice::ObjectProxySeq&, const std::string&);
 
 private:
 
+    Ice::ObjectProxySeq addProxies(const Ice::ObjectProxySeq&, const Ice::Current&);
+
     const Ice::CommunicatorPtr _communicator;
+    const std::string _userId;
     const int _traceLevel;
     const int _maxSize;
+    const Ice::Long _maxMemory;
     const ProxyVerifierPtr _verifier;
+    const RoutingTableMemoryPtr _totalMemory;
 
     struct EvictorEntry;
     typedef IceUtil::Handle<EvictorEntry> EvictorEntryPtr;
@@ -57,11 +76,18 @@ private:
     struct EvictorEntry : public IceUtil::Shared
     {
         Ice::ObjectPrx proxy;
+        Ice::ObjectPrx oneway; // The oneway proxy, created on first use.
+        Ice::Long memory; // The approximate memory used by the entry, in bytes.
         EvictorQueue::iterator pos;
     };
 
+    Ice::Long entryMemory(const Ice::ObjectPrx&) const;
+    void evict(Ice::ObjectProxySeq&);
+
     EvictorMap _map;
-    EvictorQueue _queue;
+    EvictorQueue _queue; // Least recently used first.
+    Ice::Long _memory;
+    bool _destroyed;
 
     IceInternal::ObserverHelperT<Glacier2::Instrumentation::SessionObserver> _observer;
 };
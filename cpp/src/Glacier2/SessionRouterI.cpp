@@ -679,8 +679,6 @@ SessionRouterI::SessionRouterI(const InstancePtr& instance,
     _closeCallback(new CloseCallbackI(this)),
     _heartbeatCallback(new HeartbeatCallbackI(this)),
     _sessionThread(_sessionTimeout > IceUtil::Time() ? new SessionThread(this, _sessionTimeout) : 0),
-    _routersByConnectionHint(_routersByConnection.end()),
-    _routersByCategoryHint(_routersByCategory.end()),
     _sessionDestroyCallback(newCallback_Session_destroy(this, &SessionRouterI::sessionDestroyException)),
     _destroy(false)
 {
@@ -741,7 +739,7 @@ SessionRouterI::~SessionRouterI()
 void
 SessionRouterI::destroy()
 {
-    map<ConnectionPtr, RouterIPtr> routers;
+    vector<RouterIPtr> routers;
     SessionThreadPtr sessionThread;
     Callback_Session_destroyPtr destroyCallback;
     {
@@ -751,11 +749,8 @@ SessionRouterI::destroy()
         _destroy = true;
         notify();
 
-        _routersByConnection.swap(routers);
-        _routersByConnectionHint = _routersByConnection.end();
-
+        routers = _routersByConnection.clear();
         _routersByCategory.clear();
-        _routersByCategoryHint = _routersByCategory.end();
 
         sessionThread = _sessionThread;
         _sessionThread = 0;
@@ -770,9 +765,9 @@ SessionRouterI::destroy()
     // We destroy the routers outside the thread synchronization, to
     // avoid deadlocks.
     //
-    for(map<ConnectionPtr, RouterIPtr>::iterator p = routers.begin(); p != routers.end(); ++p)
+    for(vector<RouterIPtr>::const_iterator p = routers.begin(); p != routers.end(); ++p)
     {
-        p->second->destroy(destroyCallback);
+        (*p)->destroy(destroyCallback);
     }
 
     if(sessionThread)
@@ -894,15 +889,11 @@ SessionRouterI::destroySession(const Current& current)
 void
 SessionRouterI::refreshSession_async(const AMD_Router_refreshSessionPtr& callback, const Ice::Current& current)
 {
-    RouterIPtr router;
+    RouterIPtr router = getRouterImpl(current.con, current.id, false); // getRouter updates the session timestamp.
+    if(!router)
     {
-        IceUtil::Monitor<IceUtil::Mutex>::Lock lock(*this);
-        router = getRouterImpl(current.con, current.id, false); // getRouter updates the session timestamp.
-        if(!router)
-        {
-            callback->ice_exception(SessionNotExistException());
-            return;
-        }
+        callback->ice_exception(SessionNotExistException());
+        return;
     }
 
     SessionPrx session = router->getSession();
@@ -923,19 +914,15 @@ SessionRouterI::refreshSession_async(const AMD_Router_refreshSessionPtr& callbac
 void
 SessionRouterI::refreshSession(const Ice::ConnectionPtr& con)
 {
-    RouterIPtr router;
+    RouterIPtr router = getRouterImpl(con, Ice::Identity(), false); // getRouter updates the session timestamp.
+    if(!router)
     {
-        IceUtil::Monitor<IceUtil::Mutex>::Lock lock(*this);
-        router = getRouterImpl(con, Ice::Identity(), false); // getRouter updates the session timestamp.
-        if(!router)
-        {
-            //
-            // Close the connection otherwise the peer has no way to know that the
-            // session has gone.
-            //
-            con->close(ICE_SCOPED_ENUM(ConnectionClose, Forcefully));
-            throw SessionNotExistException();
-        }
+        //
+        // Close the connection otherwise the peer has no way to know that the
+        // session has gone.
+        //
+        con->close(ICE_SCOPED_ENUM(ConnectionClose, Forcefully));
+        throw SessionNotExistException();
     }
 
     SessionPrx session = router->getSession();
@@ -961,33 +948,17 @@ SessionRouterI::destroySession(const ConnectionPtr& connection)
             throw ObjectNotExistException(__FILE__, __LINE__);
         }
 
-        map<ConnectionPtr, RouterIPtr>::iterator p;
-
-        if(_routersByConnectionHint != _routersByConnection.end() && _routersByConnectionHint->first == connection)
-        {
-            p = _routersByConnectionHint;
-        }
-        else
-        {
-            p = _routersByConnection.find(connection);
-        }
-
-        if(p == _routersByConnection.end())
+        router = _routersByConnection.erase(connection);
+        if(!router)
         {
             throw SessionNotExistException();
         }
 
-        router = p->second;
-
-        _routersByConnection.erase(p++);
-        _routersByConnectionHint = p;
-
         if(_instance->serverObjectAdapter())
         {
             string category = router->getServerProxy(Current())->ice_getIdentity().category;
             assert(!category.empty());
             _routersByCategory.erase(category);
-            _routersByCategoryHint = _routersByCategory.end();
         }
     }
 
@@ -1023,54 +994,38 @@ SessionRouterI::updateSessionObservers()
     Glacier2::Instrumentation::RouterObserverPtr observer = _instance->getObserver();
     assert(observer);
 
-    for(map<ConnectionPtr, RouterIPtr>::iterator p = _routersByConnection.begin(); p != _routersByConnection.end(); ++p)
+    vector<RouterIPtr> routers = _routersByConnection.routers();
+    for(vector<RouterIPtr>::const_iterator p = routers.begin(); p != routers.end(); ++p)
     {
-        p->second->updateObserver(observer);
+        (*p)->updateObserver(observer);
     }
 }
 
 RouterIPtr
 SessionRouterI::getRouter(const ConnectionPtr& connection, const Ice::Identity& id, bool close) const
 {
-    IceUtil::Monitor<IceUtil::Mutex>::Lock lock(*this);
     return getRouterImpl(connection, id, close);
 }
 
 Ice::ObjectPtr
 SessionRouterI::getClientBlobject(const ConnectionPtr& connection, const Ice::Identity& id) const
 {
-    IceUtil::Monitor<IceUtil::Mutex>::Lock lock(*this);
     return getRouterImpl(connection, id, true)->getClientBlobject();
 }
 
 Ice::ObjectPtr
 SessionRouterI::getServerBlobject(const string& category) const
 {
-    IceUtil::Monitor<IceUtil::Mutex>::Lock lock(*this);
-
-    if(_destroy)
-    {
-        throw ObjectNotExistException(__FILE__, __LINE__);
-    }
-
-    map<string, RouterIPtr>& routers = const_cast<map<string, RouterIPtr>&>(_routersByCategory);
-
-    if(_routersByCategoryHint != routers.end() && _routersByCategoryHint->first == category)
-    {
-        return _routersByCategoryHint->second->getServerBlobject();
-    }
-
-    map<string, RouterIPtr>::iterator p = routers.find(category);
-
-    if(p != routers.end())
-    {
-        _routersByCategoryHint = p;
-        return p->second->getServerBlobject();
-    }
-    else
+    //
+    // The routers are removed from the map when the session router is
+    // destroyed, no need to check _destroy.
+    //
+    RouterIPtr router = _routersByCategory.find(category);
+    if(!router)
     {
         throw ObjectNotExistException(__FILE__, __LINE__);
     }
+    return router->getServerBlobject();
 }
 
 void
@@ -1089,29 +1044,14 @@ SessionRouterI::expireSessions()
         assert(_sessionTimeout > IceUtil::Time());
         IceUtil::Time minTimestamp = IceUtil::Time::now(IceUtil::Time::Monotonic) - _sessionTimeout;
 
-        map<ConnectionPtr, RouterIPtr>::iterator p = _routersByConnection.begin();
-
-        while(p != _routersByConnection.end())
+        routers = _routersByConnection.eraseExpired(minTimestamp);
+        if(_instance->serverObjectAdapter())
         {
-            if(p->second->getTimestamp() < minTimestamp)
-            {
-                RouterIPtr router = p->second;
-                routers.push_back(router);
-
-                _routersByConnection.erase(p++);
-                _routersByConnectionHint = p;
-
-                if(_instance->serverObjectAdapter())
-                {
-                    string category = router->getServerProxy(Current())->ice_getIdentity().category;
-                    assert(!category.empty());
-                    _routersByCategory.erase(category);
-                    _routersByCategoryHint = _routersByCategory.end();
-                }
-            }
-            else
+            for(vector<RouterIPtr>::const_iterator p = routers.begin(); p != routers.end(); ++p)
             {
-                ++p;
+                string category = (*p)->getServerProxy(Current())->ice_getIdentity().category;
+                assert(!category.empty());
+                _routersByCategory.erase(category);
             }
         }
     }
@@ -1139,26 +1079,20 @@ SessionRouterI::getRouterImpl(const ConnectionPtr& connection, const Ice::Identi
     // a proxy which points to the client endpoints (in which case the request
     // is forwarded with collocation optimization).
     //
-    if(_destroy || !connection)
+    // This is called without the session router mutex locked. The routers
+    // are removed from the map when the session router is destroyed, no
+    // need to check _destroy.
+    //
+    if(!connection)
     {
         throw ObjectNotExistException(__FILE__, __LINE__);
     }
 
-    map<ConnectionPtr, RouterIPtr>& routers = const_cast<map<ConnectionPtr, RouterIPtr>&>(_routersByConnection);
-
-    if(_routersByConnectionHint != routers.end() && _routersByConnectionHint->first == connection)
-    {
-        _routersByConnectionHint->second->updateTimestamp();
-        return _routersByConnectionHint->second;
-    }
-
-    map<ConnectionPtr, RouterIPtr>::iterator p = routers.find(connection);
-
-    if(p != routers.end())
+    RouterIPtr router = _routersByConnection.find(connection);
+    if(router)
     {
-        _routersByConnectionHint = p;
-        p->second->updateTimestamp();
-        return p->second;
+        router->updateTimestamp();
+        return router;
     }
     else if(close)
     {
@@ -1197,22 +1131,9 @@ SessionRouterI::startCreateSession(const CreateSessionPtr& cb, const ConnectionP
     //
     // Check whether a session already exists for the connection.
     //
+    if(_routersByConnection.find(connection))
     {
-        map<ConnectionPtr, RouterIPtr>::iterator p;
-        if(_routersByConnectionHint != _routersByConnection.end() &&
-           _routersByConnectionHint->first == connection)
-        {
-            p = _routersByConnectionHint;
-        }
-        else
-        {
-            p = _routersByConnection.find(connection);
-        }
-
-        if(p != _routersByConnection.end())
-        {
-            throw CannotCreateSessionException("session exists");
-        }
+        throw CannotCreateSessionException("session exists");
     }
 
     map<ConnectionPtr, CreateSessionPtr>::iterator p = _pending.find(connection);
@@ -1261,17 +1182,21 @@ SessionRouterI::finishCreateSession(const ConnectionPtr& connection, const Route
         throw CannotCreateSessionException("router is shutting down");
     }
 
-    _routersByConnectionHint = _routersByConnection.insert(
-        _routersByConnectionHint, pair<const ConnectionPtr, RouterIPtr>(connection, router));
+#ifndef NDEBUG
+    bool inserted =
+#endif
+        _routersByConnection.insert(connection, router);
+    assert(inserted);
 
     if(_instance->serverObjectAdapter())
     {
         string category = router->getServerProxy(Ice::emptyCurrent)->ice_getIdentity().category;
         assert(!category.empty());
-        pair<map<string, RouterIPtr>::iterator, bool> rc =
-            _routersByCategory.insert(pair<const string, RouterIPtr>(category, router));
-        assert(rc.second);
-        _routersByCategoryHint = rc.first;
+#ifndef NDEBUG
+        inserted =
+#endif
+            _routersByCategory.insert(category, router);
+        assert(inserted);
     }
 
     connection->setCloseCallback(_closeCallback);
@@ -20,6 +20,7 @@
 #include <Glacier2/Instrumentation.h>
 
 #include <set>
+#include <map>
 
 namespace Glacier2
 {
@@ -88,6 +89,165 @@ typedef IceUtil::Handle<UserPasswordCreateSession> UserPasswordCreateSessionPtr;
 class SSLCreateSession;
 typedef IceUtil::Handle<SSLCreateSession> SSLCreateSessionPtr;
 
+//
+// The routers indexed by connection or by category. The map is split in
+// buckets, each protected by its own mutex, so that finding the router
+// of a routed request doesn't require the session router mutex and
+// doesn't contend with the lookups for other sessions.
+//
+template<typename K>
+class RouterMap
+{
+public:
+
+    RouterIPtr
+    find(const K& key) const
+    {
+        const Bucket& b = bucket(key);
+        IceUtil::Mutex::Lock sync(b.mutex);
+        typename std::map<K, RouterIPtr>::const_iterator p = b.routers.find(key);
+        return p != b.routers.end() ? p->second : RouterIPtr();
+    }
+
+    bool
+    insert(const K& key, const RouterIPtr& router)
+    {
+        Bucket& b = bucket(key);
+        IceUtil::Mutex::Lock sync(b.mutex);
+        return b.routers.insert(std::pair<const K, RouterIPtr>(key, router)).second;
+    }
+
+    RouterIPtr
+    erase(const K& key)
+    {
+        Bucket& b = bucket(key);
+        IceUtil::Mutex::Lock sync(b.mutex);
+        typename std::map<K, RouterIPtr>::iterator p = b.routers.find(key);
+        if(p == b.routers.end())
+        {
+            return 0;
+        }
+        RouterIPtr router = p->second;
+        b.routers.erase(p);
+        return router;
+    }
+
+    // Removes the routers whose timestamp is older than the given time and returns them.
+    std::vector<RouterIPtr>
+    eraseExpired(const IceUtil::Time& minTimestamp)
+    {
+        std::vector<RouterIPtr> expired;
+        for(int i = 0; i < bucketCount; ++i)
+        {
+            IceUtil::Mutex::Lock sync(_buckets[i].mutex);
+            typename std::map<K, RouterIPtr>::iterator p = _buckets[i].routers.begin();
+            while(p != _buckets[i].routers.end())
+            {
+                if(p->second->getTimestamp() < minTimestamp)
+                {
+                    expired.push_back(p->second);
+                    _buckets[i].routers.erase(p++);
+                }
+                else
+                {
+                    ++p;
+                }
+            }
+        }
+        return expired;
+    }
+
+    // Removes all the routers and returns them.
+    std::vector<RouterIPtr>
+    clear()
+    {
+        std::vector<RouterIPtr> routers;
+        for(int i = 0; i < bucketCount; ++i)
+        {
+            IceUtil::Mutex::Lock sync(_buckets[i].mutex);
+            for(typename std::map<K, RouterIPtr>::const_iterator p = _buckets[i].routers.begin();
+                p != _buckets[i].routers.end(); ++p)
+            {
+                routers.push_back(p->second);
+            }
+            _buckets[i].routers.clear();
+        }
+        return routers;
+    }
+
+    std::vector<RouterIPtr>
+    routers() const
+    {
+        std::vector<RouterIPtr> routers;
+        for(int i = 0; i < bucketCount; ++i)
+        {
+            IceUtil::Mutex::Lock sync(_buckets[i].mutex);
+            for(typename std::map<K, RouterIPtr>::const_iterator p = _buckets[i].routers.begin();
+                p != _buckets[i].routers.end(); ++p)
+            {
+                routers.push_back(p->second);
+            }
+        }
+        return routers;
+    }
+
+    bool
+    empty() const
+    {
+        for(int i = 0; i < bucketCount; ++i)
+        {
+            IceUtil::Mutex::Lock sync(_buckets[i].mutex);
+            if(!_buckets[i].routers.empty())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+
+    static const int bucketCount = 64;
+
+    struct Bucket
+    {
+        IceUtil::Mutex mutex;
+        std::map<K, RouterIPtr> routers;
+    };
+
+    static size_t
+    hash(const Ice::ConnectionPtr& connection)
+    {
+        // Connections are heap allocated, skip the low bits which are the same for all connections.
+        return reinterpret_cast<size_t>(connection.get()) >> 4;
+    }
+
+    static size_t
+    hash(const std::string& category)
+    {
+        size_t h = 5381;
+        for(std::string::const_iterator p = category.begin(); p != category.end(); ++p)
+        {
+            h = ((h << 5) + h) ^ static_cast<unsigned char>(*p);
+        }
+        return h;
+    }
+
+    Bucket&
+    bucket(const K& key)
+    {
+        return _buckets[hash(key) % bucketCount];
+    }
+
+    const Bucket&
+    bucket(const K& key) const
+    {
+        return _buckets[hash(key) % bucketCount];
+    }
+
+    Bucket _buckets[bucketCount];
+};
+
 class SessionRouterI : public Router,
                        public Glacier2::Instrumentation::ObserverUpdater,
                        private IceUtil::Monitor<IceUtil::Mutex>
@@ -168,11 +328,12 @@ private:
     typedef IceUtil::Handle<SessionThread> SessionThreadPtr;
     SessionThreadPtr _sessionThread;
 
-    std::map<Ice::ConnectionPtr, RouterIPtr> _routersByConnection;
-    mutable std::map<Ice::ConnectionPtr, RouterIPtr>::iterator _routersByConnectionHint;
-
-    std::map<std::string, RouterIPtr> _routersByCategory;
-    mutable std::map<std::string, RouterIPtr>::iterator _routersByCategoryHint;
+    //
+    // The routers are added and removed with the session router mutex
+    // locked. They are looked up without the mutex.
+    //
+    RouterMap<Ice::ConnectionPtr> _routersByConnection;
+    RouterMap<std::string> _routersByCategory;
 
     std::map<Ice::ConnectionPtr, CreateSessionPtr> _pending;
 
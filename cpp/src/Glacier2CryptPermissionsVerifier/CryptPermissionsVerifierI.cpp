@@ -11,13 +11,16 @@
 #include <IceUtil/IceUtil.h>
 #include <Ice/Ice.h>
 #include <Ice/UniqueRef.h>
+#include <Ice/SHA1.h>
 
 #include <IceUtil/FileUtil.h>
 #include <IceUtil/StringUtil.h>
 #include <IceUtil/InputUtil.h>
 #include <IceUtil/Mutex.h>
+#include <IceUtil/Random.h>
 
 #include <fstream>
+#include <deque>
 
 #if defined(__GLIBC__) || defined(_AIX)
 #   include <crypt.h>
@@ -142,14 +145,129 @@ class CryptPermissionsVerifierI : public PermissionsVerifier
 {
 public:
 
-    CryptPermissionsVerifierI(const map<string, string>&);
+    CryptPermissionsVerifierI(const map<string, string>&, const IceUtil::Time&);
 
     virtual bool checkPermissions(const string&, const string&, string&, const Ice::Current&) const;
 
 private:
 
+    bool checkPassword(const string&, const string&) const;
+    vector<unsigned char> passwordDigest(const string&) const;
+
     const map<string, string> _passwords;
     IceUtil::Mutex _cryptMutex; // for old thread-unsafe crypt()
+
+    //
+    // The successful verifications are cached for _cacheTimeout. The cache keeps a HMAC of
+    // the password, keyed with a random key, rather than the password.
+    //
+    struct CacheEntry
+    {
+        vector<unsigned char> digest;
+        IceUtil::Time expires;
+    };
+
+    const IceUtil::Time _cacheTimeout;
+    vector<unsigned char> _cacheKey;
+    IceUtil::Mutex _cacheMutex;
+    mutable map<string, CacheEntry> _cache;
+};
+typedef IceUtil::Handle<CryptPermissionsVerifierI> CryptPermissionsVerifierIPtr;
+
+//
+// A password verification waiting for a verifier thread.
+//
+class Verification : public IceUtil::Shared
+{
+public:
+
+    Verification(const CryptPermissionsVerifierIPtr&, const AMD_Object_ice_invokePtr&, const string&, const string&,
+                 const Current&);
+
+    void run();
+    void rejected();
+    void destroyed();
+
+private:
+
+    void response(bool, const string&);
+
+    const CryptPermissionsVerifierIPtr _verifier;
+    const AMD_Object_ice_invokePtr _cb;
+    const string _userId;
+    const string _password;
+    const Current _current;
+};
+typedef IceUtil::Handle<Verification> VerificationPtr;
+
+//
+// The threads verifying the passwords. crypt() and PBKDF2 are slow by
+// design, the verifications are done by these threads rather than by
+// the server thread pool of the router communicator, which only has one
+// thread by default. Verifications queued once the queue is full are
+// rejected.
+//
+class VerifierThreads : public IceUtil::Shared, private IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    VerifierThreads(int, size_t);
+
+    void queue(const VerificationPtr&);
+    void destroy();
+
+    VerificationPtr next(); // Returns null once destroyed.
+
+private:
+
+    class VerifierThread : public IceUtil::Thread
+    {
+    public:
+
+        VerifierThread(const IceUtil::Handle<VerifierThreads>& threads) :
+            IceUtil::Thread("Glacier2 crypt permissions verifier"),
+            _threads(threads)
+        {
+        }
+
+        virtual void
+        run()
+        {
+            while(VerificationPtr verification = _threads->next())
+            {
+                verification->run();
+            }
+        }
+
+    private:
+
+        const IceUtil::Handle<VerifierThreads> _threads;
+    };
+
+    const size_t _maxQueueSize;
+    deque<VerificationPtr> _queue;
+    vector<IceUtil::ThreadControl> _threads;
+    bool _destroyed;
+};
+typedef IceUtil::Handle<VerifierThreads> VerifierThreadsPtr;
+
+//
+// The servant of a verifier. It's added to a colloc-only adapter and
+// hands over the verifications to the verifier threads, so the server
+// thread pool isn't held while a password is verified.
+//
+class CryptPermissionsVerifierBlobject : public Ice::BlobjectAsync
+{
+public:
+
+    CryptPermissionsVerifierBlobject(const CryptPermissionsVerifierIPtr&, const VerifierThreadsPtr&);
+
+    virtual void ice_invoke_async(const AMD_Object_ice_invokePtr&, const vector<Byte>&, const Current&);
+
+private:
+
+    const CryptPermissionsVerifierIPtr _verifier;
+    const VerifierThreadsPtr _threads;
 };
 
 class CryptPermissionsVerifierPlugin : public Ice::Plugin
@@ -164,6 +282,7 @@ public:
 private:
 
     CommunicatorPtr _communicator;
+    VerifierThreadsPtr _threads;
 };
 
 map<string, string>
@@ -200,9 +319,13 @@ retrievePasswordMap(const string& file)
     return passwords;
 }
 
-CryptPermissionsVerifierI::CryptPermissionsVerifierI(const map<string, string>& passwords) :
-    _passwords(passwords)
+CryptPermissionsVerifierI::CryptPermissionsVerifierI(const map<string, string>& passwords,
+                                                     const IceUtil::Time& cacheTimeout) :
+    _passwords(passwords),
+    _cacheTimeout(cacheTimeout),
+    _cacheKey(64) // The SHA-1 block size.
 {
+    IceUtilInternal::generateRandom(reinterpret_cast<char*>(&_cacheKey[0]), _cacheKey.size());
 }
 
 namespace
@@ -235,9 +358,294 @@ paddingBytes(size_t length)
 }
 #endif
 
+//
+// Compares the digests in constant time, the time taken doesn't depend on
+// the first byte which differs.
+//
+bool
+digestEquals(const vector<unsigned char>& lhs, const vector<unsigned char>& rhs)
+{
+    if(lhs.size() != rhs.size())
+    {
+        return false;
+    }
+
+    unsigned char diff = 0;
+    for(vector<unsigned char>::size_type i = 0; i < lhs.size(); ++i)
+    {
+        diff |= lhs[i] ^ rhs[i];
+    }
+    return diff == 0;
+}
+
+int
+processorCount()
+{
+#ifdef _WIN32
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+    return static_cast<int>(sysInfo.dwNumberOfProcessors);
+#else
+    return static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+}
+
 }
+
 bool
 CryptPermissionsVerifierI::checkPermissions(const string& userId, const string& password, string&, const Current&) const
+{
+    if(_cacheTimeout <= IceUtil::Time())
+    {
+        return checkPassword(userId, password);
+    }
+
+    vector<unsigned char> digest = passwordDigest(password);
+    {
+        IceUtil::Mutex::Lock lock(_cacheMutex);
+        map<string, CacheEntry>::const_iterator p = _cache.find(userId);
+        if(p != _cache.end() && digestEquals(p->second.digest, digest) &&
+           IceUtil::Time::now(IceUtil::Time::Monotonic) < p->second.expires)
+        {
+            return true;
+        }
+    }
+
+    if(!checkPassword(userId, password))
+    {
+        return false;
+    }
+
+    IceUtil::Mutex::Lock lock(_cacheMutex);
+    CacheEntry& entry = _cache[userId];
+    entry.digest.swap(digest);
+    entry.expires = IceUtil::Time::now(IceUtil::Time::Monotonic) + _cacheTimeout;
+    return true;
+}
+
+vector<unsigned char>
+CryptPermissionsVerifierI::passwordDigest(const string& password) const
+{
+    //
+    // HMAC-SHA1 (RFC 2104) of the password, keyed with the random cache key.
+    //
+    vector<unsigned char> innerKey(_cacheKey);
+    vector<unsigned char> outerKey(_cacheKey);
+    for(vector<unsigned char>::size_type i = 0; i < _cacheKey.size(); ++i)
+    {
+        innerKey[i] ^= 0x36;
+        outerKey[i] ^= 0x5c;
+    }
+
+    vector<unsigned char> digest;
+
+    IceInternal::SHA1 inner;
+    inner.update(&innerKey[0], innerKey.size());
+    inner.update(reinterpret_cast<const unsigned char*>(password.data()), password.size());
+    inner.finalize(digest);
+
+    IceInternal::SHA1 outer;
+    outer.update(&outerKey[0], outerKey.size());
+    outer.update(&digest[0], digest.size());
+    outer.finalize(digest);
+    return digest;
+}
+
+Verification::Verification(const CryptPermissionsVerifierIPtr& verifier, const AMD_Object_ice_invokePtr& cb,
+                           const string& userId, const string& password, const Current& current) :
+    _verifier(verifier),
+    _cb(cb),
+    _userId(userId),
+    _password(password),
+    _current(current)
+{
+}
+
+void
+Verification::run()
+{
+    try
+    {
+        string reason;
+        bool ok = _verifier->checkPermissions(_userId, _password, reason, _current);
+        response(ok, reason);
+    }
+    catch(const std::exception& ex)
+    {
+        _cb->ice_exception(ex);
+    }
+}
+
+void
+Verification::rejected()
+{
+    //
+    // The router raises PermissionDeniedException with this reason.
+    //
+    try
+    {
+        response(false, "too many pending password verifications");
+    }
+    catch(const std::exception& ex)
+    {
+        _cb->ice_exception(ex);
+    }
+}
+
+void
+Verification::destroyed()
+{
+    _cb->ice_exception(Ice::CommunicatorDestroyedException(__FILE__, __LINE__));
+}
+
+void
+Verification::response(bool ok, const string& reason)
+{
+    Ice::OutputStream out(_current.adapter->getCommunicator(), _current.encoding);
+    out.startEncapsulation(_current.encoding, Ice::DefaultFormat);
+    out.write(reason);
+    out.write(ok);
+    out.endEncapsulation();
+    vector<Byte> outEncaps;
+    out.finished(outEncaps);
+    _cb->ice_response(true, outEncaps);
+}
+
+VerifierThreads::VerifierThreads(int size, size_t maxQueueSize) :
+    _maxQueueSize(maxQueueSize),
+    _destroyed(false)
+{
+    for(int i = 0; i < size; ++i)
+    {
+        IceUtil::ThreadPtr thread = new VerifierThread(this);
+        _threads.push_back(thread->start());
+    }
+}
+
+void
+VerifierThreads::queue(const VerificationPtr& verification)
+{
+    {
+        Lock sync(*this);
+        if(!_destroyed)
+        {
+            if(_queue.size() < _maxQueueSize)
+            {
+                _queue.push_back(verification);
+                notify();
+                return;
+            }
+            sync.release();
+            verification->rejected();
+            return;
+        }
+    }
+    verification->destroyed();
+}
+
+void
+VerifierThreads::destroy()
+{
+    deque<VerificationPtr> queue;
+    {
+        Lock sync(*this);
+        _destroyed = true;
+        _queue.swap(queue);
+        notifyAll();
+    }
+
+    for(deque<VerificationPtr>::const_iterator p = queue.begin(); p != queue.end(); ++p)
+    {
+        (*p)->destroyed();
+    }
+
+    for(vector<IceUtil::ThreadControl>::iterator p = _threads.begin(); p != _threads.end(); ++p)
+    {
+        p->join();
+    }
+    _threads.clear();
+}
+
+VerificationPtr
+VerifierThreads::next()
+{
+    Lock sync(*this);
+    while(_queue.empty() && !_destroyed)
+    {
+        wait();
+    }
+    if(_destroyed)
+    {
+        return 0;
+    }
+    VerificationPtr verification = _queue.front();
+    _queue.pop_front();
+    return verification;
+}
+
+CryptPermissionsVerifierBlobject::CryptPermissionsVerifierBlobject(const CryptPermissionsVerifierIPtr& verifier,
+                                                                   const VerifierThreadsPtr& threads) :
+    _verifier(verifier),
+    _threads(threads)
+{
+}
+
+void
+CryptPermissionsVerifierBlobject::ice_invoke_async(const AMD_Object_ice_invokePtr& cb, const vector<Byte>& inEncaps,
+                                                   const Current& current)
+{
+    Ice::InputStream in(current.adapter->getCommunicator(), inEncaps);
+    in.startEncapsulation();
+    if(current.operation == "checkPermissions")
+    {
+        string userId;
+        string password;
+        in.read(userId);
+        in.read(password);
+        in.endEncapsulation();
+        _threads->queue(new Verification(_verifier, cb, userId, password, current));
+        return;
+    }
+
+    //
+    // The operations of Ice::Object are dispatched to the verifier right away.
+    //
+    Ice::OutputStream out(current.adapter->getCommunicator(), current.encoding);
+    out.startEncapsulation(current.encoding, Ice::DefaultFormat);
+    if(current.operation == "ice_ping")
+    {
+        in.endEncapsulation();
+        _verifier->ice_ping(current);
+    }
+    else if(current.operation == "ice_isA")
+    {
+        string id;
+        in.read(id);
+        in.endEncapsulation();
+        out.write(_verifier->ice_isA(id, current));
+    }
+    else if(current.operation == "ice_id")
+    {
+        in.endEncapsulation();
+        out.write(_verifier->ice_id(current));
+    }
+    else if(current.operation == "ice_ids")
+    {
+        in.endEncapsulation();
+        out.write(_verifier->ice_ids(current));
+    }
+    else
+    {
+        throw OperationNotExistException(__FILE__, __LINE__, current.id, current.facet, current.operation);
+    }
+    out.endEncapsulation();
+    vector<Byte> outEncaps;
+    out.finished(outEncaps);
+    cb->ice_response(true, outEncaps);
+}
+
+bool
+CryptPermissionsVerifierI::checkPassword(const string& userId, const string& password) const
 {
     map<string, string>::const_iterator p = _passwords.find(userId);
 
@@ -514,12 +922,27 @@ void
 CryptPermissionsVerifierPlugin::initialize()
 {
     const string prefix = "Glacier2CryptPermissionsVerifier.";
-    const PropertyDict props = _communicator->getProperties()->getPropertiesForPrefix(prefix);
+    const PropertiesPtr properties = _communicator->getProperties();
+    const PropertyDict props = properties->getPropertiesForPrefix(prefix);
 
     if(!props.empty())
     {
         ObjectAdapterPtr adapter = _communicator->createObjectAdapter(""); // colloc-only adapter
 
+        //
+        // The passwords are verified by Glacier2.CryptPermissionsVerifier.Threads threads (the
+        // number of cores by default). At most Glacier2.CryptPermissionsVerifier.MaxQueueSize
+        // verifications (1000 by default) wait for a thread, the logins in excess are denied.
+        //
+        int threads = properties->getPropertyAsInt("Glacier2.CryptPermissionsVerifier.Threads");
+        int maxQueueSize = properties->getPropertyAsIntWithDefault("Glacier2.CryptPermissionsVerifier.MaxQueueSize",
+                                                                   1000);
+        _threads = new VerifierThreads(threads > 0 ? threads : max(processorCount(), 1),
+                                       static_cast<size_t>(max(maxQueueSize, 0)));
+
+        const IceUtil::Time cacheTimeout =
+            IceUtil::Time::seconds(properties->getPropertyAsInt("Glacier2.CryptPermissionsVerifier.CacheTimeout"));
+
         // Each prop represents a property to set + the associated password file
 
         for(PropertyDict::const_iterator p = props.begin(); p != props.end(); ++p)
@@ -528,8 +951,10 @@ CryptPermissionsVerifierPlugin::initialize()
             Identity id;
             id.name = Ice::generateUUID();
             id.category = "Glacier2CryptPermissionsVerifier";
-            ObjectPrx prx = adapter->add(new CryptPermissionsVerifierI(retrievePasswordMap(p->second)), id);
-            _communicator->getProperties()->setProperty(name, _communicator->proxyToString(prx));
+            ObjectPrx prx = adapter->add(new CryptPermissionsVerifierBlobject(
+                                             new CryptPermissionsVerifierI(retrievePasswordMap(p->second),
+                                                                           cacheTimeout), _threads), id);
+            properties->setProperty(name, _communicator->proxyToString(prx));
         }
 
         adapter->activate();
@@ -539,6 +964,11 @@ CryptPermissionsVerifierPlugin::initialize()
 void
 CryptPermissionsVerifierPlugin::destroy()
 {
+    if(_threads)
+    {
+        _threads->destroy();
+        _threads = 0;
+    }
 }
 
 }
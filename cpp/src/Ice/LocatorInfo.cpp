@@ -8,6 +8,7 @@
 // **********************************************************************
 
 #include <IceUtil/DisableWarnings.h>
+#include <IceUtil/Timer.h>
 #include <Ice/LocatorInfo.h>
 #include <Ice/Locator.h>
 #include <Ice/LocalException.h>
@@ -19,6 +20,7 @@
 #include <Ice/Functional.h>
 #include <Ice/Properties.h>
 #include <Ice/Comparable.h>
+#include <Ice/BuiltinSequences.h>
 #include <iterator>
 
 using namespace std;
@@ -89,6 +91,19 @@ public:
     }
 
     virtual void send()
+    {
+        if(!_locatorInfo->batchAdapterRequest(this, _ref->getInstance()))
+        {
+            sendFindAdapterById();
+        }
+    }
+
+    const ReferencePtr& getReference() const
+    {
+        return _ref;
+    }
+
+    void sendFindAdapterById()
     {
         try
         {
@@ -125,10 +140,70 @@ public:
     }
 };
 
+#ifndef ICE_CPP11_MAPPING
+class AdapterRequestsCallback : public IceUtil::Shared
+{
+public:
+
+    AdapterRequestsCallback(const LocatorInfoPtr& locatorInfo, const vector<LocatorInfo::RequestPtr>& requests) :
+        _locatorInfo(locatorInfo), _requests(requests)
+    {
+    }
+
+    void response(const ObjectProxySeq& proxies)
+    {
+        _locatorInfo->batchAdapterRequestsResponse(_requests, proxies);
+    }
+
+    void exception(const Ice::Exception& ex)
+    {
+        _locatorInfo->batchAdapterRequestsException(_requests, ex);
+    }
+
+private:
+
+    const LocatorInfoPtr _locatorInfo;
+    const vector<LocatorInfo::RequestPtr> _requests;
+};
+typedef IceUtil::Handle<AdapterRequestsCallback> AdapterRequestsCallbackPtr;
+#endif
+
+class BatchAdapterRequestsTimerTask : public IceUtil::TimerTask
+{
+public:
+
+    BatchAdapterRequestsTimerTask(const LocatorInfoPtr& locatorInfo) : _locatorInfo(locatorInfo)
+    {
+    }
+
+    virtual void runTimerTask()
+    {
+        _locatorInfo->sendBatchAdapterRequests();
+    }
+
+private:
+
+    const LocatorInfoPtr _locatorInfo;
+};
+
+void
+sendFindAdapterById(const vector<LocatorInfo::RequestPtr>& requests)
+{
+    for(vector<LocatorInfo::RequestPtr>::const_iterator p = requests.begin(); p != requests.end(); ++p)
+    {
+        static_cast<AdapterRequest*>(p->get())->sendFindAdapterById();
+    }
+}
+
 }
 
 IceInternal::LocatorManager::LocatorManager(const Ice::PropertiesPtr& properties) :
     _background(properties->getPropertyAsInt("Ice.BackgroundLocatorCacheUpdates") > 0),
+    _batchWait(properties->getPropertyAsInt("Ice.LocatorBatchRequests") > 0 ?
+               properties->getPropertyAsInt("Ice.LocatorBatchRequests") : 0),
+    _cacheMaxSize(static_cast<size_t>(properties->getPropertyAsInt("Ice.LocatorCacheMaxSize") > 0 ?
+                                      properties->getPropertyAsInt("Ice.LocatorCacheMaxSize") : 0)),
+    _cacheRefreshAhead(properties->getPropertyAsInt("Ice.LocatorCacheRefreshAhead")),
     _tableHint(_table.end())
 {
 }
@@ -193,13 +268,14 @@ IceInternal::LocatorManager::get(const LocatorPrxPtr& loc)
         {
             t = _locatorTables.insert(_locatorTables.begin(),
                                       pair<const pair<Identity, EncodingVersion>, LocatorTablePtr>(
-                                          locatorKey, new LocatorTable()));
+                                          locatorKey, new LocatorTable(_cacheMaxSize, _cacheRefreshAhead)));
         }
 
         _tableHint = _table.insert(_tableHint,
                                    pair<const LocatorPrxPtr, LocatorInfoPtr>(locator,
                                                                           new LocatorInfo(locator, t->second,
-                                                                                          _background)));
+                                                                                          _background,
+                                                                                          _batchWait)));
     }
     else
     {
@@ -209,7 +285,10 @@ IceInternal::LocatorManager::get(const LocatorPrxPtr& loc)
     return _tableHint->second;
 }
 
-IceInternal::LocatorTable::LocatorTable()
+IceInternal::LocatorTable::LocatorTable(size_t maxSize, int refreshAhead) :
+    _refreshAhead(refreshAhead),
+    _adapterEndpointsMap(maxSize),
+    _objectMap(maxSize)
 {
 }
 
@@ -223,7 +302,8 @@ IceInternal::LocatorTable::clear()
 }
 
 bool
-IceInternal::LocatorTable::getAdapterEndpoints(const string& adapter, int ttl, vector<EndpointIPtr>& endpoints)
+IceInternal::LocatorTable::getAdapterEndpoints(const string& adapter, int ttl, vector<EndpointIPtr>& endpoints,
+                                               bool& refresh)
 {
     if(ttl == 0) // No locator cache.
     {
@@ -232,12 +312,11 @@ IceInternal::LocatorTable::getAdapterEndpoints(const string& adapter, int ttl, v
 
     IceUtil::Mutex::Lock sync(*this);
 
-    map<string, pair<IceUtil::Time, vector<EndpointIPtr> > >::iterator p = _adapterEndpointsMap.find(adapter);
-
-    if(p != _adapterEndpointsMap.end())
+    const LocatorCacheMap<string, vector<EndpointIPtr> >::Entry* entry = _adapterEndpointsMap.get(adapter);
+    if(entry)
     {
-        endpoints = p->second.second;
-        return checkTTL(p->second.first, ttl);
+        endpoints = entry->value;
+        return checkTTL(entry->time, ttl, refresh);
     }
     return false;
 }
@@ -246,18 +325,7 @@ void
 IceInternal::LocatorTable::addAdapterEndpoints(const string& adapter, const vector<EndpointIPtr>& endpoints)
 {
     IceUtil::Mutex::Lock sync(*this);
-
-    map<string, pair<IceUtil::Time, vector<EndpointIPtr> > >::iterator p = _adapterEndpointsMap.find(adapter);
-
-    if(p != _adapterEndpointsMap.end())
-    {
-        p->second = make_pair(IceUtil::Time::now(IceUtil::Time::Monotonic), endpoints);
-    }
-    else
-    {
-        _adapterEndpointsMap.insert(
-            make_pair(adapter, make_pair(IceUtil::Time::now(IceUtil::Time::Monotonic), endpoints)));
-    }
+    _adapterEndpointsMap.add(adapter, endpoints);
 }
 
 vector<EndpointIPtr>
@@ -265,21 +333,13 @@ IceInternal::LocatorTable::removeAdapterEndpoints(const string& adapter)
 {
     IceUtil::Mutex::Lock sync(*this);
 
-    map<string, pair<IceUtil::Time, vector<EndpointIPtr> > >::iterator p = _adapterEndpointsMap.find(adapter);
-    if(p == _adapterEndpointsMap.end())
-    {
-        return vector<EndpointIPtr>();
-    }
-
-    vector<EndpointIPtr> endpoints = p->second.second;
-
-    _adapterEndpointsMap.erase(p);
-
+    vector<EndpointIPtr> endpoints;
+    _adapterEndpointsMap.remove(adapter, endpoints);
     return endpoints;
 }
 
 bool
-IceInternal::LocatorTable::getObjectReference(const Identity& id, int ttl, ReferencePtr& ref)
+IceInternal::LocatorTable::getObjectReference(const Identity& id, int ttl, ReferencePtr& ref, bool& refresh)
 {
     if(ttl == 0) // No locator cache
     {
@@ -288,12 +348,11 @@ IceInternal::LocatorTable::getObjectReference(const Identity& id, int ttl, Refer
 
     IceUtil::Mutex::Lock sync(*this);
 
-    map<Identity, pair<IceUtil::Time, ReferencePtr> >::iterator p = _objectMap.find(id);
-
-    if(p != _objectMap.end())
+    const LocatorCacheMap<Identity, ReferencePtr>::Entry* entry = _objectMap.get(id);
+    if(entry)
     {
-        ref = p->second.second;
-        return checkTTL(p->second.first, ttl);
+        ref = entry->value;
+        return checkTTL(entry->time, ttl, refresh);
     }
     return false;
 }
@@ -302,17 +361,7 @@ void
 IceInternal::LocatorTable::addObjectReference(const Identity& id, const ReferencePtr& ref)
 {
     IceUtil::Mutex::Lock sync(*this);
-
-    map<Identity, pair<IceUtil::Time, ReferencePtr> >::iterator p = _objectMap.find(id);
-
-    if(p != _objectMap.end())
-    {
-        p->second = make_pair(IceUtil::Time::now(IceUtil::Time::Monotonic), ref);
-    }
-    else
-    {
-        _objectMap.insert(make_pair(id, make_pair(IceUtil::Time::now(IceUtil::Time::Monotonic), ref)));
-    }
+    _objectMap.add(id, ref);
 }
 
 ReferencePtr
@@ -320,28 +369,36 @@ IceInternal::LocatorTable::removeObjectReference(const Identity& id)
 {
     IceUtil::Mutex::Lock sync(*this);
 
-    map<Identity, pair<IceUtil::Time, ReferencePtr> >::iterator p = _objectMap.find(id);
-    if(p == _objectMap.end())
-    {
-        return 0;
-    }
-
-    ReferencePtr ref = p->second.second;
-    _objectMap.erase(p);
+    ReferencePtr ref;
+    _objectMap.remove(id, ref);
     return ref;
 }
 
 bool
-IceInternal::LocatorTable::checkTTL(const IceUtil::Time& time, int ttl) const
+IceInternal::LocatorTable::checkTTL(const IceUtil::Time& time, int ttl, bool& refresh) const
 {
     assert(ttl != 0);
+    refresh = false;
     if (ttl < 0) // TTL = infinite
     {
         return true;
     }
     else
     {
-        return IceUtil::Time::now(IceUtil::Time::Monotonic) - time <= IceUtil::Time::seconds(ttl);
+        //
+        // If refresh ahead is enabled, the entry must be refreshed if
+        // it's still valid but older than the given percentage of the
+        // TTL. This allows to update the entries which are in use
+        // before they expire.
+        //
+        IceUtil::Time age = IceUtil::Time::now(IceUtil::Time::Monotonic) - time;
+        if(age > IceUtil::Time::seconds(ttl))
+        {
+            return false;
+        }
+        refresh = _refreshAhead > 0 &&
+            age >= IceUtil::Time::milliSeconds(static_cast<IceUtil::Int64>(ttl) * 10 * _refreshAhead);
+        return true;
     }
 }
 
@@ -488,10 +545,14 @@ IceInternal::LocatorInfo::Request::exception(const Ice::Exception& ex)
     }
 }
 
-IceInternal::LocatorInfo::LocatorInfo(const LocatorPrxPtr& locator, const LocatorTablePtr& table, bool background) :
+IceInternal::LocatorInfo::LocatorInfo(const LocatorPrxPtr& locator, const LocatorTablePtr& table, bool background,
+                                      int batchWait) :
     _locator(locator),
     _table(table),
-    _background(background)
+    _background(background),
+    _batchWait(IceUtil::Time::milliSeconds(batchWait)),
+    _batchRequests(batchWait > 0),
+    _batchScheduled(false)
 {
     assert(_locator);
     assert(_table);
@@ -500,10 +561,31 @@ IceInternal::LocatorInfo::LocatorInfo(const LocatorPrxPtr& locator, const Locato
 void
 IceInternal::LocatorInfo::destroy()
 {
-    IceUtil::Mutex::Lock sync(*this);
+    vector<RequestPtr> requests;
+    {
+        IceUtil::Mutex::Lock sync(*this);
+
+        _locatorRegistry = 0;
+        _table->clear();
+
+        //
+        // The timer is destroyed before the locator manager and the
+        // batch timer task is never run, the batched requests are
+        // failed here. Requests are no longer batched once destroyed.
+        //
+        requests.swap(_batchAdapterRequests);
+        _batchScheduled = false;
+        _batchRequests = false;
+    }
 
-    _locatorRegistry = 0;
-    _table->clear();
+    if(!requests.empty())
+    {
+        CommunicatorDestroyedException ex(__FILE__, __LINE__);
+        for(vector<RequestPtr>::const_iterator p = requests.begin(); p != requests.end(); ++p)
+        {
+            (*p)->exception(ex);
+        }
+    }
 }
 
 bool
@@ -559,9 +641,10 @@ IceInternal::LocatorInfo::getEndpoints(const ReferencePtr& ref,
 {
     assert(ref->isIndirect());
     vector<EndpointIPtr> endpoints;
+    bool refresh = false;
     if(!ref->isWellKnown())
     {
-        if(!_table->getAdapterEndpoints(ref->getAdapterId(), ttl, endpoints))
+        if(!_table->getAdapterEndpoints(ref->getAdapterId(), ttl, endpoints, refresh))
         {
             if(_background && !endpoints.empty())
             {
@@ -573,11 +656,19 @@ IceInternal::LocatorInfo::getEndpoints(const ReferencePtr& ref,
                 return;
             }
         }
+        else if(refresh)
+        {
+            //
+            // The cached endpoints are still valid but about to expire,
+            // we refresh them in the background.
+            //
+            getAdapterRequest(ref)->addCallback(ref, wellKnownRef, ttl, 0);
+        }
     }
     else
     {
         ReferencePtr r;
-        if(!_table->getObjectReference(ref->getIdentity(), ttl, r))
+        if(!_table->getObjectReference(ref->getIdentity(), ttl, r, refresh))
         {
             if(_background && r)
             {
@@ -589,6 +680,10 @@ IceInternal::LocatorInfo::getEndpoints(const ReferencePtr& ref,
                 return;
             }
         }
+        else if(refresh)
+        {
+            getObjectRequest(ref)->addCallback(ref, 0, ttl, 0);
+        }
 
         if(!r->isIndirect())
         {
@@ -892,3 +987,160 @@ IceInternal::LocatorInfo::finishRequest(const ReferencePtr& ref,
         _objectRequests.erase(ref->getIdentity());
     }
 }
+
+bool
+IceInternal::LocatorInfo::batchAdapterRequest(const RequestPtr& request, const InstancePtr& instance)
+{
+    IceUtil::Mutex::Lock sync(*this);
+    if(!_batchRequests)
+    {
+        return false;
+    }
+
+    //
+    // The first adapter request waits at most the batch wait for other
+    // adapter requests before the batch is sent. The batches are sent
+    // independently, a batch doesn't wait for the previous batch to
+    // complete.
+    //
+    if(!_batchScheduled)
+    {
+        try
+        {
+            instance->timer()->schedule(new BatchAdapterRequestsTimerTask(this), _batchWait);
+        }
+        catch(const IceUtil::Exception&)
+        {
+            return false; // Communicator destroyed, findAdapterById reports the failure.
+        }
+        _batchScheduled = true;
+    }
+    _batchAdapterRequests.push_back(request);
+    return true;
+}
+
+void
+IceInternal::LocatorInfo::sendBatchAdapterRequests()
+{
+    vector<RequestPtr> requests;
+    bool batchRequests;
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        requests.swap(_batchAdapterRequests);
+        _batchScheduled = false;
+        batchRequests = _batchRequests;
+    }
+
+    if(requests.empty())
+    {
+        return;
+    }
+    else if(!batchRequests || requests.size() == 1)
+    {
+        //
+        // Don't use findAdaptersById if the locator doesn't support it
+        // or for a single adapter.
+        //
+        sendFindAdapterById(requests);
+        return;
+    }
+
+    try
+    {
+        StringSeq ids;
+        ids.reserve(requests.size());
+        for(vector<RequestPtr>::const_iterator p = requests.begin(); p != requests.end(); ++p)
+        {
+            ids.push_back(static_cast<AdapterRequest*>(p->get())->getReference()->getAdapterId());
+        }
+
+        const ReferencePtr& ref = static_cast<AdapterRequest*>(requests.front().get())->getReference();
+        if(ref->getInstance()->traceLevels()->location >= 1)
+        {
+            Trace out(ref->getInstance()->initializationData().logger, ref->getInstance()->traceLevels()->locationCat);
+            out << "searching for adapters by id with a single request\nadapters = ";
+            for(StringSeq::const_iterator p = ids.begin(); p != ids.end(); ++p)
+            {
+                if(p != ids.begin())
+                {
+                    out << ", ";
+                }
+                out << *p;
+            }
+        }
+
+        BulkLocatorPrxPtr locator = ICE_UNCHECKED_CAST(BulkLocatorPrx, _locator);
+#ifdef ICE_CPP11_MAPPING
+        LocatorInfoPtr self = this;
+        locator->findAdaptersByIdAsync(ids,
+                                       [self, requests](const ObjectProxySeq& proxies)
+                                       {
+                                           self->batchAdapterRequestsResponse(requests, proxies);
+                                       },
+                                       [self, requests](exception_ptr e)
+                                       {
+                                           try
+                                           {
+                                               rethrow_exception(e);
+                                           }
+                                           catch(const Exception& ex)
+                                           {
+                                               self->batchAdapterRequestsException(requests, ex);
+                                           }
+                                       });
+#else
+        AdapterRequestsCallbackPtr cb = new AdapterRequestsCallback(this, requests);
+        locator->begin_findAdaptersById(ids,
+                                        newCallback_BulkLocator_findAdaptersById(cb,
+                                                                                 &AdapterRequestsCallback::response,
+                                                                                 &AdapterRequestsCallback::exception));
+#endif
+    }
+    catch(const Ice::Exception& ex)
+    {
+        batchAdapterRequestsException(requests, ex);
+    }
+}
+
+void
+IceInternal::LocatorInfo::batchAdapterRequestsResponse(const vector<RequestPtr>& requests,
+                                                       const ObjectProxySeq& proxies)
+{
+    if(proxies.size() != requests.size())
+    {
+        //
+        // The locator failed to resolve the adapters, resolve them one
+        // by one to get the failure of each adapter.
+        //
+        sendFindAdapterById(requests);
+        return;
+    }
+
+    //
+    // An adapter which isn't resolved by the locator is resolved again
+    // with findAdapterById to report AdapterNotFoundException or to use
+    // the locator's fallback for this adapter.
+    //
+    for(vector<RequestPtr>::size_type i = 0; i < requests.size(); ++i)
+    {
+        if(proxies[i])
+        {
+            requests[i]->response(proxies[i]);
+        }
+        else
+        {
+            static_cast<AdapterRequest*>(requests[i].get())->sendFindAdapterById();
+        }
+    }
+}
+
+void
+IceInternal::LocatorInfo::batchAdapterRequestsException(const vector<RequestPtr>& requests, const Ice::Exception& ex)
+{
+    if(dynamic_cast<const Ice::OperationNotExistException*>(&ex))
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        _batchRequests = false;
+    }
+    sendFindAdapterById(requests);
+}
@@ -15,15 +15,19 @@
 #include <IceUtil/Monitor.h>
 #include <IceUtil/Time.h>
 #include <Ice/LocatorInfoF.h>
+#include <Ice/InstanceF.h>
 #include <Ice/LocatorF.h>
 #include <Ice/ReferenceF.h>
 #include <Ice/Identity.h>
+#include <Ice/BuiltinSequences.h>
 #include <Ice/EndpointIF.h>
 #include <Ice/PropertiesF.h>
 #include <Ice/Version.h>
 
 #include <Ice/UniquePtr.h>
 
+#include <list>
+
 namespace IceInternal
 {
 
@@ -44,6 +48,9 @@ public:
 private:
 
     const bool _background;
+    const int _batchWait;
+    const size_t _cacheMaxSize;
+    const int _cacheRefreshAhead;
 
 #ifdef ICE_CPP11_MAPPING
     using LocatorInfoTable = std::map<std::shared_ptr<Ice::LocatorPrx>,
@@ -58,28 +65,110 @@ private:
     std::map<std::pair<Ice::Identity, Ice::EncodingVersion>, LocatorTablePtr> _locatorTables;
 };
 
+//
+// A map of locator cache entries which keeps track of the use of the
+// entries to evict the least recently used entry once the map is full.
+//
+template<typename K, typename V> class LocatorCacheMap
+{
+public:
+
+    struct Entry
+    {
+        IceUtil::Time time;
+        V value;
+        typename std::list<K>::iterator pos;
+    };
+
+    LocatorCacheMap(size_t maxSize) : _maxSize(maxSize)
+    {
+    }
+
+    const Entry*
+    get(const K& key)
+    {
+        typename std::map<K, Entry>::iterator p = _map.find(key);
+        if(p == _map.end())
+        {
+            return 0;
+        }
+        _queue.splice(_queue.end(), _queue, p->second.pos);
+        return &p->second;
+    }
+
+    void
+    add(const K& key, const V& value)
+    {
+        typename std::map<K, Entry>::iterator p = _map.find(key);
+        if(p == _map.end())
+        {
+            p = _map.insert(std::make_pair(key, Entry())).first;
+            p->second.pos = _queue.insert(_queue.end(), key);
+            if(_maxSize > 0 && _map.size() > _maxSize)
+            {
+                _map.erase(_queue.front());
+                _queue.pop_front();
+            }
+        }
+        else
+        {
+            _queue.splice(_queue.end(), _queue, p->second.pos);
+        }
+        p->second.time = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        p->second.value = value;
+    }
+
+    bool
+    remove(const K& key, V& value)
+    {
+        typename std::map<K, Entry>::iterator p = _map.find(key);
+        if(p == _map.end())
+        {
+            return false;
+        }
+        value = p->second.value;
+        _queue.erase(p->second.pos);
+        _map.erase(p);
+        return true;
+    }
+
+    void
+    clear()
+    {
+        _map.clear();
+        _queue.clear();
+    }
+
+private:
+
+    const size_t _maxSize;
+    std::map<K, Entry> _map;
+    std::list<K> _queue;
+};
+
 class LocatorTable : public IceUtil::Shared, public IceUtil::Mutex
 {
 public:
 
-    LocatorTable();
+    LocatorTable(size_t, int);
 
     void clear();
 
-    bool getAdapterEndpoints(const std::string&, int, ::std::vector<EndpointIPtr>&);
+    bool getAdapterEndpoints(const std::string&, int, ::std::vector<EndpointIPtr>&, bool&);
     void addAdapterEndpoints(const std::string&, const ::std::vector<EndpointIPtr>&);
     ::std::vector<EndpointIPtr> removeAdapterEndpoints(const std::string&);
 
-    bool getObjectReference(const Ice::Identity&, int, ReferencePtr&);
+    bool getObjectReference(const Ice::Identity&, int, ReferencePtr&, bool&);
     void addObjectReference(const Ice::Identity&, const ReferencePtr&);
     ReferencePtr removeObjectReference(const Ice::Identity&);
 
 private:
 
-    bool checkTTL(const IceUtil::Time&, int) const;
+    bool checkTTL(const IceUtil::Time&, int, bool&) const;
 
-    std::map<std::string, std::pair<IceUtil::Time, std::vector<EndpointIPtr> > > _adapterEndpointsMap;
-    std::map<Ice::Identity, std::pair<IceUtil::Time, ReferencePtr> > _objectMap;
+    const int _refreshAhead;
+    LocatorCacheMap<std::string, std::vector<EndpointIPtr> > _adapterEndpointsMap;
+    LocatorCacheMap<Ice::Identity, ReferencePtr> _objectMap;
 };
 
 class LocatorInfo : public IceUtil::Shared, public IceUtil::Mutex
@@ -142,7 +231,7 @@ public:
     };
     typedef IceUtil::Handle<Request> RequestPtr;
 
-    LocatorInfo(const Ice::LocatorPrxPtr&, const LocatorTablePtr&, bool);
+    LocatorInfo(const Ice::LocatorPrxPtr&, const LocatorTablePtr&, bool, int);
 
     void destroy();
 
@@ -166,6 +255,11 @@ public:
 
     void clearCache(const ReferencePtr&);
 
+    bool batchAdapterRequest(const RequestPtr&, const InstancePtr&);
+    void sendBatchAdapterRequests();
+    void batchAdapterRequestsResponse(const std::vector<RequestPtr>&, const Ice::ObjectProxySeq&);
+    void batchAdapterRequestsException(const std::vector<RequestPtr>&, const Ice::Exception&);
+
 private:
 
     void getEndpointsException(const ReferencePtr&, const Ice::Exception&);
@@ -187,6 +281,11 @@ private:
 
     std::map<std::string, RequestPtr> _adapterRequests;
     std::map<Ice::Identity, RequestPtr> _objectRequests;
+
+    const IceUtil::Time _batchWait;
+    bool _batchRequests;
+    bool _batchScheduled;
+    std::vector<RequestPtr> _batchAdapterRequests;
 };
 
 }
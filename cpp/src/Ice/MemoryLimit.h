@@ -0,0 +1,206 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2018 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_MEMORY_LIMIT_H
+#define ICE_MEMORY_LIMIT_H
+
+#include <IceUtil/Shared.h>
+#include <IceUtil/Handle.h>
+#include <IceUtil/Mutex.h>
+#include <IceUtil/Atomic.h>
+#include <Ice/Config.h>
+#include <map>
+
+namespace IceInternal
+{
+
+//
+// Keeps track of the memory used by a set of owners (the IceStorm
+// subscriber queues, the Glacier2 routing tables, ...) against a
+// maximum. The memory is only tracked if a maximum is configured.
+//
+// Memory is added and removed for a payload: a payload added by
+// several owners is accounted for with each owner but only counted
+// once in the total. A null payload is never shared.
+//
+// When the total exceeds the maximum, largest() returns the owner which
+// uses the most memory, memory is reclaimed from this owner rather than
+// from the owner which added memory last. The owners are kept ordered
+// by size and largest() doesn't lock unless the maximum is exceeded.
+//
+template<class T> class MemoryLimit : public IceUtil::Shared, private IceUtil::Mutex
+{
+public:
+
+    typedef IceUtil::Handle<T> TPtr;
+
+    MemoryLimit(Ice::Long max) :
+        _max(max),
+        _size(0),
+        _exceeded(0)
+    {
+    }
+
+    bool
+    enabled() const
+    {
+        return _max > 0;
+    }
+
+    Ice::Long
+    max() const
+    {
+        return _max;
+    }
+
+    //
+    // Returns the memory used by all the owners, 0 if no maximum is
+    // configured.
+    //
+    Ice::Long
+    size() const
+    {
+        if(_max <= 0)
+        {
+            return 0;
+        }
+
+        IceUtil::Mutex::Lock sync(*this);
+        return _size;
+    }
+
+    void
+    add(T* owner, const void* payload, Ice::Long size)
+    {
+        if(_max <= 0)
+        {
+            return;
+        }
+
+        IceUtil::Mutex::Lock sync(*this);
+        typename OwnerMap::iterator p = _owners.find(owner);
+        if(p == _owners.end())
+        {
+            p = _owners.insert(typename OwnerMap::value_type(owner, Entry(owner, _bySize.end()))).first;
+        }
+        resize(p, p->second.size + size);
+
+        if(!payload || ++_payloads[payload] == 1)
+        {
+            _size += size;
+            updateExceeded();
+        }
+    }
+
+    void
+    remove(T* owner, const void* payload, Ice::Long size)
+    {
+        if(_max <= 0)
+        {
+            return;
+        }
+
+        IceUtil::Mutex::Lock sync(*this);
+        typename OwnerMap::iterator p = _owners.find(owner);
+        if(p != _owners.end())
+        {
+            if(p->second.size - size <= 0)
+            {
+                _bySize.erase(p->second.position);
+                _owners.erase(p); // Don't keep a reference on owners which no longer use memory.
+            }
+            else
+            {
+                resize(p, p->second.size - size);
+            }
+        }
+
+        if(payload)
+        {
+            std::map<const void*, int>::iterator q = _payloads.find(payload);
+            if(q == _payloads.end() || --q->second > 0)
+            {
+                return;
+            }
+            _payloads.erase(q);
+        }
+        _size -= size;
+        assert(_size >= 0);
+        updateExceeded();
+    }
+
+    //
+    // Returns the owner which uses the most memory if the maximum is
+    // exceeded, null otherwise.
+    //
+    TPtr
+    largest() const
+    {
+        if(_max <= 0 || _exceeded.load() == 0)
+        {
+            return TPtr();
+        }
+
+        IceUtil::Mutex::Lock sync(*this);
+        if(_size <= _max || _bySize.empty())
+        {
+            return TPtr();
+        }
+        return _owners.find(_bySize.rbegin()->second)->second.owner;
+    }
+
+private:
+
+    typedef std::multimap<Ice::Long, T*> SizeMap;
+
+    struct Entry
+    {
+        Entry(T* o, typename SizeMap::iterator p) :
+            owner(o), size(0), position(p)
+        {
+        }
+
+        TPtr owner;
+        Ice::Long size;
+        typename SizeMap::iterator position; // The position of the owner in _bySize.
+    };
+    typedef std::map<T*, Entry> OwnerMap;
+
+    void
+    resize(typename OwnerMap::iterator p, Ice::Long size)
+    {
+        if(p->second.position != _bySize.end())
+        {
+            _bySize.erase(p->second.position);
+        }
+        p->second.size = size;
+        p->second.position = _bySize.insert(typename SizeMap::value_type(size, p->first));
+    }
+
+    void
+    updateExceeded()
+    {
+        bool exceeded = _size > _max;
+        if(exceeded != (_exceeded.load() != 0))
+        {
+            _exceeded.exchange(exceeded ? 1 : 0);
+        }
+    }
+
+    const Ice::Long _max;
+    Ice::Long _size;
+    IceUtilInternal::Atomic _exceeded; // Read without the lock by largest().
+    OwnerMap _owners;
+    SizeMap _bySize;
+    std::map<const void*, int> _payloads;
+};
+
+}
+
+#endif
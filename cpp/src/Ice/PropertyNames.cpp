@@ -6,7 +6,7 @@
 // ICE_LICENSE file included in this distribution.
 //
 // **********************************************************************
-// Generated by makeprops.py from file ./config/PropertyNames.xml, Wed Sep 12 19:11:29 2018
+// Generated by makeprops.py from file ./config/PropertyNames.xml, Sun Oct 18 17:11:16 2026
 
 // IMPORTANT: Do not edit this file -- any edits made here will be lost!
 
@@ -123,6 +123,9 @@ const IceInternal::Property IcePropsData[] =
     IceInternal::Property("Ice.InitPlugins", false, 0),
     IceInternal::Property("Ice.IPv4", false, 0),
     IceInternal::Property("Ice.IPv6", false, 0),
+    IceInternal::Property("Ice.LocatorBatchRequests", false, 0),
+    IceInternal::Property("Ice.LocatorCacheMaxSize", false, 0),
+    IceInternal::Property("Ice.LocatorCacheRefreshAhead", false, 0),
     IceInternal::Property("Ice.LogFile", false, 0),
     IceInternal::Property("Ice.LogFile.SizeMax", false, 0),
     IceInternal::Property("Ice.LogStdErr.Convert", false, 0),
@@ -733,8 +736,11 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Node.CollocateRegistry", false, 0),
     IceInternal::Property("IceGrid.Node.Data", false, 0),
     IceInternal::Property("IceGrid.Node.DisableOnFailure", false, 0),
+    IceInternal::Property("IceGrid.Node.DispatchMetricsPeriod", false, 0),
+    IceInternal::Property("IceGrid.Node.MaxConcurrentActivations", false, 0),
     IceInternal::Property("IceGrid.Node.Name", false, 0),
     IceInternal::Property("IceGrid.Node.Output", false, 0),
+    IceInternal::Property("IceGrid.Node.PeerPatching", false, 0),
     IceInternal::Property("IceGrid.Node.ProcessorSocketCount", false, 0),
     IceInternal::Property("IceGrid.Node.PrintServersReady", false, 0),
     IceInternal::Property("IceGrid.Node.PropertiesOverride", false, 0),
@@ -934,9 +940,12 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.Internal.ThreadPool.ThreadIdleTime", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.ThreadPool.ThreadPriority", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.MessageSizeMax", false, 0),
+    IceInternal::Property("IceGrid.Registry.LMDB.GroupCommit", false, 0),
     IceInternal::Property("IceGrid.Registry.LMDB.MapSize", false, 0),
     IceInternal::Property("IceGrid.Registry.LMDB.Path", false, 0),
+    IceInternal::Property("IceGrid.Registry.NodeObserverCoalescePeriod", false, 0),
     IceInternal::Property("IceGrid.Registry.NodeSessionTimeout", false, 0),
+    IceInternal::Property("IceGrid.Registry.PatchFanOut", false, 0),
     IceInternal::Property("IceGrid.Registry.PermissionsVerifier.EndpointSelection", false, 0),
     IceInternal::Property("IceGrid.Registry.PermissionsVerifier.ConnectionCached", false, 0),
     IceInternal::Property("IceGrid.Registry.PermissionsVerifier.PreferSecure", false, 0),
@@ -1233,11 +1242,15 @@ const IceInternal::Property Glacier2PropsData[] =
     IceInternal::Property("Glacier2.Client.AlwaysBatch", false, 0),
     IceInternal::Property("Glacier2.Client.Buffered", false, 0),
     IceInternal::Property("Glacier2.Client.ForwardContext", false, 0),
+    IceInternal::Property("Glacier2.Client.FlushThreads", false, 0),
     IceInternal::Property("Glacier2.Client.SleepTime", false, 0),
     IceInternal::Property("Glacier2.Client.Trace.Override", false, 0),
     IceInternal::Property("Glacier2.Client.Trace.Reject", false, 0),
     IceInternal::Property("Glacier2.Client.Trace.Request", false, 0),
     IceInternal::Property("Glacier2.CryptPasswords", false, 0),
+    IceInternal::Property("Glacier2.CryptPermissionsVerifier.CacheTimeout", false, 0),
+    IceInternal::Property("Glacier2.CryptPermissionsVerifier.MaxQueueSize", false, 0),
+    IceInternal::Property("Glacier2.CryptPermissionsVerifier.Threads", false, 0),
     IceInternal::Property("Glacier2.Filter.Address.Reject", false, 0),
     IceInternal::Property("Glacier2.Filter.Address.Accept", false, 0),
     IceInternal::Property("Glacier2.Filter.ProxySizeMax", false, 0),
@@ -1267,7 +1280,9 @@ const IceInternal::Property Glacier2PropsData[] =
     IceInternal::Property("Glacier2.SSLPermissionsVerifier.CollocationOptimized", false, 0),
     IceInternal::Property("Glacier2.SSLPermissionsVerifier.Context.*", false, 0),
     IceInternal::Property("Glacier2.SSLPermissionsVerifier", false, 0),
+    IceInternal::Property("Glacier2.RoutingTable.MaxMemory", false, 0),
     IceInternal::Property("Glacier2.RoutingTable.MaxSize", false, 0),
+    IceInternal::Property("Glacier2.RoutingTable.TotalMaxMemory", false, 0),
     IceInternal::Property("Glacier2.Server.ACM.Timeout", false, 0),
     IceInternal::Property("Glacier2.Server.ACM.Heartbeat", false, 0),
     IceInternal::Property("Glacier2.Server.ACM.Close", false, 0),
@@ -1308,6 +1323,7 @@ const IceInternal::Property Glacier2PropsData[] =
     IceInternal::Property("Glacier2.Server.AlwaysBatch", false, 0),
     IceInternal::Property("Glacier2.Server.Buffered", false, 0),
     IceInternal::Property("Glacier2.Server.ForwardContext", false, 0),
+    IceInternal::Property("Glacier2.Server.FlushThreads", false, 0),
     IceInternal::Property("Glacier2.Server.SleepTime", false, 0),
     IceInternal::Property("Glacier2.Server.Trace.Override", false, 0),
     IceInternal::Property("Glacier2.Server.Trace.Request", false, 0),
@@ -6,7 +6,7 @@
 // ICE_LICENSE file included in this distribution.
 //
 // **********************************************************************
-// Generated by makeprops.py from file ./config/PropertyNames.xml, Wed Sep 12 19:11:29 2018
+// Generated by makeprops.py from file ./config/PropertyNames.xml, Sun Oct 18 17:11:16 2026
 
 // IMPORTANT: Do not edit this file -- any edits made here will be lost!
 
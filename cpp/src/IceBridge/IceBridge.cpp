@@ -12,6 +12,7 @@
 #include <Ice/Service.h>
 #include <Ice/UUID.h>
 #include <IceUtil/Options.h>
+#include <IceUtil/Timer.h>
 
 using namespace std;
 using namespace Ice;
@@ -20,37 +21,30 @@ namespace
 {
 
 //
-// Represents a pending invocation.
+// Relays the outcome of forwarded invocations. A single instance is shared by all the invocations
+// forwarded over a bridged connection, the AMD callback of the incoming invocation is passed as
+// the cookie of the outgoing invocation.
 //
-class Invocation : public IceUtil::Shared
+class RelayCallback : public IceUtil::Shared
 {
 public:
 
-    Invocation(const AMD_Object_ice_invokePtr& cb) :
-        _cb(cb)
+    void response(bool ok, const pair<const Byte*, const Byte*>& results, const AMD_Object_ice_invokePtr& cb)
     {
+        cb->ice_response(ok, results);
     }
 
-    void success(bool ok, const pair<const Byte*, const Byte*>& results)
+    void exception(const Exception& ex, const AMD_Object_ice_invokePtr& cb)
     {
-        _cb->ice_response(ok, results);
-    }
-
-    void exception(const Exception& ex)
-    {
-        _cb->ice_exception(ex);
+        cb->ice_exception(ex);
     }
 
-    void sent(bool)
+    void sent(bool, const AMD_Object_ice_invokePtr& cb)
     {
-        _cb->ice_response(true, vector<Byte>()); // For oneway invocations
+        cb->ice_response(true, vector<Byte>()); // For oneway invocations
     }
-
-private:
-
-    const AMD_Object_ice_invokePtr _cb;
 };
-typedef IceUtil::Handle<Invocation> InvocationPtr;
+typedef IceUtil::Handle<RelayCallback> RelayCallbackPtr;
 
 //
 // Holds information about an incoming invocation that's been queued until an outgoing connection has
@@ -176,7 +170,7 @@ class BridgeConnection : public IceUtil::Shared
 {
 public:
 
-    BridgeConnection(const ObjectAdapterPtr&, const ObjectPrx&, const ConnectionPtr&);
+    BridgeConnection(const ObjectAdapterPtr&, const ObjectPrx&, const ConnectionPtr&, const IceUtil::TimerPtr&);
 
     void outgoingSuccess(const ConnectionPtr&);
     void outgoingException(const Exception&);
@@ -184,21 +178,55 @@ public:
     void closed(const ConnectionPtr&);
     void dispatch(const AMD_Object_ice_invokePtr&, const pair<const Byte*, const Byte*>&, const Current&);
 
+    void flushBatchRequests(const ConnectionPtr&);
+
 private:
 
-    void send(const ConnectionPtr&,
+    //
+    // The state used to forward requests over one of the bridged connections.
+    //
+    struct Destination
+    {
+        Destination() : datagram(false), batchRequests(false), flushScheduled(false)
+        {
+        }
+
+        ConnectionPtr connection;
+        bool datagram;
+
+        //
+        // The proxies used to forward requests, cached by identity to avoid creating new proxies
+        // for each request.
+        //
+        map<Identity, ObjectPrx> proxies;
+        map<Identity, ObjectPrx> batchProxies;
+
+        bool batchRequests; // Whether oneway requests are queued with the connection batch request queue.
+        bool flushScheduled;
+    };
+
+    void send(Destination&,
               const AMD_Object_ice_invokePtr&,
               const pair<const Byte*, const Byte*>&,
               const Current&);
 
+    ObjectPrx proxy(Destination&, const Identity&, bool);
+    void flush(Destination&);
+
     const ObjectAdapterPtr _adapter;
     const ObjectPrx _target;
     const ConnectionPtr _incoming;
+    const IceUtil::TimerPtr _timer;
+    const Callback_Object_ice_invokePtr _twowayCallback;
+    const Callback_Object_ice_invokePtr _onewayCallback;
 
     IceUtil::Mutex _lock;
     ConnectionPtr _outgoing;
     IceInternal::UniquePtr<Exception> _exception;
 
+    Destination _toIncoming;
+    Destination _toOutgoing;
+
     //
     // We maintain our own queue for invocations that arrive on the incoming connection before the outgoing
     // connection has been established. We don't want to forward these to proxies and let the proxies handle
@@ -208,6 +236,29 @@ private:
     vector<QueuedInvocationPtr> _queue;
 };
 
+//
+// Flushes the oneway requests queued with the batch request queue of a bridged connection.
+//
+class FlushBatchRequestsTask : public IceUtil::TimerTask
+{
+public:
+
+    FlushBatchRequestsTask(const BridgeConnectionPtr& bc, const ConnectionPtr& con) :
+        _bc(bc), _connection(con)
+    {
+    }
+
+    virtual void runTimerTask()
+    {
+        _bc->flushBatchRequests(_connection);
+    }
+
+private:
+
+    const BridgeConnectionPtr _bc;
+    const ConnectionPtr _connection;
+};
+
 //
 // The main bridge servant.
 //
@@ -215,7 +266,7 @@ class BridgeI : public Ice::BlobjectArrayAsync
 {
 public:
 
-    BridgeI(const ObjectAdapterPtr& adapter, const ObjectPrx& target);
+    BridgeI(const ObjectAdapterPtr&, const ObjectPrx&, const IceUtil::TimerPtr&);
 
     virtual void ice_invoke_async(const AMD_Object_ice_invokePtr&,
                                   const std::pair<const Byte*, const Byte*>&,
@@ -229,6 +280,7 @@ private:
 
     const ObjectAdapterPtr _adapter;
     const ObjectPrx _target;
+    const IceUtil::TimerPtr _timer;
 
     IceUtil::Mutex _lock;
     map<ConnectionPtr, BridgeConnectionPtr> _connections;
@@ -249,6 +301,8 @@ protected:
 private:
 
     void usage(const std::string&);
+
+    IceUtil::TimerPtr _timer;
 };
 
 }
@@ -301,9 +355,21 @@ GetConnectionCallback::exception(const Exception& ex)
     _bridge->outgoingException(_bc, ex);
 }
 
-BridgeConnection::BridgeConnection(const ObjectAdapterPtr& adapter, const ObjectPrx& target, const ConnectionPtr& inc) :
-    _adapter(adapter), _target(target), _incoming(inc)
-{
+BridgeConnection::BridgeConnection(const ObjectAdapterPtr& adapter, const ObjectPrx& target, const ConnectionPtr& inc,
+                                   const IceUtil::TimerPtr& timer) :
+    _adapter(adapter),
+    _target(target),
+    _incoming(inc),
+    _timer(timer),
+    _twowayCallback(newCallback_Object_ice_invoke(RelayCallbackPtr(new RelayCallback),
+                                                  &RelayCallback::response,
+                                                  &RelayCallback::exception)),
+    _onewayCallback(newCallback_Object_ice_invoke(RelayCallbackPtr(new RelayCallback),
+                                                  &RelayCallback::exception,
+                                                  &RelayCallback::sent))
+{
+    _toIncoming.connection = _incoming;
+    _toIncoming.datagram = _incoming->getEndpoint()->getInfo()->datagram();
 }
 
 void
@@ -322,6 +388,8 @@ BridgeConnection::outgoingSuccess(const ConnectionPtr& outgoing)
     }
 
     _outgoing = outgoing;
+    _toOutgoing.connection = _outgoing;
+    _toOutgoing.datagram = _outgoing->getEndpoint()->getInfo()->datagram();
 
     //
     // Register hearbeat callbacks on both connections.
@@ -340,7 +408,7 @@ BridgeConnection::outgoingSuccess(const ConnectionPtr& outgoing)
     for(vector<QueuedInvocationPtr>::const_iterator p = _queue.begin(); p != _queue.end(); ++p)
     {
         pair<const Byte*, const Byte*> paramData(&(*p)->paramData[0], &(*p)->paramData[0] + (*p)->paramData.size());
-        send(outgoing, (*p)->cb, paramData, (*p)->current);
+        send(_toOutgoing, (*p)->cb, paramData, (*p)->current);
     }
     _queue.clear();
 }
@@ -394,6 +462,10 @@ BridgeConnection::closed(const ConnectionPtr& con)
         _exception.reset(ex.ice_clone());
         if(toBeClosed)
         {
+            //
+            // Send the oneway requests still queued for the connection before closing it.
+            //
+            flush(toBeClosed == _incoming ? _toIncoming : _toOutgoing);
             toBeClosed->close(ICE_SCOPED_ENUM(ConnectionClose, Gracefully));
         }
     }
@@ -441,40 +513,60 @@ BridgeConnection::dispatch(const AMD_Object_ice_invokePtr& cb, const pair<const
     }
     else
     {
-        send(current.con == _incoming ? _outgoing : _incoming, cb, paramData, current);
+        send(current.con == _incoming ? _toOutgoing : _toIncoming, cb, paramData, current);
+    }
+}
+
+void
+BridgeConnection::flushBatchRequests(const ConnectionPtr& con)
+{
+    IceUtil::Mutex::Lock lock(_lock);
+    Destination& dest = con == _incoming ? _toIncoming : _toOutgoing;
+    dest.flushScheduled = false;
+    if(!_exception)
+    {
+        flush(dest);
     }
 }
 
 void
-BridgeConnection::send(const ConnectionPtr& dest,
+BridgeConnection::send(Destination& dest,
                        const AMD_Object_ice_invokePtr& cb,
                        const pair<const Byte*, const Byte*>& paramData,
                        const Current& current)
 {
     try
     {
-        //
-        // Create a proxy having the same identity as the request.
-        //
-        ObjectPrx prx = dest->createProxy(current.id);
-
-        //
-        // Examine the request to determine whether it should be forwarded as a oneway or a twoway.
-        //
-        Callback_Object_ice_invokePtr d;
-        if(!current.requestId)
+        if(current.requestId)
         {
-            if(prx->ice_isTwoway())
-            {
-                prx = prx->ice_oneway();
-            }
-            d = newCallback_Object_ice_invoke(new Invocation(cb), &Invocation::exception, &Invocation::sent);
+            //
+            // Send the oneway requests queued before this request first to preserve ordering.
+            //
+            flush(dest);
+            proxy(dest, current.id, false)->begin_ice_invoke(current.operation, current.mode, paramData, current.ctx,
+                                                            _twowayCallback, cb);
+        }
+        else if(dest.datagram)
+        {
+            proxy(dest, current.id, false)->begin_ice_invoke(current.operation, current.mode, paramData, current.ctx,
+                                                            _onewayCallback, cb);
         }
         else
         {
-            d = newCallback_Object_ice_invoke(new Invocation(cb), &Invocation::success, &Invocation::exception);
+            //
+            // Oneway requests are queued with the connection batch request queue, which is flushed by the
+            // timer thread. A burst of oneway requests, such as the requests of a batch, is therefore
+            // forwarded with a few messages rather than with a message per request.
+            //
+            proxy(dest, current.id, true)->begin_ice_invoke(current.operation, current.mode, paramData, current.ctx);
+            dest.batchRequests = true;
+            if(!dest.flushScheduled)
+            {
+                _timer->schedule(new FlushBatchRequestsTask(this, dest.connection), IceUtil::Time());
+                dest.flushScheduled = true;
+            }
+            cb->ice_response(true, vector<Byte>());
         }
-        prx->begin_ice_invoke(current.operation, current.mode, paramData, current.ctx, d);
     }
     catch(const std::exception& ex)
     {
@@ -482,8 +574,56 @@ BridgeConnection::send(const ConnectionPtr& dest,
     }
 }
 
-BridgeI::BridgeI(const ObjectAdapterPtr& adapter, const ObjectPrx& target) :
-    _adapter(adapter), _target(target)
+ObjectPrx
+BridgeConnection::proxy(Destination& dest, const Identity& id, bool batch)
+{
+    map<Identity, ObjectPrx>& proxies = batch ? dest.batchProxies : dest.proxies;
+    map<Identity, ObjectPrx>::const_iterator p = proxies.find(id);
+    if(p != proxies.end())
+    {
+        return p->second;
+    }
+
+    //
+    // The identities are chosen by the peers, we clear the cache rather than let it grow without bounds.
+    //
+    if(proxies.size() >= 1000)
+    {
+        proxies.clear();
+    }
+
+    //
+    // Create a proxy having the same identity as the request. The proxy is a datagram proxy if the connection
+    // is a datagram connection.
+    //
+    ObjectPrx prx = dest.connection->createProxy(id);
+    if(batch)
+    {
+        prx = prx->ice_batchOneway();
+    }
+    proxies.insert(make_pair(id, prx));
+    return prx;
+}
+
+void
+BridgeConnection::flush(Destination& dest)
+{
+    if(dest.batchRequests)
+    {
+        dest.batchRequests = false;
+        try
+        {
+            dest.connection->begin_flushBatchRequests(ICE_SCOPED_ENUM(CompressBatch, BasedOnProxy));
+        }
+        catch(const Ice::LocalException&)
+        {
+            // Ignore, the connection close callback takes care of the failure.
+        }
+    }
+}
+
+BridgeI::BridgeI(const ObjectAdapterPtr& adapter, const ObjectPrx& target, const IceUtil::TimerPtr& timer) :
+    _adapter(adapter), _target(target), _timer(timer)
 {
 }
 
@@ -528,7 +668,7 @@ BridgeI::ice_invoke_async(const AMD_Object_ice_invokePtr& cb,
             //
             target = target->ice_connectionId(Ice::generateUUID());
 
-            bc = new BridgeConnection(_adapter, target, current.con);
+            bc = new BridgeConnection(_adapter, target, current.con, _timer);
             _connections.insert(make_pair(current.con, bc));
             current.con->setCloseCallback(new CloseCallbackI(this));
 
@@ -684,7 +824,12 @@ BridgeService::start(int argc, char* argv[], int& status)
 
     ObjectAdapterPtr adapter = communicator()->createObjectAdapter("IceBridge.Source");
 
-    adapter->addDefaultServant(new BridgeI(adapter, target), "");
+    //
+    // The timer thread flushes the oneway requests queued by the bridged connections.
+    //
+    _timer = new IceUtil::Timer();
+
+    adapter->addDefaultServant(new BridgeI(adapter, target, _timer), "");
 
     string instanceName = properties->getPropertyWithDefault("IceBridge.InstanceName", "IceBridge");
     RouterPrx router = RouterPrx::uncheckedCast(adapter->add(new RouterI, stringToIdentity(instanceName + "/router")));
@@ -711,6 +856,11 @@ BridgeService::start(int argc, char* argv[], int& status)
 bool
 BridgeService::stop()
 {
+    if(_timer)
+    {
+        _timer->destroy();
+        _timer = 0;
+    }
     return true;
 }
 
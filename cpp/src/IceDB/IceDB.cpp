@@ -144,7 +144,7 @@ BadEnvException::ice_throw() const
     throw *this;
 }
 
-Env::Env(const string& path, MDB_dbi maxDbs, size_t mapSize, unsigned int maxReaders)
+Env::Env(const string& path, MDB_dbi maxDbs, size_t mapSize, unsigned int maxReaders, unsigned int flags)
 {
     int rc = mdb_env_create(&_menv);
     if(rc != MDB_SUCCESS)
@@ -193,7 +193,7 @@ Env::Env(const string& path, MDB_dbi maxDbs, size_t mapSize, unsigned int maxRea
         }
     }
 
-    rc = mdb_env_open(_menv, path.c_str(), 0, 0644);
+    rc = mdb_env_open(_menv, path.c_str(), flags, 0644);
     if(rc != MDB_SUCCESS)
     {
         throw LMDBException(__FILE__, __LINE__, rc);
@@ -304,6 +304,73 @@ ReadWriteTxn::ReadWriteTxn(const Env& env) :
 {
 }
 
+GroupCommit::GroupCommit(const Env& env, bool enabled) :
+    _env(env),
+    _enabled(enabled),
+    _committed(0),
+    _synced(0),
+    _syncing(false)
+{
+}
+
+Ice::Long
+GroupCommit::commit(Txn& txn)
+{
+    txn.commit();
+
+    //
+    // The ticket is assigned after the commit: a flush started before
+    // the ticket is assigned flushes the transaction but doesn't
+    // consider it flushed. Tickets are also assigned if group commit is
+    // disabled, callers can use them to order the committed
+    // transactions.
+    //
+    Lock lock(*this);
+    return ++_committed;
+}
+
+void
+GroupCommit::sync(Ice::Long ticket)
+{
+    if(!_enabled)
+    {
+        return;
+    }
+
+    Lock lock(*this);
+    while(_synced < ticket)
+    {
+        if(_syncing)
+        {
+            wait();
+            continue;
+        }
+
+        //
+        // Flush all the transactions committed so far, the writers
+        // waiting for these transactions don't need to flush again.
+        //
+        _syncing = true;
+        Ice::Long committed = _committed;
+        lock.release();
+        const int rc = mdb_env_sync(_env.menv(), 1);
+        lock.acquire();
+        _syncing = false;
+        notifyAll();
+        if(rc != MDB_SUCCESS)
+        {
+            throw LMDBException(__FILE__, __LINE__, rc);
+        }
+        _synced = committed;
+    }
+}
+
+bool
+GroupCommit::enabled() const
+{
+    return _enabled;
+}
+
 DbiBase::DbiBase(const Txn& txn, const std::string& name, unsigned int flags, MDB_cmp_func* cmp)
 {
     int rc = mdb_dbi_open(txn.mtxn(), name.c_str(), flags, &_mdbi);
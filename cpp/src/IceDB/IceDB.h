@@ -12,6 +12,8 @@
 
 #include <IceUtil/Exception.h>
 #include <IceUtil/FileUtil.h>
+#include <IceUtil/Monitor.h>
+#include <IceUtil/Mutex.h>
 #include <Ice/Initialize.h>
 #include <Ice/OutputStream.h>
 #include <Ice/InputStream.h>
@@ -151,7 +153,7 @@ class ICE_DB_API Env
 {
 public:
 
-    explicit Env(const std::string&, MDB_dbi = 0, size_t = 0, unsigned int = 0);
+    explicit Env(const std::string&, MDB_dbi = 0, size_t = 0, unsigned int = 0, unsigned int = 0);
     ~Env();
 
     void close();
@@ -212,6 +214,43 @@ public:
     explicit ReadWriteTxn(const Env&);
 };
 
+//
+// GroupCommit flushes the transactions committed with an environment
+// opened with MDB_NOSYNC: commit() commits the transaction without
+// flushing it and returns a ticket, sync() waits for the transaction
+// with the given ticket to be flushed. The transactions committed while
+// a flush is in progress are flushed together by the next flush, so
+// that concurrent writers share a single sync of the environment.
+//
+// commit() can be called with locks held, sync() should be called once
+// the locks serializing the writers are released. The tickets increase
+// with each commit. If group commit is disabled, commit() commits and
+// flushes the transaction and sync() returns immediately.
+//
+class ICE_DB_API GroupCommit : public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    GroupCommit(const Env&, bool);
+
+    Ice::Long commit(Txn&);
+    void sync(Ice::Long);
+
+    bool enabled() const;
+
+private:
+
+    // Not implemented: class is not copyable
+    GroupCommit(const GroupCommit&);
+    void operator=(const GroupCommit&);
+
+    const Env& _env;
+    const bool _enabled;
+    Ice::Long _committed;
+    Ice::Long _synced;
+    bool _syncing;
+};
+
 class ICE_DB_API DbiBase
 {
 public:
@@ -439,6 +478,27 @@ public:
         return false;
     }
 
+    //
+    // Position the cursor on the first key greater than or equal to
+    // the given key and return this key and its data.
+    //
+    bool findRange(K& key, D& data)
+    {
+        unsigned char kbuf[maxKeySize];
+        MDB_val mkey = {maxKeySize, kbuf};
+        if(Codec<K, C, H>::write(key, mkey, _marshalingContext))
+        {
+            MDB_val mdata;
+            if(CursorBase::get(&mkey, &mdata, MDB_SET_RANGE))
+            {
+                Codec<K, C, H>::read(key, mkey, _marshalingContext);
+                Codec<D, C, H>::read(data, mdata, _marshalingContext);
+                return true;
+            }
+        }
+        return false;
+    }
+
 protected:
 
     C _marshalingContext;
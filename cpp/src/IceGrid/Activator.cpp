@@ -41,6 +41,17 @@
 #   include <grp.h> // for setgroups
 #endif
 
+//
+// posix_spawn_file_actions_addchdir_np and posix_spawn_file_actions_addclosefrom_np
+// are required to spawn the server without forking the node process. They are
+// available with glibc >= 2.34.
+//
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 34))
+#   define ICE_GRID_POSIX_SPAWN
+#   include <spawn.h>
+extern char** environ;
+#endif
+
 using namespace std;
 using namespace Ice;
 using namespace IceInternal;
@@ -105,6 +116,103 @@ reportChildError(int err, int fd, const char* cannot, const char* name, const Tr
     _exit(EXIT_FAILURE);
 }
 
+#ifdef ICE_GRID_POSIX_SPAWN
+//
+// Spawn the server process with posix_spawn. Unlike fork, this doesn't
+// need to copy the address space of the node, which can be costly for a
+// large node process. The server process runs with the node user and
+// group ids. The write end of the termination pipe is duplicated to the
+// file descriptor 3 and all the other file descriptors are closed.
+//
+// The forked child process instead keeps the pipe with its original
+// file descriptor number: it closes the other descriptors one by one,
+// which posix_spawn file actions can't do without knowing which
+// descriptors are open, closefrom requires the pipe to be the lowest
+// descriptor kept. The number doesn't matter to the server, which
+// doesn't use the descriptor: the node only waits for the pipe to be
+// closed by the exit of the server and of the processes it started.
+//
+pid_t
+spawnProcess(const StringSeq& args, const StringSeq& envs, const string& pwd, int pipeFd)
+{
+    //
+    // Merge the server environment variables with the node environment,
+    // the same way putenv does it in the forked child process.
+    //
+    StringSeq env;
+    for(char** p = environ; *p != 0; ++p)
+    {
+        env.push_back(*p);
+    }
+    for(StringSeq::const_iterator p = envs.begin(); p != envs.end(); ++p)
+    {
+        const string prefix = p->substr(0, p->find('=')) + '=';
+        StringSeq::iterator q = env.begin();
+        while(q != env.end())
+        {
+            if(q->compare(0, prefix.size(), prefix) == 0)
+            {
+                q = env.erase(q);
+            }
+            else
+            {
+                ++q;
+            }
+        }
+        if(p->find('=') != string::npos)
+        {
+            env.push_back(*p);
+        }
+    }
+
+    IceInternal::ArgVector av(args);
+    IceInternal::ArgVector ev(env);
+
+    //
+    // Unblock signals blocked by IceUtil::CtrlCHandler and assign a new
+    // process group for the server process.
+    //
+    sigset_t sigs;
+    pthread_sigmask(SIG_SETMASK, 0, &sigs);
+    sigdelset(&sigs, SIGHUP);
+    sigdelset(&sigs, SIGINT);
+    sigdelset(&sigs, SIGTERM);
+
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setsigmask(&attr, &sigs);
+    posix_spawnattr_setpgroup(&attr, 0);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETPGROUP);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    int err = posix_spawn_file_actions_adddup2(&actions, pipeFd, 3);
+    if(err == 0)
+    {
+        err = posix_spawn_file_actions_addclosefrom_np(&actions, 4);
+    }
+    if(err == 0 && !pwd.empty())
+    {
+        err = posix_spawn_file_actions_addchdir_np(&actions, pwd.c_str());
+    }
+
+    pid_t pid = 0;
+    if(err == 0)
+    {
+        err = posix_spawnp(&pid, av.argv[0], &actions, &attr, av.argv, ev.argv);
+    }
+
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+
+    if(err != 0)
+    {
+        throw runtime_error("cannot execute `" + args[0] + "': " + IceUtilInternal::errorToString(err));
+    }
+    return pid;
+}
+#endif
+
 #endif
 
 string
@@ -293,9 +401,11 @@ extern "C" void CALLBACK activatorWaitCallback(PVOID data, BOOLEAN)
 }
 #endif
 
-Activator::Activator(const TraceLevelsPtr& traceLevels) :
+Activator::Activator(const TraceLevelsPtr& traceLevels, int maxActivations) :
     _traceLevels(traceLevels),
-    _deactivating(false)
+    _deactivating(false),
+    _maxActivations(max(maxActivations, 1)),
+    _activations(0)
 {
 #ifdef _WIN32
     _hIntr = CreateEvent(
@@ -352,13 +462,58 @@ Activator::activate(const string& name,
                     const Ice::StringSeq& envs,
                     const ServerIPtr& server)
 {
-    IceUtil::Monitor< IceUtil::Mutex>::Lock sync(*this);
+    //
+    // Server processes are created without holding the activator lock so
+    // that several servers can be activated in parallel. The number of
+    // concurrent activations is bounded by IceGrid.Node.MaxConcurrentActivations.
+    //
+    {
+        IceUtil::Monitor< IceUtil::Mutex>::Lock sync(*this);
+        while(!_deactivating && _activations >= _maxActivations)
+        {
+            wait();
+        }
 
-    if(_deactivating)
+        if(_deactivating)
+        {
+            throw runtime_error("The node is being shutdown.");
+        }
+        ++_activations;
+    }
+
+    try
+    {
+#ifndef _WIN32
+        int pid = activateProcess(name, exePath, pwdPath, uid, gid, options, envs, server);
+#else
+        int pid = activateProcess(name, exePath, pwdPath, options, envs, server);
+#endif
+        IceUtil::Monitor< IceUtil::Mutex>::Lock sync(*this);
+        --_activations;
+        notifyAll();
+        return pid;
+    }
+    catch(...)
     {
-        throw runtime_error("The node is being shutdown.");
+        IceUtil::Monitor< IceUtil::Mutex>::Lock sync(*this);
+        --_activations;
+        notifyAll();
+        throw;
     }
+}
 
+int
+Activator::activateProcess(const string& name,
+                           const string& exePath,
+                           const string& pwdPath,
+#ifndef _WIN32
+                           uid_t uid,
+                           gid_t gid,
+#endif
+                           const Ice::StringSeq& options,
+                           const Ice::StringSeq& envs,
+                           const ServerIPtr& server)
+{
     string path = exePath;
     if(path.empty())
     {
@@ -603,6 +758,8 @@ Activator::activate(const string& name,
     process.pid = pi.dwProcessId;
     process.hnd = pi.hProcess;
     process.server = server;
+
+    IceUtil::Monitor< IceUtil::Mutex>::Lock sync(*this);
     map<string, Process>::iterator it = _processes.insert(make_pair(name, process)).first;
 
     Process* pp = &it->second;
@@ -666,6 +823,48 @@ Activator::activate(const string& name,
         throw SyscallException(__FILE__, __LINE__, getSystemErrno());
     }
 
+#ifdef ICE_GRID_POSIX_SPAWN
+    //
+    // Spawn the process if it runs with the node user and group ids. We
+    // fork if the server environment sets PATH since posix_spawnp looks
+    // up the executable with the node PATH.
+    //
+    bool spawn = uid == getuid() && gid == getgid() && uid != 0;
+    for(StringSeq::const_iterator p = envs.begin(); spawn && p != envs.end(); ++p)
+    {
+        spawn = p->compare(0, 5, "PATH=") != 0;
+    }
+    if(spawn)
+    {
+        pid_t pid;
+        try
+        {
+            pid = spawnProcess(args, envs, pwd, fds[1]);
+        }
+        catch(...)
+        {
+            close(fds[0]);
+            close(fds[1]);
+            throw;
+        }
+        close(fds[1]);
+
+        Process process;
+        process.pid = pid;
+        process.pipeFd = fds[0];
+        process.server = server;
+
+        int flags = fcntl(process.pipeFd, F_GETFL);
+        flags |= O_NONBLOCK;
+        fcntl(process.pipeFd, F_SETFL, flags);
+
+        IceUtil::Monitor< IceUtil::Mutex>::Lock sync(*this);
+        _processes.insert(make_pair(name, process));
+        setInterrupt();
+        return pid;
+    }
+#endif
+
     int errorFds[2];
     if(pipe(errorFds) != 0)
     {
@@ -743,7 +942,8 @@ Activator::activate(const string& name,
         //
         // Close all file descriptors, except for standard input,
         // standard output, standard error, and the write side
-        // of the newly created pipe.
+        // of the newly created pipe. Unlike with posix_spawn, the
+        // pipe keeps its file descriptor number (see spawnProcess).
         //
         int maxFd = static_cast<int>(sysconf(_SC_OPEN_MAX));
         for(int fd = 3; fd < maxFd; ++fd)
@@ -838,12 +1038,13 @@ Activator::activate(const string& name,
         process.pid = pid;
         process.pipeFd = fds[0];
         process.server = server;
-        _processes.insert(make_pair(name, process));
 
         int flags = fcntl(process.pipeFd, F_GETFL);
         flags |= O_NONBLOCK;
         fcntl(process.pipeFd, F_SETFL, flags);
 
+        IceUtil::Monitor< IceUtil::Mutex>::Lock sync(*this);
+        _processes.insert(make_pair(name, process));
         setInterrupt();
 
     //
@@ -1077,6 +1278,15 @@ Activator::destroy()
     {
         IceUtil::Monitor< IceUtil::Mutex>::Lock sync(*this);
         assert(_deactivating);
+
+        //
+        // Wait for pending activations, their process must be stopped
+        // as well.
+        //
+        while(_activations > 0)
+        {
+            wait();
+        }
         processes = _processes;
     }
 
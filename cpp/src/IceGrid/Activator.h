@@ -47,7 +47,7 @@ public:
         ServerIPtr server;
     };
 
-    Activator(const TraceLevelsPtr&);
+    Activator(const TraceLevelsPtr&, int = 4);
     virtual ~Activator();
 
     virtual int activate(const std::string&, const std::string&, const std::string&,
@@ -77,6 +77,12 @@ public:
 
 private:
 
+    int activateProcess(const std::string&, const std::string&, const std::string&,
+#ifndef _WIN32
+                        uid_t, gid_t,
+#endif
+                        const Ice::StringSeq&, const Ice::StringSeq&, const ServerIPtr&);
+
     void terminationListener();
     void clearInterrupt();
     void setInterrupt();
@@ -88,6 +94,8 @@ private:
     TraceLevelsPtr _traceLevels;
     std::map<std::string, Process> _processes;
     bool _deactivating;
+    const int _maxActivations;
+    int _activations;
 
 #ifdef _WIN32
     HANDLE _hIntr;
@@ -462,6 +462,38 @@ ServerAdapterEntry::getPriority() const
     return _priority;
 }
 
+float
+ServerAdapterEntry::getDispatchLoad() const
+{
+    //
+    // The dispatch load is the recent dispatch latency weighted by the
+    // number of requests being dispatched. An adapter without dispatch
+    // load is considered idle so that a new replica gets requests.
+    //
+    try
+    {
+        AdapterDispatchLoad load;
+        if(_server->getDispatchLoad(_id, load))
+        {
+            return load.latency * static_cast<float>(load.current + 1);
+        }
+    }
+    catch(const ServerNotExistException&)
+    {
+        // This might happen if the application is updated concurrently.
+    }
+    catch(const NodeNotExistException&)
+    {
+        // This might happen if the application is updated concurrently.
+    }
+    catch(const Ice::Exception& ex)
+    {
+        Ice::Error error(_cache.getTraceLevels()->logger);
+        error << "unexpected exception while getting adapter dispatch load:\n" << ex;
+    }
+    return 0.0f;
+}
+
 string
 ServerAdapterEntry::getServerId() const
 {
@@ -613,6 +645,7 @@ ReplicaGroupEntry::getLocatorAdapterInfo(LocatorAdapterInfoSeq& adapters, int& n
 {
     vector<ServerAdapterEntryPtr> replicas;
     bool adaptive = false;
+    bool latency = false;
     LoadSample loadSample = LoadSample1;
     {
         Lock sync(*this);
@@ -649,6 +682,12 @@ ReplicaGroupEntry::getLocatorAdapterInfo(LocatorAdapterInfoSeq& adapters, int& n
             loadSample = _loadSample;
             adaptive = true;
         }
+        else if(LatencyLoadBalancingPolicyPtr::dynamicCast(_loadBalancing))
+        {
+            replicas = _replicas;
+            IceUtilInternal::shuffle(replicas.begin(), replicas.end());
+            latency = true;
+        }
         else if(OrderedLoadBalancingPolicyPtr::dynamicCast(_loadBalancing))
         {
             replicas = _replicas;
@@ -680,6 +719,21 @@ ReplicaGroupEntry::getLocatorAdapterInfo(LocatorAdapterInfoSeq& adapters, int& n
             replicas.clear();
             transform(rl.begin(), rl.end(), back_inserter(replicas), TransformToReplica());
         }
+        else if(latency && replicas.size() > 1)
+        {
+            //
+            // Power of two choices: we compare the dispatch load of the
+            // first two replicas of the shuffled replicas and put the
+            // least loaded first. Unlike sorting all the replicas by
+            // load, this doesn't send all the clients to the same
+            // replica until the next dispatch load update from the
+            // nodes. The other replicas remain in random order.
+            //
+            if(replicas[1]->getDispatchLoad() < replicas[0]->getDispatchLoad())
+            {
+                swap(replicas[0], replicas[1]);
+            }
+        }
 
         //
         // Retrieve the proxy of each adapter from the server. The adapter
@@ -88,6 +88,7 @@ public:
     void getLocatorAdapterInfo(LocatorAdapterInfoSeq&) const;
     const std::string& getReplicaGroupId() const { return _replicaGroupId; }
     int getPriority() const;
+    float getDispatchLoad() const;
 
     std::string getServerId() const;
     std::string getNodeName() const;
@@ -138,6 +138,366 @@ private:
     const AmdCB _cb;
 };
 
+//
+// Patches the application distribution of the nodes with a tree
+// fan-out: the origin IcePatch2 server and the nodes which are done
+// patching serve the distribution to at most fanOut nodes at a time
+// (see IceGrid.Node.PeerPatching). A node which fails to patch from
+// another node is patched again from the origin server.
+//
+class FanOutPatcherFeedbackAggregator : public AMDPatcherFeedbackAggregator<AMD_Admin_patchApplicationPtr>
+{
+public:
+
+    FanOutPatcherFeedbackAggregator(const AMD_Admin_patchApplicationPtr& cb,
+                                    Ice::Identity id,
+                                    const TraceLevelsPtr& traceLevels,
+                                    const string& application,
+                                    int nodeCount,
+                                    const string& instanceName,
+                                    int fanOut,
+                                    bool shutdown) :
+        AMDPatcherFeedbackAggregator<AMD_Admin_patchApplicationPtr>(cb, id, traceLevels, "application", application,
+                                                                    nodeCount),
+        _traceLevels(traceLevels),
+        _application(application),
+        _instanceName(instanceName),
+        _fanOut(fanOut),
+        _shutdown(shutdown)
+    {
+    }
+
+    void
+    add(const string& name, const NodeEntryPtr& node, const InternalDistributionDescriptorPtr& distrib)
+    {
+        //
+        // Nodes are grouped by distribution, a node can only serve the
+        // distribution to nodes which patch the same distribution.
+        //
+        ostringstream os;
+        os << distrib->icepatch;
+        for(Ice::StringSeq::const_iterator p = distrib->directories.begin(); p != distrib->directories.end(); ++p)
+        {
+            os << '\n' << *p;
+        }
+
+        IceUtil::Mutex::Lock sync(_fanOutMutex);
+        NodePatch& patch = _nodes[name];
+        patch.name = name;
+        patch.node = node;
+        patch.distrib = distrib;
+        patch.group = os.str();
+        patch.retried = false;
+
+        Group& group = _groups[patch.group];
+        group.pending.push_back(name);
+        group.sources[""] = 0; // The origin server.
+    }
+
+    void
+    start()
+    {
+        vector<pair<string, InternalDistributionDescriptorPtr> > patches;
+        {
+            IceUtil::Mutex::Lock sync(_fanOutMutex);
+            for(map<string, Group>::iterator p = _groups.begin(); p != _groups.end(); ++p)
+            {
+                schedule(p->second, patches);
+            }
+        }
+        patch(patches);
+    }
+
+    virtual void
+    finished(const string& node)
+    {
+        vector<pair<string, InternalDistributionDescriptorPtr> > patches;
+        Ice::ObjectPrx source;
+        {
+            IceUtil::Mutex::Lock sync(_fanOutMutex);
+            map<string, NodePatch>::iterator p = _nodes.find(node);
+            if(p != _nodes.end() && p->second.active)
+            {
+                p->second.active = false;
+                Group& group = _groups[p->second.group];
+                releaseSource(group, p->second.source);
+
+                //
+                // The node can serve the distribution to other nodes if it
+                // patched all the directories of the distribution. We only
+                // use it once it confirmed that it serves the distribution
+                // (the node doesn't if IceGrid.Node.PeerPatching isn't set),
+                // the nodes waiting for a source are scheduled once it
+                // answered.
+                //
+                if(p->second.distrib->directories.empty())
+                {
+                    try
+                    {
+                        Ice::Identity id;
+                        id.category = _instanceName + "-Distrib";
+                        id.name = _application;
+                        source = p->second.node->getSession()->getNode()->ice_identity(id);
+                    }
+                    catch(const Ice::UserException&)
+                    {
+                    }
+                }
+
+                if(!source)
+                {
+                    schedule(group, patches);
+                }
+            }
+        }
+
+        if(source)
+        {
+            source->begin_ice_ping(Ice::newCallback_Object_ice_ping(new SourceCB(this, node, source),
+                                                                    &SourceCB::response,
+                                                                    &SourceCB::exception));
+        }
+        patch(patches);
+        PatcherFeedbackAggregator::finished(node);
+    }
+
+    void
+    sourceReady(const string& node, const Ice::ObjectPrx& source)
+    {
+        vector<pair<string, InternalDistributionDescriptorPtr> > patches;
+        {
+            IceUtil::Mutex::Lock sync(_fanOutMutex);
+            Group& group = _groups[_nodes[node].group];
+            group.sources[node] = 0;
+            group.proxies[node] = source->ice_getCommunicator()->proxyToString(source);
+            schedule(group, patches);
+        }
+        patch(patches);
+    }
+
+    void
+    sourceFailed(const string& node, const Ice::Exception& ex)
+    {
+        if(_traceLevels->patch > 1)
+        {
+            Ice::Trace out(_traceLevels->logger, _traceLevels->patchCat);
+            out << "node `" << node << "' doesn't serve the distribution of application `" << _application << "':\n"
+                << ex;
+        }
+
+        vector<pair<string, InternalDistributionDescriptorPtr> > patches;
+        {
+            IceUtil::Mutex::Lock sync(_fanOutMutex);
+            schedule(_groups[_nodes[node].group], patches);
+        }
+        patch(patches);
+    }
+
+    virtual void
+    failed(const string& node, const string& reason)
+    {
+        vector<pair<string, InternalDistributionDescriptorPtr> > patches;
+        bool retry = false;
+        {
+            IceUtil::Mutex::Lock sync(_fanOutMutex);
+            map<string, NodePatch>::iterator p = _nodes.find(node);
+            if(p != _nodes.end() && p->second.active)
+            {
+                p->second.active = false;
+                Group& group = _groups[p->second.group];
+                releaseSource(group, p->second.source);
+                if(!p->second.source.empty() && !p->second.retried)
+                {
+                    if(_traceLevels->patch > 0)
+                    {
+                        Ice::Trace out(_traceLevels->logger, _traceLevels->patchCat);
+                        out << "patching of application `" << _application << "' on node `" << node
+                            << "' from node `" << p->second.source << "' failed, retrying from the origin server:\n"
+                            << reason;
+                    }
+
+                    //
+                    // Don't use the source node anymore and patch the node
+                    // again from the origin server.
+                    //
+                    group.sources.erase(p->second.source);
+                    group.proxies.erase(p->second.source);
+                    group.retries.push_back(node);
+                    p->second.retried = true;
+                    retry = true;
+                }
+                schedule(group, patches);
+            }
+        }
+        patch(patches);
+        if(!retry)
+        {
+            PatcherFeedbackAggregator::failed(node, reason);
+        }
+    }
+
+private:
+
+    class SourceCB : public IceUtil::Shared
+    {
+    public:
+
+        SourceCB(const IceUtil::Handle<FanOutPatcherFeedbackAggregator>& aggregator, const string& node,
+                 const Ice::ObjectPrx& source) :
+            _aggregator(aggregator), _node(node), _source(source)
+        {
+        }
+
+        void
+        response()
+        {
+            _aggregator->sourceReady(_node, _source);
+        }
+
+        void
+        exception(const Ice::Exception& ex)
+        {
+            _aggregator->sourceFailed(_node, ex);
+        }
+
+    private:
+
+        const IceUtil::Handle<FanOutPatcherFeedbackAggregator> _aggregator;
+        const string _node;
+        const Ice::ObjectPrx _source;
+    };
+
+    struct NodePatch
+    {
+        NodePatch() : retried(false), active(false)
+        {
+        }
+
+        string name;
+        NodeEntryPtr node;
+        InternalDistributionDescriptorPtr distrib;
+        string group;
+        string source;
+        bool retried;
+        bool active;
+    };
+
+    struct Group
+    {
+        deque<string> pending;
+        deque<string> retries;
+        map<string, int> sources; // The number of nodes patched by each source, "" is the origin server.
+        map<string, string> proxies;
+    };
+
+    void
+    releaseSource(Group& group, const string& source)
+    {
+        map<string, int>::iterator p = group.sources.find(source);
+        if(p != group.sources.end())
+        {
+            --p->second;
+        }
+    }
+
+    void
+    schedule(Group& group, vector<pair<string, InternalDistributionDescriptorPtr> >& patches)
+    {
+        //
+        // The nodes to retry are only patched from the origin server,
+        // the other nodes are patched from the nodes serving the
+        // distribution first to offload the origin server.
+        //
+        int& origin = group.sources[""];
+        while(origin < _fanOut && !group.retries.empty())
+        {
+            NodePatch& patch = _nodes[group.retries.front()];
+            group.retries.pop_front();
+            patch.source = "";
+            patch.active = true;
+            ++origin;
+            patches.push_back(make_pair(patch.name, patch.distrib));
+        }
+
+        for(map<string, int>::iterator p = group.sources.begin(); p != group.sources.end() && !group.pending.empty();
+            ++p)
+        {
+            if(p->first.empty())
+            {
+                continue;
+            }
+
+            while(p->second < _fanOut && !group.pending.empty())
+            {
+                NodePatch& patch = _nodes[group.pending.front()];
+                group.pending.pop_front();
+                patch.source = p->first;
+                patch.active = true;
+                ++p->second;
+                InternalDistributionDescriptorPtr distrib =
+                    new InternalDistributionDescriptor(group.proxies[p->first], patch.distrib->directories);
+                patches.push_back(make_pair(patch.name, distrib));
+            }
+        }
+
+        while(origin < _fanOut && !group.pending.empty())
+        {
+            NodePatch& patch = _nodes[group.pending.front()];
+            group.pending.pop_front();
+            patch.source = "";
+            patch.active = true;
+            ++origin;
+            patches.push_back(make_pair(patch.name, patch.distrib));
+        }
+    }
+
+    void
+    patch(const vector<pair<string, InternalDistributionDescriptorPtr> >& patches)
+    {
+        for(vector<pair<string, InternalDistributionDescriptorPtr> >::const_iterator p = patches.begin();
+            p != patches.end(); ++p)
+        {
+            NodeEntryPtr node;
+            {
+                IceUtil::Mutex::Lock sync(_fanOutMutex);
+                node = _nodes[p->first].node;
+            }
+
+            try
+            {
+                if(_traceLevels->patch > 0)
+                {
+                    Ice::Trace out(_traceLevels->logger, _traceLevels->patchCat);
+                    out << "started patching of application `" << _application << "' on node `" << p->first
+                        << "' from `" << p->second->icepatch << "'";
+                }
+                node->getSession()->patch(this, _application, "", p->second, _shutdown);
+            }
+            catch(const NodeUnreachableException& e)
+            {
+                failed(p->first, "node is unreachable: " + e.reason);
+            }
+            catch(const Ice::Exception& e)
+            {
+                ostringstream os;
+                os << e;
+                failed(p->first, "node is unreachable:\n" + os.str());
+            }
+        }
+    }
+
+    const TraceLevelsPtr _traceLevels;
+    const string _application;
+    const string _instanceName;
+    const int _fanOut;
+    const bool _shutdown;
+
+    IceUtil::Mutex _fanOutMutex;
+    map<string, NodePatch> _nodes;
+    map<string, Group> _groups;
+};
+typedef IceUtil::Handle<FanOutPatcherFeedbackAggregator> FanOutPatcherFeedbackAggregatorPtr;
+
 template<typename AmdCB> PatcherFeedbackAggregatorPtr
 static newPatcherFeedback(const AmdCB& cb,
                           Ice::Identity id,
@@ -253,6 +613,51 @@ AdminI::patchApplication_async(const AMD_Admin_patchApplicationPtr& amdCB,
     id.category = current.id.category;
     id.name = Ice::generateUUID();
 
+    int fanOut = _database->getCommunicator()->getProperties()->getPropertyAsInt("IceGrid.Registry.PatchFanOut");
+    if(fanOut > 0 && !appDistrib.icepatch.empty())
+    {
+        FanOutPatcherFeedbackAggregatorPtr feedback =
+            new FanOutPatcherFeedbackAggregator(amdCB, id, _traceLevels, name, static_cast<int>(nodes.size()),
+                                                _database->getInstanceName(), fanOut, shutdown);
+
+        vector<string> failed;
+        vector<string> reasons;
+        for(vector<string>::const_iterator p = nodes.begin(); p != nodes.end(); ++p)
+        {
+            try
+            {
+                NodeEntryPtr node = _database->getNode(*p);
+                Resolver resolve(node->getInfo(), _database->getCommunicator());
+                DistributionDescriptor desc = resolve(appDistrib);
+                feedback->add(*p, node, new InternalDistributionDescriptor(desc.icepatch, desc.directories));
+            }
+            catch(const NodeNotExistException&)
+            {
+                failed.push_back(*p);
+                reasons.push_back("node doesn't exist");
+            }
+            catch(const NodeUnreachableException& e)
+            {
+                failed.push_back(*p);
+                reasons.push_back("node is unreachable: " + e.reason);
+            }
+            catch(const Ice::Exception& e)
+            {
+                ostringstream os;
+                os << e;
+                failed.push_back(*p);
+                reasons.push_back("node is unreachable:\n" + os.str());
+            }
+        }
+
+        feedback->start();
+        for(vector<string>::size_type i = 0; i < failed.size(); ++i)
+        {
+            feedback->failed(failed[i], reasons[i]);
+        }
+        return;
+    }
+
     PatcherFeedbackAggregatorPtr feedback =
         newPatcherFeedback(amdCB, id, _traceLevels, "application", name, static_cast<int>(nodes.size()));
 
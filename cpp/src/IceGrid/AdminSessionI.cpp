@@ -107,7 +107,125 @@ FileIteratorI::read(int size, Ice::StringSeq& lines, const Ice::Current&)
 void
 FileIteratorI::destroy(const Ice::Current& current)
 {
-    _session->removeFileIterator(current.id, current);
+    _session->removeIterator(current.id, current);
+}
+
+ObjectInfoIteratorI::ObjectInfoIteratorI(const AdminSessionIPtr& session,
+                                         const DatabasePtr& database,
+                                         const string& expression) :
+    _session(session),
+    _database(database),
+    _expression(expression),
+    _cacheDone(false),
+    _done(false)
+{
+}
+
+bool
+ObjectInfoIteratorI::next(int max, ObjectInfoSeq& infos, const Ice::Current&)
+{
+    Lock sync(*this);
+    max = max < 1 ? 1 : max; // Always make progress.
+
+    //
+    // The objects from the application descriptors are returned
+    // first, then the objects from the database.
+    //
+    if(!_cacheDone)
+    {
+        _cacheDone = _database->getObjectCache().getPage(_expression, _cursor, max, infos);
+        if(!_cacheDone)
+        {
+            return false;
+        }
+        _cursor = Ice::Identity();
+    }
+    if(!_done)
+    {
+        _done = _database->getObjectInfosPage(_expression, _cursor, max, infos);
+    }
+    return _done;
+}
+
+void
+ObjectInfoIteratorI::destroy(const Ice::Current& current)
+{
+    _session->removeIterator(current.id, current);
+}
+
+ServerIdIteratorI::ServerIdIteratorI(const AdminSessionIPtr& session, const DatabasePtr& database) :
+    _session(session),
+    _database(database),
+    _done(false)
+{
+}
+
+bool
+ServerIdIteratorI::next(int max, Ice::StringSeq& ids, const Ice::Current&)
+{
+    Lock sync(*this);
+    max = max < 1 ? 1 : max; // Always make progress.
+    if(!_done)
+    {
+        _done = _database->getServerCache().getPage("", _cursor, max, ids);
+    }
+    return _done;
+}
+
+void
+ServerIdIteratorI::destroy(const Ice::Current& current)
+{
+    _session->removeIterator(current.id, current);
+}
+
+AdapterIdIteratorI::AdapterIdIteratorI(const AdminSessionIPtr& session, const DatabasePtr& database) :
+    _session(session),
+    _database(database),
+    _cacheDone(false),
+    _databaseDone(false)
+{
+}
+
+bool
+AdapterIdIteratorI::next(int max, Ice::StringSeq& ids, const Ice::Current&)
+{
+    Lock sync(*this);
+    max = max < 1 ? 1 : max; // Always make progress.
+
+    //
+    // The adapters and replica groups from the application descriptors
+    // are returned first, then the adapters from the database and last
+    // the replica groups of these adapters.
+    //
+    if(!_cacheDone)
+    {
+        _cacheDone = _database->getAdapterCache().getPage("", _cursor, max, ids);
+        if(!_cacheDone)
+        {
+            return false;
+        }
+        _cursor.clear();
+    }
+    if(!_databaseDone)
+    {
+        _databaseDone = _database->getAdaptersPage("", _cursor, max, ids, _replicaGroups);
+        if(!_databaseDone)
+        {
+            return false;
+        }
+    }
+    while(!_replicaGroups.empty() && static_cast<int>(ids.size()) < max)
+    {
+        ids.push_back(*_replicaGroups.begin());
+        _replicaGroups.erase(_replicaGroups.begin());
+    }
+    return _replicaGroups.empty();
+}
+
+void
+AdapterIdIteratorI::destroy(const Ice::Current& current)
+{
+    _session->removeIterator(current.id, current);
 }
 
 AdminSessionI::AdminSessionI(const string& id, const DatabasePtr& db, int timeout, const RegistryIPtr& registry) :
@@ -365,6 +483,25 @@ AdminSessionI::openRegistryStdErr(const string& name, int nLines, const Ice::Cur
     return addFileIterator(reader, "stderr", nLines, current);
 }
 
+ObjectInfoIteratorPrx
+AdminSessionI::openObjectInfos(const string& expression, const Ice::Current& current)
+{
+    return ObjectInfoIteratorPrx::uncheckedCast(addIterator(new ObjectInfoIteratorI(this, _database, expression),
+                                                            current));
+}
+
+IdIteratorPrx
+AdminSessionI::openServerIds(const Ice::Current& current)
+{
+    return IdIteratorPrx::uncheckedCast(addIterator(new ServerIdIteratorI(this, _database), current));
+}
+
+IdIteratorPrx
+AdminSessionI::openAdapterIds(const Ice::Current& current)
+{
+    return IdIteratorPrx::uncheckedCast(addIterator(new AdapterIdIteratorI(this, _database), current));
+}
+
 void
 AdminSessionI::destroy(const Ice::Current&)
 {
@@ -448,8 +585,19 @@ AdminSessionI::addFileIterator(const FileReaderPrx& reader, const string& filena
     return FileIteratorPrx::uncheckedCast(obj);
 }
 
+Ice::ObjectPrx
+AdminSessionI::addIterator(const Ice::ObjectPtr& iterator, const Ice::Current& current)
+{
+    Lock sync(*this);
+    if(_destroyed)
+    {
+        throw Ice::ObjectNotExistException(__FILE__, __LINE__, current.id, "", "");
+    }
+    return _servantManager->add(iterator, this);
+}
+
 void
-AdminSessionI::removeFileIterator(const Ice::Identity& id, const Ice::Current&)
+AdminSessionI::removeIterator(const Ice::Identity& id, const Ice::Current&)
 {
     Lock sync(*this);
     _servantManager->remove(id);
@@ -59,9 +59,13 @@ public:
     virtual FileIteratorPrx openRegistryStdOut(const std::string&, int, const Ice::Current&);
     virtual FileIteratorPrx openRegistryStdErr(const std::string&, int, const Ice::Current&);
 
+    virtual ObjectInfoIteratorPrx openObjectInfos(const std::string&, const Ice::Current&);
+    virtual IdIteratorPrx openServerIds(const Ice::Current&);
+    virtual IdIteratorPrx openAdapterIds(const Ice::Current&);
+
     virtual void destroy(const Ice::Current&);
 
-    void removeFileIterator(const Ice::Identity&, const Ice::Current&);
+    void removeIterator(const Ice::Identity&, const Ice::Current&);
 
 private:
 
@@ -69,6 +73,7 @@ private:
     Ice::ObjectPrx addForwarder(const Ice::Identity&, const Ice::Current&);
     Ice::ObjectPrx addForwarder(const Ice::ObjectPrx&);
     FileIteratorPrx addFileIterator(const FileReaderPrx&, const std::string&, int, const Ice::Current&);
+    Ice::ObjectPrx addIterator(const Ice::ObjectPtr&, const Ice::Current&);
 
     virtual void destroyImpl(bool);
 
@@ -147,6 +152,61 @@ private:
     const int _messageSizeMax;
 };
 
+class ObjectInfoIteratorI : public ObjectInfoIterator, public IceUtil::Mutex
+{
+public:
+
+    ObjectInfoIteratorI(const AdminSessionIPtr&, const DatabasePtr&, const std::string&);
+
+    virtual bool next(int, ObjectInfoSeq&, const Ice::Current&);
+    virtual void destroy(const Ice::Current&);
+
+private:
+
+    const AdminSessionIPtr _session;
+    const DatabasePtr _database;
+    const std::string _expression;
+    bool _cacheDone;
+    bool _done;
+    Ice::Identity _cursor;
+};
+
+class ServerIdIteratorI : public IdIterator, public IceUtil::Mutex
+{
+public:
+
+    ServerIdIteratorI(const AdminSessionIPtr&, const DatabasePtr&);
+
+    virtual bool next(int, Ice::StringSeq&, const Ice::Current&);
+    virtual void destroy(const Ice::Current&);
+
+private:
+
+    const AdminSessionIPtr _session;
+    const DatabasePtr _database;
+    bool _done;
+    std::string _cursor;
+};
+
+class AdapterIdIteratorI : public IdIterator, public IceUtil::Mutex
+{
+public:
+
+    AdapterIdIteratorI(const AdminSessionIPtr&, const DatabasePtr&);
+
+    virtual bool next(int, Ice::StringSeq&, const Ice::Current&);
+    virtual void destroy(const Ice::Current&);
+
+private:
+
+    const AdminSessionIPtr _session;
+    const DatabasePtr _database;
+    bool _cacheDone;
+    bool _databaseDone;
+    std::string _cursor;
+    std::set<std::string> _replicaGroups;
+};
+
 };
 
 #endif
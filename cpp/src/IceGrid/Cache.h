@@ -152,6 +152,13 @@ public:
         IceUtil::Monitor<IceUtil::Mutex>::Lock sync(*this);
         return getMatchingKeys<std::map<std::string,TPtr> >(Cache<std::string, T>::_entries, expr);
     }
+
+    bool
+    getPage(const std::string& expr, std::string& cursor, int max, std::vector<std::string>& keys)
+    {
+        IceUtil::Monitor<IceUtil::Mutex>::Lock sync(*this);
+        return getMatchingKeys<std::map<std::string,TPtr> >(Cache<std::string, T>::_entries, expr, cursor, max, keys);
+    }
 };
 
 };
@@ -13,6 +13,7 @@
 #include <Ice/LoggerUtil.h>
 #include <Ice/Communicator.h>
 #include <Ice/ObjectAdapter.h>
+#include <Ice/UUID.h>
 #include <IceGrid/Database.h>
 #include <IceGrid/TraceLevels.h>
 #include <IceGrid/Util.h>
@@ -47,6 +48,7 @@ const string objectsByTypeDbName = "objectsByType";
 const string internalObjectsDbName = "internal-objects";
 const string internalObjectsByTypeDbName = "internal-objectsByType";
 const string serialsDbName = "serials";
+const string generationsDbName = "generations";
 
 struct ObjectLoadCI : binary_function<pair<Ice::ObjectPrx, float>&, pair<Ice::ObjectPrx, float>&, bool>
 {
@@ -212,8 +214,10 @@ Database::Database(const Ice::ObjectAdapterPtr& registryAdapter,
     _allocatableObjectCache(_communicator),
     _serverCache(_communicator, _instanceName, _nodeCache, _adapterCache, _objectCache, _allocatableObjectCache),
     _dbLock(_communicator->getProperties()->getProperty("IceGrid.Registry.LMDB.Path") + "/icedb.lock"),
-    _env(_communicator->getProperties()->getProperty("IceGrid.Registry.LMDB.Path"), 8,
-         IceDB::getMapSize(_communicator->getProperties()->getPropertyAsInt("IceGrid.Registry.LMDB.MapSize"))),
+    _env(_communicator->getProperties()->getProperty("IceGrid.Registry.LMDB.Path"), 9,
+         IceDB::getMapSize(_communicator->getProperties()->getPropertyAsInt("IceGrid.Registry.LMDB.MapSize")), 0,
+         _communicator->getProperties()->getPropertyAsInt("IceGrid.Registry.LMDB.GroupCommit") > 0 ? MDB_NOSYNC : 0),
+    _groupCommit(_env, _communicator->getProperties()->getPropertyAsInt("IceGrid.Registry.LMDB.GroupCommit") > 0),
     _pluginFacade(RegistryPluginFacadeIPtr::dynamicCast(getRegistryPluginFacade())),
     _lock(0)
 {
@@ -236,6 +240,7 @@ Database::Database(const Ice::ObjectAdapterPtr& registryAdapter,
     _internalObjectsByType = StringIdentityMap(txn, internalObjectsByTypeDbName, context, MDB_CREATE|MDB_DUPSORT);
 
     _serials = StringLongMap(txn, serialsDbName, context, MDB_CREATE);
+    _generations = StringStringMap(txn, generationsDbName, context, MDB_CREATE);
 
     ServerEntrySeq entries;
 
@@ -262,7 +267,8 @@ Database::Database(const Ice::ObjectAdapterPtr& registryAdapter,
     _objectCache.setTraceLevels(_traceLevels);
     _allocatableObjectCache.setTraceLevels(_traceLevels);
 
-    _nodeObserverTopic = new NodeObserverTopic(_topicManager, _internalAdapter);
+    _nodeObserverTopic = new NodeObserverTopic(_topicManager, _internalAdapter,
+        _communicator->getProperties()->getPropertyAsInt("IceGrid.Registry.NodeObserverCoalescePeriod"));
     _registryObserverTopic = new RegistryObserverTopic(_topicManager);
 
     _serverCache.setNodeObserverTopic(_nodeObserverTopic);
@@ -282,14 +288,30 @@ Database::Database(const Ice::ObjectAdapterPtr& registryAdapter,
         _serials.put(txn, objectsDbName, 1);
     }
 
+    //
+    // Assign a generation to the databases which don't have one yet
+    // (new databases or databases created by an older registry).
+    //
+    const string dbNames[] = { applicationsDbName, adaptersDbName, objectsDbName };
+    for(size_t i = 0; i < sizeof(dbNames) / sizeof(string); ++i)
+    {
+        if(getGeneration(txn, dbNames[i]).empty())
+        {
+            updateGeneration(txn, dbNames[i], "");
+        }
+    }
+
     _applicationObserverTopic =
-        new ApplicationObserverTopic(_topicManager, toMap(txn, _applications), getSerial(txn, applicationsDbName));
+        new ApplicationObserverTopic(_topicManager, toMap(txn, _applications), getSerial(txn, applicationsDbName),
+                                     getGeneration(txn, applicationsDbName));
     _adapterObserverTopic =
-        new AdapterObserverTopic(_topicManager, toMap(txn, _adapters), getSerial(txn, adaptersDbName));
+        new AdapterObserverTopic(_topicManager, toMap(txn, _adapters), getSerial(txn, adaptersDbName),
+                                 getGeneration(txn, adaptersDbName));
     _objectObserverTopic =
-        new ObjectObserverTopic(_topicManager, toMap(txn, _objects), getSerial(txn, objectsDbName));
+        new ObjectObserverTopic(_topicManager, toMap(txn, _objects), getSerial(txn, objectsDbName),
+                                getGeneration(txn, objectsDbName));
 
-    txn.commit();
+    _groupCommit.sync(_groupCommit.commit(txn));
 
     _registryObserverTopic->registryUp(info);
 
@@ -375,158 +397,187 @@ Database::unlock(AdminSessionI* session)
 }
 
 void
-Database::syncApplications(const ApplicationInfoSeq& newApplications, Ice::Long dbSerial)
+Database::syncApplications(const ApplicationInfoSeq& newApplications, Ice::Long dbSerial, const string& generation)
 {
     assert(dbSerial != 0);
     int serial = 0;
     {
         Lock sync(*this);
 
-        map<string, ApplicationInfo> oldApplications;
-        try
+        //
+        // The replica database doesn't need to be synchronized if it
+        // already has the master database serial and generation.
+        //
+        string dbGeneration = generation;
+        bool upToDate = isUpToDate(applicationsDbName, dbSerial, generation);
+        if(!upToDate)
         {
-            IceDB::ReadWriteTxn txn(_env);
+            map<string, ApplicationInfo> oldApplications;
+            try
+            {
+                IceDB::ReadWriteTxn txn(_env);
 
-            oldApplications = toMap(txn, _applications);
-            _applications.clear(txn);
-            for(ApplicationInfoSeq::const_iterator p = newApplications.begin(); p != newApplications.end(); ++p)
+                oldApplications = toMap(txn, _applications);
+                _applications.clear(txn);
+                for(ApplicationInfoSeq::const_iterator p = newApplications.begin(); p != newApplications.end(); ++p)
+                {
+                    _applications.put(txn, p->descriptor.name, *p);
+                }
+                dbSerial = updateSerial(txn, applicationsDbName, dbSerial);
+                dbGeneration = updateGeneration(txn, applicationsDbName, generation);
+
+                _groupCommit.sync(_groupCommit.commit(txn));
+            }
+            catch(const IceDB::LMDBException& ex)
             {
-                _applications.put(txn, p->descriptor.name, *p);
+                logError(_communicator, ex);
+                throw;
             }
-            dbSerial = updateSerial(txn, applicationsDbName, dbSerial);
 
-            txn.commit();
-        }
-        catch(const IceDB::LMDBException& ex)
-        {
-            logError(_communicator, ex);
-            throw;
-        }
+            _instantiatedApplications.clear();
 
-        ServerEntrySeq entries;
-        set<string> names;
+            ServerEntrySeq entries;
+            set<string> names;
 
-        for(ApplicationInfoSeq::const_iterator p = newApplications.begin(); p != newApplications.end(); ++p)
-        {
-            try
+            for(ApplicationInfoSeq::const_iterator p = newApplications.begin(); p != newApplications.end(); ++p)
             {
-                map<string, ApplicationInfo>::const_iterator q = oldApplications.find(p->descriptor.name);
-                if(q != oldApplications.end())
+                try
                 {
-                    ApplicationHelper previous(_communicator, q->second.descriptor);
-                    ApplicationHelper helper(_communicator, p->descriptor);
-                    reload(previous, helper, entries, p->uuid, p->revision, false);
+                    map<string, ApplicationInfo>::const_iterator q = oldApplications.find(p->descriptor.name);
+                    if(q != oldApplications.end())
+                    {
+                        ApplicationHelper previous(_communicator, q->second.descriptor);
+                        ApplicationHelper helper(_communicator, p->descriptor);
+                        reload(previous, helper, entries, p->uuid, p->revision, false);
+                    }
+                    else
+                    {
+                        load(ApplicationHelper(_communicator, p->descriptor), entries, p->uuid, p->revision);
+                    }
                 }
-                else
+                catch(const DeploymentException& ex)
                 {
-                    load(ApplicationHelper(_communicator, p->descriptor), entries, p->uuid, p->revision);
+                    Ice::Warning warn(_traceLevels->logger);
+                    warn << "invalid application `" << p->descriptor.name << "':\n" << ex.reason;
                 }
+                names.insert(p->descriptor.name);
             }
-            catch(const DeploymentException& ex)
-            {
-                Ice::Warning warn(_traceLevels->logger);
-                warn << "invalid application `" << p->descriptor.name << "':\n" << ex.reason;
-            }
-            names.insert(p->descriptor.name);
-        }
 
-        for(map<string, ApplicationInfo>::iterator s = oldApplications.begin(); s != oldApplications.end(); ++s)
-        {
-            if(names.find(s->first) == names.end())
+            for(map<string, ApplicationInfo>::iterator s = oldApplications.begin(); s != oldApplications.end(); ++s)
             {
-                unload(ApplicationHelper(_communicator, s->second.descriptor), entries);
+                if(names.find(s->first) == names.end())
+                {
+                    unload(ApplicationHelper(_communicator, s->second.descriptor), entries);
+                }
             }
-        }
 
-        for_each(entries.begin(), entries.end(), IceUtil::voidMemFun(&ServerEntry::sync));
+            for_each(entries.begin(), entries.end(), IceUtil::voidMemFun(&ServerEntry::sync));
+        }
 
         if(_traceLevels->application > 0)
         {
             Ice::Trace out(_traceLevels->logger, _traceLevels->applicationCat);
-            out << "synchronized applications (serial = `" << dbSerial << "')";
+            out << (upToDate ? "applications already synchronized" : "synchronized applications");
+            out << " (serial = `" << dbSerial << "')";
         }
 
-        serial = _applicationObserverTopic->applicationInit(dbSerial, newApplications);
+        serial = _applicationObserverTopic->applicationInit(dbSerial, dbGeneration, newApplications);
     }
     _applicationObserverTopic->waitForSyncedSubscribers(serial);
 }
 
 void
-Database::syncAdapters(const AdapterInfoSeq& adapters, Ice::Long dbSerial)
+Database::syncAdapters(const AdapterInfoSeq& adapters, Ice::Long dbSerial, const string& generation)
 {
     assert(dbSerial != 0);
     int serial = 0;
     {
         Lock sync(*this);
-        try
+        string dbGeneration = generation;
+        bool upToDate = isUpToDate(adaptersDbName, dbSerial, generation);
+        if(!upToDate)
         {
-            IceDB::ReadWriteTxn txn(_env);
+            try
+            {
+                IceDB::ReadWriteTxn txn(_env);
 
-            _adapters.clear(txn);
-            _adaptersByGroupId.clear(txn);
-            for(AdapterInfoSeq::const_iterator r = adapters.begin(); r != adapters.end(); ++r)
+                _adapters.clear(txn);
+                _adaptersByGroupId.clear(txn);
+                for(AdapterInfoSeq::const_iterator r = adapters.begin(); r != adapters.end(); ++r)
+                {
+                    addAdapter(txn, *r);
+                }
+                dbSerial = updateSerial(txn, adaptersDbName, dbSerial);
+                dbGeneration = updateGeneration(txn, adaptersDbName, generation);
+
+                _groupCommit.sync(_groupCommit.commit(txn));
+            }
+            catch(const IceDB::KeyTooLongException&)
             {
-                addAdapter(txn, *r);
+                throw;
+            }
+            catch(const IceDB::LMDBException& ex)
+            {
+                logError(_communicator, ex);
+                throw;
             }
-            dbSerial = updateSerial(txn, adaptersDbName, dbSerial);
-
-            txn.commit();
-        }
-        catch(const IceDB::KeyTooLongException&)
-        {
-            throw;
-        }
-        catch(const IceDB::LMDBException& ex)
-        {
-            logError(_communicator, ex);
-            throw;
         }
 
         if(_traceLevels->adapter > 0)
         {
             Ice::Trace out(_traceLevels->logger, _traceLevels->adapterCat);
-            out << "synchronized adapters (serial = `" << dbSerial << "')";
+            out << (upToDate ? "adapters already synchronized" : "synchronized adapters");
+            out << " (serial = `" << dbSerial << "')";
         }
 
-        serial = _adapterObserverTopic->adapterInit(dbSerial, adapters);
+        waitForPublished();
+        serial = _adapterObserverTopic->adapterInit(dbSerial, dbGeneration, adapters);
     }
     _adapterObserverTopic->waitForSyncedSubscribers(serial);
 }
 
 void
-Database::syncObjects(const ObjectInfoSeq& objects, Ice::Long dbSerial)
+Database::syncObjects(const ObjectInfoSeq& objects, Ice::Long dbSerial, const string& generation)
 {
     assert(dbSerial != 0);
     int serial = 0;
     {
         Lock sync(*this);
-        try
+        string dbGeneration = generation;
+        bool upToDate = isUpToDate(objectsDbName, dbSerial, generation);
+        if(!upToDate)
         {
-            IceDB::ReadWriteTxn txn(_env);
+            try
+            {
+                IceDB::ReadWriteTxn txn(_env);
+
+                _objects.clear(txn);
+                _objectsByType.clear(txn);
+                for(ObjectInfoSeq::const_iterator q = objects.begin(); q != objects.end(); ++q)
+                {
+                    addObject(txn, *q, false);
+                }
+                dbSerial = updateSerial(txn, objectsDbName, dbSerial);
+                dbGeneration = updateGeneration(txn, objectsDbName, generation);
 
-            _objects.clear(txn);
-            _objectsByType.clear(txn);
-            for(ObjectInfoSeq::const_iterator q = objects.begin(); q != objects.end(); ++q)
+                _groupCommit.sync(_groupCommit.commit(txn));
+            }
+            catch(const IceDB::LMDBException& ex)
             {
-                addObject(txn, *q, false);
+                logError(_communicator, ex);
+                throw;
             }
-            dbSerial = updateSerial(txn, objectsDbName, dbSerial);
-
-            txn.commit();
-        }
-        catch(const IceDB::LMDBException& ex)
-        {
-            logError(_communicator, ex);
-            throw;
         }
 
         if(_traceLevels->object > 0)
         {
             Ice::Trace out(_traceLevels->logger, _traceLevels->objectCat);
-            out << "synchronized objects (serial = `" << dbSerial << "')";
+            out << (upToDate ? "objects already synchronized" : "synchronized objects");
+            out << " (serial = `" << dbSerial << "')";
         }
 
-        serial = _objectObserverTopic->objectInit(dbSerial, objects);
+        waitForPublished();
+        serial = _objectObserverTopic->objectInit(dbSerial, dbGeneration, objects);
     }
     _objectObserverTopic->waitForSyncedSubscribers(serial);
 }
@@ -620,7 +671,7 @@ Database::addApplication(const ApplicationInfo& info, AdminSessionI* session, Ic
         checkForAddition(helper, txn);
         dbSerial = saveApplication(info, txn, dbSerial);
 
-        txn.commit();
+        _groupCommit.sync(_groupCommit.commit(txn));
 
         load(helper, entries, info.uuid, info.revision);
         startUpdating(info.descriptor.name, info.uuid, info.revision);
@@ -677,7 +728,7 @@ Database::addApplication(const ApplicationInfo& info, AdminSessionI* session, Ic
 
                 IceDB::ReadWriteTxn txn(_env);
                 dbSerial = removeApplication(info.descriptor.name, txn);
-                txn.commit();
+                _groupCommit.sync(_groupCommit.commit(txn));
 
                 for_each(entries.begin(), entries.end(), IceUtil::voidMemFun(&ServerEntry::sync));
                 serial = _applicationObserverTopic->applicationRemoved(dbSerial, info.descriptor.name);
@@ -715,8 +766,8 @@ Database::updateApplication(const ApplicationUpdateInfo& updt, bool noRestart, A
 
     ApplicationInfo oldApp;
     ApplicationUpdateInfo update = updt;
-    IceInternal::UniquePtr<ApplicationHelper> previous;
-    IceInternal::UniquePtr<ApplicationHelper> helper;
+    ApplicationHelperPtr previous;
+    ApplicationHelperPtr helper;
     try
     {
         Lock sync(*this);
@@ -736,8 +787,7 @@ Database::updateApplication(const ApplicationUpdateInfo& updt, bool noRestart, A
             update.revision = oldApp.revision + 1;
         }
 
-        previous.reset(new ApplicationHelper(_communicator, oldApp.descriptor));
-        helper.reset(new ApplicationHelper(_communicator, previous->update(update.descriptor), true));
+        previous = getApplicationHelper(oldApp);
 
         startUpdating(update.descriptor.name, oldApp.uuid, oldApp.revision + 1);
     }
@@ -747,7 +797,27 @@ Database::updateApplication(const ApplicationUpdateInfo& updt, bool noRestart, A
         throw;
     }
 
-    finishApplicationUpdate(update, oldApp, *previous, *helper, session, noRestart, dbSerial);
+    //
+    // The application can't be updated by another thread once it's
+    // marked as updating, so we instantiate it without holding the
+    // database lock. Only the nodes affected by the update are
+    // instantiated again.
+    //
+    try
+    {
+        if(!previous)
+        {
+            previous = new ApplicationHelper(_communicator, oldApp.descriptor);
+        }
+        helper = new ApplicationHelper(*previous, update.descriptor, true);
+    }
+    catch(...)
+    {
+        finishUpdating(update.descriptor.name);
+        throw;
+    }
+
+    finishApplicationUpdate(update, oldApp, *previous, helper, session, noRestart, dbSerial);
 }
 
 void
@@ -757,8 +827,8 @@ Database::syncApplicationDescriptor(const ApplicationDescriptor& newDesc, bool n
 
     ApplicationUpdateInfo update;
     ApplicationInfo oldApp;
-    IceInternal::UniquePtr<ApplicationHelper> previous;
-    IceInternal::UniquePtr<ApplicationHelper> helper;
+    ApplicationHelperPtr previous;
+    ApplicationHelperPtr helper;
     try
     {
         Lock sync(*this);
@@ -773,8 +843,12 @@ Database::syncApplicationDescriptor(const ApplicationDescriptor& newDesc, bool n
             throw ApplicationNotExistException(newDesc.name);
         }
 
-        previous.reset(new ApplicationHelper(_communicator, oldApp.descriptor));
-        helper.reset(new ApplicationHelper(_communicator, newDesc, true));
+        previous = getApplicationHelper(oldApp);
+        if(!previous)
+        {
+            previous = new ApplicationHelper(_communicator, oldApp.descriptor);
+        }
+        helper = new ApplicationHelper(_communicator, newDesc, true);
 
         update.updateTime = IceUtil::Time::now().toMilliSeconds();
         update.updateUser = _lockUserId;
@@ -789,7 +863,7 @@ Database::syncApplicationDescriptor(const ApplicationDescriptor& newDesc, bool n
         throw;
     }
 
-    finishApplicationUpdate(update, oldApp, *previous, *helper, session, noRestart);
+    finishApplicationUpdate(update, oldApp, *previous, helper, session, noRestart);
 }
 
 void
@@ -802,8 +876,8 @@ Database::instantiateServer(const string& application,
 
     ApplicationUpdateInfo update;
     ApplicationInfo oldApp;
-    IceInternal::UniquePtr<ApplicationHelper> previous;
-    IceInternal::UniquePtr<ApplicationHelper> helper;
+    ApplicationHelperPtr previous;
+    ApplicationHelperPtr helper;
 
     try
     {
@@ -819,8 +893,12 @@ Database::instantiateServer(const string& application,
             throw ApplicationNotExistException(application);
         }
 
-        previous.reset(new ApplicationHelper(_communicator, oldApp.descriptor));
-        helper.reset(new ApplicationHelper(_communicator, previous->instantiateServer(node, instance), true));
+        previous = getApplicationHelper(oldApp);
+        if(!previous)
+        {
+            previous = new ApplicationHelper(_communicator, oldApp.descriptor);
+        }
+        helper = new ApplicationHelper(_communicator, previous->instantiateServer(node, instance), true);
 
         update.updateTime = IceUtil::Time::now().toMilliSeconds();
         update.updateUser = _lockUserId;
@@ -835,7 +913,7 @@ Database::instantiateServer(const string& application,
         throw;
     }
 
-    finishApplicationUpdate(update, oldApp, *previous, *helper, session, true);
+    finishApplicationUpdate(update, oldApp, *previous, helper, session, true);
 }
 
 void
@@ -878,7 +956,9 @@ Database::removeApplication(const string& name, AdminSessionI* session, Ice::Lon
         }
         dbSerial = removeApplication(name, txn, dbSerial);
 
-        txn.commit();
+        _groupCommit.sync(_groupCommit.commit(txn));
+
+        _instantiatedApplications.erase(name);
 
         startUpdating(name, appInfo.uuid, appInfo.revision);
 
@@ -981,6 +1061,18 @@ Database::getServer(const string& id) const
     return _serverCache.get(id);
 }
 
+AdapterCache&
+Database::getAdapterCache()
+{
+    return _adapterCache;
+}
+
+ObjectCache&
+Database::getObjectCache()
+{
+    return _objectCache;
+}
+
 AllocatableObjectCache&
 Database::getAllocatableObjectCache()
 {
@@ -1000,6 +1092,9 @@ Database::setAdapterDirectProxy(const string& adapterId, const string& replicaGr
     assert(dbSerial != 0 || _master);
 
     int serial = 0; // Initialize to prevent warning.
+    PublishTicket ticket(*this);
+    AdapterInfo info;
+    bool updated = false;
     {
         Lock sync(*this);
         if(_adapterCache.has(adapterId))
@@ -1014,12 +1109,10 @@ Database::setAdapterDirectProxy(const string& adapterId, const string& replicaGr
                                       "can be member of this replica group");
         }
 
-        AdapterInfo info;
         info.id = adapterId;
         info.proxy = proxy;
         info.replicaGroupId = replicaGroupId;
 
-        bool updated = false;
         try
         {
             IceDB::ReadWriteTxn txn(_env);
@@ -1046,7 +1139,7 @@ Database::setAdapterDirectProxy(const string& adapterId, const string& replicaGr
             }
             dbSerial = updateSerial(txn, adaptersDbName, dbSerial);
 
-            txn.commit();
+            ticket.commit(txn);
         }
         catch(const IceDB::KeyTooLongException&)
         {
@@ -1068,23 +1161,25 @@ Database::setAdapterDirectProxy(const string& adapterId, const string& replicaGr
             }
             out << " (serial = `" << dbSerial << "')";
         }
+    }
 
-        if(proxy)
+    ticket.wait();
+    if(proxy)
+    {
+        if(updated)
         {
-            if(updated)
-            {
-                serial = _adapterObserverTopic->adapterUpdated(dbSerial, info);
-            }
-            else
-            {
-                serial = _adapterObserverTopic->adapterAdded(dbSerial, info);
-            }
+            serial = _adapterObserverTopic->adapterUpdated(dbSerial, info);
         }
         else
         {
-            serial = _adapterObserverTopic->adapterRemoved(dbSerial, adapterId);
+            serial = _adapterObserverTopic->adapterAdded(dbSerial, info);
         }
     }
+    else
+    {
+        serial = _adapterObserverTopic->adapterRemoved(dbSerial, adapterId);
+    }
+    ticket.finish();
     _adapterObserverTopic->waitForSyncedSubscribers(serial);
 }
 
@@ -1129,6 +1224,9 @@ Database::removeAdapter(const string& adapterId)
     assert(_master);
 
     int serial = 0; // Initialize to prevent warning.
+    PublishTicket ticket(*this);
+    AdapterInfoSeq infos;
+    Ice::Long dbSerial = 0;
     {
         Lock sync(*this);
         if(_adapterCache.has(adapterId))
@@ -1139,8 +1237,6 @@ Database::removeAdapter(const string& adapterId)
                                       adpt->getApplication() + "'");
         }
 
-        AdapterInfoSeq infos;
-        Ice::Long dbSerial = 0;
         try
         {
             IceDB::ReadWriteTxn txn(_env);
@@ -1166,7 +1262,7 @@ Database::removeAdapter(const string& adapterId)
             }
             dbSerial = updateSerial(txn, adaptersDbName);
 
-            txn.commit();
+            ticket.commit(txn);
         }
         catch(const IceDB::KeyTooLongException&)
         {
@@ -1183,19 +1279,21 @@ Database::removeAdapter(const string& adapterId)
             Ice::Trace out(_traceLevels->logger, _traceLevels->adapterCat);
             out << "removed " << (infos.empty() ? "adapter" : "replica group") << " `" << adapterId << "' (serial = `" << dbSerial << "')";
         }
+    }
 
-        if(infos.empty())
-        {
-            serial = _adapterObserverTopic->adapterRemoved(dbSerial, adapterId);
-        }
-        else
+    ticket.wait();
+    if(infos.empty())
+    {
+        serial = _adapterObserverTopic->adapterRemoved(dbSerial, adapterId);
+    }
+    else
+    {
+        for(AdapterInfoSeq::const_iterator p = infos.begin(); p != infos.end(); ++p)
         {
-            for(AdapterInfoSeq::const_iterator p = infos.begin(); p != infos.end(); ++p)
-            {
-                serial = _adapterObserverTopic->adapterUpdated(dbSerial, *p);
-            }
+            serial = _adapterObserverTopic->adapterUpdated(dbSerial, *p);
         }
     }
+    ticket.finish();
     _adapterObserverTopic->waitForSyncedSubscribers(serial);
 }
 
@@ -1455,12 +1553,61 @@ Database::getAllAdapters(const string& expression)
     return result;
 }
 
+bool
+Database::getAdaptersPage(const string& expression, string& cursor, int max, Ice::StringSeq& ids,
+                          set<string>& groups)
+{
+    //
+    // Returns the ids of the adapters from the database following the
+    // cursor. The replica group ids of these adapters are added to the
+    // given set, it's the caller responsibility to return them once
+    // all the adapters have been visited.
+    //
+    IceDB::ReadOnlyTxn txn(_env);
+
+    string name = cursor;
+    AdapterInfo info;
+    AdapterMapROCursor dbCursor(_adapters, txn);
+    bool found;
+    if(cursor.empty())
+    {
+        found = dbCursor.get(name, info, MDB_FIRST);
+    }
+    else
+    {
+        found = dbCursor.findRange(name, info);
+        if(found && name == cursor)
+        {
+            found = dbCursor.get(name, info, MDB_NEXT);
+        }
+    }
+
+    while(found && static_cast<int>(ids.size()) < max)
+    {
+        if(expression.empty() || IceUtilInternal::match(name, expression, true))
+        {
+            ids.push_back(name);
+        }
+        string replicaGroupId = info.replicaGroupId;
+        if(!replicaGroupId.empty() && (expression.empty() || IceUtilInternal::match(replicaGroupId, expression, true)))
+        {
+            groups.insert(replicaGroupId);
+        }
+        cursor = name;
+        found = dbCursor.get(name, info, MDB_NEXT);
+    }
+    dbCursor.close();
+    return !found;
+}
+
 void
 Database::addObject(const ObjectInfo& info)
 {
     assert(_master);
 
     int serial = 0;
+    PublishTicket ticket(*this);
+    Ice::Long dbSerial = 0;
     {
         Lock sync(*this);
         const Ice::Identity id = info.proxy->ice_getIdentity();
@@ -1470,7 +1617,6 @@ Database::addObject(const ObjectInfo& info)
             throw ObjectExistsException(id);
         }
 
-        Ice::Long dbSerial = 0;
         try
         {
             IceDB::ReadWriteTxn txn(_env);
@@ -1482,7 +1628,7 @@ Database::addObject(const ObjectInfo& info)
             addObject(txn, info, false);
             dbSerial = updateSerial(txn, objectsDbName);
 
-            txn.commit();
+            ticket.commit(txn);
         }
         catch(const IceDB::LMDBException& ex)
         {
@@ -1490,14 +1636,16 @@ Database::addObject(const ObjectInfo& info)
             throw;
         }
 
-        serial = _objectObserverTopic->objectAdded(dbSerial, info);
-
         if(_traceLevels->object > 0)
         {
             Ice::Trace out(_traceLevels->logger, _traceLevels->objectCat);
             out << "added object `" << _communicator->identityToString(id) << "' (serial = `" << dbSerial << "')";
         }
     }
+
+    ticket.wait();
+    serial = _objectObserverTopic->objectAdded(dbSerial, info);
+    ticket.finish();
     _objectObserverTopic->waitForSyncedSubscribers(serial);
 }
 
@@ -1507,6 +1655,8 @@ Database::addOrUpdateObject(const ObjectInfo& info, Ice::Long dbSerial)
     assert(dbSerial != 0 || _master);
 
     int serial = 0; // Initialize to prevent warning.
+    PublishTicket ticket(*this);
+    bool update = false;
     {
         Lock sync(*this);
         const Ice::Identity id = info.proxy->ice_getIdentity();
@@ -1516,7 +1666,6 @@ Database::addOrUpdateObject(const ObjectInfo& info, Ice::Long dbSerial)
             throw ObjectExistsException(id);
         }
 
-        bool update = false;
         try
         {
             IceDB::ReadWriteTxn txn(_env);
@@ -1531,7 +1680,7 @@ Database::addOrUpdateObject(const ObjectInfo& info, Ice::Long dbSerial)
             addObject(txn, info, false);
             dbSerial = updateSerial(txn, objectsDbName, dbSerial);
 
-            txn.commit();
+            ticket.commit(txn);
         }
         catch(const IceDB::LMDBException& ex)
         {
@@ -1539,21 +1688,23 @@ Database::addOrUpdateObject(const ObjectInfo& info, Ice::Long dbSerial)
             throw;
         }
 
-        if(update)
-        {
-            serial = _objectObserverTopic->objectUpdated(dbSerial, info);
-        }
-        else
-        {
-            serial = _objectObserverTopic->objectAdded(dbSerial, info);
-        }
-
         if(_traceLevels->object > 0)
         {
             Ice::Trace out(_traceLevels->logger, _traceLevels->objectCat);
             out << (!update ? "added" : "updated") << " object `" << _communicator->identityToString(id) << "' (serial = `" << dbSerial << "')";
         }
     }
+
+    ticket.wait();
+    if(update)
+    {
+        serial = _objectObserverTopic->objectUpdated(dbSerial, info);
+    }
+    else
+    {
+        serial = _objectObserverTopic->objectAdded(dbSerial, info);
+    }
+    ticket.finish();
     _objectObserverTopic->waitForSyncedSubscribers(serial);
 }
 
@@ -1563,6 +1714,7 @@ Database::removeObject(const Ice::Identity& id, Ice::Long dbSerial)
     assert(dbSerial != 0 || _master);
 
     int serial = 0; // Initialize to prevent warning.
+    PublishTicket ticket(*this);
     {
         Lock sync(*this);
         if(_objectCache.has(id))
@@ -1584,7 +1736,7 @@ Database::removeObject(const Ice::Identity& id, Ice::Long dbSerial)
             deleteObject(txn, info, false);
             dbSerial = updateSerial(txn, objectsDbName, dbSerial);
 
-            txn.commit();
+            ticket.commit(txn);
         }
         catch(const IceDB::LMDBException& ex)
         {
@@ -1592,14 +1744,16 @@ Database::removeObject(const Ice::Identity& id, Ice::Long dbSerial)
             throw;
         }
 
-        serial = _objectObserverTopic->objectRemoved(dbSerial, id);
-
         if(_traceLevels->object > 0)
         {
             Ice::Trace out(_traceLevels->logger, _traceLevels->objectCat);
             out << "removed object `" << _communicator->identityToString(id) << "' (serial = `" << dbSerial << "')";
         }
     }
+
+    ticket.wait();
+    serial = _objectObserverTopic->objectRemoved(dbSerial, id);
+    ticket.finish();
     _objectObserverTopic->waitForSyncedSubscribers(serial);
 }
 
@@ -1609,6 +1763,9 @@ Database::updateObject(const Ice::ObjectPrx& proxy)
     assert(_master);
 
     int serial = 0;
+    PublishTicket ticket(*this);
+    ObjectInfo info;
+    Ice::Long dbSerial = 0;
     {
         Lock sync(*this);
 
@@ -1620,8 +1777,6 @@ Database::updateObject(const Ice::ObjectPrx& proxy)
                                       _objectCache.get(id)->getApplication() + "'");
         }
 
-        ObjectInfo info;
-        Ice::Long dbSerial = 0;
         try
         {
             IceDB::ReadWriteTxn txn(_env);
@@ -1634,7 +1789,7 @@ Database::updateObject(const Ice::ObjectPrx& proxy)
             addObject(txn, info, false);
             dbSerial = updateSerial(txn, objectsDbName);
 
-            txn.commit();
+            ticket.commit(txn);
         }
         catch(const IceDB::LMDBException& ex)
         {
@@ -1642,13 +1797,16 @@ Database::updateObject(const Ice::ObjectPrx& proxy)
             throw;
         }
 
-        serial = _objectObserverTopic->objectUpdated(dbSerial, info);
         if(_traceLevels->object > 0)
         {
             Ice::Trace out(_traceLevels->logger, _traceLevels->objectCat);
             out << "updated object `" << _communicator->identityToString(id) << "' (serial = `" << dbSerial << "')";
         }
     }
+
+    ticket.wait();
+    serial = _objectObserverTopic->objectUpdated(dbSerial, info);
+    ticket.finish();
     _objectObserverTopic->waitForSyncedSubscribers(serial);
 }
 
@@ -1669,7 +1827,7 @@ Database::addOrUpdateRegistryWellKnownObjects(const ObjectInfoSeq& objects)
             }
             addObject(txn, *p, false);
         }
-        txn.commit();
+        _groupCommit.sync(_groupCommit.commit(txn));
     }
     catch(const IceDB::LMDBException& ex)
     {
@@ -1696,7 +1854,7 @@ Database::removeRegistryWellKnownObjects(const ObjectInfoSeq& objects)
                 deleteObject(txn, info, false);
             }
         }
-        txn.commit();
+        _groupCommit.sync(_groupCommit.commit(txn));
     }
     catch(const IceDB::LMDBException& ex)
     {
@@ -1848,6 +2006,41 @@ Database::getAllObjectInfos(const string& expression)
     return infos;
 }
 
+bool
+Database::getObjectInfosPage(const string& expression, Ice::Identity& cursor, int max, ObjectInfoSeq& infos)
+{
+    IceDB::ReadOnlyTxn txn(_env);
+
+    Ice::Identity id = cursor;
+    ObjectInfo info;
+    ObjectsMapROCursor dbCursor(_objects, txn);
+    bool found;
+    if(cursor.name.empty())
+    {
+        found = dbCursor.get(id, info, MDB_FIRST);
+    }
+    else
+    {
+        found = dbCursor.findRange(id, info);
+        if(found && id == cursor)
+        {
+            found = dbCursor.get(id, info, MDB_NEXT);
+        }
+    }
+
+    while(found && static_cast<int>(infos.size()) < max)
+    {
+        if(expression.empty() || IceUtilInternal::match(_communicator->identityToString(id), expression, true))
+        {
+            infos.push_back(info);
+        }
+        cursor = id;
+        found = dbCursor.get(id, info, MDB_NEXT);
+    }
+    dbCursor.close();
+    return !found;
+}
+
 ObjectInfoSeq
 Database::getObjectInfosByType(const string& type)
 {
@@ -1883,7 +2076,7 @@ Database::addInternalObject(const ObjectInfo& info, bool replace)
         }
         addObject(txn, info, true);
 
-        txn.commit();
+        _groupCommit.sync(_groupCommit.commit(txn));
     }
     catch(const IceDB::LMDBException& ex)
     {
@@ -1908,7 +2101,7 @@ Database::removeInternalObject(const Ice::Identity& id)
         }
         deleteObject(txn, info, true);
 
-        txn.commit();
+        _groupCommit.sync(_groupCommit.commit(txn));
     }
     catch(const IceDB::LMDBException& ex)
     {
@@ -1931,6 +2124,129 @@ Database::getInternalObjectsByType(const string& type)
     return proxies;
 }
 
+bool
+Database::isUpToDate(const string& dbName, Ice::Long dbSerial, const string& generation)
+{
+    //
+    // The serials of databases with a different generation can match
+    // while the databases differ (if the master database was re-created
+    // for example). The database is considered out of date if the
+    // master doesn't provide its generation.
+    //
+    if(dbSerial <= 0 || generation.empty())
+    {
+        return false;
+    }
+
+    try
+    {
+        IceDB::ReadOnlyTxn txn(_env);
+        return getSerial(txn, dbName) == dbSerial && getGeneration(txn, dbName) == generation;
+    }
+    catch(const IceDB::LMDBException& ex)
+    {
+        logError(_communicator, ex);
+        throw;
+    }
+}
+
+Ice::Long
+Database::commitForPublish(IceDB::ReadWriteTxn& txn)
+{
+    //
+    // Must be called with the database lock held, the updates are
+    // published in the order of their commit.
+    //
+    Ice::Long ticket = _groupCommit.commit(txn);
+    IceUtil::Monitor<IceUtil::Mutex>::Lock sync(_publishMonitor);
+    _unpublished.insert(ticket);
+    return ticket;
+}
+
+void
+Database::waitForPublish(Ice::Long ticket)
+{
+    //
+    // An update is only published to the observers and replicas once
+    // its transaction is flushed and once the updates committed before
+    // it are published. With group commit, the flush is shared with the
+    // updates committed concurrently.
+    //
+    try
+    {
+        _groupCommit.sync(ticket);
+    }
+    catch(const IceDB::LMDBException& ex)
+    {
+        logError(_communicator, ex);
+        throw;
+    }
+
+    IceUtil::Monitor<IceUtil::Mutex>::Lock sync(_publishMonitor);
+    while(*_unpublished.begin() != ticket)
+    {
+        _publishMonitor.wait();
+    }
+}
+
+void
+Database::finishPublish(Ice::Long ticket)
+{
+    IceUtil::Monitor<IceUtil::Mutex>::Lock sync(_publishMonitor);
+    _unpublished.erase(ticket);
+    _publishMonitor.notifyAll();
+}
+
+Database::PublishTicket::PublishTicket(Database& database) :
+    _database(database),
+    _ticket(0)
+{
+}
+
+Database::PublishTicket::~PublishTicket()
+{
+    //
+    // Release the ticket if the update isn't published because of an
+    // exception, otherwise the updates committed after it would never
+    // be published.
+    //
+    finish();
+}
+
+void
+Database::PublishTicket::commit(IceDB::ReadWriteTxn& txn)
+{
+    assert(_ticket == 0);
+    _ticket = _database.commitForPublish(txn);
+}
+
+void
+Database::PublishTicket::wait()
+{
+    assert(_ticket != 0);
+    _database.waitForPublish(_ticket);
+}
+
+void
+Database::PublishTicket::finish()
+{
+    if(_ticket != 0)
+    {
+        _database.finishPublish(_ticket);
+        _ticket = 0;
+    }
+}
+
+void
+Database::waitForPublished()
+{
+    IceUtil::Monitor<IceUtil::Mutex>::Lock sync(_publishMonitor);
+    while(!_unpublished.empty())
+    {
+        _publishMonitor.wait();
+    }
+}
+
 void
 Database::checkForAddition(const ApplicationHelper& app, const IceDB::ReadWriteTxn& txn)
 {
@@ -2531,12 +2847,12 @@ void
 Database::finishApplicationUpdate(const ApplicationUpdateInfo& update,
                                   const ApplicationInfo& oldApp,
                                   const ApplicationHelper& previous,
-                                  const ApplicationHelper& helper,
+                                  const ApplicationHelperPtr& helper,
                                   AdminSessionI* /*session*/,
                                   bool noRestart,
                                   Ice::Long dbSerial)
 {
-    const ApplicationDescriptor& newDesc = helper.getDefinition();
+    const ApplicationDescriptor& newDesc = helper->getDefinition();
 
     ServerEntrySeq entries;
     int serial = 0;
@@ -2544,15 +2860,15 @@ Database::finishApplicationUpdate(const ApplicationUpdateInfo& update,
     {
         if(_master)
         {
-            checkUpdate(previous, helper, oldApp.uuid, oldApp.revision, noRestart);
+            checkUpdate(previous, *helper, oldApp.uuid, oldApp.revision, noRestart);
         }
 
         Lock sync(*this);
 
         IceDB::ReadWriteTxn txn(_env);
 
-        checkForUpdate(previous, helper, txn);
-        reload(previous, helper, entries, oldApp.uuid, oldApp.revision + 1, noRestart);
+        checkForUpdate(previous, *helper, txn);
+        reload(previous, *helper, entries, oldApp.uuid, oldApp.revision + 1, noRestart);
 
         for_each(entries.begin(), entries.end(), IceUtil::voidMemFun(&ServerEntry::sync));
 
@@ -2563,7 +2879,13 @@ Database::finishApplicationUpdate(const ApplicationUpdateInfo& update,
         info.descriptor = newDesc;
         dbSerial = saveApplication(info, txn, dbSerial);
 
-        txn.commit();
+        _groupCommit.sync(_groupCommit.commit(txn));
+
+        InstantiatedApplication instantiated;
+        instantiated.uuid = info.uuid;
+        instantiated.revision = info.revision;
+        instantiated.helper = helper;
+        _instantiatedApplications[info.descriptor.name] = instantiated;
 
         serial = _applicationObserverTopic->applicationUpdated(dbSerial, update);
     }
@@ -2619,11 +2941,13 @@ Database::finishApplicationUpdate(const ApplicationUpdateInfo& update,
                 ApplicationInfo info = oldApp;
                 info.revision = update.revision + 1;
 
+                _instantiatedApplications.erase(info.descriptor.name);
+
                 try
                 {
                     IceDB::ReadWriteTxn txn(_env);
                     dbSerial = saveApplication(info, txn);
-                    txn.commit();
+                    _groupCommit.sync(_groupCommit.commit(txn));
                 }
                 catch(const IceDB::LMDBException& ex)
                 {
@@ -2660,6 +2984,18 @@ Database::finishApplicationUpdate(const ApplicationUpdateInfo& update,
     finishUpdating(update.descriptor.name);
 }
 
+ApplicationHelperPtr
+Database::getApplicationHelper(const ApplicationInfo& info) const
+{
+    // Must be called within the synchronization.
+    map<string, InstantiatedApplication>::const_iterator p = _instantiatedApplications.find(info.descriptor.name);
+    if(p != _instantiatedApplications.end() && p->second.uuid == info.uuid && p->second.revision == info.revision)
+    {
+        return p->second.helper;
+    }
+    return 0;
+}
+
 void
 Database::waitForUpdate(const string& name)
 {
@@ -2722,6 +3058,26 @@ Database::updateSerial(const IceDB::ReadWriteTxn& txn, const string& dbName, Ice
     }
 }
 
+string
+Database::getGeneration(const IceDB::Txn& txn, const string& dbName)
+{
+    string generation;
+    _generations.get(txn, dbName, generation);
+    return generation;
+}
+
+string
+Database::updateGeneration(const IceDB::ReadWriteTxn& txn, const string& dbName, const string& generation)
+{
+    //
+    // A database synchronized from a master which doesn't provide its
+    // generation gets a new generation.
+    //
+    string dbGeneration = generation.empty() ? Ice::generateUUID() : generation;
+    _generations.put(txn, dbName, dbGeneration);
+    return dbGeneration;
+}
+
 void
 Database::addAdapter(const IceDB::ReadWriteTxn& txn, const AdapterInfo& info)
 {
@@ -82,9 +82,9 @@ public:
     int lock(AdminSessionI*, const std::string&);
     void unlock(AdminSessionI*);
 
-    void syncApplications(const ApplicationInfoSeq&, Ice::Long);
-    void syncAdapters(const AdapterInfoSeq&, Ice::Long);
-    void syncObjects(const ObjectInfoSeq&, Ice::Long);
+    void syncApplications(const ApplicationInfoSeq&, Ice::Long, const std::string&);
+    void syncAdapters(const AdapterInfoSeq&, Ice::Long, const std::string&);
+    void syncObjects(const ObjectInfoSeq&, Ice::Long, const std::string&);
 
     ApplicationInfoSeq getApplications(Ice::Long&);
     AdapterInfoSeq getAdapters(Ice::Long&);
@@ -110,6 +110,9 @@ public:
     ServerCache& getServerCache();
     ServerEntryPtr getServer(const std::string&) const;
 
+    AdapterCache& getAdapterCache();
+    ObjectCache& getObjectCache();
+
     AllocatableObjectCache& getAllocatableObjectCache();
     AllocatableObjectEntryPtr getAllocatableObject(const Ice::Identity&) const;
 
@@ -133,6 +136,7 @@ public:
     std::string getAdapterApplication(const std::string&) const;
     std::string getAdapterNode(const std::string&) const;
     Ice::StringSeq getAllAdapters(const std::string& = std::string());
+    bool getAdaptersPage(const std::string&, std::string&, int, Ice::StringSeq&, std::set<std::string>&);
 
     void addObject(const ObjectInfo&);
     void addOrUpdateObject(const ObjectInfo&, Ice::Long = 0);
@@ -154,6 +158,7 @@ public:
     ObjectInfo getObjectInfo(const Ice::Identity&);
     ObjectInfoSeq getObjectInfosByType(const std::string&);
     ObjectInfoSeq getAllObjectInfos(const std::string& = std::string());
+    bool getObjectInfosPage(const std::string&, Ice::Identity&, int, ObjectInfoSeq&);
 
     void addInternalObject(const ObjectInfo&, bool = false);
     void removeInternalObject(const Ice::Identity&);
@@ -161,6 +166,34 @@ public:
 
 private:
 
+    //
+    // The ticket of an update committed with commitForPublish, the
+    // destructor releases the ticket if finish() isn't called.
+    //
+    class PublishTicket : private IceUtil::noncopyable
+    {
+    public:
+
+        PublishTicket(Database&);
+        ~PublishTicket();
+
+        void commit(IceDB::ReadWriteTxn&);
+        void wait();
+        void finish();
+
+    private:
+
+        Database& _database;
+        Ice::Long _ticket;
+    };
+    friend class PublishTicket;
+
+    Ice::Long commitForPublish(IceDB::ReadWriteTxn&);
+    void waitForPublish(Ice::Long);
+    void finishPublish(Ice::Long);
+    void waitForPublished();
+    bool isUpToDate(const std::string&, Ice::Long, const std::string&);
+
     void checkForAddition(const ApplicationHelper&, const IceDB::ReadWriteTxn&);
     void checkForUpdate(const ApplicationHelper&, const ApplicationHelper&, const IceDB::ReadWriteTxn&);
     void checkForRemove(const ApplicationHelper&);
@@ -181,7 +214,9 @@ private:
     Ice::Long removeApplication(const std::string&, const IceDB::ReadWriteTxn&, Ice::Long = 0);
 
     void finishApplicationUpdate(const ApplicationUpdateInfo&, const ApplicationInfo&, const ApplicationHelper&,
-                                 const ApplicationHelper&, AdminSessionI*, bool, Ice::Long = 0);
+                                 const ApplicationHelperPtr&, AdminSessionI*, bool, Ice::Long = 0);
+
+    ApplicationHelperPtr getApplicationHelper(const ApplicationInfo&) const;
 
     void checkSessionLock(AdminSessionI*);
 
@@ -191,6 +226,8 @@ private:
 
     Ice::Long getSerial(const IceDB::Txn&, const std::string&);
     Ice::Long updateSerial(const IceDB::ReadWriteTxn&, const std::string&, Ice::Long = 0);
+    std::string getGeneration(const IceDB::Txn&, const std::string&);
+    std::string updateGeneration(const IceDB::ReadWriteTxn&, const std::string&, const std::string&);
 
     void addAdapter(const IceDB::ReadWriteTxn&, const AdapterInfo&);
     void deleteAdapter(const IceDB::ReadWriteTxn&, const AdapterInfo&);
@@ -229,6 +266,9 @@ private:
 
     IceUtilInternal::FileLock _dbLock;
     IceDB::Env _env;
+    IceDB::GroupCommit _groupCommit;
+    IceUtil::Monitor<IceUtil::Mutex> _publishMonitor;
+    std::set<Ice::Long> _unpublished;
 
     StringApplicationInfoMap _applications;
 
@@ -242,6 +282,7 @@ private:
     StringIdentityMap _internalObjectsByType;
 
     StringLongMap _serials;
+    StringStringMap _generations;
 
     RegistryPluginFacadeIPtr _pluginFacade;
 
@@ -287,6 +328,18 @@ private:
         }
     };
     std::vector<UpdateInfo> _updating;
+
+    //
+    // The instantiated helper of the latest revision of each application,
+    // the next update of the application is instantiated from it.
+    //
+    struct InstantiatedApplication
+    {
+        std::string uuid;
+        int revision;
+        ApplicationHelperPtr helper;
+    };
+    std::map<std::string, InstantiatedApplication> _instantiatedApplications;
 };
 typedef IceUtil::Handle<Database> DatabasePtr;
 
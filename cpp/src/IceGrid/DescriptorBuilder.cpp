@@ -300,6 +300,10 @@ ApplicationDescriptorBuilder::setLoadBalancing(const XmlAttributesHelper& attrs)
         alb->loadSample = attrs("load-sample", "1");
         policy = alb;
     }
+    else if(type == "latency")
+    {
+        policy = new LatencyLoadBalancingPolicy();
+    }
     else
     {
         throw invalid_argument("invalid load balancing policy `" + type + "'");
@@ -2660,13 +2660,76 @@ ApplicationHelper::ApplicationHelper(const Ice::CommunicatorPtr& communicator,
                                      bool instantiate) :
     _communicator(communicator),
     _def(desc)
+{
+    init(enableWarning, instantiate, NodeHelperDict(), set<string>());
+}
+
+ApplicationHelper::ApplicationHelper(const ApplicationHelper& previous,
+                                     const ApplicationUpdateDescriptor& update,
+                                     bool enableWarning) :
+    _communicator(previous._communicator),
+    _def(previous.update(update))
+{
+    //
+    // Only the nodes which are updated or which use an updated server
+    // template are instantiated, the other nodes are re-used from the
+    // previous instantiation. If the update changes the application
+    // variables, property sets or service templates, all the nodes are
+    // instantiated since they might depend on them.
+    //
+    set<string> reused;
+    if(update.variables.empty() && update.removeVariables.empty() &&
+       update.propertySets.empty() && update.removePropertySets.empty() &&
+       update.serviceTemplates.empty() && update.removeServiceTemplates.empty())
+    {
+        set<string> templates(update.removeServerTemplates.begin(), update.removeServerTemplates.end());
+        for(TemplateDescriptorDict::const_iterator t = update.serverTemplates.begin();
+            t != update.serverTemplates.end(); ++t)
+        {
+            templates.insert(t->first);
+        }
+
+        set<string> updated;
+        for(NodeUpdateDescriptorSeq::const_iterator p = update.nodes.begin(); p != update.nodes.end(); ++p)
+        {
+            updated.insert(p->name);
+        }
+
+        for(NodeHelperDict::const_iterator n = previous._nodes.begin(); n != previous._nodes.end(); ++n)
+        {
+            if(updated.find(n->first) != updated.end() || _def.nodes.find(n->first) == _def.nodes.end())
+            {
+                continue;
+            }
+
+            const ServerInstanceDescriptorSeq& instances = n->second.getDefinition().serverInstances;
+            ServerInstanceDescriptorSeq::const_iterator q;
+            for(q = instances.begin(); q != instances.end(); ++q)
+            {
+                if(templates.find(q->_cpp_template) != templates.end())
+                {
+                    break;
+                }
+            }
+            if(q == instances.end())
+            {
+                reused.insert(n->first);
+            }
+        }
+    }
+
+    init(enableWarning, true, previous._nodes, reused);
+}
+
+void
+ApplicationHelper::init(bool enableWarning, bool instantiate, const NodeHelperDict& nodes, const set<string>& reused)
 {
     if(_def.name.empty())
     {
         throw DeploymentException("invalid application: empty name");
     }
 
-    Resolver resolve(_def, communicator, enableWarning);
+    Resolver resolve(_def, _communicator, enableWarning);
 
     if(instantiate)
     {
@@ -2731,7 +2794,16 @@ ApplicationHelper::ApplicationHelper(const Ice::CommunicatorPtr& communicator,
     NodeHelperDict::const_iterator n;
     for(NodeDescriptorDict::const_iterator p = _def.nodes.begin(); p != _def.nodes.end(); ++p)
     {
-        n = _nodes.insert(make_pair(p->first, NodeHelper(p->first, p->second, resolve, instantiate))).first;
+        if(reused.find(p->first) != reused.end())
+        {
+            NodeHelperDict::const_iterator q = nodes.find(p->first);
+            assert(q != nodes.end());
+            n = _nodes.insert(*q).first;
+        }
+        else
+        {
+            n = _nodes.insert(make_pair(p->first, NodeHelper(p->first, p->second, resolve, instantiate))).first;
+        }
         if(instantiate)
         {
             _instance.nodes.insert(make_pair(n->first, n->second.getInstance()));
@@ -2874,7 +2946,6 @@ ApplicationHelper::update(const ApplicationUpdateDescriptor& updt) const
         NodeHelperDict::const_iterator q = _nodes.find(p->name);
         if(q != _nodes.end()) // Updated node
         {
-            NodeDescriptor desc = q->second.update(*p, resolve);
             def.nodes.insert(make_pair(p->name, q->second.update(*p, resolve)));
         }
         else // New node
@@ -3120,6 +3191,10 @@ ApplicationHelper::print(Output& out, const ApplicationInfo& info) const
             {
                 out << "adaptive" ;
             }
+            else if(LatencyLoadBalancingPolicyPtr::dynamicCast(p->loadBalancing))
+            {
+                out << "latency";
+            }
             else
             {
                 out << "<unknown load balancing policy>";
@@ -310,11 +310,12 @@ private:
     ServerInstanceHelperDict _servers;
 };
 
-class ApplicationHelper
+class ApplicationHelper : public IceUtil::Shared
 {
 public:
 
     ApplicationHelper(const Ice::CommunicatorPtr&, const ApplicationDescriptor&, bool = false, bool = true);
+    ApplicationHelper(const ApplicationHelper&, const ApplicationUpdateDescriptor&, bool = false);
 
     ApplicationUpdateDescriptor diff(const ApplicationHelper&) const;
     ApplicationDescriptor update(const ApplicationUpdateDescriptor&) const;
@@ -332,13 +333,17 @@ public:
 
 private:
 
+    typedef std::map<std::string, NodeHelper> NodeHelperDict;
+
+    void init(bool, bool, const NodeHelperDict&, const std::set<std::string>&);
+
     Ice::CommunicatorPtr _communicator;
     ApplicationDescriptor _def;
     ApplicationDescriptor _instance;
 
-    typedef std::map<std::string, NodeHelper> NodeHelperDict;
     NodeHelperDict _nodes;
 };
+typedef IceUtil::Handle<ApplicationHelper> ApplicationHelperPtr;
 
 bool descriptorEqual(const ServerDescriptorPtr&, const ServerDescriptorPtr&, bool = false);
 ServerHelperPtr createHelper(const ServerDescriptorPtr&);
@@ -288,7 +288,8 @@ NodeService::startImpl(int argc, char* argv[], int& status)
     // Create the activator.
     //
     TraceLevelsPtr traceLevels = new TraceLevels(communicator(), "IceGrid.Node");
-    _activator = new Activator(traceLevels);
+    _activator = new Activator(traceLevels,
+                               properties->getPropertyAsIntWithDefault("IceGrid.Node.MaxConcurrentActivations", 4));
 
     //
     // Collocate the IceGrid registry if we need to.
@@ -490,6 +491,11 @@ NodeService::startImpl(int argc, char* argv[], int& status)
     //
     _sessions->create(_node);
 
+    //
+    // Start the periodic updates of the adapter dispatch loads if enabled.
+    //
+    _node->startDispatchLoadUpdates();
+
     //
     // Create Admin unless there is a collocated registry with its own Admin
     //
@@ -151,6 +151,83 @@ private:
     const Ice::ObjectPrx _obj;
 };
 
+//
+// Collects the responses of the LocatorI::findAdapterById_async()
+// calls made for each adapter by LocatorI::findAdaptersById_async().
+//
+class FindAdaptersByIdCallback : public IceUtil::Mutex, public IceUtil::Shared
+{
+public:
+
+    FindAdaptersByIdCallback(const Ice::AMD_BulkLocator_findAdaptersByIdPtr& cb, size_t count) :
+        _cb(cb),
+        _proxies(count),
+        _count(count)
+    {
+    }
+
+    void
+    response(size_t index, const Ice::ObjectPrx& proxy)
+    {
+        {
+            Lock sync(*this);
+            _proxies[index] = proxy;
+            if(--_count > 0)
+            {
+                return;
+            }
+        }
+        _cb->ice_response(_proxies);
+    }
+
+private:
+
+    const Ice::AMD_BulkLocator_findAdaptersByIdPtr _cb;
+    Ice::ObjectProxySeq _proxies;
+    size_t _count;
+};
+typedef IceUtil::Handle<FindAdaptersByIdCallback> FindAdaptersByIdCallbackPtr;
+
+class FindAdaptersByIdEntryCallback : public Ice::AMD_Locator_findAdapterById
+{
+public:
+
+    FindAdaptersByIdEntryCallback(const FindAdaptersByIdCallbackPtr& cb, size_t index) :
+        _cb(cb),
+        _index(index)
+    {
+    }
+
+    virtual void ice_response(const ::Ice::ObjectPrx& obj)
+    {
+        _cb->response(_index, obj);
+    }
+
+    virtual void ice_exception(const ::Ice::Exception&)
+    {
+        //
+        // The adapter couldn't be found, the client can still call
+        // findAdapterById to get the exception.
+        //
+        _cb->response(_index, 0);
+    }
+
+    virtual void ice_exception(const std::exception&)
+    {
+        _cb->response(_index, 0);
+    }
+
+    virtual void ice_exception()
+    {
+        _cb->response(_index, 0);
+    }
+
+private:
+
+    const FindAdaptersByIdCallbackPtr _cb;
+    const size_t _index;
+};
+
 class AdapterRequest : public LocatorI::Request
 {
 public:
@@ -929,6 +1006,36 @@ LocatorI::findAdapterById_async(const Ice::AMD_Locator_findAdapterByIdPtr& cb,
     }
 }
 
+void
+LocatorI::findAdaptersById_async(const Ice::AMD_BulkLocator_findAdaptersByIdPtr& cb,
+                                 const Ice::StringSeq& ids,
+                                 const Ice::Current& current) const
+{
+    if(ids.empty())
+    {
+        cb->ice_response(Ice::ObjectProxySeq());
+        return;
+    }
+
+    //
+    // The adapters are resolved concurrently, the response is sent
+    // once all the adapters are resolved.
+    //
+    FindAdaptersByIdCallbackPtr callback = new FindAdaptersByIdCallback(cb, ids.size());
+    for(size_t i = 0; i < ids.size(); ++i)
+    {
+        Ice::AMD_Locator_findAdapterByIdPtr amdCB = new FindAdaptersByIdEntryCallback(callback, i);
+        try
+        {
+            findAdapterById_async(amdCB, ids[i], current);
+        }
+        catch(const Ice::Exception& ex)
+        {
+            amdCB->ice_exception(ex);
+        }
+    }
+}
+
 Ice::LocatorRegistryPrx
 LocatorI::getRegistry(const Ice::Current&) const
 {
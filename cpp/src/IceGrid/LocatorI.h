@@ -60,6 +60,8 @@ public:
     virtual Ice::LocatorRegistryPrx getRegistry(const Ice::Current&) const;
     virtual RegistryPrx getLocalRegistry(const Ice::Current&) const;
     virtual QueryPrx getLocalQuery(const Ice::Current&) const;
+    virtual void findAdaptersById_async(const Ice::AMD_BulkLocator_findAdaptersByIdPtr&, const Ice::StringSeq&,
+                                        const Ice::Current&) const;
 
     const Ice::CommunicatorPtr& getCommunicator() const;
     const TraceLevelsPtr& getTraceLevels() const;
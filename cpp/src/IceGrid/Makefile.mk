@@ -69,7 +69,14 @@ $(project)_generated_includedir := $(project)/generated/IceGrid
 $(project)_dependencies         := IceGrid Glacier2 Ice
 $(project)_targetdir            := $(bindir)
 
+#
+# The node serves patched application distributions to the other nodes with
+# the IcePatch2 file server implementation (see IceGrid.Node.PeerPatching).
+# The implementation is compiled in rather than exported by the IcePatch2
+# library to keep it out of the library's public API.
+#
 icegridnode_sources             := $(addprefix $(currentdir)/,$(local_node_srcs) $(local_registry_srcs) IceGridNode.cpp) \
+                                   $(currentdir)/../IcePatch2/FileServerI.cpp \
                                    $(slicedir)/IceLocatorDiscovery/IceLocatorDiscovery.ice
 icegridnode_dependencies        := IceBox IceStormService IceStorm IceXML IceSSL IcePatch2 IceDB
 icegridnode_cppflags            := $(if $(lmdb_includedir),-I$(lmdb_includedir))
@@ -528,6 +528,22 @@ NodeEntry::getLoadInfoAndLoadFactor(const string& application, float& loadFactor
     return _session->getLoadInfo();
 }
 
+bool
+NodeEntry::getAdapterDispatchLoad(const string& id, AdapterDispatchLoad& load) const
+{
+    //
+    // We don't check the session here: the dispatch load is only used
+    // to order the replicas, an inactive node is detected when the
+    // adapter proxy is retrieved.
+    //
+    NodeSessionIPtr session;
+    {
+        Lock sync(*this);
+        session = _session;
+    }
+    return session && !session->isDestroyed() && session->getAdapterDispatchLoad(id, load);
+}
+
 NodeSessionIPtr
 NodeEntry::getSession() const
 {
@@ -50,6 +50,7 @@ public:
     InternalNodeInfoPtr getInfo() const;
     ServerEntrySeq getServers() const;
     LoadInfo getLoadInfoAndLoadFactor(const std::string&, float&) const;
+    bool getAdapterDispatchLoad(const std::string&, AdapterDispatchLoad&) const;
     NodeSessionIPtr getSession() const;
 
     Ice::ObjectPrx getAdminProxy() const;
@@ -12,6 +12,7 @@
 #include <Ice/Ice.h>
 #include <IcePatch2Lib/Util.h>
 #include <IcePatch2/ClientUtil.h>
+#include <IcePatch2/FileServerI.h>
 #include <IceGrid/NodeI.h>
 #include <IceGrid/Activator.h>
 #include <IceGrid/ServerI.h>
@@ -277,6 +278,25 @@ private:
     AdapterDynamicInfo _info;
 };
 
+class DispatchLoadTask : public IceUtil::TimerTask
+{
+public:
+
+    DispatchLoadTask(const NodeIPtr& node) : _node(node)
+    {
+    }
+
+    virtual void
+    runTimerTask()
+    {
+        _node->updateDispatchLoads();
+    }
+
+private:
+
+    const NodeIPtr _node;
+};
+
 }
 
 NodeI::Update::Update(const NodeIPtr& node, const NodeObserverPrx& observer) : _node(node), _observer(observer)
@@ -312,6 +332,7 @@ NodeI::NodeI(const Ice::ObjectAdapterPtr& adapter,
     _proxy(proxy),
     _redirectErrToOut(false),
     _allowEndpointsOverride(false),
+    _peerPatching(false),
     _waitTime(0),
     _instanceName(instanceName),
     _userAccountMapper(mapper),
@@ -329,6 +350,9 @@ NodeI::NodeI(const Ice::ObjectAdapterPtr& adapter,
     const_cast<string&>(_outputDir) = props->getProperty("IceGrid.Node.Output");
     const_cast<bool&>(_redirectErrToOut) = props->getPropertyAsInt("IceGrid.Node.RedirectErrToOut") > 0;
     const_cast<bool&>(_allowEndpointsOverride) = props->getPropertyAsInt("IceGrid.Node.AllowEndpointsOverride") > 0;
+    const_cast<bool&>(_peerPatching) = props->getPropertyAsInt("IceGrid.Node.PeerPatching") > 0;
+    const_cast<IceUtil::Time&>(_dispatchMetricsPeriod) =
+        IceUtil::Time::seconds(props->getPropertyAsInt("IceGrid.Node.DispatchMetricsPeriod"));
 
     //
     // Parse the properties override property.
@@ -611,7 +635,17 @@ NodeI::patch_async(const AMD_Node_patchPtr& amdCB,
                 {
                     throw runtime_error("proxy `" + appDistrib->icepatch + "' is not a file server.");
                 }
-                patch(icepatch, "distrib/" + application, appDistrib->directories);
+
+                //
+                // Stop serving the application distribution to the other
+                // nodes while it's being patched.
+                //
+                removeDistributionServer(application);
+                patch(icepatch, "distrib/" + application, appDistrib->directories, _peerPatching);
+                if(_peerPatching)
+                {
+                    addDistributionServer(application);
+                }
             }
 
             //
@@ -627,7 +661,7 @@ NodeI::patch_async(const AMD_Node_patchPtr& amdCB,
                     {
                         throw runtime_error("proxy `" + dist->icepatch + "' is not a file server.");
                     }
-                    patch(icepatch, "servers/" + (*s)->getId() + "/distrib", dist->directories);
+                    patch(icepatch, "servers/" + (*s)->getId() + "/distrib", dist->directories, false);
 
                     if(!server.empty())
                     {
@@ -835,6 +869,12 @@ NodeI::allowEndpointsOverride() const
     return _allowEndpointsOverride;
 }
 
+IceUtil::Time
+NodeI::getDispatchMetricsPeriod() const
+{
+    return _dispatchMetricsPeriod;
+}
+
 NodeSessionPrx
 NodeI::registerWithRegistry(const InternalRegistryPrx& registry)
 {
@@ -894,6 +934,35 @@ NodeI::checkConsistency(const NodeSessionPrx& session)
     for_each(commands.begin(), commands.end(), IceUtil::voidMemFun(&ServerCommand::execute));
 }
 
+LoadedServerInfoSeq
+NodeI::getLoadedServers() const
+{
+    //
+    // The servers lock can't be held while calling on the servers,
+    // the servers call addServer/removeServer with their lock held.
+    //
+    set<ServerIPtr> servers;
+    {
+        IceUtil::Mutex::Lock sync(_serversLock);
+        for(map<string, set<ServerIPtr> >::const_iterator p = _serversByApplication.begin();
+            p != _serversByApplication.end(); ++p)
+        {
+            servers.insert(p->second.begin(), p->second.end());
+        }
+    }
+
+    LoadedServerInfoSeq infos;
+    for(set<ServerIPtr>::const_iterator p = servers.begin(); p != servers.end(); ++p)
+    {
+        LoadedServerInfo info;
+        if((*p)->getLoadedServerInfo(info))
+        {
+            infos.push_back(info);
+        }
+    }
+    return infos;
+}
+
 void
 NodeI::addObserver(const NodeSessionPrx& session, const NodeObserverPrx& observer)
 {
@@ -1061,6 +1130,8 @@ NodeI::removeServer(const ServerIPtr& server, const std::string& application)
         {
             _serversByApplication.erase(p);
 
+            removeDistributionServer(application);
+
             string appDir = _dataDir + "/distrib/" + application;
             if(IceUtilInternal::directoryExists(appDir))
             {
@@ -1078,6 +1149,65 @@ NodeI::removeServer(const ServerIPtr& server, const std::string& application)
     }
 }
 
+void
+NodeI::startDispatchLoadUpdates()
+{
+    if(_dispatchMetricsPeriod > IceUtil::Time())
+    {
+        _timer->scheduleRepeated(new DispatchLoadTask(this), _dispatchMetricsPeriod);
+    }
+}
+
+void
+NodeI::updateDispatchLoads()
+{
+    set<ServerIPtr> servers;
+    {
+        IceUtil::Mutex::Lock sync(_serversLock);
+        for(map<string, set<ServerIPtr> >::const_iterator p = _serversByApplication.begin();
+            p != _serversByApplication.end(); ++p)
+        {
+            servers.insert(p->second.begin(), p->second.end());
+        }
+    }
+
+    //
+    // Each server returns the dispatch loads computed from the metrics
+    // retrieved on the previous run and requests the metrics for the
+    // next run.
+    //
+    AdapterDispatchLoadSeq loads;
+    for(set<ServerIPtr>::const_iterator p = servers.begin(); p != servers.end(); ++p)
+    {
+        (*p)->updateDispatchLoads(loads);
+    }
+
+    set<NodeSessionPrx> sessions;
+    {
+        IceUtil::Mutex::Lock sync(_observerMutex);
+        for(map<NodeSessionPrx, NodeObserverPrx>::const_iterator p = _observers.begin(); p != _observers.end(); ++p)
+        {
+            sessions.insert(p->first);
+        }
+    }
+
+    //
+    // The loads are sent to each registry, failures are ignored: the
+    // registry might not support dispatch loads or the session might
+    // be re-established concurrently.
+    //
+    for(set<NodeSessionPrx>::const_iterator p = sessions.begin(); p != sessions.end(); ++p)
+    {
+        try
+        {
+            (*p)->begin_setAdapterDispatchLoads(loads);
+        }
+        catch(const Ice::LocalException&)
+        {
+        }
+    }
+}
+
 Ice::Identity
 NodeI::createServerIdentity(const string& name) const
 {
@@ -1283,11 +1413,13 @@ NodeI::canRemoveServerDirectory(const string& name)
 }
 
 void
-NodeI::patch(const FileServerPrx& icepatch, const string& dest, const vector<string>& directories)
+NodeI::patch(const FileServerPrx& icepatch, const string& dest, const vector<string>& directories,
+             bool keepCompressed)
 {
     IcePatch2::PatcherFeedbackPtr feedback = new LogPatcherFeedback(_traceLevels, dest);
     IcePatch2Internal::createDirectory(_dataDir + "/" + dest);
-    PatcherPtr patcher = PatcherFactory::create(icepatch, feedback, _dataDir + "/" + dest, false, 100, 1);
+    PatcherPtr patcher = IcePatch2Internal::createPatcher(icepatch, feedback, _dataDir + "/" + dest, false, 100, 1,
+                                                          keepCompressed);
     bool aborted = !patcher->prepare();
     if(!aborted)
     {
@@ -1320,6 +1452,120 @@ NodeI::patch(const FileServerPrx& icepatch, const string& dest, const vector<str
     //
 }
 
+void
+NodeI::addDistributionServer(const string& application)
+{
+    //
+    // Serve the patched application distribution to the other nodes,
+    // the registry directs the patching of other nodes to this server
+    // (see IceGrid.Registry.PatchFanOut). The distribution is only
+    // served if all the files listed in the summary file are present,
+    // this isn't the case if only some directories of the distribution
+    // are patched. The compressed form of the files which weren't
+    // downloaded by the last patch (because they were already up to
+    // date before peer patching was enabled for example) is created
+    // here.
+    //
+    string dir = _dataDir + "/distrib/" + application;
+    LargeFileInfoSeq infoSeq;
+    try
+    {
+        loadFileInfoSeq(dir, infoSeq);
+    }
+    catch(const exception& ex)
+    {
+        if(_traceLevels->patch > 0)
+        {
+            Ice::Trace out(_traceLevels->logger, _traceLevels->patchCat);
+            out << "distrib/" << application << ": can't serve distribution to other nodes:\n" << ex.what();
+        }
+        return;
+    }
+
+    for(LargeFileInfoSeq::const_iterator p = infoSeq.begin(); p != infoSeq.end(); ++p)
+    {
+        string path = dir + "/" + p->path;
+        bool exists;
+        if(p->size < 0)
+        {
+            exists = IceUtilInternal::directoryExists(path);
+        }
+        else
+        {
+            exists = IceUtilInternal::fileExists(path);
+        }
+
+        if(!exists)
+        {
+            if(_traceLevels->patch > 0)
+            {
+                Ice::Trace out(_traceLevels->logger, _traceLevels->patchCat);
+                out << "distrib/" << application << ": can't serve distribution to other nodes:\n"
+                    << "`" << p->path << "' is missing";
+            }
+            return;
+        }
+
+        //
+        // The compressed file is re-created unless it's newer than the
+        // file, it could otherwise be left from a previous revision of
+        // the distribution.
+        //
+        IceUtilInternal::structstat buf;
+        IceUtilInternal::structstat bufBZ2;
+        if(p->size > 0 &&
+           (IceUtilInternal::stat(path, &buf) == -1 || IceUtilInternal::stat(path + ".bz2", &bufBZ2) == -1 ||
+            !isOlder(buf, bufBZ2)))
+        {
+            try
+            {
+                compressFile(path);
+            }
+            catch(const exception& ex)
+            {
+                if(_traceLevels->patch > 0)
+                {
+                    Ice::Trace out(_traceLevels->logger, _traceLevels->patchCat);
+                    out << "distrib/" << application << ": can't serve distribution to other nodes:\n" << ex.what();
+                }
+                return;
+            }
+        }
+    }
+
+    Ice::Identity id;
+    id.category = _instanceName + "-Distrib";
+    id.name = application;
+    try
+    {
+        _adapter->add(new FileServerI(dir, infoSeq), id);
+    }
+    catch(const Ice::AlreadyRegisteredException&)
+    {
+    }
+    catch(const Ice::ObjectAdapterDeactivatedException&)
+    {
+    }
+}
+
+void
+NodeI::removeDistributionServer(const string& application)
+{
+    Ice::Identity id;
+    id.category = _instanceName + "-Distrib";
+    id.name = application;
+    try
+    {
+        _adapter->remove(id);
+    }
+    catch(const Ice::NotRegisteredException&)
+    {
+    }
+    catch(const Ice::ObjectAdapterDeactivatedException&)
+    {
+    }
+}
+
 set<ServerIPtr>
 NodeI::getApplicationServers(const string& application) const
 {
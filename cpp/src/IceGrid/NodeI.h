@@ -125,9 +125,11 @@ public:
     std::string getOutputDir() const;
     bool getRedirectErrToOut() const;
     bool allowEndpointsOverride() const;
+    IceUtil::Time getDispatchMetricsPeriod() const;
 
     NodeSessionPrx registerWithRegistry(const InternalRegistryPrx&);
     void checkConsistency(const NodeSessionPrx&);
+    LoadedServerInfoSeq getLoadedServers() const;
     NodeSessionPrx getMasterNodeSession() const;
 
     void addObserver(const NodeSessionPrx&, const NodeObserverPrx&);
@@ -140,6 +142,9 @@ public:
     void addServer(const ServerIPtr&, const std::string&);
     void removeServer(const ServerIPtr&, const std::string&);
 
+    void startDispatchLoadUpdates();
+    void updateDispatchLoads();
+
     Ice::Identity createServerIdentity(const std::string&) const;
     std::string getServerAdminCategory() const;
 
@@ -148,7 +153,9 @@ public:
 private:
 
     std::vector<ServerCommandPtr> checkConsistencyNoSync(const Ice::StringSeq&);
-    void patch(const IcePatch2::FileServerPrx&, const std::string&, const std::vector<std::string>&);
+    void patch(const IcePatch2::FileServerPrx&, const std::string&, const std::vector<std::string>&, bool);
+    void addDistributionServer(const std::string&);
+    void removeDistributionServer(const std::string&);
 
     std::set<ServerIPtr> getApplicationServers(const std::string&) const;
     std::string getFilePath(const std::string&) const;
@@ -170,7 +177,9 @@ private:
     const std::string _outputDir;
     const bool _redirectErrToOut;
     const bool _allowEndpointsOverride;
+    const bool _peerPatching;
     const Ice::Int _waitTime;
+    const IceUtil::Time _dispatchMetricsPeriod;
     const std::string _instanceName;
     const UserAccountMapperPrx _userAccountMapper;
     mutable PlatformInfo _platform;
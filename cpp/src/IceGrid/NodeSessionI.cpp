@@ -218,6 +218,37 @@ NodeSessionI::setReplicaObserver(const ReplicaObserverPrx& observer, const Ice::
     _database->getReplicaCache().subscribe(observer);
 }
 
+void
+NodeSessionI::setAdapterDispatchLoads(const AdapterDispatchLoadSeq& loads, const Ice::Current&)
+{
+    Lock sync(*this);
+    if(_destroy)
+    {
+        throw Ice::ObjectNotExistException(__FILE__, __LINE__);
+    }
+
+    //
+    // The node sends the load of the adapters of all its active
+    // servers, the loads of adapters which are no longer active are
+    // discarded.
+    //
+    _dispatchLoads.clear();
+    for(AdapterDispatchLoadSeq::const_iterator p = loads.begin(); p != loads.end(); ++p)
+    {
+        _dispatchLoads.insert(make_pair(p->id, *p));
+    }
+
+    if(_traceLevels->node > 2)
+    {
+        Ice::Trace out(_traceLevels->logger, _traceLevels->nodeCat);
+        out << "node `" << _info->name << "' dispatch loads:";
+        for(AdapterDispatchLoadSeq::const_iterator p = loads.begin(); p != loads.end(); ++p)
+        {
+            out << "\nadapter `" << p->id << "' (current = " << p->current << ", latency = " << p->latency << "ms)";
+        }
+    }
+}
+
 int
 NodeSessionI::getTimeout(const Ice::Current&) const
 {
@@ -252,6 +283,45 @@ NodeSessionI::loadServers_async(const AMD_NodeSession_loadServersPtr& amdCB, con
     }
 }
 
+void
+NodeSessionI::loadServersDelta_async(const AMD_NodeSession_loadServersDeltaPtr& amdCB,
+                                     const LoadedServerInfoSeq& loaded,
+                                     const Ice::Current&) const
+{
+    amdCB->ice_response();
+
+    map<string, const LoadedServerInfo*> loadedServers;
+    for(LoadedServerInfoSeq::const_iterator p = loaded.begin(); p != loaded.end(); ++p)
+    {
+        loadedServers.insert(make_pair(p->id, &*p));
+    }
+
+    //
+    // Only load the servers which are not already loaded on the node
+    // with the same descriptor revision.
+    //
+    ServerEntrySeq servers = _database->getNode(_info->name)->getServers();
+    int upToDate = 0;
+    for(ServerEntrySeq::const_iterator p = servers.begin(); p != servers.end(); ++p)
+    {
+        map<string, const LoadedServerInfo*>::const_iterator q = loadedServers.find((*p)->getId());
+        if(q != loadedServers.end() && (*p)->syncLoaded(*q->second, _timeout))
+        {
+            ++upToDate;
+            continue;
+        }
+        (*p)->sync();
+        (*p)->waitForSyncNoThrow(1); // Don't wait too long.
+    }
+
+    if(_traceLevels->node > 0)
+    {
+        Ice::Trace out(_traceLevels->logger, _traceLevels->nodeCat);
+        out << "loaded " << static_cast<int>(servers.size()) - upToDate << " server(s) on node `" << _info->name
+            << "', " << upToDate << " server(s) already up to date";
+    }
+}
+
 Ice::StringSeq
 NodeSessionI::getServers(const Ice::Current&) const
 {
@@ -347,6 +417,19 @@ NodeSessionI::getLoadInfo() const
     return _load;
 }
 
+bool
+NodeSessionI::getAdapterDispatchLoad(const string& id, AdapterDispatchLoad& load) const
+{
+    Lock sync(*this);
+    map<string, AdapterDispatchLoad>::const_iterator p = _dispatchLoads.find(id);
+    if(p == _dispatchLoads.end())
+    {
+        return false;
+    }
+    load = p->second;
+    return true;
+}
+
 NodeSessionPrx
 NodeSessionI::getProxy() const
 {
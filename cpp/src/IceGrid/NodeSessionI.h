@@ -29,8 +29,8 @@ public:
     PatcherFeedbackAggregator(Ice::Identity, const TraceLevelsPtr&, const std::string&, const std::string&, int);
     virtual ~PatcherFeedbackAggregator();
 
-    void finished(const std::string&);
-    void failed(const std::string&, const std::string&);
+    virtual void finished(const std::string&);
+    virtual void failed(const std::string&, const std::string&);
 
 protected:
 
@@ -60,9 +60,12 @@ public:
 
     virtual void keepAlive(const LoadInfo&, const Ice::Current&);
     virtual void setReplicaObserver(const ReplicaObserverPrx&, const Ice::Current&);
+    virtual void setAdapterDispatchLoads(const AdapterDispatchLoadSeq&, const Ice::Current&);
     virtual int getTimeout(const Ice::Current&) const;
     virtual NodeObserverPrx getObserver(const Ice::Current&) const;
     virtual void loadServers_async(const AMD_NodeSession_loadServersPtr&, const Ice::Current&) const;
+    virtual void loadServersDelta_async(const AMD_NodeSession_loadServersDeltaPtr&, const LoadedServerInfoSeq&,
+                                        const Ice::Current&) const;
     virtual Ice::StringSeq getServers(const Ice::Current&) const;
     virtual void waitForApplicationUpdate_async(const AMD_NodeSession_waitForApplicationUpdatePtr&,
                                                 const std::string&, int, const Ice::Current&) const;
@@ -76,6 +79,7 @@ public:
     const NodePrx& getNode() const;
     const InternalNodeInfoPtr& getInfo() const;
     const LoadInfo& getLoadInfo() const;
+    bool getAdapterDispatchLoad(const std::string&, AdapterDispatchLoad&) const;
     NodeSessionPrx getProxy() const;
 
     bool isDestroyed() const;
@@ -95,6 +99,7 @@ private:
     ReplicaObserverPrx _replicaObserver;
     IceUtil::Time _timestamp;
     LoadInfo _load;
+    std::map<std::string, AdapterDispatchLoad> _dispatchLoads;
     bool _destroy;
     std::set<PatcherFeedbackPtr> _feedbacks;
 };
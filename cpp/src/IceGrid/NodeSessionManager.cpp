@@ -471,9 +471,21 @@ NodeSessionManager::syncServers(const NodeSessionPrx& session)
     // the registry replicas (at least the ones which are up) have all
     // established their session with the node.
     //
+    // If the node already has servers loaded (the registry was
+    // restarted), only the servers which aren't up to date are
+    // re-loaded. Registries which don't support loadServersDelta
+    // re-load all the servers.
+    //
     assert(session);
     _node->checkConsistency(session);
-    session->loadServers();
+    try
+    {
+        session->loadServersDelta(_node->getLoadedServers());
+    }
+    catch(const Ice::OperationNotExistException&)
+    {
+        session->loadServers();
+    }
 }
 
 void
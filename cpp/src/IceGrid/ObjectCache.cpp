@@ -169,6 +169,23 @@ ObjectCache::getAll(const string& expression)
     return infos;
 }
 
+bool
+ObjectCache::getPage(const string& expression, Ice::Identity& cursor, int max, ObjectInfoSeq& infos)
+{
+    Lock sync(*this);
+    map<Ice::Identity, ObjectEntryPtr>::const_iterator p =
+        cursor.name.empty() ? _entries.begin() : _entries.upper_bound(cursor);
+    for(; p != _entries.end() && static_cast<int>(infos.size()) < max; ++p)
+    {
+        if(expression.empty() || IceUtilInternal::match(_communicator->identityToString(p->first), expression, true))
+        {
+            infos.push_back(p->second->getObjectInfo());
+        }
+        cursor = p->first;
+    }
+    return p == _entries.end();
+}
+
 ObjectInfoSeq
 ObjectCache::getAllByType(const string& type)
 {
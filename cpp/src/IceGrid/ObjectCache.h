@@ -54,6 +54,7 @@ public:
     std::vector<ObjectEntryPtr> getObjectsByType(const std::string&);
 
     ObjectInfoSeq getAll(const std::string&);
+    bool getPage(const std::string&, Ice::Identity&, int, ObjectInfoSeq&);
     ObjectInfoSeq getAllByType(const std::string&);
 
     const Ice::CommunicatorPtr& getCommunicator() const { return _communicator; }
@@ -264,6 +264,39 @@ void outputString(const string& s)
     consoleOut << s;
 }
 
+//
+// Reads all the elements of a registry iterator in batches and destroys
+// the iterator.
+//
+const int iteratorBatchSize = 1000;
+
+template<class Prx, class Seq> void
+readIterator(const Prx& it, Seq& seq)
+{
+    try
+    {
+        bool done = false;
+        while(!done)
+        {
+            Seq batch;
+            done = it->next(iteratorBatchSize, batch);
+            seq.insert(seq.end(), batch.begin(), batch.end());
+        }
+    }
+    catch(...)
+    {
+        try
+        {
+            it->destroy();
+        }
+        catch(...)
+        {
+        }
+        throw;
+    }
+    it->destroy();
+}
+
 void writeMessage(const string& message, bool indent)
 {
     string s = message;
@@ -1680,7 +1713,7 @@ Parser::listAllServers(const list<string>& args)
     try
     {
         ostringstream os;
-        Ice::StringSeq ids = _admin->getAllServerIds();
+        Ice::StringSeq ids = getAllServerIds();
         copy(ids.begin(), ids.end(), ostream_iterator<string>(os,"\n"));
         consoleOut << os.str();
     }
@@ -2000,7 +2033,7 @@ Parser::listAllAdapters(const list<string>& args)
     try
     {
         ostringstream os;
-        Ice::StringSeq ids = _admin->getAllAdapterIds();
+        Ice::StringSeq ids = getAllAdapterIds();
         copy(ids.begin(), ids.end(), ostream_iterator<string>(os,"\n"));
         consoleOut << os.str();
     }
@@ -2107,12 +2140,12 @@ Parser::describeObject(const list<string>& args)
             }
             else
             {
-                objects = _admin->getAllObjectInfos(arg);
+                objects = getAllObjectInfos(arg);
             }
         }
         else
         {
-            objects = _admin->getAllObjectInfos("");
+            objects = getAllObjectInfos("");
         }
 
         for(ObjectInfoSeq::const_iterator p = objects.begin(); p != objects.end(); ++p)
@@ -2141,11 +2174,11 @@ Parser::listObject(const list<string>& args)
         ObjectInfoSeq objects;
         if(args.size() == 1)
         {
-            objects = _admin->getAllObjectInfos(*(args.begin()));
+            objects = getAllObjectInfos(*(args.begin()));
         }
         else
         {
-            objects = _admin->getAllObjectInfos("");
+            objects = getAllObjectInfos("");
         }
 
         for(ObjectInfoSeq::const_iterator p = objects.begin(); p != objects.end(); ++p)
@@ -2403,6 +2436,51 @@ Parser::showFile(const string& id, const string& reader, const string& filename,
     }
 }
 
+Ice::StringSeq
+Parser::getAllServerIds()
+{
+    Ice::StringSeq ids;
+    try
+    {
+        readIterator(_session->openServerIds(), ids);
+    }
+    catch(const Ice::OperationNotExistException&)
+    {
+        ids = _admin->getAllServerIds(); // Registry older than 3.7.2
+    }
+    return ids;
+}
+
+Ice::StringSeq
+Parser::getAllAdapterIds()
+{
+    Ice::StringSeq ids;
+    try
+    {
+        readIterator(_session->openAdapterIds(), ids);
+    }
+    catch(const Ice::OperationNotExistException&)
+    {
+        ids = _admin->getAllAdapterIds(); // Registry older than 3.7.2
+    }
+    return ids;
+}
+
+ObjectInfoSeq
+Parser::getAllObjectInfos(const string& expr)
+{
+    ObjectInfoSeq infos;
+    try
+    {
+        readIterator(_session->openObjectInfos(expr), infos);
+    }
+    catch(const Ice::OperationNotExistException&)
+    {
+        infos = _admin->getAllObjectInfos(expr); // Registry older than 3.7.2
+    }
+    return infos;
+}
+
 void
 Parser::showLog(const string& id, const string& reader, bool tail, bool follow, int lineCount)
 {
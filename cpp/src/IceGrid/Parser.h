@@ -160,6 +160,10 @@ private:
     void showFile(const std::string&, const std::string&, const std::string&, bool, bool, bool, int);
     void showLog(const std::string&, const std::string&, bool, bool, int);
 
+    Ice::StringSeq getAllServerIds();
+    Ice::StringSeq getAllAdapterIds();
+    ObjectInfoSeq getAllObjectInfos(const std::string&);
+
     std::string _commands;
     Ice::CommunicatorPtr _communicator;
     AdminSessionPrx _session;
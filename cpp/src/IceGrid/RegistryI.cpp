@@ -483,11 +483,11 @@ RegistryI::startImpl()
             Ice::Long serial;
             IceGrid::InternalRegistryPrx registry = IceGrid::InternalRegistryPrx::checkedCast(proxy);
             ApplicationInfoSeq applications = registry->getApplications(serial);
-            _database->syncApplications(applications, serial);
+            _database->syncApplications(applications, serial, "");
             AdapterInfoSeq adapters = registry->getAdapters(serial);
-            _database->syncAdapters(adapters, serial);
+            _database->syncAdapters(adapters, serial, "");
             ObjectInfoSeq objects = registry->getObjects(serial);
-            _database->syncObjects(objects, serial);
+            _database->syncObjects(objects, serial, "");
         }
         catch(const Ice::OperationNotExistException&)
         {
@@ -36,7 +36,7 @@ public:
     applicationInit(int, const ApplicationInfoSeq& applications, const Ice::Current& current)
     {
         int serial;
-        _database->syncApplications(applications, getSerials(current.ctx, serial));
+        _database->syncApplications(applications, getSerials(current.ctx, serial), getGeneration(current.ctx));
         receivedUpdate(ApplicationObserverTopicName, serial);
     }
 
@@ -104,7 +104,7 @@ public:
     adapterInit(const AdapterInfoSeq& adapters, const Ice::Current& current)
     {
         int serial;
-        _database->syncAdapters(adapters, getSerials(current.ctx, serial));
+        _database->syncAdapters(adapters, getSerials(current.ctx, serial), getGeneration(current.ctx));
         receivedUpdate(AdapterObserverTopicName, serial);
     }
 
@@ -160,7 +160,7 @@ public:
     objectInit(const ObjectInfoSeq& objects, const Ice::Current& current)
     {
         int serial;
-        _database->syncObjects(objects, getSerials(current.ctx, serial));
+        _database->syncObjects(objects, getSerials(current.ctx, serial), getGeneration(current.ctx));
         receivedUpdate(ObjectObserverTopicName, serial);
     }
 
@@ -259,6 +259,13 @@ private:
         }
     }
 
+    string
+    getGeneration(const Ice::Context& context)
+    {
+        Ice::Context::const_iterator p = context.find("dbGeneration");
+        return p != context.end() ? p->second : string();
+    }
+
     void
     receivedUpdate(TopicName name, int serial, const string& failure = string())
     {
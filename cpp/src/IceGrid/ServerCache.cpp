@@ -664,6 +664,28 @@ ServerEntry::getLoad(LoadSample sample) const
     }
 }
 
+bool
+ServerEntry::getDispatchLoad(const string& adapterId, AdapterDispatchLoad& load) const
+{
+    string node;
+    {
+        Lock sync(*this);
+        if(_loaded.get())
+        {
+            node = _loaded->node;
+        }
+        else if(_load.get())
+        {
+            node = _load->node;
+        }
+        else
+        {
+            throw ServerNotExistException();
+        }
+    }
+    return _cache.getNodeCache().get(node)->getAdapterDispatchLoad(adapterId, load);
+}
+
 void
 ServerEntry::syncImpl()
 {
@@ -829,6 +851,49 @@ ServerEntry::synchronized(const Ice::Exception& ex)
     }
 }
 
+bool
+ServerEntry::syncLoaded(const LoadedServerInfo& server, int sessionTimeout)
+{
+    //
+    // If the node already loaded the descriptor of this entry, we use
+    // the proxies from the node instead of loading the server again.
+    //
+    Lock sync(*this);
+    if(_synchronizing || _destroy.get() || _session)
+    {
+        return false;
+    }
+
+    ServerInfo* info = _load.get() ? _load.get() : _loaded.get();
+    if(!info || !info->sessionId.empty() || info->uuid != server.uuid || info->revision != server.revision)
+    {
+        return false;
+    }
+
+    if(_load.get())
+    {
+        _loaded.reset(_load.release());
+    }
+    _proxy = server.proxy;
+    _adapters = server.adapters;
+
+    //
+    // Add the node session timeout to the timeouts, see LoadCB.
+    //
+    _activationTimeout = server.activationTimeout + sessionTimeout;
+    _deactivationTimeout = server.deactivationTimeout + sessionTimeout;
+    _updated = false;
+    _exception.reset(0);
+
+    TraceLevelsPtr traceLevels = _cache.getTraceLevels();
+    if(traceLevels && traceLevels->server > 1)
+    {
+        Ice::Trace out(traceLevels->logger, traceLevels->serverCat);
+        out << "server `" << _id << "' already loaded on node `" << _loaded->node << "'";
+    }
+    return true;
+}
+
 void
 ServerEntry::loadCallback(const ServerPrx& proxy, const AdapterPrxDict& adpts, int at, int dt)
 {
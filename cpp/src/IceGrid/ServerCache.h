@@ -91,11 +91,13 @@ public:
     AdapterPrx getAdapter(const std::string&, bool);
     AdapterPrx getAdapter(int&, int&, const std::string&, bool);
     float getLoad(LoadSample) const;
+    bool getDispatchLoad(const std::string&, AdapterDispatchLoad&) const;
 
     bool canRemove();
     CheckUpdateResultPtr checkUpdate(const ServerInfo&, bool);
     bool isDestroyed();
 
+    bool syncLoaded(const LoadedServerInfo&, int);
     void loadCallback(const ServerPrx&, const AdapterPrxDict&, int, int);
     void destroyCallback();
     void exception(const Ice::Exception&);
@@ -1119,6 +1119,35 @@ ServerI::dependsOnApplicationDistrib() const
     return _desc ? _desc->applicationDistrib : false;
 }
 
+bool
+ServerI::getLoadedServerInfo(LoadedServerInfo& info) const
+{
+    Lock sync(*this);
+
+    //
+    // Only servers which are loaded and without pending load or
+    // destroy are reported. Servers allocated by a session are always
+    // re-loaded since their descriptor depends on the session.
+    //
+    if(!_desc || _load || _destroy || _state == Destroying || _state == Destroyed || !_desc->sessionId.empty())
+    {
+        return false;
+    }
+
+    info.id = _id;
+    info.uuid = _desc->uuid;
+    info.revision = _desc->revision;
+    info.proxy = _this;
+    info.adapters.clear();
+    for(ServerAdapterDict::const_iterator p = _adapters.begin(); p != _adapters.end(); ++p)
+    {
+        info.adapters.insert(make_pair(p->first, p->second->getProxy()));
+    }
+    info.activationTimeout = _activationTimeout;
+    info.deactivationTimeout = _deactivationTimeout;
+    return true;
+}
+
 void
 ServerI::start(ServerActivation activation, const AMD_Server_startPtr& amdCB)
 {
@@ -2717,6 +2746,132 @@ ServerI::updateRuntimePropertiesCallback(const Ice::Exception& ex, const Interna
     }
 }
 
+void
+ServerI::updateDispatchLoads(AdapterDispatchLoadSeq& loads)
+{
+    Ice::ObjectPrx process;
+    {
+        Lock sync(*this);
+        if(_state != Active || !_process)
+        {
+            _dispatchLoads.clear();
+            _dispatchTotals.clear();
+            return;
+        }
+
+        for(map<string, AdapterDispatchLoad>::const_iterator p = _dispatchLoads.begin(); p != _dispatchLoads.end();
+            ++p)
+        {
+            loads.push_back(p->second);
+        }
+        process = _process;
+    }
+
+    try
+    {
+        IceMX::MetricsAdminPrx admin = IceMX::MetricsAdminPrx::uncheckedCast(process, "Metrics");
+        admin->begin_getMetricsView("IceGrid", IceMX::newCallback_MetricsAdmin_getMetricsView(
+                                        this,
+                                        &ServerI::dispatchMetricsView,
+                                        &ServerI::dispatchMetricsException));
+    }
+    catch(const Ice::LocalException&)
+    {
+    }
+}
+
+void
+ServerI::dispatchMetricsView(const IceMX::MetricsView& view, Ice::Long)
+{
+    Lock sync(*this);
+    if(_state != Active || !_desc)
+    {
+        return;
+    }
+
+    //
+    // The metrics of the dispatch map are grouped by object adapter
+    // name, the adapter id is the value of the <name>.AdapterId
+    // property of the server configuration.
+    //
+    map<string, string> adapterIds;
+    PropertyDescriptorSeqDict::const_iterator c = _desc->properties.find("config");
+    if(c != _desc->properties.end())
+    {
+        const string suffix = ".AdapterId";
+        for(PropertyDescriptorSeq::const_iterator p = c->second.begin(); p != c->second.end(); ++p)
+        {
+            if(p->name.size() > suffix.size() &&
+               p->name.compare(p->name.size() - suffix.size(), suffix.size(), suffix) == 0 &&
+               _adapters.find(p->value) != _adapters.end())
+            {
+                adapterIds[p->name.substr(0, p->name.size() - suffix.size())] = p->value;
+            }
+        }
+    }
+
+    map<string, AdapterDispatchLoad> dispatchLoads;
+    map<string, pair<Ice::Long, Ice::Long> > dispatchTotals;
+    IceMX::MetricsView::const_iterator d = view.find("Dispatch");
+    if(d != view.end())
+    {
+        for(IceMX::MetricsMap::const_iterator p = d->second.begin(); p != d->second.end(); ++p)
+        {
+            map<string, string>::const_iterator q = adapterIds.find((*p)->id);
+            if(q == adapterIds.end())
+            {
+                continue;
+            }
+
+            //
+            // The latency is the average lifetime of the requests
+            // dispatched since the previous update. If no requests
+            // were dispatched, we keep the previous latency.
+            //
+            AdapterDispatchLoad load;
+            load.id = q->second;
+            load.current = (*p)->current;
+            load.latency = 0.0f;
+
+            Ice::Long completed = (*p)->total - (*p)->current;
+            pair<Ice::Long, Ice::Long> totals = make_pair(completed, (*p)->totalLifetime);
+
+            map<string, pair<Ice::Long, Ice::Long> >::const_iterator t = _dispatchTotals.find((*p)->id);
+            map<string, AdapterDispatchLoad>::const_iterator l = _dispatchLoads.find(load.id);
+            if(t != _dispatchTotals.end() && completed > t->second.first)
+            {
+                load.latency = static_cast<float>(totals.second - t->second.second) /
+                    static_cast<float>(completed - t->second.first) / 1000.0f;
+            }
+            else if(t == _dispatchTotals.end() && completed > 0)
+            {
+                load.latency = static_cast<float>(totals.second) / static_cast<float>(completed) / 1000.0f;
+            }
+            else if(l != _dispatchLoads.end())
+            {
+                load.latency = l->second.latency;
+            }
+
+            dispatchLoads.insert(make_pair(load.id, load));
+            dispatchTotals.insert(make_pair((*p)->id, totals));
+        }
+    }
+    _dispatchLoads.swap(dispatchLoads);
+    _dispatchTotals.swap(dispatchTotals);
+}
+
+void
+ServerI::dispatchMetricsException(const Ice::Exception&)
+{
+    //
+    // The metrics might not be enabled or the Metrics admin facet
+    // might not be available.
+    //
+    Lock sync(*this);
+    _dispatchLoads.clear();
+    _dispatchTotals.clear();
+}
+
 bool
 ServerI::checkActivation()
 {
@@ -3211,6 +3366,16 @@ ServerI::getProperties(const InternalServerDescriptorPtr& desc)
         }
     }
 
+    //
+    // Enable the dispatch metrics used by the node to compute the
+    // dispatch load of the server adapters.
+    //
+    if(_node->getDispatchMetricsPeriod() > IceUtil::Time() &&
+       getProperty(props, "IceMX.Metrics.IceGrid.Map.Dispatch.GroupBy").empty())
+    {
+        props.push_back(createProperty("IceMX.Metrics.IceGrid.Map.Dispatch.GroupBy", "parent"));
+    }
+
     //
     // Add the locator proxy property and the node properties override
     //
@@ -12,6 +12,7 @@
 
 #include <IceUtil/Mutex.h>
 #include <IceUtil/Timer.h>
+#include <Ice/Metrics.h>
 #include <IceGrid/Activator.h>
 #include <IceGrid/Internal.h>
 #include <set>
@@ -92,6 +93,7 @@ public:
     const std::string& getId() const;
     InternalDistributionDescriptorPtr getDistribution() const;
     bool dependsOnApplicationDistrib() const;
+    bool getLoadedServerInfo(LoadedServerInfo&) const;
 
     void start(ServerActivation, const AMD_Server_startPtr& = AMD_Server_startPtr());
     ServerCommandPtr load(const AMD_Node_loadServerPtr&, const InternalServerDescriptorPtr&, const std::string&, bool);
@@ -121,6 +123,8 @@ public:
 
     PropertyDescriptorSeqDict getProperties(const InternalServerDescriptorPtr&);
 
+    void updateDispatchLoads(AdapterDispatchLoadSeq&);
+
     void updateRuntimePropertiesCallback(const InternalServerDescriptorPtr&);
     void updateRuntimePropertiesCallback(const Ice::Exception&, const InternalServerDescriptorPtr&);
 
@@ -144,6 +148,9 @@ private:
     ServerDynamicInfo getDynamicInfo() const;
     std::string getFilePath(const std::string&) const;
 
+    void dispatchMetricsView(const IceMX::MetricsView&, Ice::Long);
+    void dispatchMetricsException(const Ice::Exception&);
+
     const NodeIPtr _node;
     const ServerPrx _this;
     const std::string _id;
@@ -173,6 +180,8 @@ private:
     std::string _stdOutFile;
     Ice::StringSeq _logs;
     PropertyDescriptorSeq _properties;
+    std::map<std::string, AdapterDispatchLoad> _dispatchLoads;
+    std::map<std::string, std::pair<Ice::Long, Ice::Long> > _dispatchTotals;
 
     DestroyCommandPtr _destroy;
     StopCommandPtr _stop;
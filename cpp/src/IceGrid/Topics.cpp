@@ -27,10 +27,33 @@ Ice::EncodingVersion encodings[] = {
     { 1, 1 }
 };
 
+class FlushTimerTask : public IceUtil::TimerTask
+{
+public:
+
+    FlushTimerTask(const NodeObserverTopicPtr& topic) : _topic(topic)
+    {
+    }
+
+    virtual void
+    runTimerTask()
+    {
+        _topic->flush();
+    }
+
+private:
+
+    const NodeObserverTopicPtr _topic;
+};
+
 }
 
-ObserverTopic::ObserverTopic(const IceStorm::TopicManagerPrx& topicManager, const string& name, Ice::Long dbSerial) :
-    _logger(topicManager->ice_getCommunicator()->getLogger()), _serial(0), _dbSerial(dbSerial)
+ObserverTopic::ObserverTopic(const IceStorm::TopicManagerPrx& topicManager, const string& name, Ice::Long dbSerial,
+                             const string& dbGeneration) :
+    _logger(topicManager->ice_getCommunicator()->getLogger()),
+    _serial(0),
+    _dbSerial(dbSerial),
+    _dbGeneration(dbGeneration)
 {
     for(int i = 0; i < static_cast<int>(sizeof(encodings) / sizeof(Ice::EncodingVersion)); ++i)
     {
@@ -284,6 +307,15 @@ ObserverTopic::getContext(int serial, Ice::Long dbSerial) const
         ostringstream os;
         os << dbSerial;
         context["dbSerial"] = os.str();
+
+        //
+        // The generation identifies the database the serial belongs
+        // to, replicas only skip a synchronization if both match.
+        //
+        if(!_dbGeneration.empty())
+        {
+            context["dbGeneration"] = _dbGeneration;
+        }
     }
     return context;
 }
@@ -362,10 +394,17 @@ RegistryObserverTopic::initObserver(const Ice::ObjectPrx& obsv)
 }
 
 NodeObserverTopic::NodeObserverTopic(const IceStorm::TopicManagerPrx& topicManager,
-                                     const Ice::ObjectAdapterPtr& adapter) :
-    ObserverTopic(topicManager, "NodeObserver")
+                                     const Ice::ObjectAdapterPtr& adapter,
+                                     int coalescePeriod) :
+    ObserverTopic(topicManager, "NodeObserver"),
+    _coalescePeriod(IceUtil::Time::milliSeconds(coalescePeriod)),
+    _flushScheduled(false)
 {
     _publishers = getPublishers<NodeObserverPrx>();
+    if(coalescePeriod > 0)
+    {
+        _timer = new IceUtil::Timer();
+    }
     try
     {
         const_cast<NodeObserverPrx&>(_externalPublisher) = NodeObserverPrx::uncheckedCast(adapter->addWithUUID(this));
@@ -390,6 +429,7 @@ NodeObserverTopic::nodeUp(const NodeDynamicInfo& info, const Ice::Current&)
         return;
     }
     updateSerial();
+    flushNoSync();
     _nodes.insert(make_pair(info.info.name, info));
     for(ServerDynamicInfoSeq::const_iterator p = info.servers.begin(); p != info.servers.end(); ++p)
     {
@@ -466,6 +506,16 @@ NodeObserverTopic::updateServer(const string& node, const ServerDynamicInfo& ser
         _serverStatus.erase(server.id);
     }
 
+    if(_timer)
+    {
+        PendingUpdate update;
+        update.node = node;
+        update.isServer = true;
+        update.server = server;
+        addPendingUpdate(_pendingServers, server.id, update);
+        return;
+    }
+
     try
     {
         for(vector<NodeObserverPrx>::const_iterator p = _publishers.begin(); p != _publishers.end(); ++p)
@@ -522,6 +572,16 @@ NodeObserverTopic::updateAdapter(const string& node, const AdapterDynamicInfo& a
         adapters.push_back(adapter);
     }
 
+    if(_timer)
+    {
+        PendingUpdate update;
+        update.node = node;
+        update.isServer = false;
+        update.adapter = adapter;
+        addPendingUpdate(_pendingAdapters, adapter.id, update);
+        return;
+    }
+
     try
     {
         for(vector<NodeObserverPrx>::const_iterator p = _publishers.begin(); p != _publishers.end(); ++p)
@@ -546,6 +606,7 @@ NodeObserverTopic::nodeDown(const string& name)
     }
 
     updateSerial();
+    flushNoSync();
 
     if(_nodes.find(name) == _nodes.end())
     {
@@ -605,16 +666,120 @@ NodeObserverTopic::isServerEnabled(const string& server) const
     }
 }
 
+void
+NodeObserverTopic::flush()
+{
+    Lock sync(*this);
+    _flushScheduled = false;
+    if(_topics.empty())
+    {
+        return;
+    }
+    flushNoSync();
+}
+
+void
+NodeObserverTopic::destroy()
+{
+    IceUtil::TimerPtr timer;
+    {
+        Lock sync(*this);
+        timer = _timer;
+        _timer = 0;
+    }
+
+    //
+    // Destroy the timer without holding the lock, the flush timer task
+    // might be running.
+    //
+    if(timer)
+    {
+        timer->destroy();
+    }
+    ObserverTopic::destroy();
+}
+
+void
+NodeObserverTopic::scheduleFlush()
+{
+    assert(_timer);
+    if(!_flushScheduled)
+    {
+        _timer->schedule(new FlushTimerTask(this), _coalescePeriod);
+        _flushScheduled = true;
+    }
+}
+
+void
+NodeObserverTopic::addPendingUpdate(PendingUpdateMap& pending, const string& id, const PendingUpdate& update)
+{
+    //
+    // Replace the previous pending update of the server or adapter, if
+    // any. The update is moved to the end of the list to preserve the
+    // order with the updates of other servers and adapters.
+    //
+    pair<string, string> key = make_pair(update.node, id);
+    PendingUpdateMap::iterator p = pending.find(key);
+    if(p != pending.end())
+    {
+        _pendingUpdates.erase(p->second);
+        p->second = _pendingUpdates.insert(_pendingUpdates.end(), update);
+    }
+    else
+    {
+        pending.insert(make_pair(key, _pendingUpdates.insert(_pendingUpdates.end(), update)));
+    }
+    scheduleFlush();
+}
+
+void
+NodeObserverTopic::flushNoSync()
+{
+    //
+    // Publish the pending updates in order. Observers only get the last
+    // state of each server and adapter.
+    //
+    PendingUpdateList updates;
+    updates.swap(_pendingUpdates);
+    _pendingServers.clear();
+    _pendingAdapters.clear();
+
+    for(PendingUpdateList::const_iterator p = updates.begin(); p != updates.end(); ++p)
+    {
+        try
+        {
+            for(vector<NodeObserverPrx>::const_iterator q = _publishers.begin(); q != _publishers.end(); ++q)
+            {
+                if(p->isServer)
+                {
+                    (*q)->updateServer(p->node, p->server);
+                }
+                else
+                {
+                    (*q)->updateAdapter(p->node, p->adapter);
+                }
+            }
+        }
+        catch(const Ice::LocalException& ex)
+        {
+            Ice::Warning out(_logger);
+            out << "unexpected exception while publishing `" << (p->isServer ? "updateServer" : "updateAdapter")
+                << "' update:\n" << ex;
+        }
+    }
+}
+
 ApplicationObserverTopic::ApplicationObserverTopic(const IceStorm::TopicManagerPrx& topicManager,
-                                                   const map<string, ApplicationInfo>& applications, Ice::Long serial) :
-    ObserverTopic(topicManager, "ApplicationObserver", serial),
+                                                   const map<string, ApplicationInfo>& applications, Ice::Long serial,
+                                                   const string& generation) :
+    ObserverTopic(topicManager, "ApplicationObserver", serial, generation),
     _applications(applications)
 {
     _publishers = getPublishers<ApplicationObserverPrx>();
 }
 
 int
-ApplicationObserverTopic::applicationInit(Ice::Long dbSerial, const ApplicationInfoSeq& apps)
+ApplicationObserverTopic::applicationInit(Ice::Long dbSerial, const string& generation, const ApplicationInfoSeq& apps)
 {
     Lock sync(*this);
     if(_topics.empty())
@@ -622,6 +787,7 @@ ApplicationObserverTopic::applicationInit(Ice::Long dbSerial, const ApplicationI
         return -1;
     }
     updateSerial(dbSerial);
+    _dbGeneration = generation;
     _applications.clear();
     for(ApplicationInfoSeq::const_iterator p = apps.begin(); p != apps.end(); ++p)
     {
@@ -765,15 +931,16 @@ ApplicationObserverTopic::initObserver(const Ice::ObjectPrx& obsv)
 }
 
 AdapterObserverTopic::AdapterObserverTopic(const IceStorm::TopicManagerPrx& topicManager,
-                                           const map<string, AdapterInfo>& adapters, Ice::Long serial) :
-    ObserverTopic(topicManager, "AdapterObserver", serial),
+                                           const map<string, AdapterInfo>& adapters, Ice::Long serial,
+                                           const string& generation) :
+    ObserverTopic(topicManager, "AdapterObserver", serial, generation),
     _adapters(adapters)
 {
     _publishers = getPublishers<AdapterObserverPrx>();
 }
 
 int
-AdapterObserverTopic::adapterInit(Ice::Long dbSerial, const AdapterInfoSeq& adpts)
+AdapterObserverTopic::adapterInit(Ice::Long dbSerial, const string& generation, const AdapterInfoSeq& adpts)
 {
     Lock sync(*this);
     if(_topics.empty())
@@ -781,6 +948,7 @@ AdapterObserverTopic::adapterInit(Ice::Long dbSerial, const AdapterInfoSeq& adpt
         return -1;
     }
     updateSerial(dbSerial);
+    _dbGeneration = generation;
     _adapters.clear();
     for(AdapterInfoSeq::const_iterator q = adpts.begin(); q != adpts.end(); ++q)
     {
@@ -893,15 +1061,16 @@ AdapterObserverTopic::initObserver(const Ice::ObjectPrx& obsv)
 }
 
 ObjectObserverTopic::ObjectObserverTopic(const IceStorm::TopicManagerPrx& topicManager,
-                                         const map<Ice::Identity, ObjectInfo>& objects, Ice::Long serial) :
-    ObserverTopic(topicManager, "ObjectObserver", serial),
+                                         const map<Ice::Identity, ObjectInfo>& objects, Ice::Long serial,
+                                         const string& generation) :
+    ObserverTopic(topicManager, "ObjectObserver", serial, generation),
     _objects(objects)
 {
     _publishers = getPublishers<ObjectObserverPrx>();
 }
 
 int
-ObjectObserverTopic::objectInit(Ice::Long dbSerial, const ObjectInfoSeq& objects)
+ObjectObserverTopic::objectInit(Ice::Long dbSerial, const string& generation, const ObjectInfoSeq& objects)
 {
     Lock sync(*this);
     if(_topics.empty())
@@ -909,6 +1078,7 @@ ObjectObserverTopic::objectInit(Ice::Long dbSerial, const ObjectInfoSeq& objects
         return -1;
     }
     updateSerial(dbSerial);
+    _dbGeneration = generation;
     _objects.clear();
     for(ObjectInfoSeq::const_iterator r = objects.begin(); r != objects.end(); ++r)
     {
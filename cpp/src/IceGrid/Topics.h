@@ -11,10 +11,12 @@
 #define ICEGRID_TOPICS_H
 
 #include <IceUtil/Mutex.h>
+#include <IceUtil/Timer.h>
 #include <IceStorm/IceStorm.h>
 #include <IceGrid/Internal.h>
 #include <IceGrid/Registry.h>
 #include <set>
+#include <list>
 
 namespace IceGrid
 {
@@ -23,12 +25,13 @@ class ObserverTopic : public IceUtil::Monitor<IceUtil::Mutex>, public virtual Ic
 {
 public:
 
-    ObserverTopic(const IceStorm::TopicManagerPrx&, const std::string&, Ice::Long = 0);
+    ObserverTopic(const IceStorm::TopicManagerPrx&, const std::string&, Ice::Long = 0,
+                  const std::string& = std::string());
     virtual ~ObserverTopic();
 
     int subscribe(const Ice::ObjectPrx&, const std::string& = std::string());
     void unsubscribe(const Ice::ObjectPrx&, const std::string& = std::string());
-    void destroy();
+    virtual void destroy();
 
     void receivedUpdate(const std::string&, int, const std::string&);
 
@@ -60,6 +63,7 @@ protected:
     std::vector<Ice::ObjectPrx> _basePublishers;
     int _serial;
     Ice::Long _dbSerial;
+    std::string _dbGeneration;
 
     std::set<std::string> _syncSubscribers;
     std::map<int, std::set<std::string> > _waitForUpdates;
@@ -89,7 +93,7 @@ class NodeObserverTopic : public ObserverTopic, public NodeObserver
 {
 public:
 
-    NodeObserverTopic(const IceStorm::TopicManagerPrx&, const Ice::ObjectAdapterPtr&);
+    NodeObserverTopic(const IceStorm::TopicManagerPrx&, const Ice::ObjectAdapterPtr&, int = 0);
 
     virtual void nodeInit(const NodeDynamicInfoSeq&, const Ice::Current&);
     virtual void nodeUp(const NodeDynamicInfo&, const Ice::Current&);
@@ -104,12 +108,43 @@ public:
 
     bool isServerEnabled(const std::string&) const;
 
+    void flush();
+    virtual void destroy();
+
 private:
 
+    void scheduleFlush();
+    void flushNoSync();
+
     const NodeObserverPrx _externalPublisher;
     std::vector<NodeObserverPrx> _publishers;
     std::map<std::string, NodeDynamicInfo> _nodes;
     std::map<std::string, bool> _serverStatus;
+
+    //
+    // When the coalesce period is set, the server and adapter updates
+    // are published by the timer once the period elapsed. Only the
+    // last update of a server or adapter is published, the updates are
+    // published in the order of these last updates.
+    //
+    struct PendingUpdate
+    {
+        std::string node;
+        bool isServer;
+        ServerDynamicInfo server;
+        AdapterDynamicInfo adapter;
+    };
+    typedef std::list<PendingUpdate> PendingUpdateList;
+    typedef std::map<std::pair<std::string, std::string>, PendingUpdateList::iterator> PendingUpdateMap;
+
+    void addPendingUpdate(PendingUpdateMap&, const std::string&, const PendingUpdate&);
+
+    const IceUtil::Time _coalescePeriod;
+    IceUtil::TimerPtr _timer;
+    bool _flushScheduled;
+    PendingUpdateList _pendingUpdates;
+    PendingUpdateMap _pendingServers;
+    PendingUpdateMap _pendingAdapters;
 };
 typedef IceUtil::Handle<NodeObserverTopic> NodeObserverTopicPtr;
 
@@ -117,9 +152,10 @@ class ApplicationObserverTopic : public ObserverTopic
 {
 public:
 
-    ApplicationObserverTopic(const IceStorm::TopicManagerPrx&, const std::map<std::string, ApplicationInfo>&, Ice::Long);
+    ApplicationObserverTopic(const IceStorm::TopicManagerPrx&, const std::map<std::string, ApplicationInfo>&, Ice::Long,
+                             const std::string&);
 
-    int applicationInit(Ice::Long, const ApplicationInfoSeq&);
+    int applicationInit(Ice::Long, const std::string&, const ApplicationInfoSeq&);
     int applicationAdded(Ice::Long, const ApplicationInfo&);
     int applicationRemoved(Ice::Long, const std::string&);
     int applicationUpdated(Ice::Long, const ApplicationUpdateInfo&);
@@ -137,9 +173,10 @@ class AdapterObserverTopic : public ObserverTopic
 {
 public:
 
-    AdapterObserverTopic(const IceStorm::TopicManagerPrx&, const std::map<std::string, AdapterInfo>&, Ice::Long);
+    AdapterObserverTopic(const IceStorm::TopicManagerPrx&, const std::map<std::string, AdapterInfo>&, Ice::Long,
+                         const std::string&);
 
-    int adapterInit(Ice::Long, const AdapterInfoSeq&);
+    int adapterInit(Ice::Long, const std::string&, const AdapterInfoSeq&);
     int adapterAdded(Ice::Long, const AdapterInfo&);
     int adapterUpdated(Ice::Long, const AdapterInfo&);
     int adapterRemoved(Ice::Long, const std::string&);
@@ -157,9 +194,10 @@ class ObjectObserverTopic : public ObserverTopic
 {
 public:
 
-    ObjectObserverTopic(const IceStorm::TopicManagerPrx&, const std::map<Ice::Identity, ObjectInfo>&, Ice::Long);
+    ObjectObserverTopic(const IceStorm::TopicManagerPrx&, const std::map<Ice::Identity, ObjectInfo>&, Ice::Long,
+                        const std::string&);
 
-    int objectInit(Ice::Long, const ObjectInfoSeq&);
+    int objectInit(Ice::Long, const std::string&, const ObjectInfoSeq&);
     int objectAdded(Ice::Long, const ObjectInfo&);
     int objectUpdated(Ice::Long, const ObjectInfo&);
     int objectRemoved(Ice::Long, const Ice::Identity&);
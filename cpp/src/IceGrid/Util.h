@@ -171,6 +171,27 @@ inline getMatchingKeys(const T& m, const std::string& expression)
     return keys;
 }
 
+//
+// Add to the given sequence up to max keys matching the expression
+// and following the cursor key. The cursor is set to the last
+// visited key. Returns true if there are no more keys to visit.
+//
+template<class T> bool
+inline getMatchingKeys(const T& m, const std::string& expression, std::string& cursor, int max,
+                       std::vector<std::string>& keys)
+{
+    typename T::const_iterator p = cursor.empty() ? m.begin() : m.upper_bound(cursor);
+    for(; p != m.end() && static_cast<int>(keys.size()) < max; ++p)
+    {
+        if(expression.empty() || IceUtilInternal::match(p->first, expression, true))
+        {
+            keys.push_back(p->first);
+        }
+        cursor = p->first;
+    }
+    return p == m.end();
+}
+
 };
 
 #endif
@@ -13,6 +13,7 @@
 #include <Ice/ConsoleUtil.h>
 #include <IcePatch2Lib/Util.h>
 #include <iterator>
+#include <sstream>
 
 using namespace std;
 using namespace Ice;
@@ -109,6 +110,9 @@ usage(const string& appName)
         "-z, --compress          Always compress files.\n"
         "-Z, --no-compress       Never compress files.\n"
         "-i, --case-insensitive  Files must not differ in case only.\n"
+        "-t, --threads NUM       Compute checksums and compress files with NUM threads.\n"
+        "-I, --incremental       Only compute checksums of files modified since the\n"
+        "                        last full run.\n"
         "-V, --verbose           Verbose mode.\n"
         ;
 }
@@ -133,6 +137,8 @@ main(int argc, char* argv[])
     int compress = 1;
     bool verbose;
     bool caseInsensitive;
+    int threads = 1;
+    bool incremental;
 
     IceUtilInternal::Options opts;
     opts.addOpt("h", "help");
@@ -141,6 +147,8 @@ main(int argc, char* argv[])
     opts.addOpt("Z", "no-compress");
     opts.addOpt("V", "verbose");
     opts.addOpt("i", "case-insensitive");
+    opts.addOpt("t", "threads", IceUtilInternal::Options::NeedArg);
+    opts.addOpt("I", "incremental");
 
     vector<string> args;
     try
@@ -182,6 +190,17 @@ main(int argc, char* argv[])
     }
     verbose = opts.isSet("verbose");
     caseInsensitive = opts.isSet("case-insensitive");
+    incremental = opts.isSet("incremental");
+    if(opts.isSet("threads"))
+    {
+        istringstream is(opts.optArg("threads"));
+        if(!(is >> threads) || threads < 1)
+        {
+            consoleErr << appName << ": the number of threads must be a positive integer" << endl;
+            usage(appName);
+            return EXIT_FAILURE;
+        }
+    }
 
     if(args.empty())
     {
@@ -238,10 +257,27 @@ main(int argc, char* argv[])
 
         LargeFileInfoSeq infoSeq;
 
+        //
+        // The start time of a full run is recorded as the modification
+        // time of a temporary file, which replaces the checksum time file
+        // once the summary file is saved. Incremental runs only re-use the
+        // checksums of files which weren't modified since this time.
+        //
+        const string pathTime = simplify(absDataDir + '/' + checksumTimeFile);
+        const string pathTimeTemp = pathTime + "temp";
         if(fileSeq.empty())
         {
+            IceUtilInternal::remove(pathTimeTemp);
+            FILE* fp = IceUtilInternal::fopen(pathTimeTemp, "wb");
+            if(!fp)
+            {
+                throw runtime_error("cannot open `" + pathTimeTemp + "' for writing:\n" +
+                                    IceUtilInternal::lastErrorToString());
+            }
+            fclose(fp);
+
             CalcCB calcCB;
-            if(!getFileInfoSeq(absDataDir, compress, verbose ? &calcCB : 0, infoSeq))
+            if(!getFileInfoSeq(absDataDir, compress, verbose ? &calcCB : 0, infoSeq, threads, incremental))
             {
                 return EXIT_FAILURE;
             }
@@ -255,7 +291,8 @@ main(int argc, char* argv[])
                 LargeFileInfoSeq partialInfoSeq;
 
                 CalcCB calcCB;
-                if(!getFileInfoSeqSubDir(absDataDir, *p, compress, verbose ? &calcCB : 0, partialInfoSeq))
+                if(!getFileInfoSeqSubDir(absDataDir, *p, compress, verbose ? &calcCB : 0, partialInfoSeq, threads,
+                                         incremental))
                 {
                     return EXIT_FAILURE;
                 }
@@ -309,6 +346,11 @@ main(int argc, char* argv[])
         }
 
         saveFileInfoSeq(absDataDir, infoSeq);
+
+        if(fileSeq.empty())
+        {
+            IcePatch2Internal::rename(pathTimeTemp, pathTime);
+        }
     }
     catch(const exception& ex)
     {
@@ -28,6 +28,14 @@ IcePatch2::FileServerI::FileServerI(const std::string& dataDir, const LargeFileI
 {
     FileTree0& tree0 = const_cast<FileTree0&>(_tree0);
     getFileTree0(infoSeq, tree0);
+
+    for(LargeFileInfoSeq::const_iterator p = infoSeq.begin(); p != infoSeq.end(); ++p)
+    {
+        if(p->size >= 0) // Skip directories.
+        {
+            _files.insert(p->path);
+        }
+    }
 }
 
 FileInfoSeq
@@ -77,7 +85,7 @@ IcePatch2::FileServerI::getFileCompressed_async(const AMD_FileServer_getFileComp
     try
     {
         vector<Byte> buffer;
-        getFileCompressedInternal(pa, pos, num, buffer, false);
+        getFileInternal(pa, pos, num, buffer, false, true);
         if(buffer.empty())
         {
             cb->ice_response(make_pair<const Byte*, const Byte*>(0, 0));
@@ -100,7 +108,7 @@ IcePatch2::FileServerI::getLargeFileCompressed_async(const AMD_FileServer_getLar
     try
     {
         vector<Byte> buffer;
-        getFileCompressedInternal(pa, pos, num, buffer, true);
+        getFileInternal(pa, pos, num, buffer, true, true);
         if(buffer.empty())
         {
             cb->ice_response(make_pair<const Byte*, const Byte*>(0, 0));
@@ -117,9 +125,71 @@ IcePatch2::FileServerI::getLargeFileCompressed_async(const AMD_FileServer_getLar
     }
 }
 
+ByteSeqSeq
+IcePatch2::FileServerI::getLargeFileBlockChecksumSeq(const string& pa, Int& blockSize, const Current&) const
+{
+    string path = getPath(pa);
+
+    blockSize = checksumBlockSize;
+
+    Ice::Long blockCount = getBlockCount(path);
+    if(blockCount <= 0)
+    {
+        return ByteSeqSeq();
+    }
+
+    ByteSeq bytes;
+    Int size = static_cast<Int>(blockCount * 20);
+    getFileInternal(path + blockChecksumsSuffix, blockChecksumsHeaderSize, size, bytes, true, false);
+    if(bytes.size() != static_cast<size_t>(size))
+    {
+        return ByteSeqSeq();
+    }
+
+    ByteSeqSeq checksums(static_cast<size_t>(blockCount));
+    for(size_t i = 0; i < checksums.size(); ++i)
+    {
+        checksums[i].assign(bytes.begin() + i * 20, bytes.begin() + (i + 1) * 20);
+    }
+    return checksums;
+}
+
 void
-IcePatch2::FileServerI::getFileCompressedInternal(const std::string& pa, Ice::Long pos, Ice::Int num,
-                                                  vector<Byte>& buffer, bool largeFile) const
+IcePatch2::FileServerI::getLargeFile_async(const AMD_FileServer_getLargeFilePtr& cb,
+                                           const string& pa, Long pos, Int num, const Current&) const
+{
+    try
+    {
+        //
+        // Uncompressed contents are only returned for the files of the
+        // summary whose block checksums were computed from the current
+        // contents of the file.
+        //
+        string path = getPath(pa);
+        if(getBlockCount(path) <= 0)
+        {
+            throw FileAccessException("no valid block checksums for `" + path + "'");
+        }
+
+        vector<Byte> buffer;
+        getFileInternal(path, pos, num, buffer, true, false);
+        if(buffer.empty())
+        {
+            cb->ice_response(make_pair<const Byte*, const Byte*>(0, 0));
+        }
+        else
+        {
+            cb->ice_response(make_pair<const Byte*, const Byte*>(&buffer[0], &buffer[0] + buffer.size()));
+        }
+    }
+    catch(const std::exception& ex)
+    {
+        cb->ice_exception(ex);
+    }
+}
+
+string
+IcePatch2::FileServerI::getPath(const string& pa) const
 {
     if(IceUtilInternal::isAbsolutePath(pa))
     {
@@ -135,12 +205,67 @@ IcePatch2::FileServerI::getFileCompressedInternal(const std::string& pa, Ice::Lo
         throw FileAccessException(string("illegal `..' component in path `") + path + "'");
     }
 
+    return path;
+}
+
+Ice::Long
+IcePatch2::FileServerI::getBlockCount(const string& path) const
+{
+    if(_files.find(path) == _files.end())
+    {
+        throw FileAccessException("`" + path + "' is not a file of the distribution");
+    }
+
+    //
+    // The block checksums are only valid if they were computed from the
+    // current contents of the file: the checksums file must be newer
+    // than the file and record its current size. Otherwise, -1 is
+    // returned and the client falls back to downloading the whole
+    // compressed file.
+    //
+    string absolutePath = _dataDir + '/' + path;
+    IceUtilInternal::structstat buf;
+    IceUtilInternal::structstat bufBlocks;
+    if(IceUtilInternal::stat(absolutePath, &buf) == -1 ||
+       IceUtilInternal::stat(absolutePath + blockChecksumsSuffix, &bufBlocks) == -1 ||
+       !isOlder(buf, bufBlocks))
+    {
+        return -1;
+    }
+
+    Ice::Long blockCount = (buf.st_size + checksumBlockSize - 1) / checksumBlockSize;
+    if(bufBlocks.st_size != blockChecksumsHeaderSize + blockCount * 20)
+    {
+        return -1;
+    }
+
+    ByteSeq header;
+    getFileInternal(path + blockChecksumsSuffix, 0, blockChecksumsHeaderSize, header, true, false);
+    if(header.size() != static_cast<size_t>(blockChecksumsHeaderSize))
+    {
+        return -1;
+    }
+
+    Ice::Long size = 0;
+    for(size_t i = 0; i < header.size(); ++i)
+    {
+        size |= static_cast<Ice::Long>(header[i]) << (8 * i);
+    }
+    return size == buf.st_size ? blockCount : -1;
+}
+
+void
+IcePatch2::FileServerI::getFileInternal(const std::string& pa, Ice::Long pos, Ice::Int num,
+                                        vector<Byte>& buffer, bool largeFile, bool compressed) const
+{
+    string path = getPath(pa);
+
     if(num <= 0 || pos < 0)
     {
         return;
     }
 
-    string absolutePath = _dataDir + '/' + path + ".bz2";
+    string absolutePath = _dataDir + '/' + path + (compressed ? ".bz2" : "");
     int fd = IceUtilInternal::open(absolutePath, O_RDONLY|O_BINARY);
     if(fd == -1)
     {
@@ -195,4 +320,13 @@ IcePatch2::FileServerI::getFileCompressedInternal(const std::string& pa, Ice::Lo
     }
 
     IceUtilInternal::close(fd);
+
+    //
+    // The compressed file contents are always returned with the
+    // requested size for compatibility with older clients.
+    //
+    if(!compressed)
+    {
+        buffer.resize(static_cast<size_t>(r));
+    }
 }
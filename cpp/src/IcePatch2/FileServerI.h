@@ -12,6 +12,7 @@
 
 #include <IcePatch2Lib/Util.h>
 #include <IcePatch2/FileServer.h>
+#include <set>
 
 namespace IcePatch2
 {
@@ -43,17 +44,30 @@ public:
                                       Ice::Int,
                                       const Ice::Current&) const;
 
+    ByteSeqSeq getLargeFileBlockChecksumSeq(const std::string&, Ice::Int&, const Ice::Current&) const;
+
+    void getLargeFile_async(const AMD_FileServer_getLargeFilePtr&,
+                            const std::string&,
+                            Ice::Long,
+                            Ice::Int,
+                            const Ice::Current&) const;
+
 private:
 
+    std::string getPath(const std::string&) const;
+    Ice::Long getBlockCount(const std::string&) const;
+
     void
-    getFileCompressedInternal(const std::string&,
-                              Ice::Long,
-                              Ice::Int,
-                              std::vector<Ice::Byte>&,
-                              bool) const;
+    getFileInternal(const std::string&,
+                    Ice::Long,
+                    Ice::Int,
+                    std::vector<Ice::Byte>&,
+                    bool,
+                    bool) const;
 
     const std::string _dataDir;
     const IcePatch2Internal::FileTree0 _tree0;
+    std::set<std::string> _files;
 };
 
 }
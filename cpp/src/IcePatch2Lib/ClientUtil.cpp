@@ -9,11 +9,19 @@
 
 #include <IceUtil/StringUtil.h>
 #include <IceUtil/FileUtil.h>
+#include <Ice/SHA1.h>
 #include <IcePatch2/ClientUtil.h>
 #include <IcePatch2Lib/Util.h>
 #include <list>
+#include <set>
 #include <iterator>
 
+#ifdef _WIN32
+#   include <io.h>
+#else
+#   include <unistd.h>
+#endif
+
 using namespace std;
 using namespace Ice;
 using namespace IceUtil;
@@ -37,7 +45,7 @@ class Decompressor : public IceUtil::Thread, public IceUtil::Monitor<IceUtil::Mu
 {
 public:
 
-    Decompressor(const string&);
+    Decompressor(const string&, bool);
     virtual ~Decompressor();
 
     void destroy();
@@ -49,6 +57,7 @@ public:
 private:
 
     const string _dataDir;
+    const bool _keepCompressed;
 
     string _exception;
     list<LargeFileInfo> _files;
@@ -62,7 +71,7 @@ class PatcherI : public Patcher
 public:
 
     PatcherI(const Ice::CommunicatorPtr&, const PatcherFeedbackPtr&);
-    PatcherI(const FileServerPrx&, const PatcherFeedbackPtr&, const std::string&, bool, Ice::Int, Ice::Int);
+    PatcherI(const FileServerPrx&, const PatcherFeedbackPtr&, const std::string&, bool, Ice::Int, Ice::Int, bool);
     virtual ~PatcherI();
 
     virtual bool prepare();
@@ -77,11 +86,16 @@ private:
     bool updateFilesInternal(const LargeFileInfoSeq&, const DecompressorPtr&);
     bool updateFlags(const LargeFileInfoSeq&);
 
+    bool canPatchBlocks(const LargeFileInfo&) const;
+    ByteSeqSeq getBlockChecksumSeq(const LargeFileInfo&, Ice::Int&);
+    bool patchBlocks(const LargeFileInfo&, const ByteSeqSeq&, Ice::Int, Ice::Long&, Ice::Long);
+
     const PatcherFeedbackPtr _feedback;
     const std::string _dataDir;
     const bool _thorough;
     const Ice::Int _chunkSize;
     const Ice::Int _remove;
+    const bool _keepCompressed;
     const FileServerPrx _serverCompress;
     const FileServerPrx _serverNoCompress;
 
@@ -92,10 +106,12 @@ private:
 
     FILE* _log;
     bool _useSmallFileAPI;
+    bool _useBlockAPI;
 };
 
-Decompressor::Decompressor(const string& dataDir) :
+Decompressor::Decompressor(const string& dataDir, bool keepCompressed) :
     _dataDir(dataDir),
+    _keepCompressed(keepCompressed),
     _destroy(false)
 {
 }
@@ -186,7 +202,10 @@ Decompressor::run()
         {
             decompressFile(_dataDir + '/' + info.path);
             setFileFlags(_dataDir + '/' + info.path, info);
-            remove(_dataDir + '/' + info.path + ".bz2");
+            if(!_keepCompressed)
+            {
+                remove(_dataDir + '/' + info.path + ".bz2");
+            }
         }
         catch(const std::exception& ex)
         {
@@ -204,8 +223,10 @@ PatcherI::PatcherI(const CommunicatorPtr& communicator, const PatcherFeedbackPtr
     _thorough(communicator->getProperties()->getPropertyAsIntWithDefault("IcePatch2Client.Thorough", 0) > 0),
     _chunkSize(communicator->getProperties()->getPropertyAsIntWithDefault("IcePatch2Client.ChunkSize", 100)),
     _remove(communicator->getProperties()->getPropertyAsIntWithDefault("IcePatch2Client.Remove", 1)),
+    _keepCompressed(false),
     _log(0),
-    _useSmallFileAPI(false)
+    _useSmallFileAPI(false),
+    _useBlockAPI(true)
 {
     const char* clientProxyProperty = "IcePatch2Client.Proxy";
     string clientProxy = communicator->getProperties()->getProperty(clientProxyProperty);
@@ -228,13 +249,16 @@ PatcherI::PatcherI(const FileServerPrx& server,
                    const string& dataDir,
                    bool thorough,
                    Ice::Int chunkSize,
-                   Ice::Int remove) :
+                   Ice::Int remove,
+                   bool keepCompressed) :
     _feedback(feedback),
     _dataDir(dataDir),
     _thorough(thorough),
     _chunkSize(chunkSize),
     _remove(remove),
-    _useSmallFileAPI(false)
+    _keepCompressed(keepCompressed),
+    _useSmallFileAPI(false),
+    _useBlockAPI(true)
 {
     init(server);
 }
@@ -649,11 +673,40 @@ PatcherI::removeFiles(const LargeFileInfoSeq& files)
         return true;
     }
 
+    //
+    // Regular files whose contents are updated are not removed, their
+    // current contents are used as the base for block-level patching.
+    //
+    set<string> updatePaths;
+    if(_useBlockAPI && !_useSmallFileAPI && !_keepCompressed)
+    {
+        for(LargeFileInfoSeq::const_iterator p = _updateFiles.begin(); p != _updateFiles.end(); ++p)
+        {
+            if(p->size > 0)
+            {
+                updatePaths.insert(p->path);
+            }
+        }
+    }
+
     for(LargeFileInfoSeq::const_reverse_iterator p = files.rbegin(); p != files.rend(); ++p)
     {
         try
         {
-            remove(_dataDir + '/' + p->path);
+            if(p->size < 0 || updatePaths.find(p->path) == updatePaths.end())
+            {
+                remove(_dataDir + '/' + p->path);
+            }
+            if(_keepCompressed && p->size > 0)
+            {
+                try
+                {
+                    remove(_dataDir + '/' + p->path + ".bz2");
+                }
+                catch(...)
+                {
+                }
+            }
             if(fputc('-', _log) == EOF || ! writeFileInfo(_log, *p))
             {
                 throw runtime_error("error writing log file:\n" + IceUtilInternal::lastErrorToString());
@@ -697,7 +750,7 @@ PatcherI::removeFiles(const LargeFileInfoSeq& files)
 bool
 PatcherI::updateFiles(const LargeFileInfoSeq& files)
 {
-    DecompressorPtr decompressor = new Decompressor(_dataDir);
+    DecompressorPtr decompressor = new Decompressor(_dataDir, _keepCompressed);
 #if defined(__hppa)
     //
     // The thread stack size is only 64KB only HP-UX and that's not
@@ -763,6 +816,18 @@ PatcherI::updateFilesInternal(const LargeFileInfoSeq& files, const DecompressorP
                 return false;
             }
 
+            //
+            // If the first chunk of the compressed file wasn't already
+            // requested, check if the file can be patched block by block.
+            //
+            Int blockSize = 0;
+            ByteSeqSeq blockChecksums;
+            if(p->size > 0 && !nxtCB)
+            {
+                curCB = 0;
+                blockChecksums = getBlockChecksumSeq(*p, blockSize);
+            }
+
             if(p->size == 0)
             {
                 string path = simplify(_dataDir + '/' + p->path);
@@ -773,6 +838,13 @@ PatcherI::updateFilesInternal(const LargeFileInfoSeq& files, const DecompressorP
                 }
                 fclose(fp);
             }
+            else if(!blockChecksums.empty())
+            {
+                if(!patchBlocks(*p, blockChecksums, blockSize, updated, total))
+                {
+                    return false;
+                }
+            }
             else
             {
                 string pathBZ2 = simplify(_dataDir + '/' + p->path + ".bz2");
@@ -831,7 +903,7 @@ PatcherI::updateFilesInternal(const LargeFileInfoSeq& files, const DecompressorP
                                 ++q;
                             }
 
-                            if(q != files.end())
+                            if(q != files.end() && !canPatchBlocks(*q))
                             {
                                 nxtCB = _useSmallFileAPI ?
                                     _serverNoCompress->begin_getFileCompressed(q->path, 0, _chunkSize) :
@@ -971,6 +1043,229 @@ PatcherI::updateFlags(const LargeFileInfoSeq& files)
     return true;
 }
 
+bool
+PatcherI::canPatchBlocks(const LargeFileInfo& info) const
+{
+    if(!_useBlockAPI || _useSmallFileAPI || _keepCompressed || info.size <= 0)
+    {
+        return false;
+    }
+
+    //
+    // A file can only be patched block by block if a previous version
+    // of the file exists in the data directory.
+    //
+    IceUtilInternal::structstat buf;
+    return IceUtilInternal::stat(simplify(_dataDir + '/' + info.path), &buf) != -1 &&
+        S_ISREG(buf.st_mode) && buf.st_size > 0;
+}
+
+ByteSeqSeq
+PatcherI::getBlockChecksumSeq(const LargeFileInfo& info, Int& blockSize)
+{
+    if(!canPatchBlocks(info))
+    {
+        return ByteSeqSeq();
+    }
+
+    ByteSeqSeq checksums;
+    try
+    {
+        checksums = _serverNoCompress->getLargeFileBlockChecksumSeq(info.path, blockSize);
+    }
+    catch(const Ice::OperationNotExistException&)
+    {
+        //
+        // The server doesn't support block-level patching.
+        //
+        _useBlockAPI = false;
+        return ByteSeqSeq();
+    }
+    catch(const FileAccessException& ex)
+    {
+        throw runtime_error("error from IcePatch2 server for `" + info.path + "': " + ex.reason);
+    }
+
+    if(blockSize <= 0)
+    {
+        return ByteSeqSeq();
+    }
+    return checksums;
+}
+
+bool
+PatcherI::patchBlocks(const LargeFileInfo& info, const ByteSeqSeq& checksums, Int blockSize, Long& updated,
+                      Long total)
+{
+    const string path = simplify(_dataDir + '/' + info.path);
+    const string pathTemp = path + ".icepatch2temp";
+
+    int fd = IceUtilInternal::open(path, O_BINARY|O_RDONLY);
+    if(fd == -1)
+    {
+        throw runtime_error("cannot open `" + path + "' for reading:\n" + IceUtilInternal::lastErrorToString());
+    }
+
+    FILE* fileTemp = IceUtilInternal::fopen(pathTemp, "wb");
+    if(fileTemp == 0)
+    {
+        IceUtilInternal::close(fd);
+        throw runtime_error("cannot open `" + pathTemp + "' for writing:\n" + IceUtilInternal::lastErrorToString());
+    }
+
+    bool aborted = false;
+    try
+    {
+        IceInternal::SHA1 hasher;
+        hasher.update(reinterpret_cast<const IceUtil::Byte*>(info.path.c_str()), info.path.size());
+
+        Long pos = 0;
+        Long progress = 0;
+        for(ByteSeqSeq::size_type i = 0; i < checksums.size(); ++i)
+        {
+            //
+            // Read the block from the previous version of the file, the
+            // file is read sequentially so the block is at the same offset
+            // as the block from the new version of the file.
+            //
+            ByteSeq bytes(static_cast<size_t>(blockSize));
+            size_t size = 0;
+            while(size < bytes.size())
+            {
+#if defined(_MSC_VER)
+                int r = _read(fd, &bytes[size], static_cast<unsigned int>(bytes.size() - size));
+#else
+                ssize_t r = read(fd, &bytes[size], bytes.size() - size);
+#endif
+                if(r == -1)
+                {
+                    throw runtime_error("cannot read from `" + path + "':\n" + IceUtilInternal::lastErrorToString());
+                }
+                else if(r == 0)
+                {
+                    break;
+                }
+                size += static_cast<size_t>(r);
+            }
+            bytes.resize(size);
+
+            ByteSeq bytesSHA;
+            if(!bytes.empty())
+            {
+                IceInternal::sha1(&bytes[0], bytes.size(), bytesSHA);
+            }
+
+            if(bytesSHA != checksums[i])
+            {
+                //
+                // The block changed, download it from the server with
+                // protocol compression enabled.
+                //
+                bytes.clear();
+                while(bytes.size() < static_cast<size_t>(blockSize))
+                {
+                    Int num = min(_chunkSize, static_cast<Int>(blockSize - bytes.size()));
+                    ByteSeq chunk;
+                    try
+                    {
+                        chunk = _serverCompress->getLargeFile(info.path, pos + static_cast<Long>(bytes.size()), num);
+                    }
+                    catch(const FileAccessException& ex)
+                    {
+                        throw runtime_error("error from IcePatch2 server for `" + info.path + "': " + ex.reason);
+                    }
+
+                    bytes.insert(bytes.end(), chunk.begin(), chunk.end());
+                    if(chunk.size() < static_cast<size_t>(num))
+                    {
+                        break; // End of file.
+                    }
+                }
+
+                bytesSHA.clear();
+                if(!bytes.empty())
+                {
+                    IceInternal::sha1(&bytes[0], bytes.size(), bytesSHA);
+                }
+
+                if(bytesSHA != checksums[i])
+                {
+                    throw runtime_error("block checksum mismatch for `" + info.path + "'");
+                }
+            }
+
+            if(!bytes.empty())
+            {
+                if(fwrite(reinterpret_cast<char*>(&bytes[0]), bytes.size(), 1, fileTemp) != 1)
+                {
+                    throw runtime_error("cannot write `" + pathTemp + "':\n" + IceUtilInternal::lastErrorToString());
+                }
+                hasher.update(&bytes[0], bytes.size());
+            }
+            pos += static_cast<Long>(bytes.size());
+
+            //
+            // The progress is reported relative to the size of the
+            // compressed file.
+            //
+            Long newProgress = info.size * static_cast<Long>(i + 1) / static_cast<Long>(checksums.size());
+            updated += newProgress - progress;
+            progress = newProgress;
+            if(!_feedback->patchProgress(progress, info.size, updated, total))
+            {
+                aborted = true;
+                break;
+            }
+        }
+
+        if(!aborted)
+        {
+            ByteSeq bytesSHA;
+            hasher.finalize(bytesSHA);
+            if(bytesSHA != info.checksum)
+            {
+                throw runtime_error("checksum mismatch for `" + info.path + "'");
+            }
+        }
+    }
+    catch(...)
+    {
+        IceUtilInternal::close(fd);
+        fclose(fileTemp);
+        try
+        {
+            remove(pathTemp);
+        }
+        catch(...)
+        {
+        }
+        throw;
+    }
+
+    IceUtilInternal::close(fd);
+    if(aborted)
+    {
+        fclose(fileTemp);
+        remove(pathTemp);
+        return false;
+    }
+
+    if(fclose(fileTemp) != 0)
+    {
+        throw runtime_error("cannot write `" + pathTemp + "':\n" + IceUtilInternal::lastErrorToString());
+    }
+
+    rename(pathTemp, path);
+    setFileFlags(path, info);
+
+    if(fputc('+', _log) == EOF || !writeFileInfo(_log, info))
+    {
+        throw runtime_error("error writing log file:\n" + IceUtilInternal::lastErrorToString());
+    }
+
+    return true;
+}
+
 }
 
 PatcherPtr
@@ -991,5 +1286,17 @@ PatcherFactory::create(const FileServerPrx& server,
                        Ice::Int chunkSize,
                        Ice::Int remove)
 {
-    return new PatcherI(server, feedback, dataDir, thorough, chunkSize, remove);
+    return new PatcherI(server, feedback, dataDir, thorough, chunkSize, remove, false);
+}
+
+PatcherPtr
+IcePatch2Internal::createPatcher(const FileServerPrx& server,
+                                 const PatcherFeedbackPtr& feedback,
+                                 const string& dataDir,
+                                 bool thorough,
+                                 Ice::Int chunkSize,
+                                 Ice::Int remove,
+                                 bool keepCompressed)
+{
+    return new PatcherI(server, feedback, dataDir, thorough, chunkSize, remove, keepCompressed);
 }
@@ -41,6 +41,10 @@
 
 const char* IcePatch2Internal::checksumFile = "IcePatch2.sum";
 const char* IcePatch2Internal::logFile = "IcePatch2.log";
+const char* IcePatch2Internal::checksumTimeFile = "IcePatch2.time";
+const Ice::Int IcePatch2Internal::checksumBlockSize = 1024 * 1024;
+const char* IcePatch2Internal::blockChecksumsSuffix = ".icepatch2blocks";
+const Ice::Int IcePatch2Internal::blockChecksumsHeaderSize = 8;
 
 using namespace std;
 using namespace Ice;
@@ -330,7 +334,10 @@ IcePatch2Internal::ignoreSuffix(const string& path)
     return suffix == "md5" // For legacy IcePatch.
         || suffix == "tot" // For legacy IcePatch.
         || suffix == "bz2"
-        || suffix == "bz2temp";
+        || suffix == "bz2temp"
+        || suffix == "icepatch2blocks"
+        || suffix == "icepatch2blockstemp"
+        || suffix == "icepatch2temp";
 }
 
 string
@@ -624,6 +631,98 @@ IcePatch2Internal::compressBytesToFile(const string& pa, const ByteSeq& bytes, I
     fclose(stdioFile);
 }
 
+void
+IcePatch2Internal::compressFile(const string& pa)
+{
+    //
+    // Compress the file in chunks, the file can be too large to be
+    // loaded in memory.
+    //
+    const string path = simplify(pa);
+    const string pathBZ2 = path + ".bz2";
+    const string pathBZ2Temp = path + ".bz2temp";
+
+    FILE* fp = IceUtilInternal::fopen(path, "rb");
+    if(!fp)
+    {
+        throw runtime_error("cannot open `" + path + "' for reading:\n" + IceUtilInternal::lastErrorToString());
+    }
+
+    FILE* stdioFile = IceUtilInternal::fopen(pathBZ2Temp, "wb");
+    if(!stdioFile)
+    {
+        fclose(fp);
+        throw runtime_error("cannot open `" + pathBZ2Temp + "' for writing:\n" + IceUtilInternal::lastErrorToString());
+    }
+
+    int bzError;
+    BZFILE* bzFile = BZ2_bzWriteOpen(&bzError, stdioFile, 5, 0, 0);
+    if(bzError != BZ_OK)
+    {
+        string reason = "BZ2_bzWriteOpen failed";
+        if(bzError == BZ_IO_ERROR)
+        {
+            reason += ": " + IceUtilInternal::lastErrorToString();
+        }
+        fclose(stdioFile);
+        fclose(fp);
+        throw runtime_error(reason);
+    }
+
+    ByteSeq bytes(checksumBlockSize);
+    while(true)
+    {
+        size_t sz = fread(&bytes[0], 1, bytes.size(), fp);
+        if(sz == 0)
+        {
+            if(ferror(fp))
+            {
+                string reason = "cannot read from `" + path + "':\n" + IceUtilInternal::lastErrorToString();
+                BZ2_bzWriteClose(&bzError, bzFile, 0, 0, 0);
+                fclose(stdioFile);
+                fclose(fp);
+                throw runtime_error(reason);
+            }
+            break;
+        }
+
+        BZ2_bzWrite(&bzError, bzFile, &bytes[0], static_cast<int>(sz));
+        if(bzError != BZ_OK)
+        {
+            string reason = "BZ2_bzWrite failed";
+            if(bzError == BZ_IO_ERROR)
+            {
+                reason += ": " + IceUtilInternal::lastErrorToString();
+            }
+            BZ2_bzWriteClose(&bzError, bzFile, 0, 0, 0);
+            fclose(stdioFile);
+            fclose(fp);
+            throw runtime_error(reason);
+        }
+    }
+
+    fclose(fp);
+
+    BZ2_bzWriteClose(&bzError, bzFile, 0, 0, 0);
+    if(bzError != BZ_OK)
+    {
+        string reason = "BZ2_bzWriteClose failed";
+        if(bzError == BZ_IO_ERROR)
+        {
+            reason += ": " + IceUtilInternal::lastErrorToString();
+        }
+        fclose(stdioFile);
+        throw runtime_error(reason);
+    }
+
+    if(fclose(stdioFile) != 0)
+    {
+        throw runtime_error("cannot write `" + pathBZ2Temp + "':\n" + IceUtilInternal::lastErrorToString());
+    }
+
+    rename(pathBZ2Temp, pathBZ2);
+}
+
 void
 IcePatch2Internal::decompressFile(const string& pa)
 {
@@ -743,14 +842,368 @@ IcePatch2Internal::setFileFlags(const string&, const LargeFileInfo&)
 }
 #endif
 
+bool
+IcePatch2Internal::isOlder(const IceUtilInternal::structstat& lhs, const IceUtilInternal::structstat& rhs)
+{
+    if(lhs.st_mtime != rhs.st_mtime)
+    {
+        return lhs.st_mtime < rhs.st_mtime;
+    }
+#if defined(__APPLE__)
+    return lhs.st_mtimespec.tv_nsec < rhs.st_mtimespec.tv_nsec;
+#elif defined(__linux__)
+    return lhs.st_mtim.tv_nsec < rhs.st_mtim.tv_nsec;
+#else
+    return false; // Only seconds are available, assume the first file isn't older.
+#endif
+}
+
 namespace
 {
 
+static void
+writeBlockChecksums(const string& path, Ice::Long size, const ByteSeq& checksums)
+{
+    const string pathTemp = path + "temp";
+    FILE* fp = IceUtilInternal::fopen(pathTemp, "wb");
+    if(!fp)
+    {
+        throw runtime_error("cannot open `" + pathTemp + "' for writing:\n" + IceUtilInternal::lastErrorToString());
+    }
+
+    Byte header[8];
+    for(size_t i = 0; i < sizeof(header); ++i)
+    {
+        header[i] = static_cast<Byte>((size >> (8 * i)) & 0xFF);
+    }
+
+    if(fwrite(header, sizeof(header), 1, fp) != 1 ||
+       (!checksums.empty() && fwrite(&checksums[0], checksums.size(), 1, fp) != 1))
+    {
+        fclose(fp);
+        throw runtime_error("cannot write `" + pathTemp + "':\n" + IceUtilInternal::lastErrorToString());
+    }
+
+    if(fclose(fp) != 0)
+    {
+        throw runtime_error("cannot write `" + pathTemp + "':\n" + IceUtilInternal::lastErrorToString());
+    }
+
+    rename(pathTemp, path);
+}
+
+struct FileInfoJob
+{
+    LargeFileInfoSeq::size_type index;
+    string relPath;
+    string path;
+    Ice::Long size;
+    bool doCompress;
+};
+
+struct FileInfoJobSizeGreater : public binary_function<const FileInfoJob&, const FileInfoJob&, bool>
+{
+    bool
+    operator()(const FileInfoJob& lhs, const FileInfoJob& rhs)
+    {
+        return lhs.size > rhs.size;
+    }
+};
+
+struct FileInfoPathLess : public binary_function<const LargeFileInfo&, const LargeFileInfo&, bool>
+{
+    bool
+    operator()(const LargeFileInfo& lhs, const LargeFileInfo& rhs)
+    {
+        return lhs.path < rhs.path;
+    }
+};
+
+static void
+computeFileInfo(const FileInfoJob& job, LargeFileInfo& info)
+{
+    const string& relPath = job.relPath;
+    const string& path = job.path;
+    const bool doCompress = job.doCompress;
+    const string pathBZ2 = path + ".bz2";
+    const string pathBlocks = path + blockChecksumsSuffix;
+    IceUtilInternal::structstat bufBZ2;
+
+    ByteSeq bytesSHA;
+
+    if(relPath.size() + job.size == 0)
+    {
+        bytesSHA.resize(20);
+        fill(bytesSHA.begin(), bytesSHA.end(), 0);
+    }
+    else
+    {
+        IceInternal::SHA1 hasher;
+        if(relPath.size() != 0)
+        {
+            hasher.update(reinterpret_cast<const IceUtil::Byte*>(relPath.c_str()), relPath.size());
+        }
+
+        if(job.size != 0)
+        {
+            int fd = IceUtilInternal::open(path.c_str(), O_BINARY|O_RDONLY);
+            if(fd == -1)
+            {
+                throw runtime_error("cannot open `" + path + "' for reading:\n" + IceUtilInternal::lastErrorToString());
+            }
+
+            const string pathBZ2Temp = path + ".bz2temp";
+            FILE* stdioFile = 0;
+            int bzError = 0;
+            BZFILE* bzFile = 0;
+            ByteSeq blockChecksums;
+            if(doCompress)
+            {
+                stdioFile = IceUtilInternal::fopen(simplify(pathBZ2Temp), "wb");
+                if(!stdioFile)
+                {
+                    IceUtilInternal::close(fd);
+                    throw runtime_error("cannot open `" + pathBZ2Temp + "' for writing:\n" + IceUtilInternal::lastErrorToString());
+                }
+
+                bzFile = BZ2_bzWriteOpen(&bzError, stdioFile, 5, 0, 0);
+                if(bzError != BZ_OK)
+                {
+                    string reason = "BZ2_bzWriteOpen failed";
+                    if(bzError == BZ_IO_ERROR)
+                    {
+                        reason += ": " + IceUtilInternal::lastErrorToString();
+                    }
+                    fclose(stdioFile);
+                    IceUtilInternal::close(fd);
+                    throw runtime_error(reason);
+                }
+            }
+
+            long bytesLeft = job.size;
+            while(bytesLeft > 0)
+            {
+                ByteSeq bytes(min(bytesLeft, static_cast<long>(checksumBlockSize)));
+                if(
+#if defined(_MSC_VER)
+                    _read(fd, &bytes[0], static_cast<unsigned int>(bytes.size()))
+#else
+                    read(fd, &bytes[0], static_cast<unsigned int>(bytes.size()))
+#endif
+                    == -1)
+                {
+                    if(doCompress)
+                    {
+                        fclose(stdioFile);
+                    }
+
+                    IceUtilInternal::close(fd);
+                    throw runtime_error("cannot read from `" + path + "':\n" + IceUtilInternal::lastErrorToString());
+                }
+                bytesLeft -= static_cast<unsigned int>(bytes.size());
+                if(doCompress)
+                {
+                    BZ2_bzWrite(&bzError, bzFile, const_cast<Byte*>(&bytes[0]), static_cast<int>(bytes.size()));
+                    if(bzError != BZ_OK)
+                    {
+                        string reason = "BZ2_bzWrite failed";
+                        if(bzError == BZ_IO_ERROR)
+                        {
+                            reason += ": " + IceUtilInternal::lastErrorToString();
+                        }
+                        BZ2_bzWriteClose(&bzError, bzFile, 0, 0, 0);
+                        fclose(stdioFile);
+                        IceUtilInternal::close(fd);
+                        throw runtime_error(reason);
+                    }
+
+                    //
+                    // Each chunk read from the file is a block, the
+                    // last block might be smaller than the others.
+                    //
+                    ByteSeq blockSHA;
+                    IceInternal::sha1(reinterpret_cast<unsigned char*>(&bytes[0]), bytes.size(), blockSHA);
+                    blockChecksums.insert(blockChecksums.end(), blockSHA.begin(), blockSHA.end());
+                }
+
+                hasher.update(reinterpret_cast<IceUtil::Byte*>(&bytes[0]), bytes.size());
+            }
+
+            IceUtilInternal::close(fd);
+
+            if(doCompress)
+            {
+                BZ2_bzWriteClose(&bzError, bzFile, 0, 0, 0);
+                if(bzError != BZ_OK)
+                {
+                    string reason = "BZ2_bzWriteClose failed";
+                    if(bzError == BZ_IO_ERROR)
+                    {
+                        reason += ": " + IceUtilInternal::lastErrorToString();
+                    }
+                    fclose(stdioFile);
+                    throw runtime_error(reason);
+                }
+
+                fclose(stdioFile);
+
+                writeBlockChecksums(pathBlocks, job.size, blockChecksums);
+
+                rename(pathBZ2Temp, pathBZ2);
+
+                if(IceUtilInternal::stat(pathBZ2, &bufBZ2) == -1)
+                {
+                    throw runtime_error("cannot stat `" + pathBZ2 + "':\n" + IceUtilInternal::lastErrorToString());
+                }
+
+                info.size = bufBZ2.st_size;
+            }
+        }
+        hasher.finalize(bytesSHA);
+    }
+
+    info.checksum.swap(bytesSHA);
+}
+
+//
+// Computes the checksums and compresses the files collected by
+// getFileInfoSeqInternal, the files are distributed over the given
+// number of threads.
+//
+class FileInfoJobQueue : public IceUtil::Mutex
+{
+public:
+
+    FileInfoJobQueue(const vector<FileInfoJob>& jobs, GetFileInfoSeqCB* cb, LargeFileInfoSeq& infoSeq) :
+        _jobs(jobs),
+        _cb(cb),
+        _infoSeq(infoSeq),
+        _next(0),
+        _interrupted(false)
+    {
+    }
+
+    bool
+    run(int threads)
+    {
+        vector<IceUtil::ThreadPtr> workers;
+        try
+        {
+            for(int i = 1; i < threads && static_cast<size_t>(i) < _jobs.size(); ++i)
+            {
+                IceUtil::ThreadPtr worker = new Worker(*this);
+                worker->start();
+                workers.push_back(worker);
+            }
+        }
+        catch(...)
+        {
+            {
+                IceUtil::Mutex::Lock sync(*this);
+                _interrupted = true;
+            }
+            for(vector<IceUtil::ThreadPtr>::const_iterator p = workers.begin(); p != workers.end(); ++p)
+            {
+                (*p)->getThreadControl().join();
+            }
+            throw;
+        }
+
+        process();
+
+        for(vector<IceUtil::ThreadPtr>::const_iterator p = workers.begin(); p != workers.end(); ++p)
+        {
+            (*p)->getThreadControl().join();
+        }
+
+        if(!_exception.empty())
+        {
+            throw runtime_error(_exception);
+        }
+        return !_interrupted;
+    }
+
+    void
+    process()
+    {
+        while(true)
+        {
+            vector<FileInfoJob>::size_type i;
+            {
+                IceUtil::Mutex::Lock sync(*this);
+                if(_interrupted || !_exception.empty() || _next == _jobs.size())
+                {
+                    return;
+                }
+
+                i = _next++;
+
+                //
+                // The callback isn't thread-safe, it's called with the
+                // mutex locked.
+                //
+                if(_cb && ((_jobs[i].doCompress && !_cb->compress(_jobs[i].relPath)) ||
+                           !_cb->checksum(_jobs[i].relPath)))
+                {
+                    _interrupted = true;
+                    return;
+                }
+            }
+
+            try
+            {
+                computeFileInfo(_jobs[i], _infoSeq[_jobs[i].index]);
+            }
+            catch(const std::exception& ex)
+            {
+                IceUtil::Mutex::Lock sync(*this);
+                if(_exception.empty())
+                {
+                    _exception = ex.what();
+                }
+                return;
+            }
+        }
+    }
+
+private:
+
+    class Worker : public IceUtil::Thread
+    {
+    public:
+
+        Worker(FileInfoJobQueue& queue) :
+            _queue(queue)
+        {
+        }
+
+        virtual void
+        run()
+        {
+            _queue.process();
+        }
+
+    private:
+
+        FileInfoJobQueue& _queue;
+    };
+
+    const vector<FileInfoJob>& _jobs;
+    GetFileInfoSeqCB* const _cb;
+    LargeFileInfoSeq& _infoSeq;
+    vector<FileInfoJob>::size_type _next;
+    bool _interrupted;
+    string _exception;
+};
+
 static bool
-getFileInfoSeqInternal(const string& basePath, const string& relPath, int compress, GetFileInfoSeqCB* cb,
-                       LargeFileInfoSeq& infoSeq)
+getFileInfoSeqInternal(
+const string& basePath, const string& relPath, int compress, GetFileInfoSeqCB* cb,
+                       LargeFileInfoSeq& infoSeq, const LargeFileInfoSeq& previousInfoSeq, time_t since,
+                       vector<FileInfoJob>& jobs)
 {
-    if(relPath == checksumFile || relPath == logFile)
+    if(relPath == checksumFile || relPath == logFile || relPath == checksumTimeFile ||
+       relPath == string(checksumTimeFile) + "temp")
     {
         return true;
     }
@@ -835,7 +1288,8 @@ getFileInfoSeqInternal(const string& basePath, const string& relPath, int compre
             StringSeq content = readDirectory(path);
             for(StringSeq::const_iterator p = content.begin(); p != content.end() ; ++p)
             {
-                if(!getFileInfoSeqInternal(basePath, simplify(relPath + '/' + *p), compress, cb, infoSeq))
+                if(!getFileInfoSeqInternal(basePath, simplify(relPath + '/' + *p), compress, cb, infoSeq,
+                                           previousInfoSeq, since, jobs))
                 {
                     return false;
                 }
@@ -853,7 +1307,9 @@ getFileInfoSeqInternal(const string& basePath, const string& relPath, int compre
 #endif
 
             IceUtilInternal::structstat bufBZ2;
+            IceUtilInternal::structstat bufBlocks;
             const string pathBZ2 = path + ".bz2";
+            const string pathBlocks = path + blockChecksumsSuffix;
             bool doCompress = false;
             if(buf.st_size != 0 && compress > 0)
             {
@@ -862,13 +1318,12 @@ getFileInfoSeqInternal(const string& basePath, const string& relPath, int compre
                 // compress == 1: Compress if necessary.
                 // compress >= 2: Always compress.
                 //
-                if(compress >= 2 || IceUtilInternal::stat(pathBZ2, &bufBZ2) == -1 || buf.st_mtime >= bufBZ2.st_mtime)
+                // The block checksums used for block-level patching are
+                // computed along with the compressed file.
+                //
+                if(compress >= 2 || IceUtilInternal::stat(pathBZ2, &bufBZ2) == -1 || !isOlder(buf, bufBZ2) ||
+                   IceUtilInternal::stat(pathBlocks, &bufBlocks) == -1 || !isOlder(buf, bufBlocks))
                 {
-                    if(cb && !cb->compress(relPath))
-                    {
-                        return false;
-                    }
-
                     doCompress = true;
                 }
                 else
@@ -877,135 +1332,35 @@ getFileInfoSeqInternal(const string& basePath, const string& relPath, int compre
                 }
             }
 
-            if(cb && !cb->checksum(relPath))
+            //
+            // In incremental mode, the checksum of a file which wasn't
+            // modified since the start of the last full run is re-used.
+            //
+            LargeFileInfoSeq::const_iterator previous = previousInfoSeq.end();
+            if(!doCompress && buf.st_size != 0 && buf.st_mtime < since && buf.st_ctime < since)
             {
-                return false;
+                previous = lower_bound(previousInfoSeq.begin(), previousInfoSeq.end(), info, FileInfoPathLess());
+                if(previous != previousInfoSeq.end() && (previous->path != relPath || previous->size < 0))
+                {
+                    previous = previousInfoSeq.end();
+                }
             }
 
-            ByteSeq bytesSHA;
-
-            if(relPath.size() + buf.st_size == 0)
+            if(previous != previousInfoSeq.end())
             {
-                bytesSHA.resize(20);
-                fill(bytesSHA.begin(), bytesSHA.end(), 0);
+                info.checksum = previous->checksum;
             }
             else
             {
-                IceInternal::SHA1 hasher;
-                if(relPath.size() != 0)
-                {
-                    hasher.update(reinterpret_cast<const IceUtil::Byte*>(relPath.c_str()), relPath.size());
-                }
-
-                if(buf.st_size != 0)
-                {
-                    int fd = IceUtilInternal::open(path.c_str(), O_BINARY|O_RDONLY);
-                    if(fd == -1)
-                    {
-                        throw runtime_error("cannot open `" + path + "' for reading:\n" + IceUtilInternal::lastErrorToString());
-                    }
-
-                    const string pathBZ2Temp = path + ".bz2temp";
-                    FILE* stdioFile = 0;
-                    int bzError = 0;
-                    BZFILE* bzFile = 0;
-                    if(doCompress)
-                    {
-                        stdioFile = IceUtilInternal::fopen(simplify(pathBZ2Temp), "wb");
-                        if(!stdioFile)
-                        {
-                            IceUtilInternal::close(fd);
-                            throw runtime_error("cannot open `" + pathBZ2Temp + "' for writing:\n" + IceUtilInternal::lastErrorToString());
-                        }
-
-                        bzFile = BZ2_bzWriteOpen(&bzError, stdioFile, 5, 0, 0);
-                        if(bzError != BZ_OK)
-                        {
-                            string reason = "BZ2_bzWriteOpen failed";
-                            if(bzError == BZ_IO_ERROR)
-                            {
-                                reason += ": " + IceUtilInternal::lastErrorToString();
-                            }
-                            fclose(stdioFile);
-                            IceUtilInternal::close(fd);
-                            throw runtime_error(reason);
-                        }
-                    }
-
-                    long bytesLeft = buf.st_size;
-                    while(bytesLeft > 0)
-                    {
-                        ByteSeq bytes(min(bytesLeft, 1024l*1024));
-                        if(
-#if defined(_MSC_VER)
-                            _read(fd, &bytes[0], static_cast<unsigned int>(bytes.size()))
-#else
-                            read(fd, &bytes[0], static_cast<unsigned int>(bytes.size()))
-#endif
-                            == -1)
-                        {
-                            if(doCompress)
-                            {
-                                fclose(stdioFile);
-                            }
-
-                            IceUtilInternal::close(fd);
-                            throw runtime_error("cannot read from `" + path + "':\n" + IceUtilInternal::lastErrorToString());
-                        }
-                        bytesLeft -= static_cast<unsigned int>(bytes.size());
-                        if(doCompress)
-                        {
-                            BZ2_bzWrite(&bzError, bzFile, const_cast<Byte*>(&bytes[0]), static_cast<int>(bytes.size()));
-                            if(bzError != BZ_OK)
-                            {
-                                string reason = "BZ2_bzWrite failed";
-                                if(bzError == BZ_IO_ERROR)
-                                {
-                                    reason += ": " + IceUtilInternal::lastErrorToString();
-                                }
-                                BZ2_bzWriteClose(&bzError, bzFile, 0, 0, 0);
-                                fclose(stdioFile);
-                                IceUtilInternal::close(fd);
-                                throw runtime_error(reason);
-                            }
-                        }
-
-                        hasher.update(reinterpret_cast<IceUtil::Byte*>(&bytes[0]), bytes.size());
-                    }
-
-                    IceUtilInternal::close(fd);
-
-                    if(doCompress)
-                    {
-                        BZ2_bzWriteClose(&bzError, bzFile, 0, 0, 0);
-                        if(bzError != BZ_OK)
-                        {
-                            string reason = "BZ2_bzWriteClose failed";
-                            if(bzError == BZ_IO_ERROR)
-                            {
-                                reason += ": " + IceUtilInternal::lastErrorToString();
-                            }
-                            fclose(stdioFile);
-                            throw runtime_error(reason);
-                        }
-
-                        fclose(stdioFile);
-
-                        rename(pathBZ2Temp, pathBZ2);
-
-                        if(IceUtilInternal::stat(pathBZ2, &bufBZ2) == -1)
-                        {
-                            throw runtime_error("cannot stat `" + pathBZ2 + "':\n" + IceUtilInternal::lastErrorToString());
-                        }
-
-                        info.size = bufBZ2.st_size;
-                    }
-                }
-                hasher.finalize(bytesSHA);
+                FileInfoJob job;
+                job.index = infoSeq.size();
+                job.relPath = relPath;
+                job.path = path;
+                job.size = buf.st_size;
+                job.doCompress = doCompress;
+                jobs.push_back(job);
             }
 
-            info.checksum.swap(bytesSHA);
-
             infoSeq.push_back(info);
         }
     }
@@ -1024,17 +1379,70 @@ bool
 IcePatch2Internal::getFileInfoSeq(const string& basePath, int compress, GetFileInfoSeqCB* cb,
                                   LargeFileInfoSeq& infoSeq)
 {
-    return getFileInfoSeqSubDir(basePath, ".", compress, cb, infoSeq);
+    return getFileInfoSeqSubDir(basePath, ".", compress, cb, infoSeq, 1, false);
+}
+
+bool
+IcePatch2Internal::getFileInfoSeq(const string& basePath, int compress, GetFileInfoSeqCB* cb,
+                                  LargeFileInfoSeq& infoSeq, int threads, bool incremental)
+{
+    return getFileInfoSeqSubDir(basePath, ".", compress, cb, infoSeq, threads, incremental);
 }
 
 bool
 IcePatch2Internal::getFileInfoSeqSubDir(const string& basePa, const string& relPa, int compress, GetFileInfoSeqCB* cb,
                                         LargeFileInfoSeq& infoSeq)
+{
+    return getFileInfoSeqSubDir(basePa, relPa, compress, cb, infoSeq, 1, false);
+}
+
+bool
+IcePatch2Internal::getFileInfoSeqSubDir(const string& basePa, const string& relPa, int compress, GetFileInfoSeqCB* cb,
+                                        LargeFileInfoSeq& infoSeq, int threads, bool incremental)
 {
     const string basePath = simplify(basePa);
     const string relPath = simplify(relPa);
 
-    if(!getFileInfoSeqInternal(basePath, relPath, compress, cb, infoSeq))
+    //
+    // In incremental mode, the files which weren't modified since the
+    // start of the last full run keep their checksum from the summary
+    // file. The summary file's own modification time can't be used: a
+    // file modified during the last run might have been read before its
+    // modification. The ctime is also checked to detect files copied
+    // with their original mtime.
+    //
+    LargeFileInfoSeq previousInfoSeq;
+    time_t since = 0;
+    if(incremental)
+    {
+        IceUtilInternal::structstat buf;
+        IceUtilInternal::structstat bufTime;
+        if(IceUtilInternal::stat(simplify(basePath + '/' + checksumFile), &buf) != -1 &&
+           IceUtilInternal::stat(simplify(basePath + '/' + checksumTimeFile), &bufTime) != -1)
+        {
+            loadFileInfoSeq(basePath, previousInfoSeq);
+            since = bufTime.st_mtime;
+        }
+    }
+
+    vector<FileInfoJob> jobs;
+    if(!getFileInfoSeqInternal(basePath, relPath, compress, cb, infoSeq, previousInfoSeq, since, jobs))
+    {
+        return false;
+    }
+
+    if(threads > 1)
+    {
+        //
+        // Start with the largest files to balance the work between the
+        // threads. The resulting sequence doesn't depend on the order of
+        // the computations, it's sorted below.
+        //
+        stable_sort(jobs.begin(), jobs.end(), FileInfoJobSizeGreater());
+    }
+
+    FileInfoJobQueue queue(jobs, cb, infoSeq);
+    if(!queue.run(threads))
     {
         return false;
     }
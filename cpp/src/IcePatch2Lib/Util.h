@@ -12,6 +12,8 @@
 
 #include <Ice/Ice.h>
 #include <IcePatch2/FileInfo.h>
+#include <IcePatch2/ClientUtil.h>
+#include <IceUtil/FileUtil.h>
 #include <stdio.h>
 
 namespace IcePatch2Internal
@@ -20,6 +22,34 @@ namespace IcePatch2Internal
 ICEPATCH2_API extern const char* checksumFile;
 ICEPATCH2_API extern const char* logFile;
 
+//
+// The file whose modification time is the start time of the last full
+// icepatch2calc run. The checksums of the files which weren't modified
+// since this time are re-used by incremental runs.
+//
+ICEPATCH2_API extern const char* checksumTimeFile;
+
+//
+// The size of the blocks for which icepatch2calc computes the
+// checksums used for block-level patching.
+//
+ICEPATCH2_API extern const Ice::Int checksumBlockSize;
+
+//
+// The suffix of the files in which icepatch2calc saves the block
+// checksums of a file: the size of the file as a little-endian 64-bit
+// integer followed by the SHA-1 checksums of its blocks.
+//
+ICEPATCH2_API extern const char* blockChecksumsSuffix;
+ICEPATCH2_API extern const Ice::Int blockChecksumsHeaderSize;
+
+//
+// Returns true if the first file was modified before the second file.
+// The modification times are compared with sub-second precision on
+// the platforms which provide it.
+//
+ICEPATCH2_API bool isOlder(const IceUtilInternal::structstat&, const IceUtilInternal::structstat&);
+
 ICEPATCH2_API std::string lastError();
 
 ICEPATCH2_API std::string bytesToString(const Ice::ByteSeq&);
@@ -47,6 +77,7 @@ ICEPATCH2_API void createDirectory(const std::string&);
 ICEPATCH2_API void createDirectoryRecursive(const std::string&);
 
 ICEPATCH2_API void compressBytesToFile(const std::string&, const Ice::ByteSeq&, Ice::Int);
+ICEPATCH2_API void compressFile(const std::string&);
 ICEPATCH2_API void decompressFile(const std::string&);
 
 ICEPATCH2_API void setFileFlags(const std::string&, const IcePatch2::LargeFileInfo&);
@@ -167,6 +198,18 @@ ICEPATCH2_API bool getFileInfoSeq(const std::string&, int, GetFileInfoSeqCB*, Ic
 
 ICEPATCH2_API bool getFileInfoSeqSubDir(const std::string&, const std::string&, int, GetFileInfoSeqCB*, IcePatch2::LargeFileInfoSeq&);
 
+//
+// Same as above but the checksums are computed and the files are
+// compressed with the given number of threads. If incremental is
+// true, the checksums of the files which weren't modified since the
+// summary file was saved are loaded from the summary file.
+//
+ICEPATCH2_API bool getFileInfoSeq(const std::string&, int, GetFileInfoSeqCB*, IcePatch2::LargeFileInfoSeq&, int,
+                                  bool);
+
+ICEPATCH2_API bool getFileInfoSeqSubDir(const std::string&, const std::string&, int, GetFileInfoSeqCB*,
+                                        IcePatch2::LargeFileInfoSeq&, int, bool);
+
 ICEPATCH2_API void saveFileInfoSeq(const std::string&, const IcePatch2::LargeFileInfoSeq&);
 
 ICEPATCH2_API void loadFileInfoSeq(const std::string&, IcePatch2::LargeFileInfoSeq&);
@@ -194,6 +237,15 @@ struct FileTree0
 
 ICEPATCH2_API void getFileTree0(const IcePatch2::LargeFileInfoSeq&, FileTree0&);
 
+//
+// Create a patcher like PatcherFactory::create which keeps the
+// compressed files downloaded from the server if the last parameter is
+// true. The IceGrid node uses it to serve a patched distribution to
+// the other nodes, this isn't part of the public patcher API.
+//
+ICEPATCH2_API IcePatch2::PatcherPtr createPatcher(const IcePatch2::FileServerPrx&, const IcePatch2::PatcherFeedbackPtr&,
+                                                  const std::string&, bool, Ice::Int, Ice::Int, bool);
+
 }
 
 #endif
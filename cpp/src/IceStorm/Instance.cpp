@@ -12,12 +12,14 @@
 #include <IceStorm/Observers.h>
 #include <IceStorm/NodeI.h>
 #include <IceStorm/InstrumentationI.h>
+#include <IceStorm/Subscriber.h>
 #include <IceUtil/Timer.h>
 
 #include <Ice/InstrumentationI.h>
 #include <Ice/Communicator.h>
 #include <Ice/Properties.h>
 #include <Ice/TraceUtil.h>
+#include <algorithm>
 
 using namespace std;
 using namespace IceStorm;
@@ -109,11 +111,19 @@ Instance::Instance(
                                                 name + ".Discard.Interval", 60))), // default one minute.
     _flushInterval(IceUtil::Time::milliSeconds(communicator->getProperties()->getPropertyAsIntWithDefault(
                                                    name + ".Flush.Timeout", 1000))), // default one second.
+    _flushAdaptive(communicator->getProperties()->getPropertyAsInt(name + ".Flush.Adaptive") > 0),
+    _flushBatchSize(max(1, communicator->getProperties()->getPropertyAsIntWithDefault(name + ".Flush.BatchSize", 100))),
     // default one minute.
     _sendTimeout(communicator->getProperties()->getPropertyAsIntWithDefault(name + ".Send.Timeout", 60 * 1000)),
     _sendQueueSizeMax(communicator->getProperties()->getPropertyAsIntWithDefault(name + ".Send.QueueSizeMax", -1)),
     _sendQueueSizeMaxPolicy(RemoveSubscriber),
-    _topicReaper(new TopicReaper())
+    // The memory limits are configured in kilobytes.
+    _sendQueueMemoryMax(static_cast<Ice::Long>(communicator->getProperties()->getPropertyAsInt(
+                                                   name + ".Send.QueueMemoryMax")) * 1024),
+    _sendQueueMemoryTotalMaxPolicy(DropEvents),
+    _topicReaper(new TopicReaper()),
+    _queueMemory(new QueueMemory(static_cast<Ice::Long>(communicator->getProperties()->getPropertyAsInt(
+                                                            name + ".Send.QueueMemoryTotalMax")) * 1024))
 {
     try
     {
@@ -152,6 +162,21 @@ Instance::Instance(
             warn << "invalid value `" << policy << "' for `" << name << ".Send.QueueSizeMaxPolicy'";
         }
 
+        policy = properties->getProperty(name + ".Send.QueueMemoryTotalMaxPolicy");
+        if(policy == "RemoveSubscriber")
+        {
+            const_cast<SendQueueSizeMaxPolicy&>(_sendQueueMemoryTotalMaxPolicy) = RemoveSubscriber;
+        }
+        else if(policy == "DropEvents")
+        {
+            const_cast<SendQueueSizeMaxPolicy&>(_sendQueueMemoryTotalMaxPolicy) = DropEvents;
+        }
+        else if(!policy.empty())
+        {
+            Ice::Warning warn(_traceLevels->logger);
+            warn << "invalid value `" << policy << "' for `" << name << ".Send.QueueMemoryTotalMaxPolicy'";
+        }
+
         //
         // If an Ice metrics observer is setup on the communicator, also
         // enable metrics for IceStorm.
@@ -282,6 +307,12 @@ Instance::topicReaper() const
     return _topicReaper;
 }
 
+QueueMemoryPtr
+Instance::queueMemory() const
+{
+    return _queueMemory;
+}
+
 IceUtil::Time
 Instance::discardInterval() const
 {
@@ -294,6 +325,18 @@ Instance::flushInterval() const
     return _flushInterval;
 }
 
+bool
+Instance::flushAdaptive() const
+{
+    return _flushAdaptive;
+}
+
+int
+Instance::flushBatchSize() const
+{
+    return _flushBatchSize;
+}
+
 int
 Instance::sendTimeout() const
 {
@@ -312,6 +355,18 @@ Instance::sendQueueSizeMaxPolicy() const
     return _sendQueueSizeMaxPolicy;
 }
 
+Ice::Long
+Instance::sendQueueMemoryMax() const
+{
+    return _sendQueueMemoryMax;
+}
+
+Instance::SendQueueSizeMaxPolicy
+Instance::sendQueueMemoryTotalMaxPolicy() const
+{
+    return _sendQueueMemoryTotalMaxPolicy;
+}
+
 void
 Instance::shutdown()
 {
@@ -13,6 +13,7 @@
 #include <Ice/CommunicatorF.h>
 #include <Ice/ObjectAdapterF.h>
 #include <Ice/PropertiesF.h>
+#include <Ice/MemoryLimit.h>
 #include <IceUtil/Time.h>
 #include <IceStorm/Election.h>
 #include <IceStorm/Instrumentation.h>
@@ -56,6 +57,15 @@ private:
 };
 typedef IceUtil::Handle<TopicReaper> TopicReaperPtr;
 
+class Subscriber;
+
+//
+// Keeps track of the memory used by the events queued for all the
+// subscribers of the service.
+//
+typedef IceInternal::MemoryLimit<Subscriber> QueueMemory;
+typedef IceUtil::Handle<QueueMemory> QueueMemoryPtr;
+
 class Instance : public IceUtil::Shared
 {
 public:
@@ -88,12 +98,17 @@ public:
     Ice::ObjectPrx publisherReplicaProxy() const;
     IceStorm::Instrumentation::TopicManagerObserverPtr observer() const;
     TopicReaperPtr topicReaper() const;
+    QueueMemoryPtr queueMemory() const;
 
     IceUtil::Time discardInterval() const;
     IceUtil::Time flushInterval() const;
+    bool flushAdaptive() const;
+    int flushBatchSize() const;
     int sendTimeout() const;
     int sendQueueSizeMax() const;
     SendQueueSizeMaxPolicy sendQueueSizeMaxPolicy() const;
+    Ice::Long sendQueueMemoryMax() const;
+    SendQueueSizeMaxPolicy sendQueueMemoryTotalMaxPolicy() const;
 
     void shutdown();
     virtual void destroy();
@@ -110,12 +125,17 @@ private:
     const TraceLevelsPtr _traceLevels;
     const IceUtil::Time _discardInterval;
     const IceUtil::Time _flushInterval;
+    const bool _flushAdaptive;
+    const int _flushBatchSize;
     const int _sendTimeout;
     const int _sendQueueSizeMax;
     const SendQueueSizeMaxPolicy _sendQueueSizeMaxPolicy;
+    const Ice::Long _sendQueueMemoryMax;
+    const SendQueueSizeMaxPolicy _sendQueueMemoryTotalMaxPolicy;
     const Ice::ObjectPrx _topicReplicaProxy;
     const Ice::ObjectPrx _publisherReplicaProxy;
     const TopicReaperPtr _topicReaper;
+    const QueueMemoryPtr _queueMemory;
     IceStormElection::NodeIPtr _node;
     IceStormElection::ObserversPtr _observers;
     IceUtil::TimerPtr _batchFlusher;
@@ -66,7 +66,7 @@ private:
 
 TopicHelper::Attributes TopicHelper::attributes;
 
-class SubscriberHelper : public MetricsHelperT<SubscriberMetrics>
+class SubscriberHelper : public MetricsHelperT<SubscriberQueueMetrics>
 {
 public:
 
@@ -318,6 +318,37 @@ SubscriberObserverI::delivered(int count)
     forEach(DeliveredUpdate(count));
 }
 
+namespace
+{
+
+struct QueuedBytesUpdate
+{
+    QueuedBytesUpdate(Ice::Long bytes, Ice::Long total) : bytes(bytes), total(total)
+    {
+    }
+
+    void operator()(const SubscriberQueueMetricsPtr& v)
+    {
+        v->queuedBytes += bytes;
+        if(v->queuedBytes < 0)
+        {
+            v->queuedBytes = 0;
+        }
+        v->totalQueuedBytes = total;
+    }
+
+    Ice::Long bytes;
+    Ice::Long total;
+};
+
+}
+
+void
+SubscriberObserverI::queuedBytes(Ice::Long bytes, Ice::Long total)
+{
+    forEach(QueuedBytesUpdate(bytes, total));
+}
+
 TopicManagerObserverI::TopicManagerObserverI(const IceInternal::MetricsAdminIPtr& metrics) :
     _metrics(metrics),
     _topics(metrics, "Topic"),
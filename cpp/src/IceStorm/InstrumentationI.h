@@ -28,13 +28,14 @@ public:
 };
 
 class SubscriberObserverI : public IceStorm::Instrumentation::SubscriberObserver,
-                            public IceMX::ObserverT<IceMX::SubscriberMetrics>
+                            public IceMX::ObserverT<IceMX::SubscriberQueueMetrics>
 {
 public:
 
     virtual void queued(int);
     virtual void outstanding(int);
     virtual void delivered(int);
+    virtual void queuedBytes(Ice::Long, Ice::Long);
 };
 
 class TopicManagerObserverI : public IceStorm::Instrumentation::TopicManagerObserver
@@ -10,6 +10,7 @@
 #include <IceStorm/Observers.h>
 #include <IceStorm/Instance.h>
 #include <IceStorm/TraceLevels.h>
+#include <algorithm>
 
 using namespace std;
 using namespace IceStorm;
@@ -17,7 +18,11 @@ using namespace IceStormElection;
 
 Observers::Observers(const InstancePtr& instance) :
     _traceLevels(instance->traceLevels()),
-    _majority(0)
+    _maxOutstanding(max(1, instance->properties()->getPropertyAsIntWithDefault(
+                               instance->serviceName() + ".Replication.MaxOutstanding", 100))),
+    _majority(0),
+    _outstanding(0),
+    _generation(0)
 {
 }
 
@@ -68,6 +73,7 @@ Observers::clear()
 {
     Lock sync(*this);
     _observers.clear();
+    ++_generation;
 }
 
 void
@@ -131,57 +137,85 @@ Observers::init(const set<GroupNodeInfo>& slaves, const LogUpdate& llu, const To
     }
 
     _observers.swap(observers);
+    ++_generation;
 }
 
-void
+Observers::UpdatePtr
 Observers::createTopic(const LogUpdate& llu, const string& name)
 {
-    Lock sync(*this);
-    for(vector<ObserverInfo>::iterator p = _observers.begin(); p != _observers.end(); ++p)
+    UpdatePtr update = new Update(this, "createTopic");
+    for(vector<ObserverInfo>::iterator p = update->_observers.begin(); p != update->_observers.end(); ++p)
     {
         p->result = p->observer->begin_createTopic(llu, name);
     }
-    wait("createTopic");
+    return update;
 }
 
-void
+Observers::UpdatePtr
 Observers::destroyTopic(const LogUpdate& llu, const string& id)
 {
-    Lock sync(*this);
-    for(vector<ObserverInfo>::iterator p = _observers.begin(); p != _observers.end(); ++p)
+    UpdatePtr update = new Update(this, "destroyTopic");
+    for(vector<ObserverInfo>::iterator p = update->_observers.begin(); p != update->_observers.end(); ++p)
     {
         p->result = p->observer->begin_destroyTopic(llu, id);
     }
-    wait("destroyTopic");
+    return update;
 }
 
-void
+Observers::UpdatePtr
 Observers::addSubscriber(const LogUpdate& llu, const string& name, const SubscriberRecord& rec)
 {
-    Lock sync(*this);
-    for(vector<ObserverInfo>::iterator p = _observers.begin(); p != _observers.end(); ++p)
+    UpdatePtr update = new Update(this, "addSubscriber");
+    for(vector<ObserverInfo>::iterator p = update->_observers.begin(); p != update->_observers.end(); ++p)
     {
         p->result = p->observer->begin_addSubscriber(llu, name, rec);
     }
-    wait("addSubscriber");
+    return update;
 }
 
-void
+Observers::UpdatePtr
 Observers::removeSubscriber(const LogUpdate& llu, const string& name, const Ice::IdentitySeq& id)
 {
-    Lock sync(*this);
-    for(vector<ObserverInfo>::iterator p = _observers.begin(); p != _observers.end(); ++p)
+    UpdatePtr update = new Update(this, "removeSubscriber");
+    for(vector<ObserverInfo>::iterator p = update->_observers.begin(); p != update->_observers.end(); ++p)
     {
         p->result = p->observer->begin_removeSubscriber(llu, name, id);
     }
-    wait("removeSubscriber");
+    return update;
+}
+
+IceUtil::Mutex&
+Observers::sendMutex()
+{
+    return _sendMutex;
+}
+
+Observers::Update::Update(const ObserversPtr& parent, const char* op) :
+    _parent(parent),
+    _op(op)
+{
+    Lock sync(*_parent);
+    while(_parent->_outstanding >= _parent->_maxOutstanding)
+    {
+        _parent->wait();
+    }
+    ++_parent->_outstanding;
+    _observers = _parent->_observers;
+    _generation = _parent->_generation;
+}
+
+Observers::Update::~Update()
+{
+    Lock sync(*_parent);
+    --_parent->_outstanding;
+    _parent->notify();
 }
 
 void
-Observers::wait(const string& op)
+Observers::Update::wait()
 {
-    vector<ObserverInfo>::iterator p = _observers.begin();
-    while(p != _observers.end())
+    vector<int> failed;
+    for(vector<ObserverInfo>::const_iterator p = _observers.begin(); p != _observers.end(); ++p)
     {
         try
         {
@@ -190,22 +224,42 @@ Observers::wait(const string& op)
         }
         catch(const Ice::Exception& ex)
         {
-            if(_traceLevels->replication > 0)
+            if(_parent->_traceLevels->replication > 0)
             {
-                Ice::Trace out(_traceLevels->logger, _traceLevels->replicationCat);
-                out << op << ": " << ex;
+                Ice::Trace out(_parent->_traceLevels->logger, _parent->_traceLevels->replicationCat);
+                out << _op << ": " << ex;
+            }
+            failed.push_back(p->id);
+        }
+    }
+
+    Lock sync(*_parent);
+
+    //
+    // Remove the observers which failed, unless the observers were
+    // re-initialized while the update was in progress.
+    //
+    if(!failed.empty() && _generation == _parent->_generation)
+    {
+        for(vector<int>::const_iterator id = failed.begin(); id != failed.end(); ++id)
+        {
+            vector<ObserverInfo>::iterator p = _parent->_observers.begin();
+            while(p != _parent->_observers.end() && p->id != *id)
+            {
+                ++p;
             }
-            int id = p->id;
-            p = _observers.erase(p);
+            if(p != _parent->_observers.end())
+            {
+                _parent->_observers.erase(p);
 
-            IceUtil::Mutex::Lock sync(_reapedMutex);
-            _reaped.push_back(id);
-            continue;
+                IceUtil::Mutex::Lock reapedSync(_parent->_reapedMutex);
+                _parent->_reaped.push_back(*id);
+            }
         }
-        ++p;
     }
+
     // If we now no longer have the majority of observers we raise.
-    if(_observers.size() < _majority)
+    if(_parent->_observers.size() < _parent->_majority)
     {
         // TODO: Trace here?
         //Ice::Trace out(_traceLevels->logger, _traceLevels->replicationCat);
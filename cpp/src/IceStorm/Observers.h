@@ -30,9 +30,45 @@ typedef IceUtil::Handle<TraceLevels> TraceLevelsPtr;
 namespace IceStormElection
 {
 
-class Observers : public IceUtil::Shared, public IceUtil::Mutex
+class Observers : public IceUtil::Shared, public IceUtil::Monitor<IceUtil::Mutex>
 {
+    struct ObserverInfo
+    {
+        ObserverInfo(int i, const ReplicaObserverPrx& o, const Ice::AsyncResultPtr& r = 0) :
+            id(i), observer(o), result (r) {}
+        int id;
+        ReplicaObserverPrx observer;
+        ::Ice::AsyncResultPtr result;
+    };
+
 public:
+
+    //
+    // An update sent to the observers. The caller waits for the update
+    // to be acknowledged with wait(), after releasing its locks: other
+    // updates can be sent in the meantime, up to the maximum number of
+    // outstanding updates.
+    //
+    class Update : public IceUtil::Shared
+    {
+    public:
+
+        ~Update();
+
+        void wait();
+
+    private:
+
+        Update(const IceUtil::Handle<Observers>&, const char*);
+        friend class Observers;
+
+        const IceUtil::Handle<Observers> _parent;
+        const char* _op;
+        std::vector<ObserverInfo> _observers;
+        Ice::Long _generation;
+    };
+    typedef IceUtil::Handle<Update> UpdatePtr;
+
     Observers(const IceStorm::InstancePtr&);
 
     void setMajority(unsigned int);
@@ -42,27 +78,30 @@ public:
     void clear();
 
     void init(const std::set<IceStormElection::GroupNodeInfo>&, const LogUpdate&, const TopicContentSeq&);
-    void createTopic(const LogUpdate&, const std::string&);
-    void destroyTopic(const LogUpdate&, const std::string&);
-    void addSubscriber(const LogUpdate&, const std::string&, const IceStorm::SubscriberRecord&);
-    void removeSubscriber(const LogUpdate&, const std::string&, const Ice::IdentitySeq&);
+    UpdatePtr createTopic(const LogUpdate&, const std::string&);
+    UpdatePtr destroyTopic(const LogUpdate&, const std::string&);
+    UpdatePtr addSubscriber(const LogUpdate&, const std::string&, const IceStorm::SubscriberRecord&);
+    UpdatePtr removeSubscriber(const LogUpdate&, const std::string&, const Ice::IdentitySeq&);
     void getReapedSlaves(std::vector<int>&);
 
+    //
+    // The master holds this mutex from the allocation of a log update
+    // until the update is sent, so that the observers receive the
+    // updates in log order.
+    //
+    IceUtil::Mutex& sendMutex();
+
 private:
 
-    void wait(const std::string&);
+    friend class Update;
 
     const IceStorm::TraceLevelsPtr _traceLevels;
+    const int _maxOutstanding;
     unsigned int _majority;
-    struct ObserverInfo
-    {
-        ObserverInfo(int i, const ReplicaObserverPrx& o, const Ice::AsyncResultPtr& r = 0) :
-            id(i), observer(o), result (r) {}
-        int id;
-        ReplicaObserverPrx observer;
-        ::Ice::AsyncResultPtr result;
-    };
     std::vector<ObserverInfo> _observers;
+    int _outstanding; // The number of updates not acknowledged yet.
+    Ice::Long _generation; // Incremented each time the observers are cleared or initialized.
+    IceUtil::Mutex _sendMutex;
     IceUtil::Mutex _reapedMutex;
     std::vector<int> _reaped;
 };
@@ -478,10 +478,13 @@ ServiceI::validateProperties(const string& name, const PropertiesPtr& properties
         "Transient",
         "NodeId",
         "Flush.Timeout",
+        "Flush.Adaptive",
+        "Flush.BatchSize",
         "InstanceName",
         "Election.MasterTimeout",
         "Election.ElectionTimeout",
         "Election.ResponseTimeout",
+        "Replication.MaxOutstanding",
         "Publish.AdapterId",
         "Publish.Endpoints",
         "Publish.Locator",
@@ -528,6 +531,9 @@ ServiceI::validateProperties(const string& name, const PropertiesPtr& properties
         "Send.Timeout",
         "Send.QueueSizeMax",
         "Send.QueueSizeMaxPolicy",
+        "Send.QueueMemoryMax",
+        "Send.QueueMemoryTotalMax",
+        "Send.QueueMemoryTotalMaxPolicy",
         "Discard.Interval",
         "LMDB.Path",
         "LMDB.MapSize"
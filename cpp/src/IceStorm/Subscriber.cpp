@@ -75,6 +75,20 @@ private:
 };
 typedef IceUtil::Handle<PerSubscriberPublisherI> PerSubscriberPublisherIPtr;
 
+//
+// The memory used by a queued event.
+//
+Ice::Long
+eventSize(const EventDataPtr& event)
+{
+    Ice::Long size = static_cast<Ice::Long>(sizeof(EventData) + event->op.size() + event->data.size());
+    for(Ice::Context::const_iterator p = event->context.begin(); p != event->context.end(); ++p)
+    {
+        size += static_cast<Ice::Long>(p->first.size() + p->second.size());
+    }
+    return size;
+}
+
 IceStorm::Instrumentation::SubscriberState
 toSubscriberState(Subscriber::SubscriberState s)
 {
@@ -119,9 +133,28 @@ private:
 
     const Ice::ObjectPrx _obj;
     const IceUtil::Time _interval;
+    IceUtil::Time _lastFlush; // The time of the last flush, only used for adaptive flushing.
+    IceUtil::TimerTaskPtr _task; // The pending flush timer task, if any.
 };
 typedef IceUtil::Handle<SubscriberBatch> SubscriberBatchPtr;
 
+//
+// The number of events sent with a batch, passed as the cookie of
+// the flush batch requests callback.
+//
+class BatchCount : public Ice::LocalObject
+{
+public:
+
+    BatchCount(int c) :
+        count(c)
+    {
+    }
+
+    const int count;
+};
+typedef IceUtil::Handle<BatchCount> BatchCountPtr;
+
 class SubscriberOneway : public Subscriber
 {
 public:
@@ -136,9 +169,19 @@ public:
     }
     void sent(bool);
 
+    void batchException(const Ice::Exception& ex, const BatchCountPtr&)
+    {
+        error(true, ex);
+    }
+    void batchSent(bool, const BatchCountPtr&);
+
 private:
 
+    void sendBatch();
+    void delivered(int);
+
     const Ice::ObjectPrx _obj;
+    const Ice::ObjectPrx _batchObj; // The batch oneway proxy, only set if adaptive flushing is enabled.
 };
 typedef IceUtil::Handle<SubscriberOneway> SubscriberOnewayPtr;
 
@@ -207,10 +250,41 @@ SubscriberBatch::SubscriberBatch(
 void
 SubscriberBatch::flush()
 {
+    if(!_instance->flushAdaptive())
+    {
+        if(_outstanding == 0)
+        {
+            ++_outstanding;
+            _instance->batchFlusher()->schedule(new FlushTimerTask(this), _interval);
+        }
+        return;
+    }
+
+    //
+    // With adaptive flushing, the flush timeout is the latency budget
+    // of the subscriber: events are flushed right away if nothing was
+    // flushed for longer than the flush timeout or once the queue
+    // reaches the batch size. Otherwise, events received in the
+    // meantime are coalesced until the flush timeout expires.
+    //
+    bool full = static_cast<int>(_events.size()) >= _instance->flushBatchSize();
     if(_outstanding == 0)
     {
         ++_outstanding;
-        _instance->batchFlusher()->schedule(new FlushTimerTask(this), _interval);
+        IceUtil::Time elapsed = IceUtil::Time::now(IceUtil::Time::Monotonic) - _lastFlush;
+        if(full || elapsed >= _interval)
+        {
+            doFlush();
+        }
+        else
+        {
+            _task = new FlushTimerTask(this);
+            _instance->batchFlusher()->schedule(_task, _interval - elapsed);
+        }
+    }
+    else if(full && _task && _instance->batchFlusher()->cancel(_task))
+    {
+        doFlush();
     }
 }
 
@@ -219,6 +293,8 @@ SubscriberBatch::doFlush()
 {
     IceUtil::Monitor<IceUtil::RecMutex>::Lock sync(_lock);
 
+    _task = 0;
+
     //
     // If the subscriber isn't online we're done.
     //
@@ -227,8 +303,10 @@ SubscriberBatch::doFlush()
         return;
     }
 
+    _lastFlush = IceUtil::Time::now(IceUtil::Time::Monotonic);
+
     EventDataSeq v;
-    v.swap(_events);
+    dequeue(v, _events.size());
     assert(!v.empty());
 
     if(_observer)
@@ -312,7 +390,12 @@ SubscriberOneway::SubscriberOneway(
     int retryCount,
     const Ice::ObjectPrx& obj) :
     Subscriber(instance, rec, proxy, retryCount, 5),
-    _obj(obj)
+    _obj(obj),
+    //
+    // Datagram subscribers don't use batching as a batch is sent with
+    // a single datagram and would be limited to the datagram size.
+    //
+    _batchObj(instance->flushAdaptive() && obj->ice_isOneway() ? obj->ice_batchOneway() : Ice::ObjectPrx())
 {
     assert(retryCount == 0);
 }
@@ -333,12 +416,25 @@ SubscriberOneway::flush()
     // Send up to _maxOutstanding pending events.
     while(_outstanding < _maxOutstanding && !_events.empty())
     {
+        //
+        // With adaptive flushing, the events which queued up while the
+        // previous requests were being sent are sent with a single batch.
+        //
+        if(_batchObj && _events.size() > 1)
+        {
+            sendBatch();
+            if(_state != SubscriberStateOnline)
+            {
+                return;
+            }
+            continue;
+        }
+
         //
         // Dequeue the head event, count one more outstanding AMI
         // request.
         //
-        EventDataPtr e = _events.front();
-        _events.erase(_events.begin());
+        EventDataPtr e = dequeue();
         if(_observer)
         {
             _observer->outstanding(1);
@@ -379,7 +475,61 @@ SubscriberOneway::sent(bool sentSynchronously)
     {
         return;
     }
+    delivered(1);
+}
+
+void
+SubscriberOneway::batchSent(bool sentSynchronously, const BatchCountPtr& count)
+{
+    if(sentSynchronously)
+    {
+        return;
+    }
+    delivered(count->count);
+}
+
+void
+SubscriberOneway::sendBatch()
+{
+    EventDataSeq v;
+    dequeue(v, static_cast<size_t>(_instance->flushBatchSize()));
+
+    BatchCountPtr count = new BatchCount(static_cast<int>(v.size()));
+    if(_observer)
+    {
+        _observer->outstanding(count->count);
+    }
+
+    try
+    {
+        vector<Ice::Byte> dummy;
+        for(EventDataSeq::const_iterator p = v.begin(); p != v.end(); ++p)
+        {
+            _batchObj->ice_invoke((*p)->op, (*p)->mode, (*p)->data, dummy, (*p)->context);
+        }
+
+        Ice::AsyncResultPtr result = _batchObj->begin_ice_flushBatchRequests(
+            Ice::newCallback_Object_ice_flushBatchRequests(this,
+                                                           &SubscriberOneway::batchException,
+                                                           &SubscriberOneway::batchSent), count);
+        if(!result->sentSynchronously())
+        {
+            ++_outstanding;
+        }
+        else if(_observer)
+        {
+            _observer->delivered(count->count);
+        }
+    }
+    catch(const Ice::Exception& ex)
+    {
+        error(true, ex);
+    }
+}
 
+void
+SubscriberOneway::delivered(int count)
+{
     IceUtil::Monitor<IceUtil::RecMutex>::Lock sync(_lock);
 
     // Decrement the _outstanding count.
@@ -387,7 +537,7 @@ SubscriberOneway::sent(bool sentSynchronously)
     assert(_outstanding >= 0 && _outstanding < _maxOutstanding);
     if(_observer)
     {
-        _observer->delivered(1);
+        _observer->delivered(count);
     }
 
     if(_events.empty() && _outstanding == 0 && _shutdown)
@@ -432,8 +582,7 @@ SubscriberTwoway::flush()
         // Dequeue the head event, count one more outstanding AMI
         // request.
         //
-        EventDataPtr e = _events.front();
-        _events.erase(_events.begin());
+        EventDataPtr e = dequeue();
         ++_outstanding;
         if(_observer)
         {
@@ -475,7 +624,7 @@ SubscriberLink::flush()
     }
 
     EventDataSeq v;
-    v.swap(_events);
+    dequeue(v, _events.size());
 
     EventDataSeq::iterator p = v.begin();
     while(p != v.end())
@@ -661,6 +810,58 @@ Subscriber::record() const
 
 bool
 Subscriber::queue(bool forwarded, const EventDataSeq& events)
+{
+    if(!queueEvents(forwarded, events))
+    {
+        return false;
+    }
+
+    //
+    // Enforce the limit on the memory used by the events queued for
+    // all the subscribers of the service. Events are dropped from, or
+    // the subscriber is removed for, the subscriber which uses the most
+    // memory. This isn't necessarily this subscriber so this must be
+    // done without holding our lock.
+    //
+    QueueMemoryPtr memory = _instance->queueMemory();
+    bool removed = false;
+    SubscriberPtr largest;
+    while((largest = memory->largest()) && largest->shed())
+    {
+        if(largest.get() == this && _instance->sendQueueMemoryTotalMaxPolicy() == Instance::RemoveSubscriber)
+        {
+            removed = true;
+        }
+    }
+    return !removed;
+}
+
+bool
+Subscriber::shed()
+{
+    IceUtil::Monitor<IceUtil::RecMutex>::Lock sync(_lock);
+    if(_events.empty())
+    {
+        return false;
+    }
+
+    if(_instance->sendQueueMemoryTotalMaxPolicy() == Instance::RemoveSubscriber)
+    {
+        error(false, IceStorm::SendQueueSizeMaxReached(__FILE__, __LINE__));
+    }
+    else // DropEvents
+    {
+        dequeue();
+        if(_observer)
+        {
+            _observer->queued(-1);
+        }
+    }
+    return true;
+}
+
+bool
+Subscriber::queueEvents(bool forwarded, const EventDataSeq& events)
 {
     IceUtil::Monitor<IceUtil::RecMutex>::Lock sync(_lock);
 
@@ -690,8 +891,14 @@ Subscriber::queue(bool forwarded, const EventDataSeq& events)
 
     case SubscriberStateOnline:
     {
+        QueueMemoryPtr memory = _instance->queueMemory();
+        Ice::Long memoryMax = _instance->sendQueueMemoryMax();
+        Ice::Int queued = 0;
+        Ice::Long queuedBytes = 0;
         for(EventDataSeq::const_iterator p = events.begin(); p != events.end(); ++p)
         {
+            Ice::Long size = eventSize(*p);
+
             if(static_cast<int>(_events.size()) == _instance->sendQueueSizeMax())
             {
                 if(_instance->sendQueueSizeMaxPolicy() == Instance::RemoveSubscriber)
@@ -701,15 +908,46 @@ Subscriber::queue(bool forwarded, const EventDataSeq& events)
                 }
                 else // DropEvents
                 {
-                    _events.pop_front();
+                    dequeue();
+                    --queued;
                 }
             }
+
+            //
+            // The maximum memory used by the events queued for this
+            // subscriber is enforced with the same policy as the maximum
+            // number of queued events.
+            //
+            while(memoryMax > 0 && !_events.empty() && _queuedBytes + size > memoryMax)
+            {
+                if(_instance->sendQueueSizeMaxPolicy() == Instance::RemoveSubscriber)
+                {
+                    error(false, IceStorm::SendQueueSizeMaxReached(__FILE__, __LINE__));
+                    return false;
+                }
+                else // DropEvents
+                {
+                    dequeue();
+                    --queued;
+                }
+            }
+
+            //
+            // The event data is shared by all the subscribers of the
+            // topic, it's only accounted for once in the memory used by
+            // the events queued for all the subscribers.
+            //
+            memory->add(this, p->get(), size);
             _events.push_back(*p);
+            _queuedBytes += size;
+            ++queued;
+            queuedBytes += size;
         }
 
         if(_observer)
         {
-            _observer->queued(static_cast<Ice::Int>(events.size()));
+            _observer->queued(queued);
+            _observer->queuedBytes(queuedBytes, memory->size());
         }
         flush();
         break;
@@ -777,6 +1015,7 @@ Subscriber::destroy()
     }
 
     IceUtil::Monitor<IceUtil::RecMutex>::Lock sync(_lock);
+    clearEvents();
     _observer.detach();
 }
 
@@ -864,13 +1103,13 @@ Subscriber::error(bool dec, const Ice::Exception& e)
         // clear all queued events.
         _next = now + _instance->discardInterval();
         ++_currentRetry;
-        _events.clear();
+        clearEvents();
         setState(SubscriberStateOffline);
     }
     // Errored out.
     else if(_state < SubscriberStateError)
     {
-        _events.clear();
+        clearEvents();
         setState(SubscriberStateError);
 
         TraceLevelsPtr traceLevels = _instance->traceLevels();
@@ -977,6 +1216,7 @@ Subscriber::Subscriber(
     _state(SubscriberStateOnline),
     _outstanding(0),
     _outstandingCount(1),
+    _queuedBytes(0),
     _currentRetry(0)
 {
     if(_proxy && _instance->publisherReplicaProxy())
@@ -1047,6 +1287,78 @@ Subscriber::setState(Subscriber::SubscriberState state)
     }
 }
 
+EventDataPtr
+Subscriber::dequeue()
+{
+    assert(!_events.empty());
+    EventDataPtr e = _events.front();
+    release(_events.begin(), _events.begin() + 1);
+    _events.pop_front();
+    return e;
+}
+
+void
+Subscriber::dequeue(EventDataSeq& events, size_t count)
+{
+    assert(events.empty());
+    EventDataSeq::iterator last = count >= _events.size() ?
+        _events.end() : _events.begin() + static_cast<EventDataSeq::difference_type>(count);
+    release(_events.begin(), last);
+    if(last == _events.end())
+    {
+        events.swap(_events);
+    }
+    else
+    {
+        events.insert(events.end(), _events.begin(), last);
+        _events.erase(_events.begin(), last);
+    }
+}
+
+void
+Subscriber::clearEvents()
+{
+    release(_events.begin(), _events.end());
+    _events.clear();
+}
+
+void
+Subscriber::release(EventDataSeq::const_iterator first, EventDataSeq::const_iterator last)
+{
+    QueueMemoryPtr memory = _instance->queueMemory();
+    Ice::Long size = 0;
+    if(memory->enabled())
+    {
+        for(EventDataSeq::const_iterator p = first; p != last; ++p)
+        {
+            Ice::Long sz = eventSize(*p);
+            memory->remove(this, p->get(), sz);
+            size += sz;
+        }
+    }
+    else if(first == _events.begin() && last == _events.end())
+    {
+        size = _queuedBytes;
+    }
+    else
+    {
+        for(EventDataSeq::const_iterator p = first; p != last; ++p)
+        {
+            size += eventSize(*p);
+        }
+    }
+
+    if(size > 0)
+    {
+        _queuedBytes -= size;
+        assert(_queuedBytes >= 0);
+        if(_observer)
+        {
+            _observer->queuedBytes(-size, memory->size());
+        }
+    }
+}
+
 bool
 IceStorm::operator==(const SubscriberPtr& subscriber, const Ice::Identity& id)
 {
@@ -37,6 +37,9 @@ public:
 
     // Returns false if the subscriber should be reaped.
     bool queue(bool, const EventDataSeq&);
+    // Drops the head event or removes the subscriber to reclaim queued
+    // memory, returns false if no events are queued.
+    bool shed();
     bool reap();
     void resetIfReaped();
     bool errored() const;
@@ -65,6 +68,13 @@ protected:
 
     void setState(SubscriberState);
 
+    bool queueEvents(bool, const EventDataSeq&);
+
+    EventDataPtr dequeue(); // Dequeue the head event.
+    void dequeue(EventDataSeq&, size_t); // Dequeue up to the given number of events.
+    void clearEvents();
+    void release(EventDataSeq::const_iterator, EventDataSeq::const_iterator);
+
     Subscriber(const InstancePtr&, const IceStorm::SubscriberRecord&, const Ice::ObjectPrx&, int, int);
 
     // Immutable
@@ -84,6 +94,7 @@ protected:
     int _outstanding; // The current number of outstanding responses.
     int _outstandingCount; // The current number of outstanding events when batching events (only used for metrics).
     EventDataSeq _events; // The queue of events to send.
+    Ice::Long _queuedBytes; // The memory used by the queued events.
 
     // The next time to try sending a new event if we're offline.
     IceUtil::Time _next;
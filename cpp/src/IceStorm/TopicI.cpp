@@ -549,29 +549,37 @@ TopicImpl::subscribeAndGetPublisher(const QoS& qos, const Ice::ObjectPrx& obj)
     LogUpdate llu;
 
     SubscriberPtr subscriber = Subscriber::create(_instance, record);
-    try
+    Observers::UpdatePtr observerUpdate;
     {
-        IceDB::ReadWriteTxn txn(_instance->dbEnv());
+        IceUtil::Mutex::Lock sendSync(_instance->observers()->sendMutex());
+        try
+        {
+            IceDB::ReadWriteTxn txn(_instance->dbEnv());
 
-        SubscriberRecordKey key;
-        key.topic = _id;
-        key.id = subscriber->id();
+            SubscriberRecordKey key;
+            key.topic = _id;
+            key.id = subscriber->id();
 
-        _subscriberMap.put(txn, key, record);
+            _subscriberMap.put(txn, key, record);
 
-        llu = getIncrementedLLU(txn, _lluMap);
+            llu = getIncrementedLLU(txn, _lluMap);
 
-        txn.commit();
-    }
-    catch(const IceDB::LMDBException& ex)
-    {
-        logError(_instance->communicator(), ex);
-        throw; // will become UnknownException in caller
+            txn.commit();
+        }
+        catch(const IceDB::LMDBException& ex)
+        {
+            logError(_instance->communicator(), ex);
+            throw; // will become UnknownException in caller
+        }
+
+        observerUpdate = _instance->observers()->addSubscriber(llu, _name, record);
     }
 
     _subscribers.push_back(subscriber);
 
-    _instance->observers()->addSubscriber(llu, _name, record);
+    // Wait for the replicas to acknowledge the update without holding the lock.
+    sync.release();
+    observerUpdate->wait();
 
     return subscriber->proxy();
 }
@@ -607,7 +615,12 @@ TopicImpl::unsubscribe(const Ice::ObjectPrx& subscriber)
     IceUtil::Mutex::Lock sync(_subscribersMutex);
     Ice::IdentitySeq ids;
     ids.push_back(id);
-    removeSubscribers(ids);
+    Observers::UpdatePtr observerUpdate = removeSubscribers(ids);
+    sync.release();
+    if(observerUpdate)
+    {
+        observerUpdate->wait();
+    }
 }
 
 TopicLinkPrx
@@ -659,29 +672,37 @@ TopicImpl::link(const TopicPrx& topic, Ice::Int cost)
 
     SubscriberPtr subscriber = Subscriber::create(_instance, record);
 
-    try
+    Observers::UpdatePtr observerUpdate;
     {
-        IceDB::ReadWriteTxn txn(_instance->dbEnv());
+        IceUtil::Mutex::Lock sendSync(_instance->observers()->sendMutex());
+        try
+        {
+            IceDB::ReadWriteTxn txn(_instance->dbEnv());
 
-        SubscriberRecordKey key;
-        key.topic = _id;
-        key.id = id;
+            SubscriberRecordKey key;
+            key.topic = _id;
+            key.id = id;
 
-        _subscriberMap.put(txn, key, record);
+            _subscriberMap.put(txn, key, record);
 
-        llu = getIncrementedLLU(txn, _lluMap);
+            llu = getIncrementedLLU(txn, _lluMap);
 
-        txn.commit();
-    }
-    catch(const IceDB::LMDBException& ex)
-    {
-        logError(_instance->communicator(), ex);
-        throw; // will become UnknownException in caller
+            txn.commit();
+        }
+        catch(const IceDB::LMDBException& ex)
+        {
+            logError(_instance->communicator(), ex);
+            throw; // will become UnknownException in caller
+        }
+
+        observerUpdate = _instance->observers()->addSubscriber(llu, _name, record);
     }
 
     _subscribers.push_back(subscriber);
 
-    _instance->observers()->addSubscriber(llu, _name, record);
+    // Wait for the replicas to acknowledge the update without holding the lock.
+    sync.release();
+    observerUpdate->wait();
 }
 
 void
@@ -718,7 +739,12 @@ TopicImpl::unlink(const TopicPrx& topic)
 
     Ice::IdentitySeq ids;
     ids.push_back(id);
-    removeSubscribers(ids);
+    Observers::UpdatePtr observerUpdate = removeSubscribers(ids);
+    sync.release();
+    if(observerUpdate)
+    {
+        observerUpdate->wait();
+    }
 }
 
 void
@@ -741,7 +767,12 @@ TopicImpl::reap(const Ice::IdentitySeq& ids)
         }
     }
 
-    removeSubscribers(ids);
+    Observers::UpdatePtr observerUpdate = removeSubscribers(ids);
+    sync.release();
+    if(observerUpdate)
+    {
+        observerUpdate->wait();
+    }
 }
 
 void
@@ -812,10 +843,16 @@ TopicImpl::destroy()
     }
 
     // destroyInternal clears out the topic content.
-    LogUpdate llu = {0,0};
-    _instance->observers()->destroyTopic(destroyInternal(llu, true), _name);
+    Observers::UpdatePtr observerUpdate;
+    {
+        IceUtil::Mutex::Lock sendSync(_instance->observers()->sendMutex());
+        observerUpdate = _instance->observers()->destroyTopic(destroyInternal(), _name);
+    }
 
     _observer.detach();
+
+    sync.release();
+    observerUpdate->wait();
 }
 
 TopicContent
@@ -1006,7 +1043,12 @@ TopicImpl::publish(bool forwarded, const EventDataSeq& events)
         if(!unlock.getMaster())
         {
             IceUtil::Mutex::Lock sync(_subscribersMutex);
-            removeSubscribers(reap);
+            Observers::UpdatePtr observerUpdate = removeSubscribers(reap);
+            sync.release();
+            if(observerUpdate)
+            {
+                observerUpdate->wait();
+            }
             return;
         }
         masterInternal = TopicInternalPrx::uncheckedCast(unlock.getMaster()->ice_identity(_id));
@@ -1027,7 +1069,7 @@ TopicImpl::publish(bool forwarded, const EventDataSeq& events)
 }
 
 void
-TopicImpl::observerAddSubscriber(const LogUpdate& llu, const SubscriberRecord& record)
+TopicImpl::observerAddSubscriber(const IceDB::ReadWriteTxn& txn, const LogUpdate& llu, const SubscriberRecord& record)
 {
     IceUtil::Mutex::Lock sync(_subscribersMutex);
 
@@ -1070,8 +1112,6 @@ TopicImpl::observerAddSubscriber(const LogUpdate& llu, const SubscriberRecord& r
     SubscriberPtr subscriber = Subscriber::create(_instance, record);
     try
     {
-        IceDB::ReadWriteTxn txn(_instance->dbEnv());
-
         SubscriberRecordKey key;
         key.topic = _id;
         key.id = subscriber->id();
@@ -1080,8 +1120,6 @@ TopicImpl::observerAddSubscriber(const LogUpdate& llu, const SubscriberRecord& r
 
         // Update the LLU.
         _lluMap.put(txn, lluDbKey, llu);
-
-        txn.commit();
     }
     catch(const IceDB::LMDBException& ex)
     {
@@ -1093,7 +1131,7 @@ TopicImpl::observerAddSubscriber(const LogUpdate& llu, const SubscriberRecord& r
 }
 
 void
-TopicImpl::observerRemoveSubscriber(const LogUpdate& llu, const Ice::IdentitySeq& ids)
+TopicImpl::observerRemoveSubscriber(const IceDB::ReadWriteTxn& txn, const LogUpdate& llu, const Ice::IdentitySeq& ids)
 {
     TraceLevelsPtr traceLevels = _instance->traceLevels();
     if(traceLevels->topic > 0)
@@ -1116,8 +1154,6 @@ TopicImpl::observerRemoveSubscriber(const LogUpdate& llu, const Ice::IdentitySeq
     // First remove from the database.
     try
     {
-        IceDB::ReadWriteTxn txn(_instance->dbEnv());
-
         for(Ice::IdentitySeq::const_iterator id = ids.begin(); id != ids.end(); ++id)
         {
             SubscriberRecordKey key;
@@ -1128,8 +1164,6 @@ TopicImpl::observerRemoveSubscriber(const LogUpdate& llu, const Ice::IdentitySeq
         }
 
         _lluMap.put(txn, lluDbKey, llu);
-
-        txn.commit();
     }
     catch(const IceDB::LMDBException& ex)
     {
@@ -1153,6 +1187,22 @@ TopicImpl::observerRemoveSubscriber(const LogUpdate& llu, const Ice::IdentitySeq
 
 void
 TopicImpl::observerDestroyTopic(const LogUpdate& llu)
+{
+    IceDB::ReadWriteTxn txn(_instance->dbEnv());
+    observerDestroyTopic(txn, llu); // Logs the database errors.
+    try
+    {
+        txn.commit();
+    }
+    catch(const IceDB::LMDBException& ex)
+    {
+        logError(_instance->communicator(), ex);
+        throw; // will become UnknownException in caller
+    }
+}
+
+void
+TopicImpl::observerDestroyTopic(const IceDB::ReadWriteTxn& txn, const LogUpdate& llu)
 {
     IceUtil::Mutex::Lock sync(_subscribersMutex);
 
@@ -1169,7 +1219,21 @@ TopicImpl::observerDestroyTopic(const LogUpdate& llu)
         out << _name << ": destroyed";
         out << " llu: " << llu.generation << "/" << llu.iteration;
     }
-    destroyInternal(llu, false);
+
+    try
+    {
+        clearRecords(txn);
+
+        // Update the LLU.
+        _lluMap.put(txn, lluDbKey, llu);
+    }
+    catch(const IceDB::LMDBException& ex)
+    {
+        logError(_instance->communicator(), ex);
+        throw; // will become UnknownException in caller
+    }
+
+    destroyServants();
 }
 
 Ice::ObjectPtr
@@ -1199,42 +1263,18 @@ TopicImpl::updateSubscriberObservers()
 }
 
 LogUpdate
-TopicImpl::destroyInternal(const LogUpdate& origLLU, bool master)
+TopicImpl::destroyInternal()
 {
-
     // Clear out the database records related to this topic.
     LogUpdate llu;
     try
     {
         IceDB::ReadWriteTxn txn(_instance->dbEnv());
 
-        // Erase all subscriber records and the topic record.
-        SubscriberRecordKey key;
-        key.topic = _id;
-
-        SubscriberMapRWCursor cursor(_subscriberMap, txn);
-        if(cursor.find(key))
-        {
-            _subscriberMap.del(txn, key);
-
-            SubscriberRecordKey k;
-            SubscriberRecord v;
-            while(cursor.get(k, v, MDB_NEXT) && k.topic == key.topic)
-            {
-                _subscriberMap.del(txn, k);
-            }
-        }
+        clearRecords(txn);
 
         // Update the LLU.
-        if(master)
-        {
-            llu = getIncrementedLLU(txn, _lluMap);
-        }
-        else
-        {
-            llu = origLLU;
-            _lluMap.put(txn, lluDbKey, llu);
-        }
+        llu = getIncrementedLLU(txn, _lluMap);
 
         txn.commit();
     }
@@ -1244,6 +1284,34 @@ TopicImpl::destroyInternal(const LogUpdate& origLLU, bool master)
         throw; // will become UnknownException in caller
     }
 
+    destroyServants();
+    return llu;
+}
+
+void
+TopicImpl::clearRecords(const IceDB::ReadWriteTxn& txn)
+{
+    // Erase all subscriber records and the topic record.
+    SubscriberRecordKey key;
+    key.topic = _id;
+
+    SubscriberMapRWCursor cursor(_subscriberMap, txn);
+    if(cursor.find(key))
+    {
+        _subscriberMap.del(txn, key);
+
+        SubscriberRecordKey k;
+        SubscriberRecord v;
+        while(cursor.get(k, v, MDB_NEXT) && k.topic == key.topic)
+        {
+            _subscriberMap.del(txn, k);
+        }
+    }
+}
+
+void
+TopicImpl::destroyServants()
+{
     _instance->publishAdapter()->remove(_linkPrx->ice_getIdentity());
     _instance->publishAdapter()->remove(_publisherPrx->ice_getIdentity());
     _instance->topicReaper()->add(_name);
@@ -1258,17 +1326,16 @@ TopicImpl::destroyInternal(const LogUpdate& origLLU, bool master)
     _instance->topicAdapter()->remove(_id);
 
     _servant = 0;
-
-    return llu;
 }
 
-void
+Observers::UpdatePtr
 TopicImpl::removeSubscribers(const Ice::IdentitySeq& ids)
 {
     // First update the database
 
     LogUpdate llu;
     bool found = false;
+    IceUtil::Mutex::Lock sendSync(_instance->observers()->sendMutex());
     try
     {
         IceDB::ReadWriteTxn txn(_instance->dbEnv());
@@ -1303,6 +1370,9 @@ TopicImpl::removeSubscribers(const Ice::IdentitySeq& ids)
 
     if(found)
     {
+        Observers::UpdatePtr observerUpdate = _instance->observers()->removeSubscriber(llu, _name, ids);
+        sendSync.release();
+
         // Then remove the subscriber from the subscribers list. Its
         // possible that some of these subscribers have already been
         // removed (consider, for example, a concurrent reap call from two
@@ -1319,6 +1389,7 @@ TopicImpl::removeSubscribers(const Ice::IdentitySeq& ids)
             }
         }
 
-        _instance->observers()->removeSubscriber(llu, _name, ids);
+        return observerUpdate;
     }
+    return 0;
 }
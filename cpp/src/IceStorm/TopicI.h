@@ -13,6 +13,7 @@
 #include <IceStorm/IceStormInternal.h>
 #include <IceStorm/Election.h>
 #include <IceStorm/Instrumentation.h>
+#include <IceStorm/Observers.h>
 #include <IceStorm/Util.h>
 #include <Ice/ObserverHelper.h>
 #include <list>
@@ -58,9 +59,11 @@ public:
     void publish(bool, const EventDataSeq&);
 
     // Observer methods.
-    void observerAddSubscriber(const IceStormElection::LogUpdate&, const SubscriberRecord&);
-    void observerRemoveSubscriber(const IceStormElection::LogUpdate&, const Ice::IdentitySeq&);
+    void observerAddSubscriber(const IceDB::ReadWriteTxn&, const IceStormElection::LogUpdate&, const SubscriberRecord&);
+    void observerRemoveSubscriber(const IceDB::ReadWriteTxn&, const IceStormElection::LogUpdate&,
+                                  const Ice::IdentitySeq&);
     void observerDestroyTopic(const IceStormElection::LogUpdate&);
+    void observerDestroyTopic(const IceDB::ReadWriteTxn&, const IceStormElection::LogUpdate&);
 
     Ice::ObjectPtr getServant() const;
 
@@ -69,8 +72,10 @@ public:
 
 private:
 
-    IceStormElection::LogUpdate destroyInternal(const IceStormElection::LogUpdate&, bool);
-    void removeSubscribers(const Ice::IdentitySeq&);
+    IceStormElection::LogUpdate destroyInternal();
+    void clearRecords(const IceDB::ReadWriteTxn&);
+    void destroyServants();
+    IceStormElection::Observers::UpdatePtr removeSubscribers(const Ice::IdentitySeq&);
 
     //
     // Immutable members.
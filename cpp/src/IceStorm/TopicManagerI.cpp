@@ -119,17 +119,152 @@ private:
     const TopicManagerImplPtr _impl;
 };
 
-class ReplicaObserverI : public ReplicaObserver
+//
+// An update received from the master by the replica observer.
+//
+class ObserverUpdate : public IceUtil::Shared
+{
+public:
+
+    ObserverUpdate(const LogUpdate& l, const char* n) :
+        llu(l), name(n)
+    {
+    }
+
+    virtual void apply(const TopicManagerImplPtr&, const IceDB::ReadWriteTxn&) = 0;
+    virtual void response() = 0;
+    virtual void exception(const std::exception&) = 0;
+
+    const LogUpdate llu;
+    const char* const name;
+};
+typedef IceUtil::Handle<ObserverUpdate> ObserverUpdatePtr;
+
+template<class CB> class ObserverUpdateT : public ObserverUpdate
+{
+public:
+
+    ObserverUpdateT(const CB& cb, const LogUpdate& l, const char* n) :
+        ObserverUpdate(l, n), _cb(cb)
+    {
+    }
+
+    virtual void response()
+    {
+        _cb->ice_response();
+    }
+
+    virtual void exception(const std::exception& ex)
+    {
+        _cb->ice_exception(ex);
+    }
+
+private:
+
+    const CB _cb;
+};
+
+class CreateTopicUpdate : public ObserverUpdateT<AMD_ReplicaObserver_createTopicPtr>
+{
+public:
+
+    CreateTopicUpdate(const AMD_ReplicaObserver_createTopicPtr& cb, const LogUpdate& l, const string& topic) :
+        ObserverUpdateT<AMD_ReplicaObserver_createTopicPtr>(cb, l, "create"), _topic(topic)
+    {
+    }
+
+    virtual void apply(const TopicManagerImplPtr& impl, const IceDB::ReadWriteTxn& txn)
+    {
+        impl->observerCreateTopic(txn, llu, _topic);
+    }
+
+private:
+
+    const string _topic;
+};
+
+class DestroyTopicUpdate : public ObserverUpdateT<AMD_ReplicaObserver_destroyTopicPtr>
+{
+public:
+
+    DestroyTopicUpdate(const AMD_ReplicaObserver_destroyTopicPtr& cb, const LogUpdate& l, const string& topic) :
+        ObserverUpdateT<AMD_ReplicaObserver_destroyTopicPtr>(cb, l, "destroy"), _topic(topic)
+    {
+    }
+
+    virtual void apply(const TopicManagerImplPtr& impl, const IceDB::ReadWriteTxn& txn)
+    {
+        impl->observerDestroyTopic(txn, llu, _topic);
+    }
+
+private:
+
+    const string _topic;
+};
+
+class AddSubscriberUpdate : public ObserverUpdateT<AMD_ReplicaObserver_addSubscriberPtr>
+{
+public:
+
+    AddSubscriberUpdate(const AMD_ReplicaObserver_addSubscriberPtr& cb, const LogUpdate& l, const string& topic,
+                        const SubscriberRecord& record) :
+        ObserverUpdateT<AMD_ReplicaObserver_addSubscriberPtr>(cb, l, "add"), _topic(topic), _record(record)
+    {
+    }
+
+    virtual void apply(const TopicManagerImplPtr& impl, const IceDB::ReadWriteTxn& txn)
+    {
+        impl->observerAddSubscriber(txn, llu, _topic, _record);
+    }
+
+private:
+
+    const string _topic;
+    const SubscriberRecord _record;
+};
+
+class RemoveSubscriberUpdate : public ObserverUpdateT<AMD_ReplicaObserver_removeSubscriberPtr>
+{
+public:
+
+    RemoveSubscriberUpdate(const AMD_ReplicaObserver_removeSubscriberPtr& cb, const LogUpdate& l,
+                           const string& topic, const Ice::IdentitySeq& ids) :
+        ObserverUpdateT<AMD_ReplicaObserver_removeSubscriberPtr>(cb, l, "remove"), _topic(topic), _ids(ids)
+    {
+    }
+
+    virtual void apply(const TopicManagerImplPtr& impl, const IceDB::ReadWriteTxn& txn)
+    {
+        impl->observerRemoveSubscriber(txn, llu, _topic, _ids);
+    }
+
+private:
+
+    const string _topic;
+    const Ice::IdentitySeq _ids;
+};
+
+//
+// The master sends the updates in log order without waiting for the
+// previous updates to be acknowledged. The updates are dispatched
+// concurrently by the node adapter thread pool, so the replica observer
+// queues them and applies them in log order: the log update stored by
+// the replica never skips an update.
+//
+class ReplicaObserverI : public ReplicaObserver, public IceUtil::Mutex
 {
 public:
 
     ReplicaObserverI(const PersistentInstancePtr& instance, const TopicManagerImplPtr& impl) :
         _instance(instance),
-        _impl(impl)
+        _impl(impl),
+        _applying(false)
     {
+        _llu.generation = 0;
+        _llu.iteration = 0;
     }
 
-    virtual void init(const LogUpdate& llu, const TopicContentSeq& content, const Ice::Current&)
+    virtual void init(const LogUpdate& llu, const TopicContentSeq& content, const Ice::Current& current)
     {
         NodeIPtr node = _instance->node();
         if(node)
@@ -137,78 +272,218 @@ public:
             node->checkObserverInit(llu.generation);
         }
         _impl->observerInit(llu, content);
-    }
 
-    virtual void createTopic(const LogUpdate& llu, const string& name, const Ice::Current&)
-    {
-        try
+        //
+        // Updates queued for a previous master are discarded, the
+        // content received from the master includes all the updates
+        // up to the given log update.
+        //
+        map<Ice::Long, ObserverUpdatePtr> pending;
         {
-            ObserverUpdateHelper unlock(_instance->node(), llu.generation, __FILE__, __LINE__);
-            _impl->observerCreateTopic(llu, name);
+            Lock sync(*this);
+            _llu = llu;
+            _connection = current.con;
+            _pending.swap(pending);
         }
-        catch(const ObserverInconsistencyException& e)
+        for(map<Ice::Long, ObserverUpdatePtr>::const_iterator p = pending.begin(); p != pending.end(); ++p)
         {
-            Ice::Warning warn(_instance->traceLevels()->logger);
-            warn << "ReplicaObserverI::create: ObserverInconsistencyException: " << e.reason;
-            _instance->node()->recovery(llu.generation);
-            throw;
+            p->second->exception(ObserverInconsistencyException("observer re-initialized"));
         }
     }
 
-    virtual void destroyTopic(const LogUpdate& llu, const string& name, const Ice::Current&)
+    virtual void createTopic_async(const AMD_ReplicaObserver_createTopicPtr& cb, const LogUpdate& llu,
+                                   const string& name, const Ice::Current& current)
     {
-        try
+        queue(new CreateTopicUpdate(cb, llu, name), current);
+    }
+
+    virtual void destroyTopic_async(const AMD_ReplicaObserver_destroyTopicPtr& cb, const LogUpdate& llu,
+                                    const string& name, const Ice::Current& current)
+    {
+        queue(new DestroyTopicUpdate(cb, llu, name), current);
+    }
+
+    virtual void addSubscriber_async(const AMD_ReplicaObserver_addSubscriberPtr& cb, const LogUpdate& llu,
+                                     const string& name, const SubscriberRecord& rec, const Ice::Current& current)
+    {
+        queue(new AddSubscriberUpdate(cb, llu, name, rec), current);
+    }
+
+    virtual void removeSubscriber_async(const AMD_ReplicaObserver_removeSubscriberPtr& cb, const LogUpdate& llu,
+                                        const string& name, const Ice::IdentitySeq& id, const Ice::Current& current)
+    {
+        queue(new RemoveSubscriberUpdate(cb, llu, name, id), current);
+    }
+
+private:
+
+    void queue(const ObserverUpdatePtr& update, const Ice::Current& current)
+    {
+        vector<ObserverUpdatePtr> missing;
         {
-            ObserverUpdateHelper unlock(_instance->node(), llu.generation, __FILE__, __LINE__);
-            _impl->observerDestroyTopic(llu, name);
+            Lock sync(*this);
+            if(update->llu.generation != _llu.generation)
+            {
+                //
+                // The update isn't from the master which initialized
+                // this observer, dispatch it right away to reject it.
+                //
+                sync.release();
+                apply(update);
+                return;
+            }
+
+            //
+            // Updates sent over a previous connection which weren't
+            // received are lost. The master sends the updates in order
+            // so this is also the case for an update already applied.
+            //
+            if(update->llu.iteration <= _llu.iteration ||
+               (current.con != _connection && (!_pending.empty() || update->llu.iteration != _llu.iteration + 1)))
+            {
+                for(map<Ice::Long, ObserverUpdatePtr>::const_iterator p = _pending.begin(); p != _pending.end(); ++p)
+                {
+                    missing.push_back(p->second);
+                }
+                missing.push_back(update);
+                _pending.clear();
+            }
+            else
+            {
+                _connection = current.con;
+                _pending.insert(make_pair(update->llu.iteration, update));
+                if(_applying)
+                {
+                    return; // The thread applying the updates will apply this update.
+                }
+                _applying = true;
+            }
         }
-        catch(const ObserverInconsistencyException& e)
+
+        if(!missing.empty())
         {
             Ice::Warning warn(_instance->traceLevels()->logger);
-            warn << "ReplicaObserverI::destroy: ObserverInconsistencyException: " << e.reason;
-            _instance->node()->recovery(llu.generation);
-            throw;
+            warn << "ReplicaObserverI::" << update->name << ": ObserverInconsistencyException: missing update";
+            _instance->node()->recovery(update->llu.generation);
+            for(vector<ObserverUpdatePtr>::const_iterator p = missing.begin(); p != missing.end(); ++p)
+            {
+                (*p)->exception(ObserverInconsistencyException("missing update"));
+            }
+            return;
+        }
+
+        while(true)
+        {
+            //
+            // Take the contiguous run of updates queued so far, they
+            // are applied in a single database transaction.
+            //
+            vector<ObserverUpdatePtr> updates;
+            {
+                Lock sync(*this);
+                map<Ice::Long, ObserverUpdatePtr>::iterator p = _pending.begin();
+                while(p != _pending.end() && p->first == _llu.iteration + 1)
+                {
+                    updates.push_back(p->second);
+                    _llu = p->second->llu;
+                    _pending.erase(p++);
+                }
+                if(updates.empty())
+                {
+                    _applying = false;
+                    return;
+                }
+            }
+            apply(updates);
         }
     }
 
-    virtual void addSubscriber(const LogUpdate& llu, const string& name, const SubscriberRecord& rec,
-                               const Ice::Current&)
+    void apply(const ObserverUpdatePtr& update)
     {
+        apply(vector<ObserverUpdatePtr>(1, update));
+    }
+
+    //
+    // The updates share the write transaction and are only acknowledged
+    // once it's committed. The transaction is opened before the topic
+    // manager and topic mutexes are locked, this is safe since while the
+    // observer update is in progress the node is a replica and the
+    // master-side updates, which lock these mutexes before opening a
+    // transaction, are forwarded to the master.
+    //
+    // If an update fails, none of the updates are committed but the
+    // in-memory state of the updates applied before it was already
+    // changed. Unless the failure occurred on the first update, the
+    // node recovers to get the content from the master again.
+    //
+    void apply(const vector<ObserverUpdatePtr>& updates)
+    {
+        assert(!updates.empty());
+        const Ice::Long generation = updates.front()->llu.generation;
+        vector<ObserverUpdatePtr>::const_iterator p = updates.begin();
         try
         {
-            ObserverUpdateHelper unlock(_instance->node(), llu.generation, __FILE__, __LINE__);
-            _impl->observerAddSubscriber(llu, name, rec);
+            ObserverUpdateHelper unlock(_instance->node(), generation, __FILE__, __LINE__);
+            IceDB::ReadWriteTxn txn(_instance->dbEnv());
+            for(; p != updates.end(); ++p)
+            {
+                (*p)->apply(_impl, txn);
+            }
+            txn.commit();
         }
         catch(const ObserverInconsistencyException& e)
         {
             Ice::Warning warn(_instance->traceLevels()->logger);
-            warn << "ReplicaObserverI::add: ObserverInconsistencyException: " << e.reason;
-            _instance->node()->recovery(llu.generation);
-            throw;
+            warn << "ReplicaObserverI::" << (*p)->name << ": ObserverInconsistencyException: " << e.reason;
+            _instance->node()->recovery(generation);
+            for(vector<ObserverUpdatePtr>::const_iterator q = updates.begin(); q != updates.end(); ++q)
+            {
+                (*q)->exception(e);
+            }
+            return;
+        }
+        catch(const IceDB::LMDBException& ex)
+        {
+            if(p == updates.end())
+            {
+                logError(_instance->communicator(), ex); // The commit failed.
+            }
+            fail(updates, p, ex);
+            return;
+        }
+        catch(const std::exception& ex)
+        {
+            fail(updates, p, ex);
+            return;
+        }
+
+        for(p = updates.begin(); p != updates.end(); ++p)
+        {
+            (*p)->response();
         }
     }
 
-    virtual void removeSubscriber(const LogUpdate& llu, const string& name, const Ice::IdentitySeq& id,
-                                  const Ice::Current&)
+    void fail(const vector<ObserverUpdatePtr>& updates, vector<ObserverUpdatePtr>::const_iterator failed,
+              const std::exception& ex)
     {
-        try
+        if(failed != updates.begin())
         {
-            ObserverUpdateHelper unlock(_instance->node(), llu.generation, __FILE__, __LINE__);
-            _impl->observerRemoveSubscriber(llu, name, id);
+            Ice::Warning warn(_instance->traceLevels()->logger);
+            warn << "ReplicaObserverI: " << updates.size() << " updates rolled back: " << ex.what();
+            _instance->node()->recovery(updates.front()->llu.generation);
         }
-        catch(const ObserverInconsistencyException& e)
+        for(vector<ObserverUpdatePtr>::const_iterator p = updates.begin(); p != updates.end(); ++p)
         {
-            Ice::Warning warn(_instance->traceLevels()->logger);
-            warn << "ReplicaObserverI::remove: ObserverInconsistencyException: " << e.reason;
-            _instance->node()->recovery(llu.generation);
-            throw;
+            (*p)->exception(ex);
         }
     }
 
-private:
-
     const PersistentInstancePtr _instance;
     const TopicManagerImplPtr _impl;
+    LogUpdate _llu; // The last update applied or being applied.
+    Ice::ConnectionPtr _connection; // The connection from the master.
+    map<Ice::Long, ObserverUpdatePtr> _pending;
+    bool _applying;
 };
 
 class TopicManagerSyncI : public TopicManagerSync
@@ -323,30 +598,40 @@ TopicManagerImpl::create(const string& name)
     Ice::Identity id = nameToIdentity(_instance, name);
 
     LogUpdate llu;
-    try
+    Observers::UpdatePtr observerUpdate;
     {
-        IceDB::ReadWriteTxn txn(_instance->dbEnv());
+        IceUtil::Mutex::Lock sendSync(_instance->observers()->sendMutex());
+        try
+        {
+            IceDB::ReadWriteTxn txn(_instance->dbEnv());
 
-        SubscriberRecordKey key;
-        key.topic = id;
-        SubscriberRecord rec;
-        rec.link = false;
-        rec.cost = 0;
+            SubscriberRecordKey key;
+            key.topic = id;
+            SubscriberRecord rec;
+            rec.link = false;
+            rec.cost = 0;
 
-        _subscriberMap.put(txn, key, rec);
+            _subscriberMap.put(txn, key, rec);
 
-        llu = getIncrementedLLU(txn, _lluMap);
+            llu = getIncrementedLLU(txn, _lluMap);
 
-        txn.commit();
-    }
-    catch(const IceDB::LMDBException& ex)
-    {
-        logError(_instance->communicator(), ex);
-        throw; // will become UnknownException in caller
+            txn.commit();
+        }
+        catch(const IceDB::LMDBException& ex)
+        {
+            logError(_instance->communicator(), ex);
+            throw; // will become UnknownException in caller
+        }
+
+        observerUpdate = _instance->observers()->createTopic(llu, name);
     }
 
-    _instance->observers()->createTopic(llu, name);
-    return installTopic(name, id, true);
+    TopicPrx topic = installTopic(name, id, true);
+
+    // Wait for the replicas to acknowledge the update without holding the lock.
+    sync.release();
+    observerUpdate->wait();
+    return topic;
 }
 
 TopicPrx
@@ -502,15 +787,13 @@ TopicManagerImpl::observerInit(const LogUpdate& llu, const TopicContentSeq& cont
 }
 
 void
-TopicManagerImpl::observerCreateTopic(const LogUpdate& llu, const string& name)
+TopicManagerImpl::observerCreateTopic(const IceDB::ReadWriteTxn& txn, const LogUpdate& llu, const string& name)
 {
     Lock sync(*this);
     Ice::Identity id = nameToIdentity(_instance, name);
 
     try
     {
-        IceDB::ReadWriteTxn txn(_instance->dbEnv());
-
         SubscriberRecordKey key;
         key.topic = id;
         SubscriberRecord rec;
@@ -524,8 +807,6 @@ TopicManagerImpl::observerCreateTopic(const LogUpdate& llu, const string& name)
         _subscriberMap.put(txn, key, rec);
 
         _lluMap.put(txn, lluDbKey, llu);
-
-        txn.commit();
     }
     catch(const IceDB::LMDBException& ex)
     {
@@ -537,7 +818,7 @@ TopicManagerImpl::observerCreateTopic(const LogUpdate& llu, const string& name)
 }
 
 void
-TopicManagerImpl::observerDestroyTopic(const LogUpdate& llu, const string& name)
+TopicManagerImpl::observerDestroyTopic(const IceDB::ReadWriteTxn& txn, const LogUpdate& llu, const string& name)
 {
     Lock sync(*this);
 
@@ -546,13 +827,14 @@ TopicManagerImpl::observerDestroyTopic(const LogUpdate& llu, const string& name)
     {
         throw ObserverInconsistencyException("no topic: " + name);
     }
-    q->second->observerDestroyTopic(llu);
+    q->second->observerDestroyTopic(txn, llu);
 
     _topics.erase(q);
 }
 
 void
-TopicManagerImpl::observerAddSubscriber(const LogUpdate& llu, const string& name, const SubscriberRecord& record)
+TopicManagerImpl::observerAddSubscriber(const IceDB::ReadWriteTxn& txn, const LogUpdate& llu, const string& name,
+                                        const SubscriberRecord& record)
 {
     TopicImplPtr topic;
     {
@@ -566,11 +848,12 @@ TopicManagerImpl::observerAddSubscriber(const LogUpdate& llu, const string& name
         assert(q != _topics.end());
         topic = q->second;
     }
-    topic->observerAddSubscriber(llu, record);
+    topic->observerAddSubscriber(txn, llu, record);
 }
 
 void
-TopicManagerImpl::observerRemoveSubscriber(const LogUpdate& llu, const string& name, const Ice::IdentitySeq& id)
+TopicManagerImpl::observerRemoveSubscriber(const IceDB::ReadWriteTxn& txn, const LogUpdate& llu, const string& name,
+                                           const Ice::IdentitySeq& id)
 {
     TopicImplPtr topic;
     {
@@ -584,7 +867,7 @@ TopicManagerImpl::observerRemoveSubscriber(const LogUpdate& llu, const string& n
         assert(q != _topics.end());
         topic = q->second;
     }
-    topic->observerRemoveSubscriber(llu, id);
+    topic->observerRemoveSubscriber(txn, llu, id);
 }
 
 void
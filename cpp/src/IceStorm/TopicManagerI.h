@@ -49,11 +49,12 @@ public:
 
     // Observer methods.
     void observerInit(const IceStormElection::LogUpdate&, const IceStormElection::TopicContentSeq&);
-    void observerCreateTopic(const IceStormElection::LogUpdate&, const std::string&);
-    void observerDestroyTopic(const IceStormElection::LogUpdate&, const std::string&);
-    void observerAddSubscriber(const IceStormElection::LogUpdate&, const std::string&,
+    void observerCreateTopic(const IceDB::ReadWriteTxn&, const IceStormElection::LogUpdate&, const std::string&);
+    void observerDestroyTopic(const IceDB::ReadWriteTxn&, const IceStormElection::LogUpdate&, const std::string&);
+    void observerAddSubscriber(const IceDB::ReadWriteTxn&, const IceStormElection::LogUpdate&, const std::string&,
                                const IceStorm::SubscriberRecord&);
-    void observerRemoveSubscriber(const IceStormElection::LogUpdate&, const std::string&, const Ice::IdentitySeq&);
+    void observerRemoveSubscriber(const IceDB::ReadWriteTxn&, const IceStormElection::LogUpdate&, const std::string&,
+                                  const Ice::IdentitySeq&);
 
     // Sync methods.
     void getContent(IceStormElection::LogUpdate&, IceStormElection::TopicContentSeq&);
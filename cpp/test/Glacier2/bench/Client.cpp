@@ -0,0 +1,415 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2018 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <IceUtil/Options.h>
+#include <IceUtil/Thread.h>
+#include <Glacier2/Router.h>
+#include <Bench.h>
+#include <TestHelper.h>
+#include <algorithm>
+#include <iomanip>
+
+using namespace std;
+using namespace Ice;
+using namespace Test;
+
+namespace
+{
+
+class CallbackI : public Test::Callback
+{
+public:
+
+    virtual void
+    callback(const Ice::ByteSeq&, const Ice::Current&)
+    {
+    }
+};
+
+//
+// A client session with its own communicator, and therefore its own
+// connection to the router.
+//
+class Session : public IceUtil::Shared
+{
+public:
+
+    Session(const Ice::CommunicatorPtr& communicator) :
+        _communicator(communicator),
+        _router(Glacier2::RouterPrx::uncheckedCast(communicator->getDefaultRouter()))
+    {
+    }
+
+    void
+    create()
+    {
+        _router->createSession("userid", "abc123");
+    }
+
+    CallbackPrx
+    addCallback()
+    {
+        Ice::ObjectAdapterPtr adapter = _communicator->createObjectAdapterWithRouter("CallbackReceiverAdapter",
+                                                                                    _router);
+        adapter->activate();
+
+        Ice::Identity ident;
+        ident.name = "callback";
+        ident.category = _router->getCategoryForClient();
+        return CallbackPrx::uncheckedCast(adapter->add(new CallbackI, ident));
+    }
+
+    void
+    destroySession()
+    {
+        try
+        {
+            _router->destroySession();
+        }
+        catch(const Ice::LocalException&)
+        {
+        }
+    }
+
+    void
+    destroy()
+    {
+        destroySession();
+        _communicator->destroy();
+    }
+
+    const Ice::CommunicatorPtr&
+    communicator() const
+    {
+        return _communicator;
+    }
+
+private:
+
+    const Ice::CommunicatorPtr _communicator;
+    const Glacier2::RouterPrx _router;
+};
+typedef IceUtil::Handle<Session> SessionPtr;
+
+class CreateSessionThread : public IceUtil::Thread
+{
+public:
+
+    CreateSessionThread(const SessionPtr& session) :
+        _session(session), _failed(false)
+    {
+    }
+
+    virtual void
+    run()
+    {
+        try
+        {
+            _session->create();
+        }
+        catch(const Ice::Exception& ex)
+        {
+            cerr << "session creation failed: " << ex << endl;
+            _failed = true;
+        }
+    }
+
+    bool
+    failed() const
+    {
+        return _failed;
+    }
+
+private:
+
+    const SessionPtr _session;
+    bool _failed;
+};
+typedef IceUtil::Handle<CreateSessionThread> CreateSessionThreadPtr;
+
+//
+// Creates the sessions concurrently, as clients reconnecting after a
+// router restart would, and prints the session setup rate.
+//
+void
+createSessions(const vector<SessionPtr>& sessions, const string& description)
+{
+    vector<CreateSessionThreadPtr> threads;
+    for(vector<SessionPtr>::const_iterator p = sessions.begin(); p != sessions.end(); ++p)
+    {
+        threads.push_back(new CreateSessionThread(*p));
+    }
+
+    IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    vector<IceUtil::ThreadControl> controls;
+    for(vector<CreateSessionThreadPtr>::const_iterator p = threads.begin(); p != threads.end(); ++p)
+    {
+        controls.push_back((*p)->start());
+    }
+    for(vector<IceUtil::ThreadControl>::iterator p = controls.begin(); p != controls.end(); ++p)
+    {
+        p->join();
+    }
+    IceUtil::Time elapsed = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+
+    for(vector<CreateSessionThreadPtr>::const_iterator p = threads.begin(); p != threads.end(); ++p)
+    {
+        test(!(*p)->failed());
+    }
+    cout << description << ": " << sessions.size() << " sessions in " << elapsed.toMilliSeconds() << "ms ("
+         << fixed << setprecision(1) << sessions.size() / elapsed.toSecondsDouble() << " sessions/s)" << endl;
+}
+
+//
+// Makes the given number of twoway calls, or callbacks if a callback
+// proxy is provided, and records the latency of each call.
+//
+class CallThread : public IceUtil::Thread
+{
+public:
+
+    CallThread(const BackendPrx& backend, const CallbackPrx& cb, int calls, int size) :
+        _backend(backend), _callback(cb), _calls(calls), _payload(size, 0), _failed(false)
+    {
+        _latencies.reserve(calls);
+    }
+
+    virtual void
+    run()
+    {
+        try
+        {
+            for(int i = 0; i < _calls; ++i)
+            {
+                IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+                if(_callback)
+                {
+                    _backend->callback(_callback, _payload);
+                }
+                else
+                {
+                    _backend->call(_payload);
+                }
+                _latencies.push_back((IceUtil::Time::now(IceUtil::Time::Monotonic) - start).toMicroSeconds());
+            }
+        }
+        catch(const Ice::Exception& ex)
+        {
+            cerr << "call failed: " << ex << endl;
+            _failed = true;
+        }
+    }
+
+    const vector<Ice::Long>&
+    latencies() const
+    {
+        return _latencies;
+    }
+
+    bool
+    failed() const
+    {
+        return _failed;
+    }
+
+private:
+
+    const BackendPrx _backend;
+    const CallbackPrx _callback;
+    const int _calls;
+    const Ice::ByteSeq _payload;
+    vector<Ice::Long> _latencies; // The latency of each call in microseconds.
+    bool _failed;
+};
+typedef IceUtil::Handle<CallThread> CallThreadPtr;
+
+Ice::Long
+percentile(const vector<Ice::Long>& sorted, double p)
+{
+    size_t n = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[n];
+}
+
+//
+// Runs the call threads concurrently, prints the call rate and latency
+// percentiles and returns the sorted latencies.
+//
+vector<Ice::Long>
+runCalls(const vector<CallThreadPtr>& threads, const string& description)
+{
+    IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    vector<IceUtil::ThreadControl> controls;
+    for(vector<CallThreadPtr>::const_iterator p = threads.begin(); p != threads.end(); ++p)
+    {
+        controls.push_back((*p)->start());
+    }
+    for(vector<IceUtil::ThreadControl>::iterator p = controls.begin(); p != controls.end(); ++p)
+    {
+        p->join();
+    }
+    IceUtil::Time elapsed = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+
+    vector<Ice::Long> latencies;
+    for(vector<CallThreadPtr>::const_iterator p = threads.begin(); p != threads.end(); ++p)
+    {
+        test(!(*p)->failed());
+        latencies.insert(latencies.end(), (*p)->latencies().begin(), (*p)->latencies().end());
+    }
+    sort(latencies.begin(), latencies.end());
+
+    cout << description << ": " << latencies.size() << " calls with " << threads.size() << " thread(s) in "
+         << elapsed.toMilliSeconds() << "ms (" << static_cast<Ice::Long>(latencies.size() / elapsed.toSecondsDouble())
+         << " calls/s)" << endl;
+    cout << fixed << setprecision(3)
+         << "    latency (ms): p50 " << percentile(latencies, 0.5) / 1000.0
+         << ", p90 " << percentile(latencies, 0.9) / 1000.0
+         << ", p99 " << percentile(latencies, 0.99) / 1000.0
+         << ", max " << latencies.back() / 1000.0 << endl;
+    return latencies;
+}
+
+}
+
+class BenchClient : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+BenchClient::run(int argc, char** argv)
+{
+    Ice::PropertiesPtr properties = createTestProperties(argc, argv);
+    properties->setProperty("Ice.Warn.Connections", "0");
+    Ice::CommunicatorHolder communicator = initialize(argc, argv, properties);
+
+    IceUtilInternal::Options opts;
+    opts.addOpt("", "sessions", IceUtilInternal::Options::NeedArg);
+    opts.addOpt("", "calls", IceUtilInternal::Options::NeedArg);
+    opts.addOpt("", "size", IceUtilInternal::Options::NeedArg);
+    opts.addOpt("", "callbacks");
+
+    try
+    {
+        opts.parse(argc, (const char**)argv);
+    }
+    catch(const IceUtilInternal::BadOptException& e)
+    {
+        ostringstream os;
+        os << argv[0] << ": " << e.reason;
+        throw invalid_argument(os.str());
+    }
+
+    int sessions = opts.isSet("sessions") ? atoi(opts.optArg("sessions").c_str()) : 10;
+    int calls = opts.isSet("calls") ? atoi(opts.optArg("calls").c_str()) : 1000;
+    int size = opts.isSet("size") ? atoi(opts.optArg("size").c_str()) : 0;
+    if(sessions <= 0 || calls <= 0 || size < 0)
+    {
+        ostringstream os;
+        os << argv[0] << ": sessions and calls must be > 0 and size must be >= 0.";
+        throw invalid_argument(os.str());
+    }
+    bool callbacks = opts.isSet("callbacks");
+
+    BackendPrx direct = BackendPrx::uncheckedCast(communicator->stringToProxy("bench/backend:" + getTestEndpoint()));
+    direct->ice_ping();
+
+    //
+    // Create the sessions, each session uses its own communicator.
+    //
+    Ice::InitializationData initData;
+    initData.properties = communicator->getProperties()->clone();
+    initData.properties->setProperty("Ice.Default.Router", "Glacier2/router:" + getTestEndpoint(50));
+
+    vector<SessionPtr> clients;
+    for(int i = 0; i < sessions; ++i)
+    {
+        clients.push_back(new Session(Ice::initialize(initData)));
+    }
+
+    createSessions(clients, "session setup");
+
+    //
+    // Destroy and re-create the sessions, the password verifications can
+    // be served from the cache of the permissions verifier if enabled.
+    //
+    for(vector<SessionPtr>::const_iterator p = clients.begin(); p != clients.end(); ++p)
+    {
+        (*p)->destroySession();
+    }
+    createSessions(clients, "session re-creation");
+
+    //
+    // The latency of direct calls to the backend is the reference to
+    // compute the latency added by the router. The direct calls are made
+    // with the same concurrency as the routed calls: each session calls
+    // the backend from its own thread, over its own connection.
+    //
+    vector<CallThreadPtr> threads;
+    for(vector<SessionPtr>::const_iterator p = clients.begin(); p != clients.end(); ++p)
+    {
+        BackendPrx backend = BackendPrx::uncheckedCast(
+            (*p)->communicator()->stringToProxy("bench/backend:" + getTestEndpoint())->ice_router(0));
+        backend->ice_ping();
+        threads.push_back(new CallThread(backend, 0, calls, size));
+    }
+    Ice::Long directLatency = percentile(runCalls(threads, "direct calls"), 0.5);
+
+    //
+    // Routed calls, each session calls the backend from its own thread.
+    //
+    threads.clear();
+    for(vector<SessionPtr>::const_iterator p = clients.begin(); p != clients.end(); ++p)
+    {
+        BackendPrx backend = BackendPrx::uncheckedCast(
+            (*p)->communicator()->stringToProxy("bench/backend:" + getTestEndpoint()));
+        backend->ice_ping();
+        threads.push_back(new CallThread(backend, 0, calls, size));
+    }
+    Ice::Long routedLatency = percentile(runCalls(threads, "routed calls"), 0.5);
+    cout << fixed << setprecision(3) << "    added latency per router hop (ms): p50 "
+         << (routedLatency - directLatency) / 1000.0 << endl;
+
+    if(callbacks)
+    {
+        //
+        // Each callback is a routed call to the backend which makes a
+        // routed call back to the session, i.e. it goes twice through the
+        // router.
+        //
+        threads.clear();
+        for(vector<SessionPtr>::const_iterator p = clients.begin(); p != clients.end(); ++p)
+        {
+            BackendPrx backend = BackendPrx::uncheckedCast(
+                (*p)->communicator()->stringToProxy("bench/backend:" + getTestEndpoint()));
+            threads.push_back(new CallThread(backend, (*p)->addCallback(), calls, size));
+        }
+        Ice::Long callbackLatency = percentile(runCalls(threads, "routed callbacks"), 0.5);
+        cout << fixed << setprecision(3) << "    added latency per router hop (ms): p50 "
+             << (callbackLatency - 2 * directLatency) / 2 / 1000.0 << endl;
+    }
+
+    for(vector<SessionPtr>::const_iterator p = clients.begin(); p != clients.end(); ++p)
+    {
+        (*p)->destroy();
+    }
+
+    //
+    // Shutdown the backend and the router.
+    //
+    direct->shutdown();
+    Ice::ProcessPrx process = Ice::ProcessPrx::checkedCast(
+        communicator->stringToProxy("Glacier2/admin -f Process:" + getTestEndpoint(51)));
+    test(process);
+    process->shutdown();
+}
+
+DEFINE_TEST(BenchClient)
@@ -0,0 +1,15 @@
+# **********************************************************************
+#
+# Copyright (c) 2003-2018 ZeroC, Inc. All rights reserved.
+#
+# This copy of Ice is licensed to you under the terms described in the
+# ICE_LICENSE file included in this distribution.
+#
+# **********************************************************************
+
+$(test)_client_sources = Client.cpp Bench.ice
+$(test)_client_dependencies = Glacier2
+
+$(test)_server_sources = Server.cpp Bench.ice
+
+tests += $(test)
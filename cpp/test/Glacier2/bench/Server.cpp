@@ -0,0 +1,73 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2018 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <Bench.h>
+#include <TestHelper.h>
+
+using namespace std;
+using namespace Ice;
+using namespace Test;
+
+namespace
+{
+
+class BackendI : public Backend
+{
+public:
+
+    virtual void
+    call(const Ice::ByteSeq&, const Ice::Current&)
+    {
+    }
+
+    virtual void
+    callback(const CallbackPrx& cb, const Ice::ByteSeq& payload, const Ice::Current&)
+    {
+        cb->callback(payload);
+    }
+
+    virtual void
+    shutdown(const Ice::Current& current)
+    {
+        current.adapter->getCommunicator()->shutdown();
+    }
+};
+
+}
+
+class BackendServer : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+BackendServer::run(int argc, char** argv)
+{
+    Ice::PropertiesPtr properties = createTestProperties(argc, argv);
+    properties->setProperty("Ice.Warn.Connections", "0");
+
+    //
+    // The backend dispatches the requests of all the sessions, the
+    // callbacks are nested invocations.
+    //
+    properties->setProperty("Ice.ThreadPool.Server.Size", "4");
+    properties->setProperty("Ice.ThreadPool.Server.SizeMax", "16");
+
+    Ice::CommunicatorHolder communicator = initialize(argc, argv, properties);
+    communicator->getProperties()->setProperty("BackendAdapter.Endpoints", getTestEndpoint());
+    ObjectAdapterPtr adapter = communicator->createObjectAdapter("BackendAdapter");
+    adapter->add(new BackendI, Ice::stringToIdentity("bench/backend"));
+    adapter->activate();
+    communicator->waitForShutdown();
+}
+
+DEFINE_TEST(BackendServer)
@@ -0,0 +1,69 @@
+# -*- coding: utf-8 -*-
+# **********************************************************************
+#
+# Copyright (c) 2003-2018 ZeroC, Inc. All rights reserved.
+#
+# This copy of Ice is licensed to you under the terms described in the
+# ICE_LICENSE file included in this distribution.
+#
+# **********************************************************************
+
+#
+# Measures the Glacier2 router capacity with several client sessions:
+# the session setup rate, the rate of routed calls and callbacks and the
+# latency added by the router compared to direct calls to the backend.
+# Sessions are created concurrently, then destroyed and re-created to
+# measure reconnects. The client can also be run directly against a router
+# with larger --sessions, --calls and --size values.
+#
+# The benchmark isn't part of the regular test runs, it only runs if the
+# --bench option is passed to allTests.py.
+#
+
+sessions = 10
+calls = 1000
+size = 128
+
+routerProps = {
+   "Ice.Warn.Dispatch" : "0",
+   "Ice.Warn.Connections" : "0",
+   "Glacier2.SessionTimeout" : "30",
+}
+
+def buffered(enabled, threads=1):
+    return { "Glacier2.Client.Buffered": enabled, "Glacier2.Server.Buffered": enabled,
+             "Glacier2.Client.FlushThreads": threads, "Glacier2.Server.FlushThreads": threads }
+
+#
+# Filters accepting the backend, with address rules to evaluate for each
+# proxy added to the routing table.
+#
+filtering = {
+    "Glacier2.Filter.Category.Accept" : "bench",
+    "Glacier2.Filter.Address.Accept" : "*.example.com host[1-100].example.org 10.0.0.[1-254] localhost 127.0.0.1",
+}
+
+def merge(*props):
+    result = {}
+    for p in props:
+        result.update(p)
+    return result
+
+class Glacier2BenchTestCase(ClientServerTestCase):
+
+    def __init__(self, name, props, callbacks=False):
+        args = ["--sessions", str(sessions), "--calls", str(calls), "--size", str(size)]
+        if callbacks:
+            args.append("--callbacks")
+        ClientServerTestCase.__init__(self, name,
+                                      servers=[Glacier2Router(props=props), Server()],
+                                      client=Client(args=args))
+
+Glacier2TestSuite(__name__, routerProps, [
+    Glacier2BenchTestCase("unbuffered router", buffered(False), callbacks=True),
+    Glacier2BenchTestCase("buffered router", buffered(True), callbacks=True),
+    Glacier2BenchTestCase("buffered router with several flush threads", buffered(True, 4), callbacks=True),
+    Glacier2BenchTestCase("unbuffered router with filtering", merge(buffered(False), filtering)),
+    Glacier2BenchTestCase("unbuffered router with password cache",
+                          merge(buffered(False), { "Glacier2.CryptPermissionsVerifier.CacheTimeout": 60 })),
+], options={ "ipv6" : [False] }, multihost=False)
@@ -412,6 +412,65 @@ public:
     }
 };
 
+//
+// Creates a session over its own connection and destroys it, returns
+// false if the router denied the permissions.
+//
+bool
+login(const Glacier2::RouterPrx& router, const string& userId, const string& password)
+{
+    Glacier2::RouterPrx r = router->ice_connectionId(IceUtil::generateUUID());
+    try
+    {
+        r->createSession(userId, password);
+    }
+    catch(const Glacier2::PermissionDeniedException&)
+    {
+        r->ice_getCachedConnection()->close(Ice::ICE_SCOPED_ENUM(ConnectionClose, Gracefully));
+        return false;
+    }
+    r->destroySession();
+    return true;
+}
+
+IceUtil::Time
+timeLogin(const Glacier2::RouterPrx& router, const string& userId, const string& password, bool ok)
+{
+    IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    test(login(router, userId, password) == ok);
+    return IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+}
+
+class LoginThread : public IceUtil::Thread
+{
+public:
+
+    LoginThread(const Glacier2::RouterPrx& router, const string& userId, const string& password) :
+        _router(router), _userId(userId), _password(password), _ok(false)
+    {
+    }
+
+    virtual void
+    run()
+    {
+        _ok = login(_router, _userId, _password);
+    }
+
+    bool
+    ok() const
+    {
+        return _ok;
+    }
+
+private:
+
+    const Glacier2::RouterPrx _router;
+    const string _userId;
+    const string _password;
+    bool _ok;
+};
+typedef IceUtil::Handle<LoginThread> LoginThreadPtr;
+
 class CallbackClient : public Test::TestHelper
 {
 public:
@@ -468,6 +527,64 @@ CallbackClient::run(int argc, char** argv)
         cout << "ok" << endl;
     }
 
+    if(argc >= 2 && strcmp(argv[1], "--passwords") == 0)
+    {
+        cout << "testing password verification cache... " << flush;
+
+        //
+        // A wrong password is never found in the cache and requires a full
+        // verification, a correct password is found in the cache once it was
+        // verified.
+        //
+        test(login(router, "userid-0", "abc123"));
+        IceUtil::Time hit = IceUtil::Time::seconds(60);
+        IceUtil::Time miss = IceUtil::Time::seconds(60);
+        for(int i = 0; i < 3; ++i)
+        {
+            hit = min(hit, timeLogin(router, "userid-0", "abc123", true));
+            miss = min(miss, timeLogin(router, "userid-0", "xxx", false));
+        }
+        test(hit < miss);
+
+        //
+        // The cached verification of a user doesn't accept another password,
+        // or the password of another user.
+        //
+        test(!login(router, "userid-0", "abc1234"));
+        test(!login(router, "userid-0", "abc12"));
+        test(!login(router, "userid-0", ""));
+        test(!login(router, "userid-1", "xxx"));
+        test(login(router, "userid-0", "abc123"));
+        cout << "ok" << endl;
+
+        cout << "testing concurrent password verifications... " << flush;
+        vector<LoginThreadPtr> threads;
+        for(int i = 0; i < 5; ++i)
+        {
+            ostringstream os;
+            os << "userid-" << i;
+            for(int j = 0; j < 4; ++j)
+            {
+                threads.push_back(new LoginThread(router, os.str(), "abc123"));
+                threads.push_back(new LoginThread(router, os.str(), "xxx"));
+            }
+        }
+        vector<IceUtil::ThreadControl> controls;
+        for(vector<LoginThreadPtr>::const_iterator p = threads.begin(); p != threads.end(); ++p)
+        {
+            controls.push_back((*p)->start());
+        }
+        for(vector<IceUtil::ThreadControl>::iterator p = controls.begin(); p != controls.end(); ++p)
+        {
+            p->join();
+        }
+        for(vector<LoginThreadPtr>::size_type i = 0; i < threads.size(); ++i)
+        {
+            test(threads[i]->ok() == (i % 2 == 0));
+        }
+        cout << "ok" << endl;
+    }
+
     ObjectPrx base;
 
     {
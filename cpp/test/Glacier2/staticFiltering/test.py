@@ -222,6 +222,53 @@ class Glacier2StaticFilteringTestSuite(Glacier2TestSuite):
                         (False, 'cata/fooa:tcp -h 127.0.0.1 -p 12010'),
                         (True, '"a funny id/that might mess it up" @ myadapter'),
                         (False, '"a funny id/that might mess it up":tcp -h 127.0.0.1 -p 12010')], []),
+                ('testing address filter starting with a string',
+                        ('127.*', '', '', '', '', ''),
+                        [(True, 'hello:tcp -h 127.0.0.1 -p 12010'),
+                        (False, 'hello:tcp -h 128.0.0.1 -p 12010'),
+                        (False, 'hello:tcp -h 1127.0.0.1 -p 12010')], []),
+                ('testing address filter ending with a string',
+                        ('*.0.1', '', '', '', '', ''),
+                        [(True, 'hello:tcp -h 127.0.0.1 -p 12010'),
+                        (False, 'hello:tcp -h 127.0.1.0 -p 12010'),
+                        (False, 'hello:tcp -h 127.0.0.11 -p 12010')], []),
+                ('testing address filter containing a string',
+                        ('*7.0*', '', '', '', '', ''),
+                        [(True, 'hello:tcp -h 127.0.0.1 -p 12010'),
+                        (False, 'hello:tcp -h 128.0.0.1 -p 12010')], []),
+                #
+                # The character following a string bounded by wildcards
+                # isn't matched by the rest of the filter: 127.0.0.1 doesn't
+                # match *7*.0.0* but 17.0.0.0 does.
+                #
+                ('testing address filter containing strings',
+                        ('', '*7*.0.0*', '', '', '', ''),
+                        [(True, 'hello:tcp -h 127.0.0.1 -p 12010'),
+                        (False, 'hello:tcp -h 17.0.0.0 -p 12010')], []),
+                ('testing address filter with a numeric group',
+                        ('127.0.0.[0,1-3]', '', '', '', '', ''),
+                        [(True, 'hello:tcp -h 127.0.0.1 -p 12010'),
+                        (False, 'hello:tcp -h 127.0.0.4 -p 12010'),
+                        (False, 'hello:tcp -h 127.0.0.10 -p 12010')], []),
+                ('testing address filter containing a numeric group',
+                        ('*[0-1].1', '', '', '', '', ''),
+                        [(True, 'hello:tcp -h 127.0.0.1 -p 12010'),
+                        (False, 'hello:tcp -h 127.5.5.2 -p 12010')], []),
+                #
+                # A string following a numeric group is matched with the
+                # start of the host: 127.0.0.1 matches 1[27]1*.
+                #
+                ('testing address filter with a string following a numeric group',
+                        ('1[27]1*', '', '', '', '', ''),
+                        [(True, 'hello:tcp -h 127.0.0.1 -p 12010'),
+                        (False, 'hello:tcp -h 137.0.0.1 -p 12010'),
+                        (False, 'hello:tcp -h 1127.0.0.1 -p 12010')], []),
+                ('testing address filter with signed numbers',
+                        ('', 'foo[-5--1].com foo[+7].com', '', '', '', ''),
+                        [(True, 'hello:tcp -h 127.0.0.1 -p 12010'),
+                        (False, 'hello:tcp -h foo-3.com -p 12010'),
+                        (False, 'hello:tcp -h foo+7.com -p 12010'),
+                        (False, 'hello:tcp -h foo7.com -p 12010')], []),
                 ]
 
         if not limitedTests:
@@ -287,7 +334,7 @@ class Glacier2StaticFilteringTestSuite(Glacier2TestSuite):
             current.writeln("WARNING: You are running this test with SSL disabled and the network ")
             current.writeln("         configuration for this host does not permit the other tests ")
             current.writeln("         to run correctly.")
-        elif len(testcases) < 6:
+        elif limitedTests:
             current.writeln("WARNING: The network configuration for this host does not permit all ")
             current.writeln("         tests to run correctly, some tests have been disabled.")
 
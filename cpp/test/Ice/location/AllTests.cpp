@@ -629,6 +629,45 @@ allTests(Test::TestHelper* helper, const string& ref)
     }
     cout << "ok" << endl;
 
+    cout << "testing locator cache refresh ahead and size limit... " << flush;
+    {
+        Ice::InitializationData initData;
+        initData.properties = communicator->getProperties()->clone();
+        initData.properties->setProperty("Ice.LocatorCacheRefreshAhead", "50");
+        initData.properties->setProperty("Ice.LocatorCacheMaxSize", "1");
+        Ice::CommunicatorPtr ic = Ice::initialize(initData);
+
+        registry->setAdapterDirectProxy("TestAdapter5", locator->findAdapterById("TestAdapter"));
+
+        int count = locator->getRequestCount();
+        ic->stringToProxy("test@TestAdapter5")->ice_locatorCacheTimeout(2)->ice_ping(); // 2s timeout.
+        test(++count == locator->getRequestCount());
+        ic->stringToProxy("test@TestAdapter5")->ice_locatorCacheTimeout(2)->ice_ping();
+        test(count == locator->getRequestCount());
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(1200));
+
+        // The entry is still valid but older than half of the timeout, it's used and refreshed in the background.
+        ic->stringToProxy("test@TestAdapter5")->ice_locatorCacheTimeout(2)->ice_ping();
+        for(int i = 0; i < 100 && locator->getRequestCount() == count; ++i)
+        {
+            IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(10));
+        }
+        test(++count == locator->getRequestCount());
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(100));
+        ic->stringToProxy("test@TestAdapter5")->ice_locatorCacheTimeout(2)->ice_ping();
+        test(count == locator->getRequestCount());
+
+        // Caching the endpoints of another adapter evicts the least recently used entry.
+        ic->stringToProxy("test@TestAdapter")->ice_ping();
+        test(++count == locator->getRequestCount());
+        ic->stringToProxy("test@TestAdapter")->ice_ping();
+        test(count == locator->getRequestCount());
+        ic->stringToProxy("test@TestAdapter5")->ice_ping();
+        test(++count == locator->getRequestCount());
+        ic->destroy();
+    }
+    cout << "ok" << endl;
+
     cout << "testing proxy from server after shutdown... " << flush;
     hello = obj->getReplicatedHello();
     obj->shutdown();
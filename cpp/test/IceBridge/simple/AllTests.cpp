@@ -199,6 +199,25 @@ allTests(Test::TestHelper* helper)
             cl->waitCounter(counter);
             p->closeConnection(false);
         }
+
+        //
+        // Make sure ordering is preserved when batch, oneway and twoway requests are
+        // forwarded over the same connection.
+        //
+        Test::MyClassPrx p = cl->ice_connectionId("batch");
+        Test::MyClassPrx batch = p->ice_batchOneway();
+        for(int i = 0; i < 10; ++i)
+        {
+            for(int j = 0; j < 20; ++j)
+            {
+                batch->incCounter(++counter);
+            }
+            batch->ice_flushBatchRequests();
+            p->ice_oneway()->incCounter(++counter);
+            p->incCounter(++counter);
+        }
+        cl->waitCounter(counter);
+        p->closeConnection(false);
     }
     cout << "ok" << endl;
 
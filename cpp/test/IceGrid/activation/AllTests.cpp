@@ -738,6 +738,68 @@ allTests(Test::TestHelper* helper)
     }
     cout << "ok" << endl;
 
+    cout << "testing concurrent activations... " << flush;
+    {
+        IceGrid::ApplicationInfo info = admin->getApplicationInfo("Test");
+        IceGrid::ApplicationDescriptor testApp;
+        testApp.name = "TestApp";
+        testApp.serverTemplates = info.descriptor.serverTemplates;
+        testApp.variables = info.descriptor.variables;
+        const int nServers = 10;
+        for(int i = 0; i < nServers; ++i)
+        {
+            ostringstream id;
+            id << "server-" << i;
+            IceGrid::ServerInstanceDescriptor server;
+            server._cpp_template = "Server";
+            server.parameterValues["id"] = id.str();
+            testApp.nodes["localnode"].serverInstances.push_back(server);
+        }
+        try
+        {
+            admin->addApplication(testApp);
+        }
+        catch(const IceGrid::DeploymentException& ex)
+        {
+            cerr << ex.reason << endl;
+            test(false);
+        }
+
+        //
+        // Start the servers without waiting for the previous servers to
+        // be active, the node activates at most
+        // IceGrid.Node.MaxConcurrentActivations servers at a time.
+        //
+        vector<Ice::AsyncResultPtr> results;
+        for(int i = 0; i < nServers; ++i)
+        {
+            ostringstream id;
+            id << "server-" << i;
+            results.push_back(admin->begin_startServer(id.str()));
+        }
+        try
+        {
+            for(vector<Ice::AsyncResultPtr>::const_iterator p = results.begin(); p != results.end(); ++p)
+            {
+                admin->end_startServer(*p);
+            }
+        }
+        catch(const IceGrid::ServerStartException& ex)
+        {
+            cerr << ex.reason << endl;
+            test(false);
+        }
+        for(int i = 0; i < nServers; ++i)
+        {
+            ostringstream id;
+            id << "server-" << i;
+            test(admin->getServerState(id.str()) == IceGrid::Active);
+            admin->stopServer(id.str());
+        }
+        admin->removeApplication("TestApp");
+    }
+    cout << "ok" << endl;
+
     admin->stopServer("node-1");
     admin->stopServer("node-2");
 
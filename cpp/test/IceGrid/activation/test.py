@@ -9,4 +9,8 @@
 # **********************************************************************
 
 if isinstance(platform, Windows) or os.getuid() != 0:
-    TestSuite(__file__, [IceGridTestCase()], multihost=False)
+    TestSuite(__file__, [
+        IceGridTestCase(),
+        IceGridTestCase("with serialized activations",
+                        icegridnode=IceGridNode(props={ "IceGrid.Node.MaxConcurrentActivations" : 1 })),
+    ], multihost=False)
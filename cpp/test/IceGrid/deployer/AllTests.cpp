@@ -403,6 +403,39 @@ allTests(Test::TestHelper* helper)
     test(find(serverIds.begin(), serverIds.end(), "IceBox2") != serverIds.end());
     test(find(serverIds.begin(), serverIds.end(), "SimpleServer") != serverIds.end());
     test(find(serverIds.begin(), serverIds.end(), "SimpleIceBox") != serverIds.end());
+    {
+        IdIteratorPrx it = session->openServerIds();
+        Ice::StringSeq ids;
+        Ice::StringSeq batch;
+        bool done;
+        do
+        {
+            done = it->next(2, batch);
+            test(batch.size() <= 2);
+            ids.insert(ids.end(), batch.begin(), batch.end());
+        }
+        while(!done);
+        it->destroy();
+        test(ids == serverIds);
+    }
+    {
+        //
+        // A batch size lower than 1 is treated as 1.
+        //
+        IdIteratorPrx it = session->openServerIds();
+        Ice::StringSeq ids;
+        Ice::StringSeq batch;
+        bool done;
+        do
+        {
+            done = it->next(0, batch);
+            test(batch.size() <= 1);
+            ids.insert(ids.end(), batch.begin(), batch.end());
+        }
+        while(!done);
+        it->destroy();
+        test(ids == serverIds);
+    }
     cout << "ok" << endl;
 
     cout << "testing adapter registration... " << flush;
@@ -417,6 +450,23 @@ allTests(Test::TestHelper* helper)
     test(find(adapterIds.begin(), adapterIds.end(), "SimpleIceBox.SimpleService.SimpleService") != adapterIds.end());
     test(find(adapterIds.begin(), adapterIds.end(), "ReplicatedAdapter") != adapterIds.end());
     test(find(adapterIds.begin(), adapterIds.end(), "ReplicatedAdapter 2") != adapterIds.end());
+    {
+        IdIteratorPrx it = session->openAdapterIds();
+        Ice::StringSeq ids;
+        Ice::StringSeq batch;
+        bool done;
+        do
+        {
+            done = it->next(3, batch);
+            test(batch.size() <= 3);
+            ids.insert(ids.end(), batch.begin(), batch.end());
+        }
+        while(!done);
+        it->destroy();
+        sort(ids.begin(), ids.end());
+        sort(adapterIds.begin(), adapterIds.end());
+        test(ids == adapterIds);
+    }
     cout << "ok" << endl;
 
     cout << "testing object registration... " << flush;
@@ -504,6 +554,30 @@ allTests(Test::TestHelper* helper)
     test(query->findObjectById(replicated15) == locator->findObjectById(replicated15));
     test(query->findObjectById(replicated14) == locator->findObjectById(replicated14));
 
+    {
+        ObjectInfoSeq infos = admin->getAllObjectInfos("");
+        ObjectInfoIteratorPrx it = session->openObjectInfos("");
+        ObjectInfoSeq batch;
+        size_t count = 0;
+        bool done;
+        do
+        {
+            done = it->next(5, batch);
+            test(batch.size() <= 5);
+            count += batch.size();
+        }
+        while(!done);
+        it->destroy();
+        test(count == infos.size());
+
+        infos = admin->getAllObjectInfos("cat1/*");
+        test(!infos.empty());
+        it = session->openObjectInfos("cat1/*");
+        test(it->next(static_cast<int>(infos.size()) + 1, batch));
+        test(batch.size() == infos.size());
+        it->destroy();
+    }
+
     cout << "ok" << endl;
 
     //
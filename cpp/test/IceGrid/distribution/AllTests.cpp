@@ -10,6 +10,7 @@
 #include <IceUtil/Thread.h>
 #include <Ice/Ice.h>
 #include <IceGrid/IceGrid.h>
+#include <IcePatch2/FileServer.h>
 #include <TestHelper.h>
 #include <Test.h>
 
@@ -331,5 +332,205 @@ allTests(Test::TestHelper* helper)
     }
     cout << "ok" << endl;
 
+    //
+    // The nodes keep the compressed files with peer patching, block-level
+    // patching is only used otherwise.
+    //
+    if(communicator->getProperties()->getPropertyAsInt("PeerPatching") == 0)
+    {
+        cout << "testing block patching... " << flush;
+        try
+        {
+            admin->stopServer("Test.IcePatch2");
+            admin->stopServer("IcePatch2-Direct");
+
+            ApplicationUpdateDescriptor update;
+            update.name = "Test";
+            update.variables["icepatch.directory"] = "${test.dir}/data/blocks-original";
+            admin->updateApplication(update);
+            admin->startServer("Test.IcePatch2");
+
+            try
+            {
+                admin->patchServer("server-all", true);
+            }
+            catch(const PatchException& ex)
+            {
+                copy(ex.reasons.begin(), ex.reasons.end(), ostream_iterator<string>(cerr, "\n"));
+                test(false);
+            }
+
+            TestIntfPrx test = TestIntfPrx::uncheckedCast(communicator->stringToProxy("server-all"));
+            test(test->getServerFile("largefile") == "original");
+            admin->stopServer("Test.IcePatch2");
+
+            //
+            // The first block of the file was updated in place, only this
+            // block is downloaded.
+            //
+            update.variables["icepatch.directory"] = "${test.dir}/data/blocks-updated";
+            admin->updateApplication(update);
+            admin->startServer("Test.IcePatch2");
+
+            IcePatch2::FileServerPrx fileServer =
+                IcePatch2::FileServerPrx::checkedCast(communicator->stringToProxy("Test.IcePatch2/server"));
+            test(fileServer);
+
+            Ice::Int blockSize;
+            IcePatch2::ByteSeqSeq checksums = fileServer->getLargeFileBlockChecksumSeq("largefile", blockSize);
+            test(checksums.size() == 3);
+            test(blockSize == 1024 * 1024);
+
+            Ice::ByteSeq bytes = fileServer->getLargeFile("largefile", 0, 8);
+            test(string(bytes.begin(), bytes.end()) == "updated!");
+
+            //
+            // Only the files of the distribution which have valid block
+            // checksums can be read without compression.
+            //
+            const char* paths[] = { "largefile.bz2", "largefile.icepatch2blocks", "IcePatch2.sum",
+                                    "../blocks-original/largefile", "unknown" };
+            for(size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); ++i)
+            {
+                try
+                {
+                    fileServer->getLargeFile(paths[i], 0, 8);
+                    test(false);
+                }
+                catch(const IcePatch2::FileAccessException&)
+                {
+                }
+
+                try
+                {
+                    fileServer->getLargeFileBlockChecksumSeq(paths[i], blockSize);
+                    test(false);
+                }
+                catch(const IcePatch2::FileAccessException&)
+                {
+                }
+            }
+
+            try
+            {
+                admin->patchServer("server-all", true);
+            }
+            catch(const PatchException& ex)
+            {
+                copy(ex.reasons.begin(), ex.reasons.end(), ostream_iterator<string>(cerr, "\n"));
+                test(false);
+            }
+            test(test->getServerFile("largefile") == "updated!");
+            admin->stopServer("Test.IcePatch2");
+
+            //
+            // The file was updated in place after its checksums were
+            // computed, the client falls back to downloading the
+            // compressed file which matches the summary.
+            //
+            update.variables["icepatch.directory"] = "${test.dir}/data/blocks-stale";
+            admin->updateApplication(update);
+            admin->startServer("Test.IcePatch2");
+
+            test(fileServer->getLargeFileBlockChecksumSeq("largefile", blockSize).empty());
+            try
+            {
+                fileServer->getLargeFile("largefile", 0, 8);
+                test(false);
+            }
+            catch(const IcePatch2::FileAccessException&)
+            {
+            }
+
+            try
+            {
+                admin->patchServer("server-all", true);
+            }
+            catch(const PatchException& ex)
+            {
+                copy(ex.reasons.begin(), ex.reasons.end(), ostream_iterator<string>(cerr, "\n"));
+                test(false);
+            }
+            test(test->getServerFile("largefile") == "original");
+            admin->stopServer("Test.IcePatch2");
+        }
+        catch(const DeploymentException& ex)
+        {
+            cerr << ex << ":\n" << ex.reason << endl;
+            test(false);
+        }
+        cout << "ok" << endl;
+    }
+
+    if(communicator->getProperties()->getPropertyAsInt("PeerPatching") > 0)
+    {
+        cout << "testing patching from other nodes... " << flush;
+        try
+        {
+            ApplicationDescriptor app = admin->getApplicationInfo("Test").descriptor;
+            admin->removeApplication("Test");
+
+            //
+            // Nodes only serve the distribution to other nodes if they
+            // patched all its directories.
+            //
+            app.variables["icepatch.directory"] = "${test.dir}/data/original";
+            app.distrib.icepatch = "${application}.IcePatch2/server";
+            app.distrib.directories.clear();
+
+            ServerDescriptorPtr server;
+            for(ServerDescriptorSeq::const_iterator p = app.nodes["localnode"].servers.begin();
+                p != app.nodes["localnode"].servers.end(); ++p)
+            {
+                if((*p)->id == "server-all")
+                {
+                    server = ServerDescriptorPtr::dynamicCast((*p)->ice_clone());
+                }
+            }
+            test(server);
+            server->id = "server-peer";
+            server->distrib = DistributionDescriptor();
+            app.nodes["node-2"].servers.push_back(server);
+
+            admin->addApplication(app);
+            admin->startServer("Test.IcePatch2");
+
+            try
+            {
+                admin->patchApplication("Test", true);
+            }
+            catch(const PatchException& ex)
+            {
+                copy(ex.reasons.begin(), ex.reasons.end(), ostream_iterator<string>(cerr, "\n"));
+                test(false);
+            }
+
+            const char* servers[] = { "server-all", "server-peer" };
+            for(int i = 0; i < 2; ++i)
+            {
+                TestIntfPrx test = TestIntfPrx::uncheckedCast(communicator->stringToProxy(servers[i]));
+
+                test(test->getApplicationFile("rootfile") == "rootfile");
+                test(test->getApplicationFile("dir1/file1") == "dummy-file1");
+                test(test->getApplicationFile("dir1/file2") == "dummy-file2");
+                test(test->getApplicationFile("dir2/file3") == "dummy-file3");
+
+                //
+                // The compressed files are kept to serve the distribution.
+                //
+                test(test->getApplicationFile("rootfile.bz2") != "");
+                test(test->getApplicationFile("dir1/file1.bz2") != "");
+            }
+
+            admin->stopServer("Test.IcePatch2");
+        }
+        catch(const DeploymentException& ex)
+        {
+            cerr << ex << ":\n" << ex.reason << endl;
+            test(false);
+        }
+        cout << "ok" << endl;
+    }
+
     session->destroy();
 }
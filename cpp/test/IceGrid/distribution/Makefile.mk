@@ -7,6 +7,6 @@
 #
 # **********************************************************************
 
-$(test)_client_dependencies = IceGrid Glacier2
+$(test)_client_dependencies = IceGrid Glacier2 IcePatch2
 
 tests += $(test)
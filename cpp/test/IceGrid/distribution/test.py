@@ -40,7 +40,81 @@ class IceGridDistributionTestCase(IceGridTestCase):
         IcePatch2Calc(args=[os.path.join(datadir, "original")]).run(current)
         IcePatch2Calc(args=[os.path.join(datadir, "updated")]).run(current)
 
+        #
+        # Large files of 3 blocks for block-level patching. The first block
+        # of the file is updated in place in the "blocks-updated" directory.
+        # The file of the "blocks-stale" directory is updated in place after
+        # computing the checksums: its block checksums are out of date.
+        #
+        padding = ("x" * 1023 + "\n") * 2500
+        for [dir, content] in [["blocks-original", "original"], ["blocks-updated", "updated!"],
+                               ["blocks-stale", "original"]]:
+            file = os.path.join(datadir, dir, "largefile")
+            if not os.path.exists(os.path.dirname(file)):
+                os.makedirs(os.path.dirname(file))
+            f = open(file, 'w')
+            f.write(content + "\n" + padding)
+            f.close()
+            IcePatch2Calc(args=[os.path.join(datadir, dir)]).run(current)
+
+        f = open(os.path.join(datadir, "blocks-stale", "largefile"), 'r+')
+        f.write("modified")
+        f.close()
+
+        current.writeln("ok")
+
+        current.write("testing icepatch2calc with threads and incremental runs... ")
+
+        calcdir = os.path.join(datadir, "calc")
+        for i in range(0, 20):
+            file = os.path.join(calcdir, "dir%d" % (i % 4), "file%d" % i)
+            if not os.path.exists(os.path.dirname(file)):
+                os.makedirs(os.path.dirname(file))
+            f = open(file, 'w')
+            f.write("file%d" % i * (i * 100 + 1))
+            f.close()
+
+        def calc(args=[]):
+            IcePatch2Calc(args=args + [calcdir]).run(current)
+            f = open(os.path.join(calcdir, "IcePatch2.sum"), 'r')
+            summary = f.read()
+            f.close()
+            return summary
+
+        #
+        # The summary doesn't depend on the number of threads and the
+        # incremental run only computes the checksum of the modified file.
+        #
+        full = calc(["-Z"])
+        if calc(["-Z", "--threads", "4"]) != full:
+            raise RuntimeError("failed! (summary computed with 4 threads differs)")
+
+        f = open(os.path.join(calcdir, "dir1", "file5"), 'w')
+        f.write("updated")
+        f.close()
+
+        incremental = calc(["-Z", "--threads", "4", "--incremental"])
+        if incremental == full:
+            raise RuntimeError("failed! (modified file not detected by incremental run)")
+        if calc(["-Z"]) != incremental:
+            raise RuntimeError("failed! (incremental summary differs from full summary)")
+        if calc(["--threads", "4"]) != calc():
+            raise RuntimeError("failed! (summary of compressed files computed with 4 threads differs)")
+
         current.writeln("ok")
 
+#
+# The peer patching test case uses two nodes, the second node is patched from
+# the first node by the registry (see IceGrid.Registry.PatchFanOut).
+#
+nodeProps = { "IceGrid.Node.PeerPatching" : 1 }
+
 if isinstance(platform, Windows) or os.getuid() != 0:
-    TestSuite(__file__, [ IceGridDistributionTestCase() ], runOnMainThread=True, multihost=False)
+    TestSuite(__file__, [
+        IceGridDistributionTestCase(),
+        IceGridDistributionTestCase("with peer patching",
+                                    icegridregistry=[IceGridRegistryMaster(props={ "IceGrid.Registry.PatchFanOut" : 1 }),
+                                                     IceGridRegistrySlave(1)],
+                                    icegridnode=[IceGridNode(props=nodeProps), IceGridNode("node-2", props=nodeProps)],
+                                    client=IceGridClient(props={ "PeerPatching" : 1 })),
+    ], runOnMainThread=True, multihost=False)
@@ -1138,3 +1138,89 @@ allTests(Test::TestHelper* helper)
 
     session->destroy();
 }
+
+void
+allTestsLatency(Test::TestHelper* helper)
+{
+    Ice::CommunicatorPtr comm = helper->communicator();
+    IceGrid::RegistryPrx registry = IceGrid::RegistryPrx::checkedCast(
+        comm->stringToProxy(comm->getDefaultLocator()->ice_getIdentity().category + "/Registry"));
+    test(registry);
+    AdminSessionPrx session = registry->createAdminSession("foo", "bar");
+
+    session->ice_getConnection()->setACM(registry->getACMTimeout(),
+                                         IceUtil::None,
+                                         Ice::ICE_ENUM(ACMHeartbeat, HeartbeatAlways));
+
+    AdminPrx admin = session->getAdmin();
+    test(admin);
+
+    cout << "testing replication with latency load balancing... " << flush;
+    {
+        map<string, string> params;
+        params["replicaGroup"] = "Latency";
+        params["id"] = "Server1";
+        params["delay"] = "100"; // Server1 is the slow replica
+        instantiateServer(admin, "Server", "localnode", params);
+        params["id"] = "Server2";
+        params["delay"] = "0";
+        instantiateServer(admin, "Server", "localnode", params);
+        TestIntfPrx obj = TestIntfPrx::uncheckedCast(comm->stringToProxy("Latency"));
+        obj = TestIntfPrx::uncheckedCast(obj->ice_locatorCacheTimeout(0));
+        obj = TestIntfPrx::uncheckedCast(obj->ice_connectionCached(false));
+
+        //
+        // Until the node reports the dispatch loads, both replicas are
+        // idle and returned in random order.
+        //
+        set<string> replicaIds;
+        replicaIds.insert("Server1.ReplicatedAdapter");
+        replicaIds.insert("Server2.ReplicatedAdapter");
+        while(!replicaIds.empty())
+        {
+            try
+            {
+                replicaIds.erase(obj->getReplicaId());
+            }
+            catch(const Ice::LocalException& ex)
+            {
+                cerr << ex << endl;
+                test(false);
+            }
+        }
+
+        //
+        // Each replica dispatched at least one request. Wait for the node
+        // to report the dispatch loads (IceGrid.Node.DispatchMetricsPeriod
+        // is set to 1s): the first update fetches the metrics, the second
+        // sends the loads to the registry.
+        //
+        IceUtil::ThreadControl::sleep(IceUtil::Time::seconds(3));
+
+        //
+        // With two replicas, the dispatch loads of both replicas are
+        // compared for each lookup and the least loaded replica is
+        // always returned first. The slow replica keeps its latency
+        // while it doesn't dispatch requests so all the requests go to
+        // the fast replica.
+        //
+        const int nRequests = 30;
+        for(int i = 0; i < nRequests; ++i)
+        {
+            try
+            {
+                test(obj->getReplicaId() == "Server2.ReplicatedAdapter");
+            }
+            catch(const Ice::LocalException& ex)
+            {
+                cerr << ex << endl;
+                test(false);
+            }
+        }
+        removeServer(admin, "Server1");
+        removeServer(admin, "Server2");
+    }
+    cout << "ok" << endl;
+
+    session->destroy();
+}
@@ -24,8 +24,27 @@ void
 Client::run(int argc, char** argv)
 {
     Ice::CommunicatorHolder communicator = initialize(argc, argv);
-    void allTests(Test::TestHelper*);
-    allTests(this);
+
+    bool latency = false;
+    for(int i = 1; i < argc; ++i)
+    {
+        if(strcmp(argv[i], "--latency") == 0)
+        {
+            latency = true;
+            break;
+        }
+    }
+
+    if(!latency)
+    {
+        void allTests(Test::TestHelper*);
+        allTests(this);
+    }
+    else
+    {
+        void allTestsLatency(Test::TestHelper*);
+        allTestsLatency(this);
+    }
 }
 
 DEFINE_TEST(Client)
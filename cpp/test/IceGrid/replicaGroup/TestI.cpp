@@ -8,6 +8,7 @@
 // **********************************************************************
 
 #include <Ice/Ice.h>
+#include <IceUtil/Thread.h>
 #include <TestI.h>
 
 TestI::TestI(const Ice::PropertiesPtr& properties) :
@@ -18,6 +19,11 @@ TestI::TestI(const Ice::PropertiesPtr& properties) :
 std::string
 TestI::getReplicaId(const Ice::Current& current)
 {
+    int delay = _properties->getPropertyAsInt("Delay");
+    if(delay > 0)
+    {
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(delay));
+    }
     return _properties->getProperty(current.adapter->getName() + ".AdapterId");
 }
 
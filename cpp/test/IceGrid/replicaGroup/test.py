@@ -13,6 +13,14 @@ registryProps = {
     "IceGrid.Registry.DynamicRegistration" : 1
 }
 
+#
+# For the latency load balancing test, the node reports the dispatch
+# loads used by the latency load balancing policy every second.
+#
+latencyNodeProps = {
+    "IceGrid.Node.DispatchMetricsPeriod" : 1
+}
+
 clientProps = {
     "Ice.RetryIntervals" : "0 50 100 250"
 }
@@ -20,6 +28,10 @@ clientProps = {
 if isinstance(platform, Windows) or os.getuid() != 0:
     TestSuite(__file__,
               [IceGridTestCase(icegridregistry=[IceGridRegistryMaster(props=registryProps)],
-                               client=IceGridClient(props=clientProps))],
+                               client=IceGridClient(props=clientProps)),
+               IceGridTestCase("with latency load balancing",
+                               icegridregistry=[IceGridRegistryMaster(props=registryProps)],
+                               icegridnode=IceGridNode(props=latencyNodeProps),
+                               client=IceGridClient(props=clientProps, args=["--latency"]))],
               libDirs=["registryplugin", "testservice"],
               multihost=False)
@@ -15,6 +15,8 @@
 #include <TestHelper.h>
 #include <Test.h>
 
+#include <fstream>
+
 using namespace std;
 using namespace Test;
 using namespace IceGrid;
@@ -225,6 +227,70 @@ waitAndPing(const Ice::ObjectPrx& obj)
     return false;
 }
 
+ApplicationDescriptor
+createTestApplication(const Ice::CommunicatorPtr& comm, const string& name, const string& serverId)
+{
+    ApplicationDescriptor app;
+    app.name = name;
+    app.description = "added application";
+
+    ServerDescriptorPtr server = new ServerDescriptor();
+    server->id = serverId;
+    server->exe = comm->getProperties()->getProperty("ServerDir") + "/server";
+    server->pwd = ".";
+    server->applicationDistrib = false;
+    server->allocatable = false;
+    addProperty(server, "Ice.Admin.Endpoints", "tcp -h 127.0.0.1");
+    server->activation = "on-demand";
+    AdapterDescriptor adapter;
+    adapter.name = "TestAdapter";
+    adapter.id = "TestAdapter." + serverId;
+    adapter.serverLifetime = true;
+    adapter.registerProcess = false;
+    addProperty(server, "TestAdapter.Endpoints", "default");
+    addProperty(server, "Identity", "test-" + serverId);
+    ObjectDescriptor object;
+    object.id = Ice::stringToIdentity("test-" + serverId);
+    object.type = "::Test::TestIntf";
+    adapter.objects.push_back(object);
+    server->adapters.push_back(adapter);
+    app.nodes["Node1"].servers.push_back(server);
+    return app;
+}
+
+int
+countTraces(const string& logFile, const string& trace)
+{
+    ifstream is(logFile.c_str());
+    int count = 0;
+    string line;
+    while(getline(is, line))
+    {
+        if(line.find(trace) != string::npos)
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool
+waitForTraces(const string& logFile, const string& trace, int count)
+{
+    int nRetry = 0;
+    while(nRetry < maxRetry)
+    {
+        if(countTraces(logFile, trace) >= count)
+        {
+            return true;
+        }
+
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(sleepTime));
+        ++nRetry;
+    }
+    return false;
+}
+
 AdminPrx
 createAdminSession(const Ice::LocatorPrx& locator, const string& replica)
 {
@@ -1301,6 +1367,135 @@ allTests(Test::TestHelper* helper)
     }
     cout << "ok" << endl;
 
+    cout << "testing registry and node resynchronization... " << flush;
+    {
+        const string masterLog = comm->getProperties()->getProperty("TestDir") + "/logs/Master.log";
+        const string slave1Log = comm->getProperties()->getProperty("TestDir") + "/logs/Slave1.log";
+
+        //
+        // Restart the Master and Slave1 with the node and application
+        // traces enabled.
+        //
+        masterAdmin->shutdown();
+        waitForServerState(admin, "Master", false);
+        slave1Admin->shutdown();
+        waitForServerState(admin, "Slave1", false);
+
+        params.clear();
+        params["id"] = "Master";
+        params["replicaName"] = "";
+        params["port"] = "12050";
+        params["logFile"] = masterLog;
+        params["trace"] = "1";
+        instantiateServer(admin, "IceGridRegistry", params);
+
+        params.clear();
+        params["id"] = "Slave1";
+        params["replicaName"] = "Slave1";
+        params["port"] = "12051";
+        params["logFile"] = slave1Log;
+        params["trace"] = "1";
+        instantiateServer(admin, "IceGridRegistry", params);
+
+        admin->startServer("Master");
+        masterAdmin = createAdminSession(masterLocator, "");
+        admin->startServer("Slave1");
+        slave1Admin = createAdminSession(slave1Locator, "Slave1");
+
+        waitForReplicaState(masterAdmin, "Slave1", true);
+        waitForReplicaState(masterAdmin, "Slave2", true);
+        waitForNodeState(masterAdmin, "Node1", true);
+
+        masterAdmin->addApplication(createTestApplication(comm, "TestApp", "Server"));
+        masterAdmin->addApplication(createTestApplication(comm, "TestApp2", "Server2"));
+        masterAdmin->startServer("Server");
+        masterAdmin->startServer("Server2");
+        int pid = masterAdmin->getServerPid("Server");
+
+        //
+        // The Master restarts while the node servers are unchanged, the
+        // node servers are up to date and aren't re-loaded. The Master
+        // database is unchanged so Slave1 doesn't synchronize its
+        // database either.
+        //
+        const string skippedTrace = "applications already synchronized";
+        const string syncTrace = "synchronized applications";
+        int skipped = countTraces(slave1Log, skippedTrace);
+        string trace = "loaded 0 server(s) on node `Node1', 2 server(s) already up to date";
+        int count = countTraces(masterLog, trace);
+        masterAdmin->shutdown();
+        waitForServerState(admin, "Master", false);
+        admin->startServer("Master");
+        masterAdmin = createAdminSession(masterLocator, "");
+        test(waitForTraces(masterLog, trace, count + 1));
+        test(masterAdmin->getServerState("Server") == Active);
+        test(masterAdmin->getServerState("Server2") == Active);
+        test(masterAdmin->getServerPid("Server") == pid);
+        test(waitForTraces(slave1Log, skippedTrace, skipped + 1));
+
+        //
+        // Slave1 restarts with the Master database serial and
+        // generation, the applications aren't synchronized again.
+        //
+        slave1Admin->shutdown();
+        waitForServerState(admin, "Slave1", false);
+        admin->startServer("Slave1");
+        slave1Admin = createAdminSession(slave1Locator, "Slave1");
+        test(waitForTraces(slave1Log, skippedTrace, skipped + 2));
+
+        //
+        // Remove TestApp2 while Slave2 is down and restart the Master
+        // from the Slave2 database. The Master database now has a
+        // server which isn't loaded on the node, only this server is
+        // loaded when the node session is re-established.
+        //
+        slave2Admin->shutdown();
+        waitForServerState(admin, "Slave2", false);
+        masterAdmin->removeApplication("TestApp2");
+        masterAdmin->shutdown();
+        waitForServerState(admin, "Master", false);
+
+        admin->startServer("Slave2");
+        slave2Admin = createAdminSession(slave2Locator, "Slave2");
+
+        params.clear();
+        params["id"] = "Master";
+        params["replicaName"] = "";
+        params["port"] = "12050";
+        params["logFile"] = masterLog;
+        params["trace"] = "1";
+        params["arg"] = "--initdb-from-replica=Slave2";
+        instantiateServer(admin, "IceGridRegistry", params);
+
+        trace = "loaded 1 server(s) on node `Node1', 1 server(s) already up to date";
+        count = countTraces(masterLog, trace);
+        int synced = countTraces(slave1Log, syncTrace);
+        admin->startServer("Master");
+        masterAdmin = createAdminSession(masterLocator, "");
+        test(waitForTraces(masterLog, trace, count + 1));
+        test(masterAdmin->getServerState("Server") == Active);
+        test(masterAdmin->getServerPid("Server") == pid);
+        comm->stringToProxy("test-Server2")->ice_locator(masterLocator)->ice_locatorCacheTimeout(0)->ice_ping();
+        test(waitForTraces(slave1Log, syncTrace, synced + 1));
+
+        //
+        // Restart the Master from the Slave2 database again. The Master
+        // database gets a new generation with the same serial as the
+        // Slave1 database, Slave1 must synchronize its database.
+        //
+        waitForReplicaState(masterAdmin, "Slave2", true);
+        masterAdmin->shutdown();
+        waitForServerState(admin, "Master", false);
+        admin->startServer("Master");
+        masterAdmin = createAdminSession(masterLocator, "");
+        test(waitForTraces(slave1Log, syncTrace, synced + 2));
+        test(countTraces(slave1Log, skippedTrace) == skipped + 2);
+
+        masterAdmin->removeApplication("TestApp");
+        masterAdmin->removeApplication("TestApp2");
+    }
+    cout << "ok" << endl;
+
     cout << "testing interop with registry and node using the 1.0 encoding... " << flush;
     {
         params.clear();
@@ -8,7 +8,17 @@
 #
 # **********************************************************************
 
-clientProps = lambda process, current: { "ServerDir" : current.getBuildDir("server") }
+class IceGridReplicationTestCase(IceGridTestCase):
+
+    def setupClientSide(self, current):
+        IceGridTestCase.setupClientSide(self, current)
+        current.mkdirs("logs")
+
+clientProps = lambda process, current: {
+    "ServerDir" : current.getBuildDir("server"),
+    "TestDir" : "{testdir}"
+}
 
 if isinstance(platform, Windows) or os.getuid() != 0:
-    TestSuite(__file__, [ IceGridTestCase(client=IceGridClient(props=clientProps)) ], runOnMainThread=True, multihost=False)
+    TestSuite(__file__, [ IceGridReplicationTestCase(client=IceGridClient(props=clientProps)) ], runOnMainThread=True,
+              multihost=False)
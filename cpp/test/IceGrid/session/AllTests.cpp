@@ -82,6 +82,13 @@ public:
         --_updated;
     }
 
+    int
+    getUpdateCount()
+    {
+        Lock sync(*this);
+        return _updated;
+    }
+
 protected:
 
     void
@@ -252,6 +259,7 @@ public:
     {
         Lock sync(*this);
         this->objects.insert(make_pair(info.proxy->ice_getIdentity(), info));
+        this->added.push_back(info.proxy->ice_getIdentity());
         updated(updateSerial(0, "object added `" + info.proxy->ice_toString() + "'"));
     }
 
@@ -274,6 +282,7 @@ public:
 
     int serial;
     map<Ice::Identity, ObjectInfo> objects;
+    vector<Ice::Identity> added; // The identities of the added objects, in the order of the updates.
 
 private:
 
@@ -288,6 +297,52 @@ private:
 };
 typedef IceUtil::Handle<ObjectObserverI> ObjectObserverIPtr;
 
+//
+// Adds objects with the given prefix, one after the other, to check
+// the updates committed concurrently by several admin sessions.
+//
+class AddObjectsThread : public IceUtil::Thread
+{
+public:
+
+    AddObjectsThread(const AdminPrx& admin, const string& prefix, int count) :
+        _admin(admin), _prefix(prefix), _count(count), _failed(false)
+    {
+    }
+
+    virtual void run()
+    {
+        try
+        {
+            Ice::CommunicatorPtr communicator = _admin->ice_getCommunicator();
+            for(int i = 0; i < _count; ++i)
+            {
+                ostringstream os;
+                os << _prefix << "-" << i << ":tcp -p 10000";
+                _admin->addObjectWithType(communicator->stringToProxy(os.str()), "::Dummy");
+            }
+        }
+        catch(const Ice::Exception& ex)
+        {
+            cerr << ex << endl;
+            _failed = true;
+        }
+    }
+
+    bool failed() const
+    {
+        return _failed;
+    }
+
+private:
+
+    const AdminPrx _admin;
+    const string _prefix;
+    const int _count;
+    bool _failed;
+};
+typedef IceUtil::Handle<AddObjectsThread> AddObjectsThreadPtr;
+
 class NodeObserverI : public NodeObserver, public ObserverBase
 {
 public:
@@ -526,6 +581,8 @@ allTests(Test::TestHelper* helper)
     cout << "ok" << endl;
 
     Ice::PropertiesPtr properties = communicator->getProperties();
+    const int coalescePeriod = properties->getPropertyAsInt("NodeObserverCoalescePeriod");
+    const bool groupCommit = properties->getPropertyAsInt("GroupCommit") > 0;
 
     IceGrid::RegistryPrx registry1 = IceGrid::RegistryPrx::uncheckedCast(registry->ice_connectionId("reg1"));
     IceGrid::RegistryPrx registry2 = IceGrid::RegistryPrx::uncheckedCast(registry->ice_connectionId("reg2"));
@@ -1670,6 +1727,104 @@ allTests(Test::TestHelper* helper)
         cout << "ok" << endl;
     }
 
+    if(groupCommit)
+    {
+        cout << "testing concurrent updates with group commit... " << flush;
+
+        AdminSessionPrx session1 = AdminSessionPrx::uncheckedCast(registry->createAdminSession("admin1", "test1"));
+        session1->ice_getConnection()->setACM(registry->getACMTimeout(), IceUtil::None, Ice::HeartbeatOnIdle);
+
+        Ice::ObjectAdapterPtr adpt1 = communicator->createObjectAdapter("");
+        ObjectObserverIPtr objectObs1 = new ObjectObserverI("objectObs1.1");
+        Ice::ObjectPrx object1 = adpt1->addWithUUID(objectObs1);
+        adpt1->activate();
+        registry->ice_getConnection()->setAdapter(adpt1);
+        session1->setObserversByIdentity(Ice::Identity(),
+                                         Ice::Identity(),
+                                         Ice::Identity(),
+                                         Ice::Identity(),
+                                         object1->ice_getIdentity());
+
+        objectObs1->waitForUpdate(__FILE__, __LINE__); // init
+
+        //
+        // Each thread adds its objects with its own admin session, so
+        // the registry commits the updates of the threads concurrently.
+        //
+        const int threadCount = 5;
+        const int objectCount = 20;
+        vector<AdminSessionPrx> sessions;
+        vector<AddObjectsThreadPtr> threads;
+        for(int i = 0; i < threadCount; ++i)
+        {
+            ostringstream os;
+            os << "groupcommit" << i;
+            IceGrid::RegistryPrx r = IceGrid::RegistryPrx::uncheckedCast(registry->ice_connectionId(os.str()));
+            AdminSessionPrx s = AdminSessionPrx::uncheckedCast(
+                r->createAdminSession("admin1", "test1")->ice_connectionId(os.str()));
+            s->ice_getConnection()->setACM(registry->getACMTimeout(), IceUtil::None, Ice::HeartbeatOnIdle);
+            sessions.push_back(s);
+            AdminPrx a = AdminPrx::uncheckedCast(s->getAdmin()->ice_connectionId(os.str()));
+            threads.push_back(new AddObjectsThread(a, os.str(), objectCount));
+        }
+        for(vector<AddObjectsThreadPtr>::const_iterator p = threads.begin(); p != threads.end(); ++p)
+        {
+            (*p)->start();
+        }
+        for(vector<AddObjectsThreadPtr>::const_iterator p = threads.begin(); p != threads.end(); ++p)
+        {
+            (*p)->getThreadControl().join();
+            test(!(*p)->failed());
+        }
+
+        //
+        // All the updates are committed and each update is published
+        // once. The objects of a thread are published in the order of
+        // their commit, which is the order in which the thread added
+        // them.
+        //
+        for(int i = 0; i < threadCount * objectCount; ++i)
+        {
+            objectObs1->waitForUpdate(__FILE__, __LINE__);
+        }
+        test(objectObs1->added.size() == static_cast<size_t>(threadCount * objectCount));
+        for(int i = 0; i < threadCount; ++i)
+        {
+            ostringstream prefix;
+            prefix << "groupcommit" << i << "-";
+            int next = 0;
+            for(vector<Ice::Identity>::const_iterator p = objectObs1->added.begin(); p != objectObs1->added.end(); ++p)
+            {
+                if(p->name.find(prefix.str()) == 0)
+                {
+                    ostringstream os;
+                    os << prefix.str() << next++;
+                    test(p->name == os.str());
+                }
+            }
+            test(next == objectCount);
+
+            for(int j = 0; j < objectCount; ++j)
+            {
+                ostringstream os;
+                os << prefix.str() << j;
+                test(admin->getObjectInfo(Ice::stringToIdentity(os.str())).type == "::Dummy");
+                admin->removeObject(Ice::stringToIdentity(os.str()));
+                objectObs1->waitForUpdate(__FILE__, __LINE__);
+            }
+        }
+        test(objectObs1->objects.empty());
+
+        for(vector<AdminSessionPrx>::const_iterator p = sessions.begin(); p != sessions.end(); ++p)
+        {
+            (*p)->destroy();
+        }
+        session1->destroy();
+        adpt1->destroy();
+
+        cout << "ok" << endl;
+    }
+
     {
 //      cout << "???" << endl;
 
@@ -1776,6 +1931,7 @@ allTests(Test::TestHelper* helper)
 //      cout << "ok" << endl;
     }
 
+    if(coalescePeriod <= 0) // The node observer updates are checked one by one.
     {
         cout << "testing node observer... " << flush;
         AdminSessionPrx session1 = registry->createAdminSession("admin1", "test1");
@@ -1925,6 +2081,104 @@ allTests(Test::TestHelper* helper)
         cout << "ok" << endl;
     }
 
+    if(coalescePeriod > 0)
+    {
+        cout << "testing coalesced node observer updates... " << flush;
+        AdminSessionPrx session1 = registry->createAdminSession("admin1", "test1");
+
+        session1->ice_getConnection()->setACM(registry->getACMTimeout(), IceUtil::None, Ice::HeartbeatOnIdle);
+
+        Ice::ObjectAdapterPtr adpt1 = communicator->createObjectAdapter("");
+        ApplicationObserverIPtr appObs1 = new ApplicationObserverI("appObs1.4");
+        Ice::ObjectPrx app1 = adpt1->addWithUUID(appObs1);
+        NodeObserverIPtr nodeObs1 = new NodeObserverI("nodeObs1");
+        Ice::ObjectPrx no1 = adpt1->addWithUUID(nodeObs1);
+        adpt1->activate();
+        registry->ice_getConnection()->setAdapter(adpt1);
+        session1->setObserversByIdentity(Ice::Identity(),
+                                         no1->ice_getIdentity(),
+                                         app1->ice_getIdentity(),
+                                         Ice::Identity(),
+                                         Ice::Identity());
+
+        appObs1->waitForUpdate(__FILE__, __LINE__);
+        nodeObs1->waitForUpdate(__FILE__, __LINE__); // init
+        test(nodeObs1->nodes.find("localnode") != nodeObs1->nodes.end());
+
+        ApplicationDescriptor testApp;
+        testApp.name = "TestApp";
+        ServerDescriptorPtr server = new ServerDescriptor();
+        server->id = "Server";
+        server->exe = properties->getProperty("ServerDir") + "/server";
+        server->pwd = properties->getProperty("TestDir");
+        server->applicationDistrib = false;
+        server->allocatable = false;
+        AdapterDescriptor adapter;
+        adapter.name = "Server";
+        adapter.id = "ServerAdapter";
+        adapter.registerProcess = false;
+        adapter.serverLifetime = true;
+        server->adapters.push_back(adapter);
+        addProperty(server, "Server.Endpoints", "default");
+        addProperty(server, "Ice.Admin.Endpoints", "tcp -h 127.0.0.1");
+        NodeDescriptor node;
+        node.servers.push_back(server);
+        testApp.nodes["localnode"] = node;
+
+        session->startUpdate();
+        admin->addApplication(testApp);
+        session->finishUpdate();
+        appObs1->waitForUpdate(__FILE__, __LINE__);
+
+        //
+        // The intermediate states of the server might not be published,
+        // wait for the last state.
+        //
+        admin->startServer("Server");
+        do
+        {
+            nodeObs1->waitForUpdate(__FILE__, __LINE__);
+        }
+        while(nodeObs1->nodes["localnode"].servers.empty() ||
+              nodeObs1->nodes["localnode"].servers[0].state != Active ||
+              nodeObs1->nodes["localnode"].adapters.empty());
+        test(nodeObs1->nodes["localnode"].servers.size() == 1);
+        test(nodeObs1->nodes["localnode"].adapters[0].proxy);
+
+        //
+        // Updates received within the coalesce period are published
+        // once with the last state of the server.
+        //
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(2 * coalescePeriod));
+        int updateCount = nodeObs1->getUpdateCount();
+        admin->enableServer("Server", false);
+        admin->enableServer("Server", true);
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(2 * coalescePeriod));
+        test(nodeObs1->getUpdateCount() == updateCount + 1);
+        test(nodeObs1->nodes["localnode"].servers[0].enabled);
+
+        admin->stopServer("Server");
+        do
+        {
+            nodeObs1->waitForUpdate(__FILE__, __LINE__);
+        }
+        while(nodeObs1->nodes["localnode"].servers[0].state != Inactive ||
+              !nodeObs1->nodes["localnode"].adapters.empty());
+
+        session->startUpdate();
+        admin->removeApplication("TestApp");
+        session->finishUpdate();
+        do
+        {
+            nodeObs1->waitForUpdate(__FILE__, __LINE__);
+        }
+        while(!nodeObs1->nodes["localnode"].servers.empty());
+
+        appObs1->waitForUpdate(__FILE__, __LINE__);
+
+        cout << "ok" << endl;
+    }
+
     {
         cout << "testing registry observer... " << flush;
         AdminSessionPrx session1 = registry->createAdminSession("admin1", "test1");
@@ -50,12 +50,38 @@ clientProps10 = lambda process, current: {
     "Ice.Default.EncodingVersion" : "1.0"
 }
 
+clientPropsCoalesce = lambda process, current: {
+    "IceGridNodeExe" : IceGridNode().getCommandLine(current),
+    "ServerDir" : current.getBuildDir("server"),
+    "TestDir" : "{testdir}",
+    "NodeObserverCoalescePeriod" : 1000
+}
+
+clientPropsGroupCommit = lambda process, current: {
+    "IceGridNodeExe" : IceGridNode().getCommandLine(current),
+    "ServerDir" : current.getBuildDir("server"),
+    "TestDir" : "{testdir}",
+    "GroupCommit" : 1
+}
+
 icegridregistry = [IceGridRegistryMaster(props=registryProps)]
 
+registryPropsCoalesce = registryProps.copy()
+registryPropsCoalesce["IceGrid.Registry.NodeObserverCoalescePeriod"] = 1000
+
+registryPropsGroupCommit = registryProps.copy()
+registryPropsGroupCommit["IceGrid.Registry.LMDB.GroupCommit"] = 1
+
 if isinstance(platform, Windows) or os.getuid() != 0:
     TestSuite(__file__,
           [ IceGridSessionTestCase("with default encoding", icegridregistry=icegridregistry,
                                    client=IceGridClient(props=clientProps)),
             IceGridSessionTestCase("with 1.0 encoding", icegridregistry=icegridregistry,
-                                   client=IceGridClient(props=clientProps10))],
+                                   client=IceGridClient(props=clientProps10)),
+            IceGridSessionTestCase("with coalesced node observer updates",
+                                   icegridregistry=[IceGridRegistryMaster(props=registryPropsCoalesce)],
+                                   client=IceGridClient(props=clientPropsCoalesce)),
+            IceGridSessionTestCase("with group commit",
+                                   icegridregistry=[IceGridRegistryMaster(props=registryPropsGroupCommit)],
+                                   client=IceGridClient(props=clientPropsGroupCommit))],
             runOnMainThread=True, multihost=False)
@@ -16,6 +16,80 @@
 using namespace std;
 using namespace Test;
 
+namespace
+{
+
+//
+// Keeps the locator traces to check which lookups are sent to the
+// locator.
+//
+class TraceLoggerI : public Ice::Logger, private IceUtil::Mutex
+#ifdef ICE_CPP11_MAPPING
+                   , public std::enable_shared_from_this<TraceLoggerI>
+#endif
+{
+public:
+
+    virtual void
+    print(const string&)
+    {
+    }
+
+    virtual void
+    trace(const string& category, const string& message)
+    {
+        Lock sync(*this);
+        if(category == "Locator")
+        {
+            _traces.push_back(message);
+        }
+    }
+
+    virtual void
+    warning(const string&)
+    {
+    }
+
+    virtual void
+    error(const string&)
+    {
+    }
+
+    virtual string
+    getPrefix()
+    {
+        return "";
+    }
+
+    virtual Ice::LoggerPtr
+    cloneWithPrefix(const string&)
+    {
+        return ICE_SHARED_FROM_THIS;
+    }
+
+    int
+    count(const string& message)
+    {
+        Lock sync(*this);
+        int n = 0;
+        for(vector<string>::const_iterator p = _traces.begin(); p != _traces.end(); ++p)
+        {
+            if(p->find(message) != string::npos)
+            {
+                ++n;
+            }
+        }
+        return n;
+    }
+
+private:
+
+    vector<string> _traces;
+};
+ICE_DEFINE_PTR(TraceLoggerIPtr, TraceLoggerI);
+
+}
+
 void
 allTests(Test::TestHelper* helper)
 {
@@ -286,6 +360,77 @@ allTestsWithDeploy(Test::TestHelper* helper)
     }
     cout << "ok" << endl;
 
+    cout << "testing bulk adapter resolution... " << flush;
+    {
+        IceGrid::LocatorPrxPtr locator = ICE_CHECKED_CAST(IceGrid::LocatorPrx, communicator->getDefaultLocator());
+        test(locator);
+
+        Ice::StringSeq ids;
+        ids.push_back("TestAdapter");
+        ids.push_back("TestAdapterUnknown");
+        ids.push_back("TestAdapter10");
+        Ice::ObjectProxySeq proxies = locator->findAdaptersById(ids);
+        test(proxies.size() == 3);
+        test(proxies[0] && !proxies[0]->ice_getEndpoints().empty());
+        test(!proxies[1]);
+        test(proxies[2] && !proxies[2]->ice_getEndpoints().empty());
+        test(locator->findAdaptersById(Ice::StringSeq()).empty());
+
+        //
+        // Resolve the adapters with a communicator which batches the
+        // adapter lookups made within 500ms, the unknown adapter is still
+        // reported with NotRegisteredException.
+        //
+        TraceLoggerIPtr logger = ICE_MAKE_SHARED(TraceLoggerI);
+        Ice::InitializationData initData;
+        initData.properties = communicator->getProperties()->clone();
+        initData.properties->setProperty("Ice.LocatorBatchRequests", "500");
+        initData.properties->setProperty("Ice.Trace.Locator", "1");
+        initData.logger = logger;
+        Ice::CommunicatorHolder ich = Ice::initialize(initData);
+        TestIntfPrxPtr p1 = ICE_UNCHECKED_CAST(TestIntfPrx, ich->stringToProxy("test @ TestAdapter"));
+        Ice::ObjectPrxPtr p2 = ich->stringToProxy("test @ TestAdapterUnknown");
+        Ice::ObjectPrxPtr p3 = ich->stringToProxy("test10 @ TestAdapter10")->ice_encodingVersion(Ice::Encoding_1_0);
+#ifdef ICE_CPP11_MAPPING
+        auto r1 = p1->ice_pingAsync();
+        auto r2 = p2->ice_pingAsync();
+        auto r3 = p3->ice_pingAsync();
+        r1.get();
+        try
+        {
+            r2.get();
+            test(false);
+        }
+        catch(const Ice::NotRegisteredException& ex)
+        {
+            test(ex.id == "TestAdapterUnknown");
+        }
+        r3.get();
+#else
+        Ice::AsyncResultPtr r1 = p1->begin_ice_ping();
+        Ice::AsyncResultPtr r2 = p2->begin_ice_ping();
+        Ice::AsyncResultPtr r3 = p3->begin_ice_ping();
+        p1->end_ice_ping(r1);
+        try
+        {
+            p2->end_ice_ping(r2);
+            test(false);
+        }
+        catch(const Ice::NotRegisteredException& ex)
+        {
+            test(ex.id == "TestAdapterUnknown");
+        }
+        p3->end_ice_ping(r3);
+#endif
+
+        //
+        // The three lookups are sent with a single findAdaptersById call.
+        //
+        test(logger->count("searching for adapters by id with a single request") == 1);
+        test(logger->count("adapters = TestAdapter, TestAdapterUnknown, TestAdapter10") == 1);
+    }
+    cout << "ok" << endl;
+
     IceGrid::RegistryPrxPtr registry = ICE_CHECKED_CAST(IceGrid::RegistryPrx,
         communicator->stringToProxy(communicator->getDefaultLocator()->ice_getIdentity().category + "/Registry"));
     test(registry);
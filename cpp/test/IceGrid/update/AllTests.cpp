@@ -718,6 +718,97 @@ allTests(Test::TestHelper* helper)
         cout << "ok" << endl;
     }
 
+    {
+        cout << "testing update of nodes not included in the update... " << flush;
+
+        ServerDescriptorPtr server = new ServerDescriptor();
+        server->id = "${name}";
+        server->exe = "server";
+        server->pwd = ".";
+        server->applicationDistrib = false;
+        server->allocatable = false;
+        addProperty(server, "TemplateProperty", "1");
+        addProperty(server, "ApplicationProperty", "${appvar}");
+        TemplateDescriptor templ;
+        templ.parameters.push_back("name");
+        templ.descriptor = server;
+
+        ApplicationDescriptor testApp;
+        testApp.name = "TestApp";
+        testApp.variables["appvar"] = "1";
+        testApp.serverTemplates["ServerTemplate"] = templ;
+
+        ServerInstanceDescriptor instance;
+        instance._cpp_template = "ServerTemplate";
+        instance.parameterValues["name"] = "Server1";
+        testApp.nodes["node1"].serverInstances.push_back(instance);
+        instance.parameterValues["name"] = "Server2";
+        testApp.nodes["node2"].serverInstances.push_back(instance);
+
+        server = new ServerDescriptor();
+        server->id = "Server3";
+        server->exe = "server";
+        server->pwd = ".";
+        server->applicationDistrib = false;
+        server->allocatable = false;
+        addProperty(server, "ApplicationProperty", "${appvar}");
+        testApp.nodes["node3"].servers.push_back(server);
+
+        try
+        {
+            admin->addApplication(testApp);
+        }
+        catch(const Ice::Exception& ex)
+        {
+            cerr << ex << endl;
+            test(false);
+        }
+
+        //
+        // Updating node1 doesn't change the servers of the other nodes.
+        //
+        ApplicationUpdateDescriptor update;
+        update.name = "TestApp";
+        NodeUpdateDescriptor nodeUpdate;
+        nodeUpdate.name = "node1";
+        nodeUpdate.variables["nodevar"] = "1";
+        update.nodes.push_back(nodeUpdate);
+        admin->updateApplication(update);
+        test(getProperty(admin->getServerInfo("Server2").descriptor->propertySet.properties, "TemplateProperty") == "1");
+        test(getProperty(admin->getServerInfo("Server3").descriptor->propertySet.properties,
+                         "ApplicationProperty") == "1");
+
+        //
+        // Updating the server template updates the servers of node1 and
+        // node2 even though these nodes aren't part of the update.
+        //
+        update.nodes.clear();
+        templ.descriptor = ServerDescriptorPtr::dynamicCast(templ.descriptor->ice_clone());
+        templ.descriptor->propertySet.properties[0].value = "2";
+        update.serverTemplates["ServerTemplate"] = templ;
+        admin->updateApplication(update);
+        test(getProperty(admin->getServerInfo("Server1").descriptor->propertySet.properties, "TemplateProperty") == "2");
+        test(getProperty(admin->getServerInfo("Server2").descriptor->propertySet.properties, "TemplateProperty") == "2");
+
+        //
+        // Updating an application variable updates the servers of all
+        // the nodes.
+        //
+        update.serverTemplates.clear();
+        update.variables["appvar"] = "2";
+        admin->updateApplication(update);
+        test(getProperty(admin->getServerInfo("Server1").descriptor->propertySet.properties,
+                         "ApplicationProperty") == "2");
+        test(getProperty(admin->getServerInfo("Server2").descriptor->propertySet.properties,
+                         "ApplicationProperty") == "2");
+        test(getProperty(admin->getServerInfo("Server3").descriptor->propertySet.properties,
+                         "ApplicationProperty") == "2");
+
+        admin->removeApplication("TestApp");
+
+        cout << "ok" << endl;
+    }
+
     {
         cout << "testing variable update... " << flush;
 
@@ -0,0 +1,175 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2018 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <IceUtil/Options.h>
+#include <IceUtil/Thread.h>
+#include <IceStorm/IceStorm.h>
+#include <Event.h>
+#include <TestHelper.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceStorm;
+using namespace Test;
+
+namespace
+{
+
+class PublisherThread : public IceUtil::Thread
+{
+public:
+
+    PublisherThread(const EventPrx& proxy, int events, int size) :
+        _proxy(proxy), _events(events), _payload(size, 0), _failed(false)
+    {
+    }
+
+    virtual void
+    run()
+    {
+        try
+        {
+            for(int i = 0; i < _events; ++i)
+            {
+                _proxy->pub(IceUtil::Time::now(IceUtil::Time::Monotonic).toMicroSeconds(), _payload);
+            }
+
+            if(_proxy->ice_isOneway())
+            {
+                //
+                // Before we exit, we ping the proxy as twoway, to make sure
+                // that all oneways are delivered.
+                //
+                _proxy->ice_twoway()->ice_ping();
+            }
+        }
+        catch(const Ice::Exception& ex)
+        {
+            cerr << "publisher failed: " << ex << endl;
+            _failed = true;
+        }
+    }
+
+    bool
+    failed() const
+    {
+        return _failed;
+    }
+
+private:
+
+    const EventPrx _proxy;
+    const int _events;
+    const Ice::ByteSeq _payload;
+    bool _failed;
+};
+typedef IceUtil::Handle<PublisherThread> PublisherThreadPtr;
+
+}
+
+class Publisher : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Publisher::run(int argc, char** argv)
+{
+    Ice::CommunicatorHolder communicator = initialize(argc, argv);
+    IceUtilInternal::Options opts;
+    opts.addOpt("", "events", IceUtilInternal::Options::NeedArg);
+    opts.addOpt("", "publishers", IceUtilInternal::Options::NeedArg);
+    opts.addOpt("", "size", IceUtilInternal::Options::NeedArg);
+    opts.addOpt("", "oneway");
+
+    try
+    {
+        opts.parse(argc, (const char**)argv);
+    }
+    catch(const IceUtilInternal::BadOptException& e)
+    {
+        ostringstream os;
+        os << argv[0] << ": " << e.reason;
+        throw invalid_argument(os.str());
+    }
+
+    int events = opts.isSet("events") ? atoi(opts.optArg("events").c_str()) : 1000;
+    int publishers = opts.isSet("publishers") ? atoi(opts.optArg("publishers").c_str()) : 1;
+    int size = opts.isSet("size") ? atoi(opts.optArg("size").c_str()) : 0;
+    if(events <= 0 || publishers <= 0 || size < 0)
+    {
+        ostringstream os;
+        os << argv[0] << ": events and publishers must be > 0 and size must be >= 0.";
+        throw invalid_argument(os.str());
+    }
+    bool oneway = opts.isSet("oneway");
+
+    PropertiesPtr properties = communicator->getProperties();
+    const char* managerProxyProperty = "IceStormAdmin.TopicManager.Default";
+    string managerProxy = properties->getProperty(managerProxyProperty);
+    if(managerProxy.empty())
+    {
+        ostringstream os;
+        os << argv[0] << ": property `" << managerProxyProperty << "' is not set";
+        throw invalid_argument(os.str());
+    }
+
+    IceStorm::TopicManagerPrx manager = IceStorm::TopicManagerPrx::checkedCast(
+        communicator->stringToProxy(managerProxy));
+    if(!manager)
+    {
+        ostringstream os;
+        os << argv[0] << ": `" << managerProxy << "' is not running";
+        throw invalid_argument(os.str());
+    }
+
+    TopicPrx topic = manager->retrieve("bench");
+    Ice::ObjectPrx publisher = topic->getPublisher();
+
+    //
+    // Each publisher uses its own connection to IceStorm.
+    //
+    vector<PublisherThreadPtr> threads;
+    for(int i = 0; i < publishers; ++i)
+    {
+        ostringstream connectionId;
+        connectionId << "publisher-" << i;
+        Ice::ObjectPrx proxy = publisher->ice_connectionId(connectionId.str());
+        proxy = oneway ? proxy->ice_oneway() : proxy->ice_twoway();
+        proxy->ice_getConnection();
+        threads.push_back(new PublisherThread(EventPrx::uncheckedCast(proxy), events, size));
+    }
+
+    IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    vector<IceUtil::ThreadControl> controls;
+    for(vector<PublisherThreadPtr>::const_iterator p = threads.begin(); p != threads.end(); ++p)
+    {
+        controls.push_back((*p)->start());
+    }
+    for(vector<IceUtil::ThreadControl>::iterator p = controls.begin(); p != controls.end(); ++p)
+    {
+        p->join();
+    }
+    IceUtil::Time elapsed = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+
+    for(vector<PublisherThreadPtr>::const_iterator p = threads.begin(); p != threads.end(); ++p)
+    {
+        test(!(*p)->failed());
+    }
+
+    Ice::Long total = static_cast<Ice::Long>(events) * publishers;
+    cout << "published " << total << " events of " << size << " bytes with " << publishers << " "
+         << (oneway ? "oneway" : "twoway") << " publisher(s) in " << elapsed.toMilliSeconds() << "ms ("
+         << static_cast<Ice::Long>(total / elapsed.toSecondsDouble()) << " events/s)" << endl;
+}
+
+DEFINE_TEST(Publisher)
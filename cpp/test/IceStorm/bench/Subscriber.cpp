@@ -0,0 +1,291 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2018 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <IceStorm/IceStorm.h>
+#include <IceUtil/Options.h>
+#include <IceUtil/Monitor.h>
+#include <IceUtil/Time.h>
+#include <Event.h>
+#include <TestHelper.h>
+#include <algorithm>
+#include <iomanip>
+
+using namespace std;
+using namespace Ice;
+using namespace IceStorm;
+using namespace Test;
+
+namespace
+{
+
+class Barrier : public IceUtil::Shared, public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    Barrier(int count) :
+        _count(count)
+    {
+    }
+
+    void
+    done()
+    {
+        Lock sync(*this);
+        if(--_count == 0)
+        {
+            notifyAll();
+        }
+    }
+
+    bool
+    waitForEvents(const IceUtil::Time& timeout)
+    {
+        IceUtil::Time end = IceUtil::Time::now(IceUtil::Time::Monotonic) + timeout;
+        Lock sync(*this);
+        while(_count > 0)
+        {
+            IceUtil::Time delay = end - IceUtil::Time::now(IceUtil::Time::Monotonic);
+            if(delay <= IceUtil::Time() || !timedWait(delay))
+            {
+                return _count == 0;
+            }
+        }
+        return true;
+    }
+
+private:
+
+    int _count;
+};
+typedef IceUtil::Handle<Barrier> BarrierPtr;
+
+class EventI : public Event, public IceUtil::Mutex
+{
+public:
+
+    EventI(const BarrierPtr& barrier, int total) :
+        _barrier(barrier), _total(total)
+    {
+        _latencies.reserve(total);
+    }
+
+    virtual void
+    pub(Ice::Long timestamp, const Ice::ByteSeq&, const Ice::Current&)
+    {
+        IceUtil::Time now = IceUtil::Time::now(IceUtil::Time::Monotonic);
+
+        Lock sync(*this);
+        if(static_cast<int>(_latencies.size()) == _total)
+        {
+            return;
+        }
+        if(_latencies.empty())
+        {
+            _first = now;
+        }
+        _latencies.push_back(now.toMicroSeconds() - timestamp);
+        if(static_cast<int>(_latencies.size()) == _total)
+        {
+            _last = now;
+            _barrier->done();
+        }
+    }
+
+    const vector<Ice::Long>&
+    latencies() const
+    {
+        return _latencies;
+    }
+
+    size_t
+    received() const
+    {
+        Lock sync(*this);
+        return _latencies.size();
+    }
+
+    IceUtil::Time
+    first() const
+    {
+        return _first;
+    }
+
+    IceUtil::Time
+    last() const
+    {
+        return _last;
+    }
+
+private:
+
+    const BarrierPtr _barrier;
+    const int _total;
+    vector<Ice::Long> _latencies; // The delivery latency of each event in microseconds.
+    IceUtil::Time _first;
+    IceUtil::Time _last;
+};
+typedef IceUtil::Handle<EventI> EventIPtr;
+
+Ice::Long
+percentile(const vector<Ice::Long>& sorted, double p)
+{
+    size_t n = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[n];
+}
+
+}
+
+class Subscriber : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Subscriber::run(int argc, char** argv)
+{
+    Ice::CommunicatorHolder communicator = initialize(argc, argv);
+    IceUtilInternal::Options opts;
+    opts.addOpt("", "events", IceUtilInternal::Options::NeedArg);
+    opts.addOpt("", "subscribers", IceUtilInternal::Options::NeedArg);
+    opts.addOpt("", "reliability", IceUtilInternal::Options::NeedArg);
+    opts.addOpt("", "timeout", IceUtilInternal::Options::NeedArg);
+
+    try
+    {
+        opts.parse(argc, (const char**)argv);
+    }
+    catch(const IceUtilInternal::BadOptException& e)
+    {
+        ostringstream os;
+        os << argv[0] << ": " << e.reason;
+        throw invalid_argument(os.str());
+    }
+
+    int events = opts.isSet("events") ? atoi(opts.optArg("events").c_str()) : 1000;
+    int subscribers = opts.isSet("subscribers") ? atoi(opts.optArg("subscribers").c_str()) : 1;
+    int timeout = opts.isSet("timeout") ? atoi(opts.optArg("timeout").c_str()) : 120;
+    if(events <= 0 || subscribers <= 0 || timeout <= 0)
+    {
+        ostringstream os;
+        os << argv[0] << ": events, subscribers and timeout must be > 0.";
+        throw invalid_argument(os.str());
+    }
+
+    string reliability = opts.isSet("reliability") ? opts.optArg("reliability") : "oneway";
+    if(reliability != "oneway" && reliability != "twoway" && reliability != "batch" && reliability != "ordered")
+    {
+        ostringstream os;
+        os << argv[0] << ": invalid reliability `" << reliability << "'";
+        throw invalid_argument(os.str());
+    }
+
+    PropertiesPtr properties = communicator->getProperties();
+    const char* managerProxyProperty = "IceStormAdmin.TopicManager.Default";
+    string managerProxy = properties->getProperty(managerProxyProperty);
+    if(managerProxy.empty())
+    {
+        ostringstream os;
+        os << argv[0] << ": property `" << managerProxyProperty << "' is not set";
+        throw invalid_argument(os.str());
+    }
+
+    IceStorm::TopicManagerPrx manager = IceStorm::TopicManagerPrx::checkedCast(
+        communicator->stringToProxy(managerProxy));
+    if(!manager)
+    {
+        ostringstream os;
+        os << argv[0] << ": `" << managerProxy << "' is not running";
+        throw invalid_argument(os.str());
+    }
+
+    TopicPrx topic = manager->retrieve("bench");
+
+    Ice::ObjectAdapterPtr adapter = communicator->createObjectAdapterWithEndpoints("SubscriberAdapter", "default");
+    BarrierPtr barrier = new Barrier(subscribers);
+
+    vector<EventIPtr> servants;
+    vector<Ice::ObjectPrx> proxies;
+    for(int i = 0; i < subscribers; ++i)
+    {
+        EventIPtr servant = new EventI(barrier, events);
+        Ice::ObjectPrx obj = adapter->addWithUUID(servant);
+
+        IceStorm::QoS qos;
+        if(reliability == "ordered")
+        {
+            qos["reliability"] = "ordered";
+        }
+        else if(reliability == "batch")
+        {
+            obj = obj->ice_batchOneway();
+        }
+        else if(reliability == "oneway")
+        {
+            obj = obj->ice_oneway();
+        }
+        topic->subscribeAndGetPublisher(qos, obj);
+
+        servants.push_back(servant);
+        proxies.push_back(obj);
+    }
+
+    adapter->activate();
+
+    //
+    // Don't wait forever if events are lost (with oneway and batch
+    // subscribers for example), report how many events were received.
+    //
+    if(!barrier->waitForEvents(IceUtil::Time::seconds(timeout)))
+    {
+        ostringstream os;
+        os << "timed out after " << timeout << "s waiting for " << events << " events, received:";
+        for(vector<EventIPtr>::const_iterator p = servants.begin(); p != servants.end(); ++p)
+        {
+            os << ' ' << (*p)->received();
+        }
+        throw runtime_error(os.str());
+    }
+
+    for(vector<Ice::ObjectPrx>::const_iterator p = proxies.begin(); p != proxies.end(); ++p)
+    {
+        topic->unsubscribe(*p);
+    }
+
+    //
+    // Compute the delivery rate from the first to the last event received
+    // by any of the subscribers and the latency percentiles over all the
+    // events received.
+    //
+    vector<Ice::Long> latencies;
+    IceUtil::Time first = servants.front()->first();
+    IceUtil::Time last = servants.front()->last();
+    for(vector<EventIPtr>::const_iterator p = servants.begin(); p != servants.end(); ++p)
+    {
+        latencies.insert(latencies.end(), (*p)->latencies().begin(), (*p)->latencies().end());
+        first = min(first, (*p)->first());
+        last = max(last, (*p)->last());
+    }
+    sort(latencies.begin(), latencies.end());
+
+    double elapsed = (last - first).toSecondsDouble();
+    cout << "delivered " << latencies.size() << " events to " << subscribers << " " << reliability
+         << " subscriber(s) in " << (last - first).toMilliSeconds() << "ms ("
+         << static_cast<Ice::Long>(elapsed > 0 ? latencies.size() / elapsed : 0) << " events/s)" << endl;
+    cout << fixed << setprecision(3)
+         << "latency (ms): p50 " << percentile(latencies, 0.5) / 1000.0
+         << ", p90 " << percentile(latencies, 0.9) / 1000.0
+         << ", p99 " << percentile(latencies, 0.99) / 1000.0
+         << ", p99.9 " << percentile(latencies, 0.999) / 1000.0
+         << ", max " << latencies.back() / 1000.0 << endl;
+}
+
+DEFINE_TEST(Subscriber)
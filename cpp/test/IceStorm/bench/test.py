@@ -0,0 +1,60 @@
+# -*- coding: utf-8 -*-
+# **********************************************************************
+#
+# Copyright (c) 2003-2018 ZeroC, Inc. All rights reserved.
+#
+# This copy of Ice is licensed to you under the terms described in the
+# ICE_LICENSE file included in this distribution.
+#
+# **********************************************************************
+
+#
+# Measures the IceStorm throughput and delivery latency with several
+# publishers and subscribers for each reliability mode. The publisher and
+# subscriber can also be run directly against an IceStorm deployment with
+# larger --events, --publishers, --subscribers and --size values.
+#
+# The benchmark only runs when the test driver is started with --bench.
+#
+
+publishers = 2
+subscribers = 4
+events = 5000
+size = 128
+
+class IceStormBenchTestCase(IceStormTestCase):
+
+    def runClientSide(self, current):
+
+        def doBench(reliability):
+            subscriber = Subscriber(args=["--events", str(publishers * events),
+                                          "--subscribers", str(subscribers),
+                                          "--reliability", reliability])
+            publisher = Publisher(args=["--events", str(events),
+                                        "--publishers", str(publishers),
+                                        "--size", str(size)] +
+                                       (["--oneway"] if reliability in ["oneway", "batch"] else []))
+            ClientServerTestCase(client=publisher, server=subscriber).run(current)
+            current.writeln("ok")
+            for line in subscriber.getOutput(current).strip().split("\n"):
+                current.writeln("    " + line.strip())
+
+        current.write("setting up the topic... ")
+        self.runadmin(current, "create bench")
+        current.writeln("ok")
+
+        for reliability in ["oneway", "twoway", "batch", "ordered"]:
+            current.write("benchmarking {0} subscribers... ".format(reliability))
+            doBench(reliability)
+
+        self.runadmin(current, "destroy bench")
+
+        current.write("shutting down icestorm services... ")
+        self.stopIceStorm(current)
+        current.writeln("ok")
+
+TestSuite(__file__, [
+    IceStormBenchTestCase("persistent", icestorm=IceStorm(quiet=True)),
+    IceStormBenchTestCase("transient", icestorm=IceStorm(transient=True, quiet=True)),
+    IceStormBenchTestCase("replicated", icestorm=[IceStorm(replica=i, nreplicas=3, quiet=True) for i in range(0,3)]),
+], multihost=False)
@@ -8,6 +8,7 @@
 // **********************************************************************
 
 #include <IceUtil/IceUtil.h>
+#include <IceUtil/Options.h>
 #include <Ice/Ice.h>
 #include <IceStorm/IceStorm.h>
 #include <Single.h>
@@ -33,15 +34,30 @@ class SingleI : public Single, public IceUtil::Monitor<IceUtil::Mutex>
 {
 public:
 
-    SingleI() :
-        _nevents(0)
+    SingleI(bool ordered) :
+        _ordered(ordered),
+        _nevents(0),
+        _last(-1),
+        _unordered(false)
     {
     }
 
     virtual void
-    event(int, const Current&)
+    event(int i, const Current&)
     {
         Lock sync(*this);
+
+        //
+        // The publisher publishes an event again if the replica fails
+        // before acknowledging it so the same event can be received
+        // twice.
+        //
+        if(_ordered && i < _last)
+        {
+            cerr << "received unordered event: " << i << " " << _last << endl;
+            _unordered = true;
+        }
+        _last = i;
         ++_nevents;
     }
 
@@ -52,12 +68,82 @@ public:
         return _nevents;
     }
 
+    bool
+    unordered() const
+    {
+        Lock sync(*this);
+        return _unordered;
+    }
+
 private:
 
+    const bool _ordered;
     int _nevents;
+    int _last;
+    bool _unordered;
 };
 typedef IceUtil::Handle<SingleI> SingleIPtr;
 
+//
+// Subscribes and unsubscribes a subscriber in a loop to keep the
+// master busy replicating subscriber updates.
+//
+class ChurnThread : public IceUtil::Thread, public IceUtil::Mutex
+{
+public:
+
+    ChurnThread(const TopicPrx& topic, const Ice::ObjectPrx& subscriber) :
+        _topic(topic),
+        _subscriber(subscriber),
+        _destroy(false)
+    {
+    }
+
+    virtual void run()
+    {
+        IceStorm::QoS qos;
+        while(true)
+        {
+            {
+                Lock sync(*this);
+                if(_destroy)
+                {
+                    break;
+                }
+            }
+            try
+            {
+                try
+                {
+                    _topic->subscribeAndGetPublisher(qos, _subscriber);
+                }
+                catch(const IceStorm::AlreadySubscribed&)
+                {
+                }
+                _topic->unsubscribe(_subscriber);
+            }
+            catch(const Ice::Exception&)
+            {
+                // This is expected while a replica is going down or
+                // while the replica group is reorganized.
+            }
+        }
+    }
+
+    void destroy()
+    {
+        Lock sync(*this);
+        _destroy = true;
+    }
+
+private:
+
+    const TopicPrx _topic;
+    const Ice::ObjectPrx _subscriber;
+    bool _destroy;
+};
+typedef IceUtil::Handle<ChurnThread> ChurnThreadPtr;
+
 class Subscriber : public Test::TestHelper
 {
 public:
@@ -69,6 +155,21 @@ void
 Subscriber::run(int argc, char** argv)
 {
     Ice::CommunicatorHolder communicator = initialize(argc, argv);
+    IceUtilInternal::Options opts;
+    opts.addOpt("", "ordered");
+    opts.addOpt("", "churn");
+
+    try
+    {
+        opts.parse(argc, (const char**)argv);
+    }
+    catch(const IceUtilInternal::BadOptException& e)
+    {
+        ostringstream os;
+        os << argv[0] << ": " << e.reason;
+        throw invalid_argument(os.str());
+    }
+
     PropertiesPtr properties = communicator->getProperties();
     string managerProxy = properties->getProperty("IceStormAdmin.TopicManager.Default");
     if(managerProxy.empty())
@@ -90,11 +191,15 @@ Subscriber::run(int argc, char** argv)
     ObjectAdapterPtr adapter = communicator->createObjectAdapterWithEndpoints("SingleAdapter", "default");
     TopicPrx topic = manager->retrieve("single");
 
-    SingleIPtr sub = new SingleI();
+    SingleIPtr sub = new SingleI(opts.isSet("ordered"));
     Ice::ObjectPrx prx = adapter->addWithUUID(sub);
     Ice::ObjectPrx control = adapter->addWithUUID(new ControllerI);
 
     IceStorm::QoS qos;
+    if(opts.isSet("ordered"))
+    {
+        qos["reliability"] = "ordered";
+    }
 
     while(true)
     {
@@ -117,11 +222,26 @@ Subscriber::run(int argc, char** argv)
     }
 
     adapter->activate();
+
+    ChurnThreadPtr churn;
+    if(opts.isSet("churn"))
+    {
+        churn = new ChurnThread(topic, adapter->addWithUUID(new SingleI(false)));
+        churn->start();
+    }
+
     cout << communicator->proxyToString(control) << endl;
 
     communicator->waitForShutdown();
 
+    if(churn)
+    {
+        churn->destroy();
+        churn->getThreadControl().join();
+    }
+
     cout << sub->nevents() << endl;
+    test(!sub->unordered());
 }
 
 DEFINE_TEST(Subscriber)
@@ -24,6 +24,14 @@ props = {
 
 icestorm = [ IceStorm(replica=i, nreplicas=3, props = props) for i in range(0,3) ]
 
+#
+# Allow a single outstanding replication update to exercise the
+# replication flow control.
+#
+flowControlProps = dict(props, **{ "IceStorm.Replication.MaxOutstanding" : 1 })
+
+flowControlIceStorm = [ IceStorm(replica=i, nreplicas=3, props = flowControlProps) for i in range(0,3) ]
+
 class IceStormRepStressTestCase(IceStormTestCase):
 
     def runClientSide(self, current):
@@ -107,7 +115,96 @@ class IceStormRepStressTestCase(IceStormTestCase):
 
         current.writeln("publisher published %s events, subscriber received %s events" % (publisherCount, subscriberCount))
 
+class IceStormRepFlowControlTestCase(IceStormTestCase):
+
+    def runClientSide(self, current):
+
+        def stopReplica(num):
+            self.icestorm[num].shutdown(current)
+            self.icestorm[num].stop(current, True)
+
+        def startReplica(num):
+            self.icestorm[num].start(current)
+
+        def subscribers(replica):
+            return sorted(self.runadmin(current, "subscribers single", instance=self.icestorm[replica],
+                                        quiet=True).splitlines())
+
+        current.write("creating topic... ")
+        self.runadmin(current, "create single")
+        current.writeln("ok")
+
+        #
+        # The subscriber subscribes and unsubscribes another subscriber
+        # in a loop to keep the master busy replicating updates.
+        #
+        current.write("running ordered subscriber... ")
+        subscriber = Subscriber(args=["--ordered", "--churn"], quiet=True)
+        subscriber.start(current)
+        subscriber.expect(current, "([^\n]+)\n")
+        subControl = subscriber.getMatch(current).group(1)
+        current.writeln("ok")
+
+        #
+        # The publisher publishes its events to the first replica, the
+        # replica which is stopped doesn't interrupt the event stream.
+        #
+        current.write("running publisher... ")
+        publisher = Publisher(props={ "Ice.Default.EndpointSelection" : "Ordered" }, quiet=True)
+        publisher.start(current)
+        publisher.expect(current, "([^\n]+)\n")
+        pubControl = publisher.getMatch(current).group(1)
+        current.writeln("ok")
+
+        time.sleep(2)
+
+        for i in range(0, 3):
+            current.write("stopping replica 1 (0, 2 running)... ")
+            stopReplica(1)
+            current.writeln("ok")
+            time.sleep(2)
+
+            current.write("starting replica 1 (all running)... ")
+            startReplica(1)
+            current.writeln("ok")
+            time.sleep(2)
+
+        current.write("stopping publisher... ")
+        Client(exe="control", args=[pubControl]).run(current)
+        publisher.expect(current, "([^\n]+)\n")
+        publisherCount = publisher.getMatch(current).group(1)
+        publisher.stop(current, True)
+        current.writeln("ok")
+
+        # The subscriber exits with a failure if it received unordered events.
+        current.write("stopping subscriber... ")
+        Client(exe="control", args=[subControl]).run(current)
+        subscriber.expect(current, "([^\n]+)\n")
+        subscriberCount = subscriber.getMatch(current).group(1)
+        subscriber.stop(current, True)
+        current.writeln("ok")
+
+        current.write("checking replica synchronization... ")
+        expected = subscribers(2)
+        for replica in range(0, 2):
+            for retry in range(0, 10):
+                if subscribers(replica) == expected:
+                    break
+                time.sleep(1)
+            else:
+                raise RuntimeError("replica {0} subscribers `{1}' (expected `{2}')".format(replica,
+                                                                                           subscribers(replica),
+                                                                                           expected))
+        current.writeln("ok")
+
+        current.write("stopping replicas... ")
+        self.stopIceStorm(current)
+        current.writeln("ok")
+
+        current.writeln("publisher published %s events, subscriber received %s events" % (publisherCount, subscriberCount))
+
 TestSuite(__file__,
-          [ IceStormRepStressTestCase("replicated", icestorm=icestorm) ],
+          [ IceStormRepStressTestCase("replicated", icestorm=icestorm),
+            IceStormRepFlowControlTestCase("replicated with replication flow control", icestorm=flowControlIceStorm) ],
           options={ "ipv6" : [False] },
           multihost=False, runOnMainThread=True)
@@ -18,6 +18,7 @@
 props = { "Ice.UDP.SndSize" : 2048 * 1024, "Ice.Warn.Dispatch" : 0 }
 persistent = IceStorm(props = props)
 transient = IceStorm(props = props, transient=True)
+adaptive = IceStorm(props = dict(props, **{ "IceStorm.Flush.Adaptive" : 1, "IceStorm.Flush.BatchSize" : 10 }))
 replicated = [ IceStorm(replica=i, nreplicas=3, props = props) for i in range(0,3) ]
 
 sub = Subscriber(args=["{testcase.parent.name}"], props = { "Ice.UDP.RcvSize" : 4096 * 1024 }, readyCount=3)
@@ -35,5 +36,6 @@ class IceStormSingleTestCase(IceStormTestCase):
 TestSuite(__file__, [
     IceStormSingleTestCase("persistent", icestorm=persistent, client=ClientServerTestCase(client=pub, server=sub)),
     IceStormSingleTestCase("transient", icestorm=transient, client=ClientServerTestCase(client=pub, server=sub)),
+    IceStormSingleTestCase("adaptive", icestorm=adaptive, client=ClientServerTestCase(client=pub, server=sub)),
     IceStormSingleTestCase("replicated", icestorm=replicated, client=ClientServerTestCase(client=pub, server=sub)),
 ], multihost=False)
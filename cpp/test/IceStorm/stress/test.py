@@ -143,6 +143,17 @@ class IceStormStressTestCase(IceStormTestCase):
             s.stop(current, True)
         current.writeln("ok")
 
+        current.write("Sending 5000 ordered events with max queue memory remove subscriber... ")
+        opts = " --IceStorm.Send.QueueMemoryMax=64 --IceStorm.Send.QueueSizeMaxPolicy=RemoveSubscriber"
+        for s in icestorm1:
+            s.start(current, args=opts.split(" "))
+        doTest(("TestIceStorm1", '--events 5000 --qos "reliability,ordered" --maxQueueRemoveSub=1'),
+               '--events 5000 --maxQueueTest')
+        for s in icestorm1:
+            s.shutdown(current)
+            s.stop(current, True)
+        current.writeln("ok")
+
 TestSuite(__file__, [
 
     IceStormStressTestCase("persistent", icestorm=[IceStorm("TestIceStorm1", quiet=True),
@@ -6,7 +6,7 @@
 // ICE_LICENSE file included in this distribution.
 //
 // **********************************************************************
-// Generated by makeprops.py from file ./config/PropertyNames.xml, Wed Sep 12 19:11:29 2018
+// Generated by makeprops.py from file ./config/PropertyNames.xml, Sun Oct 18 17:11:16 2026
 
 // IMPORTANT: Do not edit this file -- any edits made here will be lost!
 
@@ -125,6 +125,9 @@ public final class PropertyNames
         new Property("Ice\\.InitPlugins", false, null),
         new Property("Ice\\.IPv4", false, null),
         new Property("Ice\\.IPv6", false, null),
+        new Property("Ice\\.LocatorBatchRequests", false, null),
+        new Property("Ice\\.LocatorCacheMaxSize", false, null),
+        new Property("Ice\\.LocatorCacheRefreshAhead", false, null),
         new Property("Ice\\.LogFile", false, null),
         new Property("Ice\\.LogFile\\.SizeMax", false, null),
         new Property("Ice\\.LogStdErr\\.Convert", false, null),
@@ -711,8 +714,11 @@ public final class PropertyNames
         new Property("IceGrid\\.Node\\.CollocateRegistry", false, null),
         new Property("IceGrid\\.Node\\.Data", false, null),
         new Property("IceGrid\\.Node\\.DisableOnFailure", false, null),
+        new Property("IceGrid\\.Node\\.DispatchMetricsPeriod", false, null),
+        new Property("IceGrid\\.Node\\.MaxConcurrentActivations", false, null),
         new Property("IceGrid\\.Node\\.Name", false, null),
         new Property("IceGrid\\.Node\\.Output", false, null),
+        new Property("IceGrid\\.Node\\.PeerPatching", false, null),
         new Property("IceGrid\\.Node\\.ProcessorSocketCount", false, null),
         new Property("IceGrid\\.Node\\.PrintServersReady", false, null),
         new Property("IceGrid\\.Node\\.PropertiesOverride", false, null),
@@ -912,9 +918,12 @@ public final class PropertyNames
         new Property("IceGrid\\.Registry\\.Internal\\.ThreadPool\\.ThreadIdleTime", false, null),
         new Property("IceGrid\\.Registry\\.Internal\\.ThreadPool\\.ThreadPriority", false, null),
         new Property("IceGrid\\.Registry\\.Internal\\.MessageSizeMax", false, null),
+        new Property("IceGrid\\.Registry\\.LMDB\\.GroupCommit", false, null),
         new Property("IceGrid\\.Registry\\.LMDB\\.MapSize", false, null),
         new Property("IceGrid\\.Registry\\.LMDB\\.Path", false, null),
+        new Property("IceGrid\\.Registry\\.NodeObserverCoalescePeriod", false, null),
         new Property("IceGrid\\.Registry\\.NodeSessionTimeout", false, null),
+        new Property("IceGrid\\.Registry\\.PatchFanOut", false, null),
         new Property("IceGrid\\.Registry\\.PermissionsVerifier\\.EndpointSelection", false, null),
         new Property("IceGrid\\.Registry\\.PermissionsVerifier\\.ConnectionCached", false, null),
         new Property("IceGrid\\.Registry\\.PermissionsVerifier\\.PreferSecure", false, null),
@@ -1193,11 +1202,14 @@ public final class PropertyNames
         new Property("Glacier2\\.Client\\.AlwaysBatch", false, null),
         new Property("Glacier2\\.Client\\.Buffered", false, null),
         new Property("Glacier2\\.Client\\.ForwardContext", false, null),
+        new Property("Glacier2\\.Client\\.FlushThreads", false, null),
         new Property("Glacier2\\.Client\\.SleepTime", false, null),
         new Property("Glacier2\\.Client\\.Trace\\.Override", false, null),
         new Property("Glacier2\\.Client\\.Trace\\.Reject", false, null),
         new Property("Glacier2\\.Client\\.Trace\\.Request", false, null),
         new Property("Glacier2\\.CryptPasswords", false, null),
+        new Property("Glacier2\\.CryptPermissionsVerifier\\.CacheTimeout", false, null),
+        new Property("Glacier2\\.CryptPermissionsVerifier\\.Threads", false, null),
         new Property("Glacier2\\.Filter\\.Address\\.Reject", false, null),
         new Property("Glacier2\\.Filter\\.Address\\.Accept", false, null),
         new Property("Glacier2\\.Filter\\.ProxySizeMax", false, null),
@@ -1227,7 +1239,9 @@ public final class PropertyNames
         new Property("Glacier2\\.SSLPermissionsVerifier\\.CollocationOptimized", false, null),
         new Property("Glacier2\\.SSLPermissionsVerifier\\.Context\\.[^\\s]+", false, null),
         new Property("Glacier2\\.SSLPermissionsVerifier", false, null),
+        new Property("Glacier2\\.RoutingTable\\.MaxMemory", false, null),
         new Property("Glacier2\\.RoutingTable\\.MaxSize", false, null),
+        new Property("Glacier2\\.RoutingTable\\.TotalMaxMemory", false, null),
         new Property("Glacier2\\.Server\\.ACM\\.Timeout", false, null),
         new Property("Glacier2\\.Server\\.ACM\\.Heartbeat", false, null),
         new Property("Glacier2\\.Server\\.ACM\\.Close", false, null),
@@ -1268,6 +1282,7 @@ public final class PropertyNames
         new Property("Glacier2\\.Server\\.AlwaysBatch", false, null),
         new Property("Glacier2\\.Server\\.Buffered", false, null),
         new Property("Glacier2\\.Server\\.ForwardContext", false, null),
+        new Property("Glacier2\\.Server\\.FlushThreads", false, null),
         new Property("Glacier2\\.Server\\.SleepTime", false, null),
         new Property("Glacier2\\.Server\\.Trace\\.Override", false, null),
         new Property("Glacier2\\.Server\\.Trace\\.Request", false, null),
@@ -211,6 +211,10 @@ class ReplicaGroup extends TreeNode
                     AdaptiveLoadBalancingPolicy policy = (AdaptiveLoadBalancingPolicy)_descriptor.loadBalancing;
                     attributes.add(createAttribute("load-sample", policy.loadSample));
                 }
+                else if(_descriptor.loadBalancing instanceof LatencyLoadBalancingPolicy)
+                {
+                    attributes.add(createAttribute("type", "latency"));
+                }
                 attributes.add(createAttribute("n-replicas", _descriptor.loadBalancing.nReplicas));
                 writer.writeElement("load-balancing", attributes);
 
@@ -249,6 +249,10 @@ class ReplicaGroupEditor extends Editor
             descriptor.loadBalancing = new AdaptiveLoadBalancingPolicy(
                 _nReplicas.getText().trim(), _loadSample.getSelectedItem().toString().trim());
         }
+        else if(loadBalancing == LATENCY)
+        {
+            descriptor.loadBalancing = new LatencyLoadBalancingPolicy(_nReplicas.getText().trim());
+        }
         else
         {
             assert false;
@@ -397,6 +401,12 @@ class ReplicaGroupEditor extends Editor
             _loadSample.setSelectedItem(
                 Utils.substitute(((AdaptiveLoadBalancingPolicy)descriptor.loadBalancing).loadSample, resolver));
         }
+        else if(descriptor.loadBalancing instanceof LatencyLoadBalancingPolicy)
+        {
+            _loadBalancing.setSelectedItem(LATENCY);
+            _nReplicas.setText(Utils.substitute(descriptor.loadBalancing.nReplicas, resolver));
+            _loadSample.setSelectedItem("1");
+        }
         else
         {
             assert false;
@@ -469,6 +479,7 @@ class ReplicaGroupEditor extends Editor
     static private String RANDOM = "Random";
     static private String ROUND_ROBIN = "Round-robin";
     static private String ADAPTIVE = "Adaptive";
+    static private String LATENCY = "Latency";
 
     private JTextField _id = new JTextField(20);
     private JTextArea _description = new JTextArea(3, 20);
@@ -476,6 +487,7 @@ class ReplicaGroupEditor extends Editor
     private JTextField _filter = new JTextField(20);
 
     private JComboBox _loadBalancing = new JComboBox(new String[] {ADAPTIVE,
+                                                                   LATENCY,
                                                                    ORDERED,
                                                                    RANDOM,
                                                                    ROUND_ROBIN});
@@ -6,7 +6,7 @@
 // ICE_LICENSE file included in this distribution.
 //
 // **********************************************************************
-// Generated by makeprops.py from file ./config/PropertyNames.xml, Wed Sep 12 19:11:29 2018
+// Generated by makeprops.py from file ./config/PropertyNames.xml, Sun Oct 18 17:11:16 2026
 
 // IMPORTANT: Do not edit this file -- any edits made here will be lost!
 
@@ -128,6 +128,9 @@ PropertyNames.IceProps =
     new Property("/^Ice\.InitPlugins/", false, null),
     new Property("/^Ice\.IPv4/", false, null),
     new Property("/^Ice\.IPv6/", false, null),
+    new Property("/^Ice\.LocatorBatchRequests/", false, null),
+    new Property("/^Ice\.LocatorCacheMaxSize/", false, null),
+    new Property("/^Ice\.LocatorCacheRefreshAhead/", false, null),
     new Property("/^Ice\.LogFile/", false, null),
     new Property("/^Ice\.LogFile\.SizeMax/", false, null),
     new Property("/^Ice\.LogStdErr\.Convert/", false, null),
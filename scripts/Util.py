@@ -2729,7 +2729,7 @@ class Driver:
     @classmethod
     def getSupportedArgs(self):
         return ("dlrR", ["debug", "driver=", "filter=", "rfilter=", "host=", "host-ipv6=", "host-bt=", "interface=",
-                         "controller-app", "valgrind", "languages=", "rlanguages="])
+                         "controller-app", "valgrind", "languages=", "rlanguages=", "bench"])
 
     @classmethod
     def usage(self):
@@ -2751,6 +2751,7 @@ class Driver:
         print("--interface=<IP>      The multicast interface to use to discover controllers.")
         print("--controller-app      Start the process controller application.")
         print("--valgrind            Start executables with valgrind.")
+        print("--bench               Also run the benchmarks (the bench tests).")
 
     def __init__(self, options, component):
         self.debug = False
@@ -2762,6 +2763,7 @@ class Driver:
         self.hostBT = ""
         self.controllerApp = False
         self.valgrind = False
+        self.bench = False
         self.languages = ",".join(os.environ.get("LANGUAGES", "").split(" "))
         self.languages = [self.languages] if self.languages else []
         self.rlanguages = []
@@ -2794,6 +2796,9 @@ class Driver:
         # Return the driver and component filters
         (filters, rfilters) = component.getFilters(mapping, config)
         (filters, rfilters) = ([re.compile(a) for a in filters], [re.compile(a) for a in rfilters])
+        if not self.bench:
+            # The benchmarks take a while to run, they only run with --bench
+            rfilters.append(re.compile("/bench$"))
         return (self.filters + filters, self.rfilters + rfilters)
 
     def isWorkerThread(self):
@@ -31,8 +31,14 @@ traceProps = {
     "Ice.Trace.Retry": 1,
 }
 
-def buffered(enabled):
-    return { "Glacier2.Client.Buffered": enabled, "Glacier2.Server.Buffered": enabled }
+passwordCache = {
+    "Glacier2.CryptPermissionsVerifier.Threads": 2,
+    "Glacier2.CryptPermissionsVerifier.CacheTimeout": 60,
+}
+
+def buffered(enabled, threads=1):
+    return { "Glacier2.Client.Buffered": enabled, "Glacier2.Server.Buffered": enabled,
+             "Glacier2.Client.FlushThreads": threads, "Glacier2.Server.FlushThreads": threads }
 
 Glacier2TestSuite(__name__, routerProps, [
                   ClientServerTestCase(name="client/server with router in unbuffered mode",
@@ -42,4 +48,12 @@ Glacier2TestSuite(__name__, routerProps, [
                   ClientServerTestCase(name="client/server with router in buffered mode",
                                        servers=[Glacier2Router(passwords=passwords, props=buffered(True)), Server()],
                                        clients=[Client(), Client(args=["--shutdown"])],
+                                       traceProps=traceProps),
+                  ClientServerTestCase(name="client/server with router in buffered mode with several flush threads",
+                                       servers=[Glacier2Router(passwords=passwords, props=buffered(True, 4)), Server()],
+                                       clients=[Client(), Client(args=["--shutdown"])],
+                                       traceProps=traceProps),
+                  ClientServerTestCase(name="client/server with router and password verification cache",
+                                       servers=[Glacier2Router(passwords=passwords, props=passwordCache), Server()],
+                                       clients=[Client(args=["--passwords"]), Client(args=["--shutdown"])],
                                        traceProps=traceProps)])